@@ -0,0 +1,96 @@
+/***
+ * Bach.decodeColumns reads the binary column format the simulation server sends when asked for
+ * application/vnd.bach.columns. The format is a short header, the JSON layout of the result with each
+ * "values" array replaced by its length, and then the values of every column as little-endian floats.
+ * Decoding gives back the same object as the JSON response, except that each "values" is a typed array
+ * viewing the response's buffer rather than an array of parsed numbers.
+ *
+ * Copyright (C) 2026 Lawrence Gunn - All Rights Reserved
+ *
+ * Revisions: Original definition by Lawrence Gunn.
+ * 2026/10/18
+ *
+ * @file column-data.js
+ */
+'use strict';
+
+var Bach = Bach || {};
+
+/**
+ * The media type to send in an Accept header, with ";precision=32" added for float32 values.
+ * @property COLUMNS_MEDIA_TYPE
+ */
+Bach.COLUMNS_MEDIA_TYPE = 'application/vnd.bach.columns';
+
+/***
+ * Decode a binary column response.
+ * @method decodeColumns
+ * @param {ArrayBuffer} buffer - the whole response body, for example from xhr.response with responseType 'arraybuffer'
+ * @return {Object} - the result, laid out as the JSON response is, with Float64Array or Float32Array values
+ */
+Bach.decodeColumns = function(buffer) {
+  var HEADER_SIZE = 12;
+  var header = new DataView(buffer, 0, HEADER_SIZE);
+  var magic = String.fromCharCode(header.getUint8(0), header.getUint8(1), header.getUint8(2), header.getUint8(3));
+  if(magic !== 'BCOL') {
+    throw new Error('Not a Bach column response');
+  }
+  var version = header.getUint16(4, true);
+  if(version !== 1) {
+    throw new Error('Unsupported Bach column format version ' + version);
+  }
+  var bytesPerValue = header.getUint8(6);
+  if(bytesPerValue !== 4 && bytesPerValue !== 8) {
+    throw new Error('Unsupported Bach column value size ' + bytesPerValue);
+  }
+  var layoutLength = header.getUint32(8, true);
+
+  var layoutBytes = new Uint8Array(buffer, HEADER_SIZE, layoutLength);
+  var layout = JSON.parse(new TextDecoder('utf-8').decode(layoutBytes));
+
+  // Typed arrays use the platform byte order, so they can only view the buffer in place on a
+  // little-endian platform, which is every browser in practice.
+  var littleEndian = new Uint8Array(new Uint16Array([1]).buffer)[0] === 1;
+  var ArrayType = (bytesPerValue === 8 ? Float64Array : Float32Array);
+  var offset = Math.ceil((HEADER_SIZE + layoutLength) / 8) * 8;
+
+  var readColumn = function(length) {
+    var column;
+    if(littleEndian) {
+      column = new ArrayType(buffer, offset, length);
+    }
+    else {
+      column = new ArrayType(length);
+      var view = new DataView(buffer, offset, length * bytesPerValue);
+      for(var i=0; i<length; i++) {
+        column[i] = (bytesPerValue === 8 ? view.getFloat64(i * 8, true) : view.getFloat32(i * 4, true));
+      }
+    }
+    offset += length * bytesPerValue;
+    return column;
+  };
+
+  // The columns follow in the order their "values" appear in the layout text, which is the
+  // order JSON.parse keeps the members in.
+  var replaceValues = function(node) {
+    if(Array.isArray(node)) {
+      node.forEach(replaceValues);
+    }
+    else if(node !== null && typeof node === 'object') {
+      Object.keys(node).forEach(function(key) {
+        if(key === 'values' && typeof node[key] === 'number') {
+          node[key] = readColumn(node[key]);
+        }
+        else {
+          replaceValues(node[key]);
+        }
+      });
+    }
+  };
+  replaceValues(layout);
+
+  if(offset !== buffer.byteLength) {
+    throw new Error('Bach column response is ' + buffer.byteLength + ' bytes but its layout describes ' + offset);
+  }
+  return layout;
+};
@@ -71,6 +71,19 @@ namespace Bach {
   void LogPlain(const wchar_t* formatString, ...);
   void LogVaArgs(const wchar_t* formatString, va_list vaList);
 
+  // Leveled logging, through the BACH_LOG_ macros below rather than called directly. The
+  // message is queued for a background thread to write, see LogRingBuffer. Errors are
+  // written before LogAtLevel returns, as the throw that follows may end the process.
+  enum LogLevel {
+    LogLevelError = 0,
+    LogLevelWarning = 1,
+    LogLevelInfo = 2,
+    LogLevelDebug = 3,
+    LogLevelTrace = 4
+  };
+
+  void LogAtLevel(LogLevel level, const wchar_t* formatString, ...);
+
   std::wstring WideStringFromUTF8(const std::string& in);
   std::string UTF8FromWideString(const std::wstring& in);
 
@@ -80,6 +93,8 @@ namespace Bach {
   class OdeAccuracySpec;
   class OdeData;
   class OdeDataCollector;
+  class OdeDenseOutput;
+  class OdeSolverTelemetry;
   class SampledDerivedData;
   class SampledData;
   class TableSearch;
@@ -91,6 +106,8 @@ namespace Bach {
   class RootSolverEquations;
   class RootSolverEquationsOdeWrapper;
   class NDimNewtonRaphson;
+  class JsonStreamWriter;
+  class BinaryColumnWriter;
   
   std::wstring ToString(const Eigen::MatrixXd& mat);
   std::wstring VecXdToString(const Eigen::VectorXd& vec);
@@ -131,4 +148,40 @@ namespace Bach {
 # define BACH_ASSERT(test)
 #endif // _DEBUG
 
+// The most detailed level of logging compiled in, as a LogLevel. The macros for levels above it
+// compile to nothing, arguments and all, so they can sit in code that runs every evaluation.
+#ifndef BACH_LOG_LEVEL
+# ifdef _DEBUG
+#  define BACH_LOG_LEVEL 3
+# else
+#  define BACH_LOG_LEVEL 2
+# endif
+#endif // BACH_LOG_LEVEL
+
+#define BACH_LOG_ERROR(...)      Bach::LogAtLevel(Bach::LogLevelError, __VA_ARGS__)
+
+#if BACH_LOG_LEVEL >= 1
+# define BACH_LOG_WARNING(...)   Bach::LogAtLevel(Bach::LogLevelWarning, __VA_ARGS__)
+#else
+# define BACH_LOG_WARNING(...)   ((void) 0)
+#endif
+
+#if BACH_LOG_LEVEL >= 2
+# define BACH_LOG_INFO(...)      Bach::LogAtLevel(Bach::LogLevelInfo, __VA_ARGS__)
+#else
+# define BACH_LOG_INFO(...)      ((void) 0)
+#endif
+
+#if BACH_LOG_LEVEL >= 3
+# define BACH_LOG_DEBUG(...)     Bach::LogAtLevel(Bach::LogLevelDebug, __VA_ARGS__)
+#else
+# define BACH_LOG_DEBUG(...)     ((void) 0)
+#endif
+
+#if BACH_LOG_LEVEL >= 4
+# define BACH_LOG_TRACE(...)     Bach::LogAtLevel(Bach::LogLevelTrace, __VA_ARGS__)
+#else
+# define BACH_LOG_TRACE(...)     ((void) 0)
+#endif
+
 #endif // __BACH_DEFS_H__
@@ -0,0 +1,82 @@
+/**********************************************************************
+
+File     : AllocationCounter.cpp
+Project  : Bach Simulation
+Purpose  : Source file for counting heap allocations in the benchmarks.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+  std::atomic<long> s_allocationCount(0);
+}
+
+    //*****************************
+    //* Bach::AllocationCounter *
+    //*****************************
+
+long Bach::AllocationCounter::GetCount() {
+  return s_allocationCount.load(std::memory_order_relaxed);
+}
+
+void Bach::AllocationCounter::Reset() {
+  s_allocationCount.store(0, std::memory_order_relaxed);
+}
+
+#if defined(__GLIBC__)
+
+// Eigen allocates with std::malloc rather than operator new, so count at the malloc level.
+extern "C" {
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t count, size_t size);
+  void* __libc_realloc(void* p, size_t size);
+
+  void* malloc(size_t size) {
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+  }
+
+  void* calloc(size_t count, size_t size) {
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+  }
+
+  void* realloc(void* p, size_t size) {
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, size);
+  }
+}
+
+#else
+
+void* operator new(std::size_t size) {
+  s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if(!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+
+#endif // __GLIBC__
@@ -0,0 +1,32 @@
+/**********************************************************************
+
+File     : AllocationCounter.h
+Project  : Bach Simulation
+Purpose  : Header file for counting heap allocations in the benchmarks.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           AllocationCounter.cpp interposes malloc (glibc) or the global operator
+           new (elsewhere), so it must only be linked into benchmark executables.
+           Counting malloc also catches Eigen's own aligned allocations.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_ALLOCATION_COUNTER_H__
+#define __BACH_ALLOCATION_COUNTER_H__
+
+namespace Bach {
+  namespace AllocationCounter {
+
+    //*****************************
+    //* Bach::AllocationCounter *
+    //*****************************
+
+    long GetCount();
+    void Reset();
+  };
+};
+
+#endif // __BACH_ALLOCATION_COUNTER_H__
@@ -0,0 +1,86 @@
+/**********************************************************************
+
+File     : BenchmarkMain.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the main function of the benchmark executable.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Takes the same flags as Google Benchmark for the things it does:
+             --benchmark_filter=<regex>     only the benchmarks matching it
+             --benchmark_min_time=<seconds> the least time of each run
+             --benchmark_repetitions=<n>    runs of each, with aggregates
+             --benchmark_out=<file>         JSON results, for compare.py
+             --benchmark_list_tests         list the names and exit
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BenchmarkRegistry.h"
+#include "MathBenchmarks.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace Bach;
+
+namespace {
+  bool GetFlag(const char* argument, const char* name, std::string& value) {
+    size_t length = std::strlen(name);
+    if(std::strncmp(argument, name, length) != 0 || argument[length] != '=') {
+      return false;
+    }
+    value = argument+length+1;
+    return true;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  BenchmarkRegistry::Options options;
+  bool listTests = false;
+  for(int i=1; i<argc; i++) {
+    std::string value;
+    if(GetFlag(argv[i], "--benchmark_filter", value)) {
+      options.filter = value;
+    }
+    else if(GetFlag(argv[i], "--benchmark_min_time", value)) {
+      options.minSeconds = std::atof(value.c_str()); // Google Benchmark's "0.5s" reads as 0.5 too.
+    }
+    else if(GetFlag(argv[i], "--benchmark_repetitions", value)) {
+      options.repetitions = std::max(std::atoi(value.c_str()), 1);
+    }
+    else if(GetFlag(argv[i], "--benchmark_out", value)) {
+      options.outputPath = value;
+    }
+    else if(std::strcmp(argv[i], "--benchmark_list_tests") == 0 || std::strcmp(argv[i], "--benchmark_list_tests=true") == 0) {
+      listTests = true;
+    }
+    else if(GetFlag(argv[i], "--benchmark_out_format", value) && value == "json") {
+      // JSON is the only file format.
+    }
+    else {
+      std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  boost::shared_ptr<BenchmarkRegistry> registry = BenchmarkRegistry::CreateInstance();
+  MathBenchmarks::Register(registry);
+
+  try {
+    if(listTests) {
+      std::vector<std::string> names = registry->GetNames(options.filter);
+      for(size_t i=0; i<names.size(); i++) {
+        std::printf("%s\n", names[i].c_str());
+      }
+      return 0;
+    }
+    return (registry->Run(options, argv[0]) ? 0 : 1);
+  }
+  catch(std::exception&) {
+    std::fprintf(stderr, "The benchmarks stopped on an error\n");
+    return 1;
+  }
+}
@@ -0,0 +1,399 @@
+/**********************************************************************
+
+File     : BenchmarkRegistry.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the registry and runner of the benchmark suite.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BenchmarkRegistry.h"
+#include "JsonStreamWriter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+using namespace Bach;
+using namespace boost;
+
+namespace {
+  // As Google Benchmark, iterations grow by up to ten times a run until one is long
+  // enough, aiming 40% past the minimum time so the last run rarely falls short.
+  const long MAX_ITERATIONS = 1000000000;
+  const double GROWTH_MARGIN = 1.4;
+  const double MAX_GROWTH = 10.0;
+
+  std::string GetDateTime() {
+    std::time_t now = std::time(NULL);
+    char buffer[64];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+    return buffer;
+  }
+
+  double GetMean(const std::vector<double>& values) {
+    double sum = 0.0;
+    for(size_t i=0; i<values.size(); i++) {
+      sum += values[i];
+    }
+    return sum/values.size();
+  }
+
+  double GetMedian(const std::vector<double>& unsorted) {
+    std::vector<double> values(unsorted);
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size()/2;
+    return (values.size() % 2 == 1 ? values[middle] : 0.5*(values[middle-1]+values[middle]));
+  }
+
+  double GetStandardDeviation(const std::vector<double>& values) {
+    if(values.size() < 2) {
+      return 0.0;
+    }
+    double mean = GetMean(values);
+    double sum = 0.0;
+    for(size_t i=0; i<values.size(); i++) {
+      sum += (values[i]-mean)*(values[i]-mean);
+    }
+    return sqrt(sum/(values.size()-1));
+  }
+
+  // A time in nanoseconds scaled to the unit that keeps it readable.
+  std::string FormatTime(double nanoseconds) {
+    char buffer[32];
+    if(nanoseconds >= 1.0e9) {
+      std::snprintf(buffer, sizeof(buffer), "%10.3f s ", nanoseconds*1.0e-9);
+    }
+    else if(nanoseconds >= 1.0e6) {
+      std::snprintf(buffer, sizeof(buffer), "%10.3f ms", nanoseconds*1.0e-6);
+    }
+    else if(nanoseconds >= 1.0e3) {
+      std::snprintf(buffer, sizeof(buffer), "%10.3f us", nanoseconds*1.0e-3);
+    }
+    else {
+      std::snprintf(buffer, sizeof(buffer), "%10.1f ns", nanoseconds);
+    }
+    return buffer;
+  }
+
+  std::string FormatCount(double value) {
+    const char* suffixes[] = { "", "k", "M", "G", "T" };
+    int suffix = 0;
+    while(fabs(value) >= 1000.0 && suffix < 4) {
+      value /= 1000.0;
+      suffix++;
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.4g%s", value, suffixes[suffix]);
+    return buffer;
+  }
+}
+
+  //******************
+  //* BenchmarkState *
+  //******************
+
+BenchmarkState::BenchmarkState(long iterations, const std::vector<long>& arguments) :
+  m_iterations(iterations),
+  m_remaining(iterations),
+  m_arguments(arguments),
+  m_timing(false),
+  m_cpuStart(0),
+  m_realSeconds(0.0),
+  m_cpuSeconds(0.0),
+  m_itemsProcessed(0.0)
+{
+}
+
+void BenchmarkState::StartTiming() {
+  if(!m_timing) {
+    m_timing = true;
+    m_cpuStart = std::clock();
+    m_realStart = std::chrono::steady_clock::now();
+  }
+}
+
+void BenchmarkState::StopTiming() {
+  if(m_timing) {
+    std::chrono::steady_clock::time_point realEnd = std::chrono::steady_clock::now();
+    std::clock_t cpuEnd = std::clock();
+    m_timing = false;
+    m_realSeconds += std::chrono::duration<double>(realEnd-m_realStart).count();
+    m_cpuSeconds += (double) (cpuEnd-m_cpuStart)/CLOCKS_PER_SEC;
+  }
+}
+
+  //*********************
+  //* BenchmarkRegistry *
+  //*********************
+
+BenchmarkRegistry::Benchmark* BenchmarkRegistry::Benchmark::Range(long first, long last, long multiplier) {
+  if(first <= 0 || multiplier < 2) {
+    BACH_LOG_ERROR(L"BenchmarkRegistry::Benchmark::Range: The range must be positive and grow");
+    throw std::exception();
+  }
+  for(long argument=first; argument<last; argument*=multiplier) {
+    Arg(argument);
+  }
+  return Arg(last);
+}
+
+shared_ptr<BenchmarkRegistry> BenchmarkRegistry::CreateInstance() {
+  shared_ptr<BenchmarkRegistry> instance(new BenchmarkRegistry());
+  return instance;
+}
+
+BenchmarkRegistry::BenchmarkRegistry() {
+}
+
+BenchmarkRegistry::Benchmark* BenchmarkRegistry::Register(const std::string& family, const std::string& name, const Function& function) {
+  shared_ptr<Benchmark> benchmark(new Benchmark(family, name, function));
+  m_benchmarks.push_back(benchmark);
+  return benchmark.get();
+}
+
+std::string BenchmarkRegistry::GetFullName(const Benchmark& benchmark, const std::vector<long>& arguments) {
+  std::ostringstream name;
+  name << benchmark.GetFamily() << "/" << benchmark.GetName();
+  for(size_t i=0; i<arguments.size(); i++) {
+    name << "/" << arguments[i];
+  }
+  if(benchmark.GetIterations() > 0) {
+    name << "/iterations:" << benchmark.GetIterations();
+  }
+  return name.str();
+}
+
+std::vector<std::string> BenchmarkRegistry::GetNames(const std::string& filter) {
+  std::regex pattern(filter.empty() ? "." : filter);
+  std::vector<std::string> names;
+  for(size_t i=0; i<m_benchmarks.size(); i++) {
+    std::vector< std::vector<long> > argumentSets = m_benchmarks[i]->GetArguments();
+    if(argumentSets.empty()) {
+      argumentSets.push_back(std::vector<long>());
+    }
+    for(size_t j=0; j<argumentSets.size(); j++) {
+      std::string name = GetFullName(*m_benchmarks[i], argumentSets[j]);
+      if(std::regex_search(name, pattern)) {
+        names.push_back(name);
+      }
+    }
+  }
+  return names;
+}
+
+bool BenchmarkRegistry::Run(const Options& options, const std::string& executable) {
+  std::regex pattern(options.filter.empty() ? "." : options.filter);
+  bool succeeded = true;
+  std::vector<RunResult> results;
+
+  std::printf("%-56s %13s %13s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+  std::printf("%s\n", std::string(97, '-').c_str());
+  for(size_t i=0; i<m_benchmarks.size(); i++) {
+    const Benchmark& benchmark = *m_benchmarks[i];
+    std::vector< std::vector<long> > argumentSets = benchmark.GetArguments();
+    if(argumentSets.empty()) {
+      argumentSets.push_back(std::vector<long>());
+    }
+
+    for(size_t j=0; j<argumentSets.size(); j++) {
+      std::string name = GetFullName(benchmark, argumentSets[j]);
+      if(!std::regex_search(name, pattern)) {
+        continue;
+      }
+
+      // Later repetitions start from the iterations the first one settled on.
+      long iterations = benchmark.GetIterations();
+      std::vector<RunResult> repetitions;
+      for(int k=0; k<options.repetitions; k++) {
+        RunResult result = RunInstance(benchmark, argumentSets[j], iterations, options.minSeconds);
+        result.name = name;
+        result.familyIndex = (int) i;
+        result.instanceIndex = (int) j;
+        result.repetitionIndex = k;
+        LogResult(result);
+        repetitions.push_back(result);
+        if(!result.error.empty()) {
+          succeeded = false;
+          break;
+        }
+      }
+      results.insert(results.end(), repetitions.begin(), repetitions.end());
+      if(options.repetitions > 1 && (int) repetitions.size() == options.repetitions) {
+        AddAggregates(repetitions, results);
+      }
+    }
+  }
+
+  if(!options.outputPath.empty()) {
+    succeeded = WriteJson(results, options, executable) && succeeded;
+  }
+  return succeeded;
+}
+
+BenchmarkRegistry::RunResult BenchmarkRegistry::RunInstance(const Benchmark& benchmark, const std::vector<long>& arguments, long& iterations, double minSeconds) {
+  bool fixed = (benchmark.GetIterations() > 0);
+  if(iterations <= 0) {
+    iterations = 1;
+  }
+
+  for(;;) {
+    BenchmarkState state(iterations, arguments);
+    benchmark.GetFunction()(state);
+
+    double seconds = state.GetRealSeconds();
+    if(fixed || !state.GetError().empty() || seconds >= minSeconds || iterations >= MAX_ITERATIONS) {
+      RunResult result;
+      result.iterations = iterations;
+      result.realNanoseconds = 1.0e9*seconds/iterations;
+      result.cpuNanoseconds = 1.0e9*state.GetCpuSeconds()/iterations;
+      result.itemsPerSecond = (state.GetItemsProcessed() > 0.0 && seconds > 0.0 ? state.GetItemsProcessed()/seconds : 0.0);
+      result.counters = state.GetCounters();
+      result.error = state.GetError();
+      return result;
+    }
+
+    double growth = (seconds > 0.0 ? GROWTH_MARGIN*minSeconds/seconds : MAX_GROWTH);
+    growth = std::min(growth, MAX_GROWTH);
+    iterations = std::min(std::max((long) ceil(iterations*growth), iterations+1), MAX_ITERATIONS);
+  }
+}
+
+void BenchmarkRegistry::AddAggregates(const std::vector<RunResult>& repetitions, std::vector<RunResult>& results) {
+  const char* names[] = { "mean", "median", "stddev" };
+  double (*aggregates[])(const std::vector<double>&) = { GetMean, GetMedian, GetStandardDeviation };
+
+  std::vector<double> realTimes;
+  std::vector<double> cpuTimes;
+  std::vector<double> itemRates;
+  for(size_t i=0; i<repetitions.size(); i++) {
+    realTimes.push_back(repetitions[i].realNanoseconds);
+    cpuTimes.push_back(repetitions[i].cpuNanoseconds);
+    itemRates.push_back(repetitions[i].itemsPerSecond);
+  }
+
+  for(int i=0; i<3; i++) {
+    RunResult result = repetitions[0];
+    result.aggregateName = names[i];
+    result.repetitionIndex = 0;
+    result.iterations = (long) repetitions.size();
+    result.realNanoseconds = aggregates[i](realTimes);
+    result.cpuNanoseconds = aggregates[i](cpuTimes);
+    result.itemsPerSecond = aggregates[i](itemRates);
+
+    std::map<std::string, double>::iterator counter;
+    for(counter=result.counters.begin(); counter!=result.counters.end(); ++counter) {
+      std::vector<double> values;
+      for(size_t j=0; j<repetitions.size(); j++) {
+        std::map<std::string, double>::const_iterator value = repetitions[j].counters.find(counter->first);
+        values.push_back(value != repetitions[j].counters.end() ? value->second : 0.0);
+      }
+      counter->second = aggregates[i](values);
+    }
+    LogResult(result);
+    results.push_back(result);
+  }
+}
+
+void BenchmarkRegistry::LogResult(const RunResult& result) {
+  std::string name = result.name+(result.aggregateName.empty() ? "" : "_"+result.aggregateName);
+  if(!result.error.empty()) {
+    std::printf("%-56s ERROR: %s\n", name.c_str(), result.error.c_str());
+    return;
+  }
+
+  std::ostringstream extra;
+  if(result.itemsPerSecond > 0.0) {
+    extra << " items_per_second=" << FormatCount(result.itemsPerSecond) << "/s";
+  }
+  std::map<std::string, double>::const_iterator counter;
+  for(counter=result.counters.begin(); counter!=result.counters.end(); ++counter) {
+    extra << " " << counter->first << "=" << FormatCount(counter->second);
+  }
+  std::printf("%-56s %s %s %12ld%s\n", name.c_str(), FormatTime(result.realNanoseconds).c_str(),
+              FormatTime(result.cpuNanoseconds).c_str(), result.iterations, extra.str().c_str());
+  std::fflush(stdout);
+}
+
+bool BenchmarkRegistry::WriteJson(const std::vector<RunResult>& results, const Options& options, const std::string& executable) {
+  std::string text = JsonStreamWriter::WriteToString([&](JsonStreamWriter& writer) {
+    writer.WriteRaw("{\n  \"context\": {\n    \"date\": ");
+    writer.WriteString(GetDateTime());
+    writer.WriteRaw(",\n    \"executable\": ");
+    writer.WriteString(executable);
+    writer.WriteRaw(",\n    \"num_cpus\": ");
+    writer.WriteInteger((long) std::thread::hardware_concurrency());
+    writer.WriteRaw(",\n    \"library_build_type\": ");
+#ifdef NDEBUG
+    writer.WriteString("release");
+#else
+    writer.WriteString("debug");
+#endif
+    writer.WriteRaw("\n  },\n  \"benchmarks\": [");
+
+    for(size_t i=0; i<results.size(); i++) {
+      const RunResult& result = results[i];
+      bool aggregate = !result.aggregateName.empty();
+      writer.WriteRaw(i == 0 ? "\n    {\n      \"name\": " : ",\n    {\n      \"name\": ");
+      writer.WriteString(aggregate ? result.name+"_"+result.aggregateName : result.name);
+      writer.WriteRaw(",\n      \"family_index\": ");
+      writer.WriteInteger(result.familyIndex);
+      writer.WriteRaw(",\n      \"per_family_instance_index\": ");
+      writer.WriteInteger(result.instanceIndex);
+      writer.WriteRaw(",\n      \"run_name\": ");
+      writer.WriteString(result.name);
+      writer.WriteRaw(",\n      \"run_type\": ");
+      writer.WriteString(aggregate ? "aggregate" : "iteration");
+      writer.WriteRaw(",\n      \"repetitions\": ");
+      writer.WriteInteger(options.repetitions);
+      if(aggregate) {
+        writer.WriteRaw(",\n      \"aggregate_name\": ");
+        writer.WriteString(result.aggregateName);
+      }
+      else {
+        writer.WriteRaw(",\n      \"repetition_index\": ");
+        writer.WriteInteger(result.repetitionIndex);
+      }
+      writer.WriteRaw(",\n      \"threads\": 1");
+      if(!result.error.empty()) {
+        writer.WriteRaw(",\n      \"error_occurred\": true,\n      \"error_message\": ");
+        writer.WriteString(result.error);
+      }
+      writer.WriteRaw(",\n      \"iterations\": ");
+      writer.WriteInteger(result.iterations);
+      writer.WriteRaw(",\n      \"real_time\": ");
+      writer.WriteDouble(result.realNanoseconds);
+      writer.WriteRaw(",\n      \"cpu_time\": ");
+      writer.WriteDouble(result.cpuNanoseconds);
+      writer.WriteRaw(",\n      \"time_unit\": \"ns\"");
+      if(result.itemsPerSecond > 0.0) {
+        writer.WriteRaw(",\n      \"items_per_second\": ");
+        writer.WriteDouble(result.itemsPerSecond);
+      }
+      std::map<std::string, double>::const_iterator counter;
+      for(counter=result.counters.begin(); counter!=result.counters.end(); ++counter) {
+        writer.WriteRaw(",\n      ");
+        writer.WriteString(counter->first);
+        writer.WriteRaw(": ");
+        writer.WriteDouble(counter->second);
+      }
+      writer.WriteRaw("\n    }");
+    }
+    writer.WriteRaw("\n  ]\n}\n");
+  });
+
+  std::ofstream file(options.outputPath.c_str(), std::ios::binary);
+  file.write(text.data(), text.size());
+  if(!file) {
+    Log(L"ERROR: BenchmarkRegistry::WriteJson: Couldn't write %s", WideStringFromUTF8(options.outputPath).c_str());
+    return false;
+  }
+  return true;
+}
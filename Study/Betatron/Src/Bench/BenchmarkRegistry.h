@@ -0,0 +1,180 @@
+/**********************************************************************
+
+File     : BenchmarkRegistry.h
+Project  : Bach Simulation
+Purpose  : Header file for the registry and runner of the benchmark suite.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Benchmarks are registered by family and name with the arguments
+           to run them at, in the manner of Google Benchmark, and each one
+           is a function that loops while its BenchmarkState says to keep
+           running. The runner grows the number of iterations until a run
+           takes the minimum time, then reports the time per iteration.
+
+           Results are printed as a table and, when asked, written to a file as
+           JSON in Google Benchmark's format, so its compare.py can be used
+           to find regressions between versions.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_BENCHMARK_REGISTRY_H__
+#define __BACH_BENCHMARK_REGISTRY_H__
+
+#include "BachDefs.h"
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <string>
+
+namespace Bach {
+
+  //******************
+  //* BenchmarkState *
+  //******************
+
+  class BenchmarkState {
+  public:
+    BenchmarkState(long iterations, const std::vector<long>& arguments);
+
+    // True for each iteration to run. Timing starts with the first call and stops with the
+    // last, so setup before the loop isn't timed.
+    bool KeepRunning() {
+      if(m_remaining > 0) {
+        if(m_remaining == m_iterations) {
+          StartTiming();
+        }
+        m_remaining--;
+        return true;
+      }
+      StopTiming();
+      return false;
+    }
+
+    // Leave work inside the loop out of the time.
+    void PauseTiming()  { StopTiming(); }
+    void ResumeTiming() { StartTiming(); }
+
+    long GetIterations() const          { return m_iterations; }
+    long GetArgument(int index = 0) const { return m_arguments[index]; }
+
+    // Items processed by all the iterations, reported as items per second.
+    void SetItemsProcessed(double items) { m_itemsProcessed = items; }
+
+    // A named value reported with the result, such as the steps a solver took.
+    void SetCounter(const std::string& name, double value) { m_counters[name] = value; }
+
+    // Report an error instead of a time, for a benchmark that can't run.
+    void SkipWithError(const std::string& message) { m_error = message; m_remaining = 0; }
+
+    double GetRealSeconds() const { return m_realSeconds; }
+    double GetCpuSeconds() const  { return m_cpuSeconds; }
+    double GetItemsProcessed() const { return m_itemsProcessed; }
+    const std::map<std::string, double>& GetCounters() const { return m_counters; }
+    const std::string& GetError() const { return m_error; }
+
+  protected:
+    void StartTiming();
+    void StopTiming();
+
+    long m_iterations;
+    long m_remaining;
+    std::vector<long> m_arguments;
+
+    bool m_timing;
+    std::chrono::steady_clock::time_point m_realStart;
+    std::clock_t m_cpuStart;
+    double m_realSeconds;
+    double m_cpuSeconds;
+
+    double m_itemsProcessed;
+    std::map<std::string, double> m_counters;
+    std::string m_error;
+  };
+
+  //*********************
+  //* BenchmarkRegistry *
+  //*********************
+
+  class BenchmarkRegistry {
+  public:
+    typedef std::function<void(BenchmarkState&)> Function;
+
+    class Benchmark {
+    public:
+      Benchmark(const std::string& family, const std::string& name, const Function& function) :
+        m_family(family), m_name(name), m_function(function), m_iterations(0) {}
+
+      // Run once for each argument, or each set of them.
+      Benchmark* Arg(long argument)                       { m_arguments.push_back(std::vector<long>(1, argument)); return this; }
+      Benchmark* Args(const std::vector<long>& arguments) { m_arguments.push_back(arguments); return this; }
+
+      // Each power of multiplier from first to last, with last included.
+      Benchmark* Range(long first, long last, long multiplier);
+
+      // A fixed number of iterations, for runs long enough to time once.
+      Benchmark* Iterations(long iterations) { m_iterations = iterations; return this; }
+
+      const std::string& GetFamily() const { return m_family; }
+      const std::string& GetName() const { return m_name; }
+      const Function& GetFunction() const { return m_function; }
+      long GetIterations() const { return m_iterations; }
+      const std::vector< std::vector<long> >& GetArguments() const { return m_arguments; }
+
+    protected:
+      std::string m_family;
+      std::string m_name;
+      Function m_function;
+      long m_iterations;
+      std::vector< std::vector<long> > m_arguments;
+    };
+
+    struct Options {
+      Options() : minSeconds(0.5), repetitions(1) {}
+      std::string filter;     // An ECMAScript regular expression the full name must contain.
+      double minSeconds;      // The least time a timed run takes.
+      int repetitions;        // Runs of each benchmark, summarized by mean, median and stddev.
+      std::string outputPath; // Where to write the JSON results, if anywhere.
+    };
+
+    static boost::shared_ptr<BenchmarkRegistry> CreateInstance();
+
+    Benchmark* Register(const std::string& family, const std::string& name, const Function& function);
+
+    // The full names, family/name/arguments, of the benchmarks the filter selects.
+    std::vector<std::string> GetNames(const std::string& filter);
+
+    // Run the benchmarks the filter selects. Returns false if any of them failed.
+    bool Run(const Options& options, const std::string& executable);
+
+  protected:
+    BenchmarkRegistry();
+
+    struct RunResult {
+      std::string name;
+      int familyIndex;
+      int instanceIndex;
+      int repetitionIndex;
+      std::string aggregateName; // Empty for an iteration run.
+      long iterations;
+      double realNanoseconds;
+      double cpuNanoseconds;
+      double itemsPerSecond;
+      std::map<std::string, double> counters;
+      std::string error;
+    };
+
+    static std::string GetFullName(const Benchmark& benchmark, const std::vector<long>& arguments);
+    RunResult RunInstance(const Benchmark& benchmark, const std::vector<long>& arguments, long& iterations, double minSeconds);
+    void AddAggregates(const std::vector<RunResult>& repetitions, std::vector<RunResult>& results);
+    void LogResult(const RunResult& result);
+    bool WriteJson(const std::vector<RunResult>& results, const Options& options, const std::string& executable);
+
+    std::vector< boost::shared_ptr<Benchmark> > m_benchmarks;
+  };
+};
+
+#endif // __BACH_BENCHMARK_REGISTRY_H__
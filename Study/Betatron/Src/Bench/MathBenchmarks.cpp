@@ -0,0 +1,1039 @@
+/**********************************************************************
+
+File     : MathBenchmarks.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the micro and macro benchmarks of the Math library.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "MathBenchmarks.h"
+#include "PolynomialInterp.h"
+#include "BarycentricInterp.h"
+#include "SplineInterp.h"
+#include "RationalInterp.h"
+#include "HermiteInterp.h"
+#include "InterpolationIndex.h"
+#include "SequentialAccessHunt.h"
+#include "EytzingerSearch.h"
+#include "RiddersExtrapolation.h"
+#include "Jacobian.h"
+#include "WorkStealingPool.h"
+#include "NDimAccuracySpec.h"
+#include "NDimNewtonRaphson.h"
+#include "RootSolverEquations.h"
+#include "BaderDeuflhardOde.h"
+#include "BaderDeuflhardOdeN.h"
+#include "LinearSolveWorkspace.h"
+#include "OdeAccuracySpec.h"
+#include "OdeData.h"
+#include "OdeDataCollector.h"
+#include "OdeEquations.h"
+#include "OdeSolverTelemetry.h"
+#include "SampledData.h"
+#include "SampledDerivedData.h"
+#include "BetatronEquationSolver.h"
+#include "BetatronBatchSolver.h"
+#include "BetatronEquations.h"
+#include "BetatronDerivatives.h"
+#include "OdeNumericalDerivatives.h"
+#include "OdeAutoDiffDerivatives.h"
+#include "MoleculeFactory.h"
+#include "MoleculeEquilibriumSolver.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <thread>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const double RADIUS = 0.1;
+  const double SPEED = 0.5;             // Fraction of the speed of light.
+  const int INITIAL_DATA_SIZE = 2000;   // Same starting size and growth as OdeDataCollector.
+  const double GROWTH_FACTOR = 1.30;
+  const int NUM_DEPENDENT = 6;
+  const int NUM_QUERIES = 4096;         // Power of two, so query indices wrap with a mask.
+  const int NUM_RESAMPLED = 1000000;    // Points on the grid a trajectory is resampled onto.
+  const int NUM_TRAJECTORIES = 64;      // In a batch, about the size of a server sweep.
+
+  // The sum of the results keeps the optimizer from discarding the timed loops.
+  volatile double s_sink = 0.0;
+
+  // Abscissas in [0, 1) with a fixed pseudo-random order, the same every run.
+  std::vector<double> GetRandomTargets(int count, double scale) {
+    std::vector<double> targets(count);
+    unsigned int state = 2463534242u;
+    for(int i=0; i<count; i++) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      targets[i] = scale*(state/4294967296.0);
+    }
+    return targets;
+  }
+
+  // Evenly spaced from 0 to size-1, or unevenly over about the same range.
+  VectorXd GetTable(int size, bool uneven = false) {
+    VectorXd table(size);
+    for(int i=0; i<size; i++) {
+      table(i) = (uneven ? i+0.4*sin((double) i) : i);
+    }
+    return table;
+  }
+
+  // Bisection of the whole table on every call, the baseline for SequentialAccessHunt,
+  // which hunts out from the last index found.
+  class BisectionSearch {
+  public:
+    int Find(double x, const VectorXd& y) {
+      int low = -1;
+      int high = (int) y.rows();
+      while(high-low > 1) {
+        int middle = (high+low) >> 1;
+        if(x >= y(middle)) {
+          low = middle;
+        }
+        else {
+          high = middle;
+        }
+      }
+      return low;
+    }
+  };
+
+  template<class Search>
+  void RunTableSearch(BenchmarkState& state, bool sequential, bool uneven = false) {
+    int size = (int) state.GetArgument();
+    VectorXd table = GetTable(size, uneven);
+
+    // Sequential targets step through the table the way an ODE run's samples are read back.
+    std::vector<double> targets = GetRandomTargets(NUM_QUERIES, size-1);
+    if(sequential) {
+      for(int i=0; i<NUM_QUERIES; i++) {
+        targets[i] = (i+0.5)*(size-1)/NUM_QUERIES;
+      }
+    }
+
+    // The first call is outside the timing, since EytzingerSearch builds its layout then.
+    Search search;
+    long sum = search.Find(targets[0], table);
+    int query = 0;
+    while(state.KeepRunning()) {
+      sum += search.Find(targets[query], table);
+      query = (query+1) & (NUM_QUERIES-1);
+    }
+    s_sink = sum;
+    state.SetItemsProcessed(state.GetIterations());
+  }
+
+  template<class Interp>
+  void RunInterpolator(BenchmarkState& state) {
+    int numPoints = (int) state.GetArgument();
+    VectorXd x(numPoints);
+    VectorXd y(numPoints);
+    for(int i=0; i<numPoints; i++) {
+      x(i) = 0.1*i;
+      y(i) = sin(x(i))+0.5;
+    }
+
+    Interp interpolator(numPoints);
+    std::vector<double> targets = GetRandomTargets(NUM_QUERIES, x(numPoints-1));
+    double sum = 0.0;
+    int query = 0;
+    while(state.KeepRunning()) {
+      sum += interpolator.Interpolate(targets[query], x, y);
+      query = (query+1) & (NUM_QUERIES-1);
+    }
+    s_sink = sum;
+  }
+
+  // Three points and a column of values per argument, the shape SampledData interpolates.
+  // PolynomialInterp runs a Neville tableau per column, BarycentricInterp shares its weights.
+  void GetColumns(int numColumns, VectorXd& x, MatrixXd& y) {
+    x.resize(3);
+    y.resize(numColumns, 3);
+    for(int i=0; i<3; i++) {
+      x(i) = 0.1*i;
+      for(int j=0; j<numColumns; j++) {
+        y(j, i) = sin(x(i)+j)+0.5;
+      }
+    }
+  }
+
+  void RunPolynomialColumns(BenchmarkState& state) {
+    int numColumns = (int) state.GetArgument();
+    VectorXd x;
+    MatrixXd y;
+    GetColumns(numColumns, x, y);
+    std::vector<VectorXd> columns(numColumns);
+    for(int j=0; j<numColumns; j++) {
+      columns[j] = y.row(j).transpose();
+    }
+
+    PolynomialInterp interpolator(3);
+    VectorXd result(numColumns);
+    std::vector<double> targets = GetRandomTargets(NUM_QUERIES, x(2));
+    double sum = 0.0;
+    int query = 0;
+    while(state.KeepRunning()) {
+      for(int j=0; j<numColumns; j++) {
+        result(j) = interpolator.Interpolate(targets[query], x, columns[j]);
+      }
+      sum += result(0);
+      query = (query+1) & (NUM_QUERIES-1);
+    }
+    s_sink = sum;
+  }
+
+  void RunBarycentricColumns(BenchmarkState& state) {
+    int numColumns = (int) state.GetArgument();
+    VectorXd x;
+    MatrixXd y;
+    GetColumns(numColumns, x, y);
+
+    BarycentricInterp interpolator(3);
+    interpolator.SetAbscissae(x);
+    VectorXd result(numColumns);
+    std::vector<double> targets = GetRandomTargets(NUM_QUERIES, x(2));
+    double sum = 0.0;
+    int query = 0;
+    while(state.KeepRunning()) {
+      interpolator.Interpolate(targets[query], y, result);
+      sum += result(0);
+      query = (query+1) & (NUM_QUERIES-1);
+    }
+    s_sink = sum;
+  }
+
+  void RunHermiteScalar(BenchmarkState& state) {
+    std::vector<double> targets = GetRandomTargets(NUM_QUERIES, 1.0);
+    double sum = 0.0;
+    int query = 0;
+    while(state.KeepRunning()) {
+      sum += HermiteInterp::Interpolate(targets[query], 0.0, 1.0, 0.5, 1.5, 1.0, -1.0);
+      query = (query+1) & (NUM_QUERIES-1);
+    }
+    s_sink = sum;
+  }
+
+  void RunHermiteVector(BenchmarkState& state) {
+    int size = (int) state.GetArgument();
+    VectorXd y0 = VectorXd::LinSpaced(size, 0.0, 1.0);
+    VectorXd y1 = VectorXd::LinSpaced(size, 1.0, 3.0);
+    VectorXd dy0 = VectorXd::Constant(size, 1.0);
+    VectorXd dy1 = VectorXd::Constant(size, -1.0);
+    VectorXd y(size);
+
+    std::vector<double> targets = GetRandomTargets(NUM_QUERIES, 1.0);
+    double sum = 0.0;
+    int query = 0;
+    while(state.KeepRunning()) {
+      HermiteInterp::Interpolate(targets[query], 0.0, 1.0, y0, y1, dy0, dy1, y);
+      sum += y(0);
+      query = (query+1) & (NUM_QUERIES-1);
+    }
+    s_sink = sum;
+  }
+
+  // Smooth, coupled functions of every variable, so each Jacobian entry is nonzero.
+  void EvaluateCoupled(const VectorXd& y, VectorXd& f) {
+    int n = (int) y.rows();
+    double total = y.sum();
+    for(int i=0; i<n; i++) {
+      f(i) = sin(y(i))*exp(0.1*total)+y(i)*y((i+1) % n);
+    }
+  }
+
+  void RunRidders(BenchmarkState& state) {
+    int size = (int) state.GetArgument();
+    RiddersExtrapolation derivatives(size);
+    shared_ptr<NDimAccuracySpec> accuracySpec(new NDimAccuracySpec(size));
+    accuracySpec->SetTolerance(1.0e-8);
+
+    VectorXd phases = VectorXd::LinSpaced(size, 0.0, 1.0);
+    VectorXd values(size);
+    long evaluations = 0;
+    double sum = 0.0;
+    while(state.KeepRunning()) {
+      derivatives.Start(0.3, 0.5);
+      while(!derivatives.GetIsFinished(accuracySpec)) {
+        double x = derivatives.GetNewValue();
+        values = (x*VectorXd::Ones(size)+phases).array().sin()*exp(x);
+        derivatives.SetFunctionValues(values);
+        evaluations++;
+      }
+      sum += derivatives.GetDerivatives()(0);
+    }
+    s_sink = sum;
+    state.SetCounter("evaluations", (double) evaluations/state.GetIterations());
+  }
+
+  void RunJacobian(BenchmarkState& state, bool onPool) {
+    int size = (int) state.GetArgument();
+    shared_ptr<RiddersExtrapolation> derivatives(new RiddersExtrapolation(size));
+    shared_ptr<NDimAccuracySpec> accuracySpec(new NDimAccuracySpec(size));
+    accuracySpec->SetTolerance(1.0e-8);
+
+    Jacobian jacobian;
+    jacobian.SetDerivativeFinder(derivatives);
+    jacobian.SetAccuracySpec(accuracySpec);
+
+    VectorXd target = VectorXd::LinSpaced(size, 0.1, 0.9);
+    VectorXd step = VectorXd::Constant(size, 0.5);
+    VectorXd values(size);
+    long evaluations = 0;
+    double sum = 0.0;
+    if(onPool) {
+      // The columns at once on the process wide pool, each thread with its own function.
+      jacobian.SetPool(WorkStealingPool::GetSharedInstance());
+      Jacobian::Function function(EvaluateCoupled);
+      jacobian.Find(target, step, function, [function]() { return function; });
+      while(state.KeepRunning()) {
+        jacobian.Find(target, step, function, [function]() { return function; });
+        sum += jacobian.GetDerivatives()(0, 0);
+      }
+      s_sink = sum;
+      return;
+    }
+
+    while(state.KeepRunning()) {
+      jacobian.Start(target, step);
+      while(!jacobian.GetIsFinished()) {
+        EvaluateCoupled(jacobian.GetNewValue(), values);
+        jacobian.SetFunctionValues(values);
+        evaluations++;
+      }
+      sum += jacobian.GetDerivatives()(0, 0);
+    }
+    s_sink = sum;
+    state.SetCounter("evaluations", (double) evaluations/state.GetIterations());
+  }
+
+  //*************************
+  //* CoupledCubicEquations *
+  //*************************
+
+  // y(i)^3+y(i)+0.1*(sum of y)-1 = 0, with its analytic Jacobian.
+  class CoupledCubicEquations : public RootSolverEquations {
+  public:
+    CoupledCubicEquations(int size) : m_evaluations(0) { SetStateLength(size); }
+
+    VectorXd GetEquationValues(const VectorXd& y) {
+      m_evaluations++;
+      return y.array().cube()+y.array()+0.1*y.sum()-1.0;
+    }
+
+    MatrixXd GetJacobian(const VectorXd& y) {
+      MatrixXd jacobian = MatrixXd::Constant(y.rows(), y.rows(), 0.1);
+      jacobian.diagonal().array() += 3.0*y.array().square()+1.0;
+      return jacobian;
+    }
+
+    long GetEvaluations() const { return m_evaluations; }
+
+  private:
+    long m_evaluations;
+  };
+
+  void RunNewtonRaphson(BenchmarkState& state) {
+    int size = (int) state.GetArgument();
+    shared_ptr<CoupledCubicEquations> equations(new CoupledCubicEquations(size));
+    shared_ptr<NDimAccuracySpec> rootValueSpec(new NDimAccuracySpec(size));
+    rootValueSpec->SetTolerance(1.0e-6); // As MoleculeEquilibriumSolver.
+    shared_ptr<NDimAccuracySpec> derivativesSpec(new NDimAccuracySpec(size));
+    derivativesSpec->SetTolerance(1.0e-6);
+
+    NDimNewtonRaphson solver;
+    solver.SetRootValueAccuracySpec(rootValueSpec);
+    solver.SetDerivativesAccuracySpec(derivativesSpec);
+
+    VectorXd initialY = VectorXd::LinSpaced(size, 2.0, 3.0);
+    double sum = 0.0;
+    while(state.KeepRunning()) {
+      solver.Solve(equations, initialY);
+      sum += solver.GetRoots()(0);
+    }
+    s_sink = sum;
+    state.SetCounter("evaluations", (double) equations->GetEvaluations()/state.GetIterations());
+  }
+
+  void RunWaterEquilibrium(BenchmarkState& state, bool onPool) {
+    double sum = 0.0;
+    while(state.KeepRunning()) {
+      state.PauseTiming();
+      shared_ptr<Molecule> water = MoleculeFactory::CreateInstance(MoleculeFactory::Water, 1);
+      shared_ptr<MoleculeEquilibriumSolver> solver = MoleculeEquilibriumSolver::CreateInstance(water);
+      if(onPool) {
+        // The copies of the molecule are made during the timed solve.
+        solver->SetPool(WorkStealingPool::GetSharedInstance());
+      }
+      state.ResumeTiming();
+      sum += solver->PositionAndSolve()(0);
+    }
+    s_sink = sum;
+  }
+
+  void RunBetatron(BenchmarkState& state, BetatronEquationSolver::JacobianMethod jacobianMethod) {
+    shared_ptr<OdeSolverTelemetry> telemetry;
+    shared_ptr<BetatronEquationSolver> solver;
+    while(state.KeepRunning()) {
+      state.PauseTiming();
+      solver = BetatronEquationSolver::CreateInstance();
+      solver->SetNumRotations(1.0);
+      solver->SetInitialConditionsFromRadiusAndSpeed(RADIUS, SPEED*Bach::SPEED_OF_LIGHT);
+      solver->SetJacobianMethod(jacobianMethod);
+      solver->Initialize();
+      state.ResumeTiming();
+
+      solver->Run();
+      telemetry = solver->GetTelemetry();
+    }
+
+    // Every solve is the same, so the last one's counts stand for all of them.
+    state.SetCounter("evaluations", telemetry->GetNumberOfEvaluations());
+    state.SetCounter("jacobians", telemetry->GetNumberOfJacobians());
+    state.SetCounter("accepted", telemetry->GetNumberAccepted());
+    state.SetCounter("rejected", telemetry->GetNumberRejected());
+
+    // Every call to Evaluate, the numerical Jacobian's included, so the saving of a cheaper
+    // Jacobian shows, and how often the steps reuse a factorization.
+    state.SetCounter("evaluationsPerStep", (double) solver->GetIterationCount()/telemetry->GetNumberAccepted());
+    state.SetCounter("factorizationsPerStep", dynamic_pointer_cast<BaderDeuflhardOde>(solver->GetOdeSolver())->GetFactorizationsPerStep());
+    state.SetItemsProcessed((double) telemetry->GetNumberAccepted()*state.GetIterations());
+  }
+
+  // Ten rotations of the betatron on one solver at a tolerance of 10^-argument, with the
+  // error of the final position relative to the radius. The fastest solver for an accuracy
+  // is the quickest of these whose error is within it.
+  void RunSolverSelection(BenchmarkState& state, BetatronEquationSolver::OdeMethod odeMethod) {
+    double tolerance = pow(10.0, (double) -state.GetArgument());
+    shared_ptr<BetatronEquationSolver> solver;
+    while(state.KeepRunning()) {
+      state.PauseTiming();
+      solver = BetatronEquationSolver::CreateInstance();
+      solver->SetNumRotations(10.0);
+      solver->SetInitialConditionsFromRadiusAndSpeed(RADIUS, SPEED*Bach::SPEED_OF_LIGHT);
+      solver->SetOdeMethod(odeMethod);
+      solver->SetTolerance(tolerance);
+      solver->Initialize();
+      state.ResumeTiming();
+
+      try {
+        solver->Run();
+      }
+      catch(std::exception& e) {
+        // As at a tolerance too tight for the solver.
+        state.SkipWithError(e.what());
+        return;
+      }
+    }
+
+    // The orbit is a circle at the starting speed, counter clockwise from the positive x axis.
+    shared_ptr<SampledDerivedData> stateData = solver->GetOdeData()->GetCollector()->GetStateData();
+    double time;
+    VectorXd y(6), dy(6);
+    stateData->Retrieve(stateData->GetNumberOfSamples()-1, time, y, dy);
+    double angle = SPEED*Bach::SPEED_OF_LIGHT*time/RADIUS;
+    double error = Vector3d(y(0)-RADIUS*cos(angle), y(1)-RADIUS*sin(angle), y(2)).norm()/RADIUS;
+
+    int steps = solver->GetOdeSolver()->GetNumberGood()+solver->GetOdeSolver()->GetNumberRetried();
+    state.SetCounter("tolerance", tolerance);
+    state.SetCounter("steps", steps);
+    state.SetCounter("evaluations", solver->GetIterationCount());
+    state.SetCounter("error", error);
+    state.SetItemsProcessed((double) steps*state.GetIterations());
+  }
+
+  // The argument's rotations of the betatron in a constant field, sampled every ten degrees,
+  // with the worst drift of the radius and the speed from their starting values.
+  void RunDrift(BenchmarkState& state, BetatronEquationSolver::OdeMethod odeMethod) {
+    shared_ptr<BetatronEquationSolver> solver;
+    while(state.KeepRunning()) {
+      state.PauseTiming();
+      solver = BetatronEquationSolver::CreateInstance();
+      solver->SetNumRotations((double) state.GetArgument());
+      solver->SetInitialConditionsFromRadiusAndSpeed(RADIUS, SPEED*Bach::SPEED_OF_LIGHT);
+      solver->SetSampleDegrees(10.0);
+      solver->SetOdeMethod(odeMethod);
+      if(odeMethod == BetatronEquationSolver::BaderDeuflhardMethod) {
+        solver->SetTolerance(1.0); // On the absolute error, of velocities of around 1.5e8 m/s.
+      }
+      solver->Initialize();
+      state.ResumeTiming();
+
+      solver->Run();
+    }
+
+    shared_ptr<SampledDerivedData> stateData = solver->GetOdeData()->GetCollector()->GetStateData();
+    double time;
+    VectorXd y(6), dy(6);
+    double maxRadiusDrift = 0.0;
+    double maxSpeedDrift = 0.0;
+    for(int i=0; i<stateData->GetNumberOfSamples(); i++) {
+      stateData->Retrieve(i, time, y, dy);
+      maxRadiusDrift = std::max(maxRadiusDrift, fabs(y.head<3>().norm()/RADIUS-1.0));
+      maxSpeedDrift = std::max(maxSpeedDrift, fabs(y.tail<3>().norm()/(SPEED*Bach::SPEED_OF_LIGHT)-1.0));
+    }
+
+    int steps = solver->GetOdeSolver()->GetNumberGood()+solver->GetOdeSolver()->GetNumberRetried();
+    state.SetCounter("steps", steps);
+    state.SetCounter("radiusDrift", maxRadiusDrift);
+    state.SetCounter("speedDrift", maxSpeedDrift);
+    state.SetItemsProcessed((double) steps*state.GetIterations());
+  }
+
+  typedef BaderDeuflhardOdeN<6, BetatronEquations> BetatronOdeN;
+
+  // Keeps every step start, as the OdeData of the dynamic solver does.
+  struct StepRecorder {
+    void operator()(double x, const BetatronOdeN::VectorN& y, const BetatronOdeN::VectorN& dydx) {
+      values.push_back(x);
+      values.insert(values.end(), y.data(), y.data()+6);
+      values.insert(values.end(), dydx.data(), dydx.data()+6);
+    }
+    std::vector<double> values;
+  };
+
+  // The solve of RunBetatron with the analytic Jacobian, on the fixed size solver, either
+  // recording every step start or keeping only the last state.
+  void RunBetatronFixedSize(BenchmarkState& state, bool storeSteps) {
+    shared_ptr<BetatronEquationSolver> solver = BetatronEquationSolver::CreateInstance();
+    solver->SetNumRotations(1.0);
+    solver->SetInitialConditionsFromRadiusAndSpeed(RADIUS, SPEED*Bach::SPEED_OF_LIGHT);
+    solver->Initialize();
+    shared_ptr<OdeData> odeData = solver->GetOdeData();
+
+    BetatronOdeN ode;
+    ode.SetStepSize(solver->GetStepSize());
+    ode.SetMaximumStepSize((odeData->GetEndTime()-odeData->GetStartTime())/40.0);
+
+    BetatronOdeN::VectorN y;
+    while(state.KeepRunning()) {
+      y = odeData->GetInitialConditions();
+      if(storeSteps) {
+        StepRecorder recorder;
+        ode.Solve(*solver->GetEquations(), odeData->GetStartTime(), odeData->GetEndTime(), y, recorder);
+      }
+      else {
+        ode.Solve(*solver->GetEquations(), odeData->GetStartTime(), odeData->GetEndTime(), y);
+      }
+    }
+    s_sink = y(0);
+
+    int accepted = ode.GetNumberGood()+ode.GetNumberRetried();
+    state.SetCounter("evaluations", ode.GetNumberOfEvaluations());
+    state.SetCounter("accepted", accepted);
+    state.SetCounter("factorizationsPerStep", (double) ode.GetNumberOfFactorizations()/accepted);
+    state.SetItemsProcessed((double) accepted*state.GetIterations());
+  }
+
+  enum LinearSolveMethod {
+    ColPivHouseholderQRSolve, // A fresh QR for each factorization, as BaderDeuflhardOde had.
+    DynamicLUSolve,
+    FixedLUSolve              // Through LinearSolveWorkspace, as the solver calls it.
+  };
+
+  // One extrapolation level's linear algebra, a factorization of (I - h*dfdy) and the solves
+  // of its sub-steps.
+  void RunLinearSolve(BenchmarkState& state, LinearSolveMethod method) {
+    const int numSubSteps = 6;
+    int size = (int) state.GetArgument();
+    MatrixXd dfdy(size, size);
+    for(int j=0; j<size; j++) {
+      for(int i=0; i<size; i++) {
+        dfdy(i, j) = sin(1.0+3.0*i+7.0*j);
+      }
+    }
+
+    shared_ptr<LinearSolveWorkspace> workspace;
+    if(method == FixedLUSolve) {
+      workspace = LinearSolveWorkspace::CreateInstance(size);
+      if(!workspace->IsFixedSize()) {
+        state.SkipWithError("No fixed size workspace for this size");
+      }
+    }
+    else {
+      workspace.reset(new DynamicLinearSolveWorkspace(size));
+    }
+
+    VectorXd b = VectorXd::LinSpaced(size, -1.0, 2.0);
+    VectorXd x(size);
+    double h = 1.0e-3;
+    double sum = 0.0;
+    while(state.KeepRunning()) {
+      x = b;
+      if(method == ColPivHouseholderQRSolve) {
+        MatrixXd a = -h*dfdy;
+        a.diagonal().array() += 1.0;
+        ColPivHouseholderQR<MatrixXd> decomposition = a.colPivHouseholderQr();
+        for(int i=0; i<numSubSteps; i++) {
+          x = decomposition.solve(x);
+        }
+      }
+      else {
+        workspace->Factor(h, dfdy);
+        for(int i=0; i<numSubSteps; i++) {
+          workspace->Solve(x, x);
+        }
+      }
+      sum += x(0);
+      h = (h < 1.0 ? 2.0*h : 1.0e-3);
+    }
+    s_sink = sum;
+    state.SetItemsProcessed(state.GetIterations());
+  }
+
+  // A single betatron Jacobian, with the differentiator each JacobianMethod gives the solver.
+  void RunBetatronDerivatives(BenchmarkState& state, BetatronEquationSolver::JacobianMethod jacobianMethod) {
+    shared_ptr<BetatronEquationSolver> solver = BetatronEquationSolver::CreateInstance();
+    solver->SetFieldIncreaseRatePerRotation(0.01);
+    solver->SetInitialConditionsFromRadiusAndSpeed(RADIUS, SPEED*Bach::SPEED_OF_LIGHT);
+    solver->Initialize();
+    shared_ptr<OdeData> odeData = solver->GetOdeData();
+    odeData->SetStoringThisCall(false);
+
+    shared_ptr<OdeDerivatives> derivatives;
+    switch(jacobianMethod) {
+      case BetatronEquationSolver::AnalyticJacobian :  derivatives.reset(new BetatronDerivatives(solver->GetEquations())); break;
+      case BetatronEquationSolver::AutomaticJacobian : derivatives.reset(new OdeAutoDiffDerivatives(NUM_DEPENDENT)); break;
+      case BetatronEquationSolver::NumericalJacobian : derivatives.reset(new OdeNumericalDerivatives(NUM_DEPENDENT)); break;
+    }
+
+    VectorXd y = odeData->GetInitialConditions();
+    VectorXd dfdx(NUM_DEPENDENT);
+    MatrixXd dfdy(NUM_DEPENDENT, NUM_DEPENDENT);
+    shared_ptr<BetatronEquations> equations = solver->GetEquations();
+    int startCount = equations->GetIterationCount();
+    double sum = 0.0;
+    while(state.KeepRunning()) {
+      derivatives->GetDerivatives(0.0, y, dfdx, dfdy, odeData);
+      sum += dfdy(3, 4);
+    }
+    s_sink = sum;
+    state.SetCounter("evaluations", (double) (equations->GetIterationCount()-startCount)/state.GetIterations());
+  }
+
+  //****************
+  //* VanDerPolOde *
+  //****************
+
+  // The Van der Pol oscillator, y'' = mu*(1-y^2)*y'-y, which is stiff for large mu.
+  class VanDerPolOde : public OdeEquations {
+  public:
+    VanDerPolOde(double mu) : m_mu(mu) { SetStateLength(2); }
+
+    void Evaluate(double x, const VectorXd& yIn, VectorXd& yOut, shared_ptr<OdeData> odeData) {
+      yOut(0) = yIn(1);
+      yOut(1) = m_mu*(1.0-yIn(0)*yIn(0))*yIn(1)-yIn(0);
+    }
+
+  private:
+    double m_mu;
+  };
+
+  void RunVanDerPol(BenchmarkState& state) {
+    double mu = (double) state.GetArgument();
+    shared_ptr<OdeData> odeData = OdeData::CreateInstance(shared_ptr<OdeEquations>(new VanDerPolOde(mu)));
+    odeData->SetStartTime(0.0);
+    odeData->SetEndTime(2.0*mu+10.0); // About one cycle for large mu.
+    VectorXd initialConditions(2);
+    initialConditions << 2.0, 0.0;
+    odeData->SetInitialConditions(initialConditions);
+
+    shared_ptr<OdeSolverTelemetry> telemetry = OdeSolverTelemetry::CreateInstance("baderDeuflhard");
+    shared_ptr<BaderDeuflhardOde> solver = BaderDeuflhardOde::CreateInstance();
+    solver->SetAccuracySpec(shared_ptr<OdeAccuracySpec>(new OdeAccuracySpec(2, 1.0e-6)));
+    solver->SetStepSize(1.0e-3);
+    solver->SetTelemetry(telemetry);
+
+    while(state.KeepRunning()) {
+      solver->Solve(odeData);
+    }
+
+    state.SetCounter("evaluations", telemetry->GetNumberOfEvaluations());
+    state.SetCounter("jacobians", telemetry->GetNumberOfJacobians());
+    state.SetCounter("accepted", telemetry->GetNumberAccepted());
+    state.SetCounter("rejected", telemetry->GetNumberRejected());
+    state.SetItemsProcessed((double) telemetry->GetNumberAccepted()*state.GetIterations());
+  }
+
+  // A batch of one rotation trajectories on a pool of the argument's threads, for the scaling.
+  void RunBatchSolver(BenchmarkState& state) {
+    // A sweep over radius, speed and field increase like the ones the server receives.
+    std::vector<BetatronBatchSolver::Parameters> parameters(NUM_TRAJECTORIES);
+    for(int i=0; i<NUM_TRAJECTORIES; i++) {
+      parameters[i].radius = 0.05+0.001*(i % 16);
+      parameters[i].speed  = (0.1+0.05*(i % 8))*Bach::SPEED_OF_LIGHT;
+      parameters[i].fieldIncreaseRatePerRotation = 0.01*(i % 4);
+      parameters[i].numRotations = 1.0;
+    }
+
+    shared_ptr<WorkStealingPool> pool = WorkStealingPool::CreateInstance((int) state.GetArgument());
+    while(state.KeepRunning()) {
+      shared_ptr<BetatronBatchSolver> batchSolver = BetatronBatchSolver::CreateInstance(pool);
+      batchSolver->Solve(parameters);
+      s_sink = batchSolver->GetNumberOfSolvers();
+    }
+    state.SetItemsProcessed((double) NUM_TRAJECTORIES*state.GetIterations());
+  }
+
+  double SampleValue(int sample, int variable) {
+    return sin(0.001*sample+variable);
+  }
+
+  //************************
+  //* PointerPerSampleData *
+  //************************
+
+  // The storage SampledData had before SampleBlock, one heap allocated vector per sample,
+  // kept as the baseline for the layouts. The layout argument is only for the same signature.
+  class PointerPerSampleData {
+  public:
+    PointerPerSampleData(int numDependent, int maxNumberOfSamples, SampleBlock::Layout = SampleBlock::VariableContiguous) :
+      m_numberOfDependent(numDependent), m_numberOfSamples(0), m_x(maxNumberOfSamples), m_yArray(maxNumberOfSamples, NULL),
+      m_interpolator(3), m_interpVectorArray(numDependent, VectorXd(3)) {}
+
+    ~PointerPerSampleData() {
+      for(int i=0; i<m_numberOfSamples; i++) {
+        delete m_yArray[i];
+      }
+    }
+
+    int GetNumberOfSamples() const    { return m_numberOfSamples; }
+    int GetMaxNumberOfSamples() const { return (int) m_yArray.size(); }
+
+    void Resize(int newSize) {
+      m_x.conservativeResize(newSize);
+      m_yArray.resize(newSize, NULL);
+    }
+
+    void Store(double x, const VectorXd& y) {
+      m_x(m_numberOfSamples) = x;
+      m_yArray[m_numberOfSamples] = new VectorXd(y);
+      m_numberOfSamples++;
+    }
+
+    void Retrieve(int index, double& x, VectorXd& y) const {
+      x = m_x(index);
+      y = *m_yArray[index];
+    }
+
+    void Retrieve(double xTarget, VectorXd& y) {
+      int indexLow = m_indexHunter.Find(xTarget, m_x.head(m_numberOfSamples));
+      indexLow = InterpolationIndex::ChooseInterpolationIndex(m_numberOfSamples, indexLow, 3);
+      for(int i=0; i<m_numberOfDependent; i++) {
+        for(int j=0; j<3; j++) {
+          m_interpVectorArray[i](j) = (*m_yArray[indexLow+j])(i);
+        }
+        y(i) = m_interpolator.Interpolate(xTarget, m_x.segment(indexLow, 3), m_interpVectorArray[i]);
+      }
+    }
+
+    int Max(int nstate) const {
+      int index = 0;
+      double maxValue = (*m_yArray[0])(nstate);
+      for(int i=1; i<m_numberOfSamples; i++) {
+        if(maxValue < (*m_yArray[i])(nstate)) {
+          maxValue = (*m_yArray[i])(nstate);
+          index = i;
+        }
+      }
+      return index;
+    }
+
+  private:
+    int m_numberOfDependent;
+    int m_numberOfSamples;
+    VectorXd m_x;
+    std::vector<VectorXd*> m_yArray;
+    SequentialAccessHunt m_indexHunter;
+    PolynomialInterp m_interpolator;
+    std::vector<VectorXd> m_interpVectorArray;
+  };
+
+  // Stores as OdeDataCollector does, growing the storage when it fills.
+  template<class DataType>
+  void StoreSamples(DataType& data, int numSamples) {
+    VectorXd y(NUM_DEPENDENT);
+    for(int i=0; i<numSamples; i++) {
+      if(data.GetNumberOfSamples() >= data.GetMaxNumberOfSamples()) {
+        data.Resize((int) (data.GetMaxNumberOfSamples()*GROWTH_FACTOR));
+      }
+      for(int j=0; j<NUM_DEPENDENT; j++) {
+        y(j) = SampleValue(i, j);
+      }
+      data.Store(i, y);
+    }
+  }
+
+  void StoreSamples(SampledDerivedData& data, int numSamples) {
+    VectorXd y(NUM_DEPENDENT);
+    VectorXd dy(NUM_DEPENDENT);
+    for(int i=0; i<numSamples; i++) {
+      for(int j=0; j<NUM_DEPENDENT; j++) {
+        y(j) = SampleValue(i, j);
+        dy(j) = 0.001*cos(0.001*i+j);
+      }
+      data.Store(i, y, dy);
+    }
+  }
+
+  void RunSampledDataStore(BenchmarkState& state, bool spline) {
+    int numSamples = (int) state.GetArgument();
+    while(state.KeepRunning()) {
+      SampledData data(NUM_DEPENDENT, INITIAL_DATA_SIZE);
+      if(spline) {
+        data.SetSpline(shared_ptr<SplineInterp>(new SplineInterp(SplineInterp::Natural, NUM_DEPENDENT)));
+      }
+      StoreSamples(data, numSamples);
+      s_sink = data(numSamples-1, 0);
+    }
+    state.SetItemsProcessed((double) numSamples*state.GetIterations());
+  }
+
+  void RunSampledDataRetrieveIndex(BenchmarkState& state) {
+    int numSamples = (int) state.GetArgument();
+    SampledData data(NUM_DEPENDENT, INITIAL_DATA_SIZE);
+    StoreSamples(data, numSamples);
+
+    VectorXd y(NUM_DEPENDENT);
+    double x;
+    double sum = 0.0;
+    int index = 0;
+    while(state.KeepRunning()) {
+      data.Retrieve(index, x, y);
+      sum += y(0);
+      if(++index == numSamples) {
+        index = 0;
+      }
+    }
+    s_sink = sum;
+    state.SetItemsProcessed(state.GetIterations());
+  }
+
+  void RunSampledDataRetrieveTarget(BenchmarkState& state, bool sequential, bool eytzinger = false, bool spline = false) {
+    int numSamples = (int) state.GetArgument();
+    SampledData data(NUM_DEPENDENT, INITIAL_DATA_SIZE);
+    StoreSamples(data, numSamples);
+    if(eytzinger) {
+      data.SetTableSearch(shared_ptr<TableSearch>(new EytzingerSearch()));
+    }
+    if(spline) {
+      data.SetSpline(shared_ptr<SplineInterp>(new SplineInterp(SplineInterp::Natural, NUM_DEPENDENT)));
+    }
+
+    std::vector<double> targets = GetRandomTargets(NUM_QUERIES, numSamples-1);
+    if(sequential) {
+      for(int i=0; i<NUM_QUERIES; i++) {
+        targets[i] = (i+0.5)*(numSamples-1)/NUM_QUERIES;
+      }
+    }
+
+    VectorXd y(NUM_DEPENDENT);
+    data.Retrieve(targets[0], y);
+    double sum = 0.0;
+    int query = 0;
+    while(state.KeepRunning()) {
+      data.Retrieve(targets[query], y);
+      sum += y(0);
+      query = (query+1) & (NUM_QUERIES-1);
+    }
+    s_sink = sum;
+    state.SetItemsProcessed(state.GetIterations());
+  }
+
+  enum LayoutOperation {
+    StoreOperation,
+    RetrieveIndexOperation,
+    ScanOperation,        // Max over every variable.
+    InterpolateOperation  // Retrieve at sequential targets between the samples.
+  };
+
+  // The same work on a storage layout, with the heap allocations made storing every sample.
+  template<class DataType>
+  void RunLayout(BenchmarkState& state, SampleBlock::Layout layout, LayoutOperation operation) {
+    int numSamples = (int) state.GetArgument();
+    if(operation == StoreOperation) {
+      long allocations = 0;
+      while(state.KeepRunning()) {
+        AllocationCounter::Reset();
+        DataType data(NUM_DEPENDENT, INITIAL_DATA_SIZE, layout);
+        StoreSamples(data, numSamples);
+        allocations = AllocationCounter::GetCount();
+        s_sink = data.GetNumberOfSamples();
+      }
+      state.SetCounter("allocations", (double) allocations);
+      state.SetItemsProcessed((double) numSamples*state.GetIterations());
+      return;
+    }
+
+    DataType data(NUM_DEPENDENT, INITIAL_DATA_SIZE, layout);
+    StoreSamples(data, numSamples);
+
+    double x;
+    VectorXd y(NUM_DEPENDENT);
+    double sum = 0.0;
+    int index = 0;
+    while(state.KeepRunning()) {
+      switch(operation) {
+        case RetrieveIndexOperation :
+          data.Retrieve(index, x, y);
+          sum += y(0);
+          break;
+        case ScanOperation :
+          for(int j=0; j<NUM_DEPENDENT; j++) {
+            sum += data.Max(j);
+          }
+          break;
+        default :
+          data.Retrieve(index+0.5, y);
+          sum += y(0);
+          break;
+      }
+      if(++index == numSamples-1) {
+        index = 0;
+      }
+    }
+    s_sink = sum;
+    state.SetItemsProcessed((double) (operation == ScanOperation ? numSamples : 1)*state.GetIterations());
+  }
+
+  void RegisterLayout(const shared_ptr<BenchmarkRegistry>& registry, const std::string& name, LayoutOperation operation) {
+    registry->Register("SampledData", "Layout/" + name + "/PointerPerSample", [operation](BenchmarkState& state) {
+      RunLayout<PointerPerSampleData>(state, SampleBlock::VariableContiguous, operation);
+    })->Arg(100000);
+    registry->Register("SampledData", "Layout/" + name + "/SampleContiguous", [operation](BenchmarkState& state) {
+      RunLayout<SampledData>(state, SampleBlock::SampleContiguous, operation);
+    })->Arg(100000);
+    registry->Register("SampledData", "Layout/" + name + "/VariableContiguous", [operation](BenchmarkState& state) {
+      RunLayout<SampledData>(state, SampleBlock::VariableContiguous, operation);
+    })->Arg(100000);
+  }
+
+  // Every sample resampled onto an evenly spaced grid, either a target at a time or in one batch.
+  template<class DataType>
+  void RunResample(BenchmarkState& state, bool batch) {
+    int numSamples = (int) state.GetArgument();
+    DataType data(NUM_DEPENDENT, numSamples);
+    StoreSamples(data, numSamples);
+
+    VectorXd xTargets = VectorXd::LinSpaced(NUM_RESAMPLED, 0.0, numSamples-1);
+    MatrixXd y(NUM_DEPENDENT, NUM_RESAMPLED);
+    VectorXd yTarget(NUM_DEPENDENT);
+    while(state.KeepRunning()) {
+      if(batch) {
+        data.Retrieve(xTargets, y);
+      }
+      else {
+        for(int k=0; k<NUM_RESAMPLED; k++) {
+          data.Retrieve(xTargets(k), yTarget);
+          y.col(k) = yTarget;
+        }
+      }
+    }
+    s_sink = y(0, NUM_RESAMPLED-1);
+    state.SetItemsProcessed((double) NUM_RESAMPLED*state.GetIterations());
+  }
+}
+
+  //************************
+  //* Bach::MathBenchmarks *
+  //************************
+
+void MathBenchmarks::Register(const shared_ptr<BenchmarkRegistry>& registry) {
+  registry->Register("Interp", "Polynomial", RunInterpolator<PolynomialInterp>)->Arg(3)->Arg(5)->Arg(8);
+  registry->Register("Interp", "Rational", RunInterpolator<RationalInterp>)->Arg(3)->Arg(5)->Arg(8);
+  registry->Register("Interp", "PolynomialColumns", RunPolynomialColumns)->Arg(6)->Arg(64);
+  registry->Register("Interp", "BarycentricColumns", RunBarycentricColumns)->Arg(6)->Arg(64);
+  registry->Register("Interp", "HermiteScalar", RunHermiteScalar);
+  registry->Register("Interp", "HermiteVector", RunHermiteVector)->Arg(6)->Arg(64);
+
+  registry->Register("TableSearch", "SequentialAccessHunt/Sequential", [](BenchmarkState& state) { RunTableSearch<SequentialAccessHunt>(state, true); })->Range(1000, 10000000, 10);
+  registry->Register("TableSearch", "Bisection/Sequential", [](BenchmarkState& state) { RunTableSearch<BisectionSearch>(state, true); })->Range(1000, 10000000, 10);
+  registry->Register("TableSearch", "SequentialAccessHunt/Random", [](BenchmarkState& state) { RunTableSearch<SequentialAccessHunt>(state, false); })->Range(1000, 10000000, 10);
+  registry->Register("TableSearch", "Bisection/Random", [](BenchmarkState& state) { RunTableSearch<BisectionSearch>(state, false); })->Range(1000, 10000000, 10);
+  registry->Register("TableSearch", "EytzingerSearch/Sequential", [](BenchmarkState& state) { RunTableSearch<EytzingerSearch>(state, true); })->Range(1000, 10000000, 10);
+  registry->Register("TableSearch", "EytzingerSearch/Random", [](BenchmarkState& state) { RunTableSearch<EytzingerSearch>(state, false); })->Range(1000, 10000000, 10);
+  registry->Register("TableSearch", "Bisection/RandomUneven", [](BenchmarkState& state) { RunTableSearch<BisectionSearch>(state, false, true); })->Range(1000, 10000000, 10);
+  registry->Register("TableSearch", "SequentialAccessHunt/RandomUneven", [](BenchmarkState& state) { RunTableSearch<SequentialAccessHunt>(state, false, true); })->Range(1000, 10000000, 10);
+  registry->Register("TableSearch", "EytzingerSearch/RandomUneven", [](BenchmarkState& state) { RunTableSearch<EytzingerSearch>(state, false, true); })->Range(1000, 10000000, 10);
+
+  registry->Register("Derivatives", "RiddersExtrapolation", RunRidders)->Arg(1)->Arg(6);
+  registry->Register("Derivatives", "Jacobian", [](BenchmarkState& state) { RunJacobian(state, false); })->Arg(6)->Arg(16)->Arg(64);
+  registry->Register("Derivatives", "Jacobian/Pool", [](BenchmarkState& state) { RunJacobian(state, true); })->Arg(6)->Arg(16)->Arg(64);
+  registry->Register("Derivatives", "Betatron/Analytic", [](BenchmarkState& state) { RunBetatronDerivatives(state, BetatronEquationSolver::AnalyticJacobian); });
+  registry->Register("Derivatives", "Betatron/Automatic", [](BenchmarkState& state) { RunBetatronDerivatives(state, BetatronEquationSolver::AutomaticJacobian); });
+  registry->Register("Derivatives", "Betatron/Numerical", [](BenchmarkState& state) { RunBetatronDerivatives(state, BetatronEquationSolver::NumericalJacobian); });
+
+  registry->Register("RootSolver", "NDimNewtonRaphson", RunNewtonRaphson)->Arg(6)->Arg(32);
+  registry->Register("RootSolver", "WaterEquilibrium", [](BenchmarkState& state) { RunWaterEquilibrium(state, false); });
+  registry->Register("RootSolver", "WaterEquilibrium/Pool", [](BenchmarkState& state) { RunWaterEquilibrium(state, true); });
+
+  registry->Register("Ode", "BaderDeuflhard/BetatronAnalytic", [](BenchmarkState& state) { RunBetatron(state, BetatronEquationSolver::AnalyticJacobian); });
+  registry->Register("Ode", "BaderDeuflhard/BetatronAutomatic", [](BenchmarkState& state) { RunBetatron(state, BetatronEquationSolver::AutomaticJacobian); });
+  registry->Register("Ode", "BaderDeuflhard/BetatronNumerical", [](BenchmarkState& state) { RunBetatron(state, BetatronEquationSolver::NumericalJacobian); });
+  // The factorization behind the analytic betatron solve's time, the old QR against the LU.
+  registry->Register("LinearSolve", "ColPivHouseholderQR", [](BenchmarkState& state) { RunLinearSolve(state, ColPivHouseholderQRSolve); })->Arg(6)->Arg(16);
+  registry->Register("LinearSolve", "PartialPivLU/Dynamic", [](BenchmarkState& state) { RunLinearSolve(state, DynamicLUSolve); })->Arg(6)->Arg(16);
+  registry->Register("LinearSolve", "PartialPivLU/Fixed", [](BenchmarkState& state) { RunLinearSolve(state, FixedLUSolve); })->Arg(6);
+
+  registry->Register("Ode", "BaderDeuflhardN/BetatronAnalytic", [](BenchmarkState& state) { RunBetatronFixedSize(state, false); });
+  registry->Register("Ode", "BaderDeuflhardN/BetatronAnalytic/Storing", [](BenchmarkState& state) { RunBetatronFixedSize(state, true); });
+  registry->Register("Ode", "BaderDeuflhard/VanDerPol", RunVanDerPol)->Arg(1)->Arg(10)->Arg(100);
+
+  // Each solver over its range of tolerances, as the exponent of 10^-argument. BaderDeuflhardOde's
+  // tolerance is on the absolute error, of velocities of around 1.5e8 m/s here, while the
+  // explicit solvers' is relative. Its solves take seconds, so they are timed once, and the
+  // family is kept out of the profile training runs, which select names starting with Ode.
+  registry->Register("SolverSelection", "Betatron/BaderDeuflhard", [](BenchmarkState& state) {
+    RunSolverSelection(state, BetatronEquationSolver::BaderDeuflhardMethod);
+  })->Arg(-2)->Arg(0)->Arg(2)->Arg(4)->Iterations(1);
+  registry->Register("SolverSelection", "Betatron/DormandPrince", [](BenchmarkState& state) {
+    RunSolverSelection(state, BetatronEquationSolver::DormandPrinceMethod);
+  })->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
+  registry->Register("SolverSelection", "Betatron/BulirschStoer", [](BenchmarkState& state) {
+    RunSolverSelection(state, BetatronEquationSolver::BulirschStoerMethod);
+  })->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
+
+  // The Boris pushers against BaderDeuflhardOde over a hundred rotations, for the time
+  // taken against the drift of the radius and speed.
+  registry->Register("Drift", "Betatron/BaderDeuflhard", [](BenchmarkState& state) {
+    RunDrift(state, BetatronEquationSolver::BaderDeuflhardMethod);
+  })->Arg(100)->Iterations(1);
+  registry->Register("Drift", "Betatron/Boris", [](BenchmarkState& state) {
+    RunDrift(state, BetatronEquationSolver::BorisMethod);
+  })->Arg(100);
+  registry->Register("Drift", "Betatron/RelativisticBoris", [](BenchmarkState& state) {
+    RunDrift(state, BetatronEquationSolver::RelativisticBorisMethod);
+  })->Arg(100);
+
+  // Trajectories per second from one thread up to one per core, the speedup being their ratio.
+  long maxThreads = std::max(1L, (long) std::thread::hardware_concurrency());
+  registry->Register("BatchSolver", "Betatron/Threads", RunBatchSolver)->Range(1, maxThreads, 2)->Iterations(1);
+
+  registry->Register("SampledData", "Store", [](BenchmarkState& state) { RunSampledDataStore(state, false); })->Range(1000, 10000000, 10);
+  registry->Register("SampledData", "Store/Spline", [](BenchmarkState& state) { RunSampledDataStore(state, true); })->Range(1000, 10000000, 10);
+  registry->Register("SampledData", "RetrieveIndex", RunSampledDataRetrieveIndex)->Range(1000, 10000000, 10);
+  registry->Register("SampledData", "RetrieveTarget/Sequential", [](BenchmarkState& state) { RunSampledDataRetrieveTarget(state, true); })->Range(1000, 10000000, 10);
+  registry->Register("SampledData", "RetrieveTarget/Random", [](BenchmarkState& state) { RunSampledDataRetrieveTarget(state, false); })->Range(1000, 10000000, 10);
+  registry->Register("SampledData", "RetrieveTarget/RandomEytzinger", [](BenchmarkState& state) { RunSampledDataRetrieveTarget(state, false, true); })->Range(1000, 10000000, 10);
+  registry->Register("SampledData", "RetrieveTarget/RandomSpline", [](BenchmarkState& state) { RunSampledDataRetrieveTarget(state, false, false, true); })->Range(1000, 10000000, 10);
+  registry->Register("SampledData", "RetrieveTarget/RandomEytzingerSpline", [](BenchmarkState& state) { RunSampledDataRetrieveTarget(state, false, true, true); })->Range(1000, 10000000, 10);
+
+  // The contiguous layouts against the pointer per sample storage they replaced.
+  RegisterLayout(registry, "Store", StoreOperation);
+  RegisterLayout(registry, "RetrieveIndex", RetrieveIndexOperation);
+  RegisterLayout(registry, "Scan", ScanOperation);
+  RegisterLayout(registry, "Interpolate", InterpolateOperation);
+
+  registry->Register("SampledData", "Resample/Single", [](BenchmarkState& state) { RunResample<SampledData>(state, false); })->Range(1000, 1000000, 10);
+  registry->Register("SampledData", "Resample/Batch", [](BenchmarkState& state) { RunResample<SampledData>(state, true); })->Range(1000, 1000000, 10);
+  registry->Register("SampledData", "ResampleDerived/Single", [](BenchmarkState& state) { RunResample<SampledDerivedData>(state, false); })->Range(1000, 1000000, 10);
+  registry->Register("SampledData", "ResampleDerived/Batch", [](BenchmarkState& state) { RunResample<SampledDerivedData>(state, true); })->Range(1000, 1000000, 10);
+}
@@ -0,0 +1,36 @@
+/**********************************************************************
+
+File     : MathBenchmarks.h
+Project  : Bach Simulation
+Purpose  : Header file for the micro and macro benchmarks of the Math library.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The micro benchmarks time the inner pieces of the solvers, the
+           interpolators, table searches and numerical derivatives, one call
+           at a time. The macro benchmarks time whole solves, the betatron and
+           a stiff system on BaderDeuflhardOde and root finding with
+           NDimNewtonRaphson, and the storage and retrieval of SampledData at
+           sizes up to those of long runs.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_MATH_BENCHMARKS_H__
+#define __BACH_MATH_BENCHMARKS_H__
+
+#include "BenchmarkRegistry.h"
+
+namespace Bach {
+  namespace MathBenchmarks {
+
+    //************************
+    //* Bach::MathBenchmarks *
+    //************************
+
+    void Register(const boost::shared_ptr<BenchmarkRegistry>& registry);
+  };
+};
+
+#endif // __BACH_MATH_BENCHMARKS_H__
@@ -0,0 +1,72 @@
+/**********************************************************************
+
+File     : BinaryColumnWriter.cpp
+Project  : Bach Betatron Library
+Purpose  : Source file for a writer of the binary column result format.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BinaryColumnWriter.h"
+#include <algorithm>
+#include <stdint.h>
+
+using namespace Bach;
+using namespace boost;
+
+namespace {
+  bool IsLittleEndian() {
+    const uint16_t one = 1;
+    return *((const uint8_t*) &one) == 1;
+  }
+
+  // Columns start on an 8 byte boundary so a client can view them in place.
+  const size_t COLUMN_ALIGNMENT = 8;
+}
+
+const char* const BinaryColumnWriter::MEDIA_TYPE = "application/vnd.bach.columns";
+
+const bool BinaryColumnWriter::s_hostIsLittleEndian = IsLittleEndian();
+
+  //**********************
+  //* BinaryColumnWriter *
+  //**********************
+
+shared_ptr<BinaryColumnWriter> BinaryColumnWriter::CreateInstance(const shared_ptr<OutputBufferPool>& pool,
+                                                                  const BufferHandler& handler,
+                                                                  Precision precision) {
+  shared_ptr<BinaryColumnWriter> instance(new BinaryColumnWriter(pool, handler, precision));
+  return instance;
+}
+
+BinaryColumnWriter::BinaryColumnWriter(const shared_ptr<OutputBufferPool>& pool, const BufferHandler& handler, Precision precision) :
+  OutputBufferWriter(pool, handler),
+  m_precision(precision) {
+}
+
+void BinaryColumnWriter::WriteHeader(const std::string& layout) {
+  uint32_t layoutLength = (uint32_t) layout.size();
+  unsigned char header[HEADER_SIZE] = {
+    'B', 'C', 'O', 'L',
+    (unsigned char) (FORMAT_VERSION & 0xff), (unsigned char) (FORMAT_VERSION >> 8),
+    (unsigned char) m_precision, 0,
+    (unsigned char) (layoutLength & 0xff), (unsigned char) ((layoutLength >> 8) & 0xff),
+    (unsigned char) ((layoutLength >> 16) & 0xff), (unsigned char) (layoutLength >> 24)
+  };
+  WriteBytes(header, HEADER_SIZE);
+  WriteBytes(layout.data(), layout.size());
+
+  static const char zeros[COLUMN_ALIGNMENT] = { 0 };
+  size_t unaligned = (HEADER_SIZE+layout.size()) % COLUMN_ALIGNMENT;
+  if(unaligned != 0) {
+    WriteBytes(zeros, COLUMN_ALIGNMENT-unaligned);
+  }
+}
+
+void BinaryColumnWriter::ReverseBytes(char* bytes, size_t length) {
+  std::reverse(bytes, bytes+length);
+}
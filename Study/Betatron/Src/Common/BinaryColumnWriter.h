@@ -0,0 +1,93 @@
+/**********************************************************************
+
+File     : BinaryColumnWriter.h
+Project  : Bach Betatron Library
+Purpose  : Header file for a writer of the binary column result format.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Results are mostly long columns of numbers, which as JSON text
+           take about 20 bytes a value and have to be parsed by the client.
+           This format sends them as raw little-endian floats that a
+           browser can view in place with a Float64Array or Float32Array.
+
+           Layout, all integers little-endian:
+             bytes 0-3   "BCOL"
+             bytes 4-5   format version, 1
+             byte  6     bytes per value, 4 for float32 or 8 for float64
+             byte  7     zero
+             bytes 8-11  length of the layout that follows
+             layout      UTF-8 JSON, the JSON form of the result with each
+                         "values" array replaced by its number of values
+             padding     zeros up to the next multiple of 8 bytes
+             columns     the values of each column in the order the layout
+                         names them, with nothing between columns
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_BINARY_COLUMN_WRITER_H__
+#define __BACH_BINARY_COLUMN_WRITER_H__
+
+#include "BachDefs.h"
+#include "OutputBufferPool.h"
+#include <string>
+
+namespace Bach {
+
+  //**********************
+  //* BinaryColumnWriter *
+  //**********************
+
+  class BinaryColumnWriter : public OutputBufferWriter {
+  public:
+    enum Precision {
+      FLOAT32 = 4,
+      FLOAT64 = 8
+    };
+
+    static const int FORMAT_VERSION = 1;
+    static const size_t HEADER_SIZE = 12;
+
+    // The media type of the format, for Accept and Content-Type headers.
+    static const char* const MEDIA_TYPE;
+
+    static boost::shared_ptr<BinaryColumnWriter> CreateInstance(const boost::shared_ptr<OutputBufferPool>& pool,
+                                                                const BufferHandler& handler,
+                                                                Precision precision = FLOAT64);
+
+    Precision GetPrecision() const { return m_precision; }
+
+    // The header, the layout and the padding before the first column.
+    void WriteHeader(const std::string& layout);
+
+    // The next value of the current column, rounded to float32 at that precision.
+    void WriteValue(double value) {
+      Reserve(sizeof(double));
+      char* end = m_buffer->GetEnd();
+      if(m_precision == FLOAT64) {
+        std::memcpy(end, &value, sizeof(double));
+      }
+      else {
+        float single = (float) value;
+        std::memcpy(end, &single, sizeof(float));
+      }
+      if(!s_hostIsLittleEndian) {
+        ReverseBytes(end, m_precision);
+      }
+      Commit(m_precision);
+    }
+
+  protected:
+    BinaryColumnWriter(const boost::shared_ptr<OutputBufferPool>& pool, const BufferHandler& handler, Precision precision);
+
+    static void ReverseBytes(char* bytes, size_t length);
+
+    static const bool s_hostIsLittleEndian;
+
+    Precision m_precision;
+  };
+};
+
+#endif // __BACH_BINARY_COLUMN_WRITER_H__
@@ -0,0 +1,115 @@
+/**********************************************************************
+
+File     : JsonStreamWriter.cpp
+Project  : Bach Betatron Library
+Purpose  : Source file for a JSON writer that streams into pooled output buffers.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "JsonStreamWriter.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+
+using namespace Bach;
+using namespace boost;
+
+  //********************
+  //* JsonStreamWriter *
+  //********************
+
+shared_ptr<JsonStreamWriter> JsonStreamWriter::CreateInstance(const shared_ptr<OutputBufferPool>& pool,
+                                                              const BufferHandler& handler) {
+  shared_ptr<JsonStreamWriter> instance(new JsonStreamWriter(pool, handler));
+  return instance;
+}
+
+JsonStreamWriter::JsonStreamWriter(const shared_ptr<OutputBufferPool>& pool, const BufferHandler& handler) :
+  OutputBufferWriter(pool, handler) {
+}
+
+void JsonStreamWriter::WriteString(const std::string& value) {
+  static const char* hexDigits = "0123456789abcdef";
+
+  WriteRaw("\"", 1);
+  size_t start = 0;
+  for(size_t i=0; i<value.size(); i++) {
+    unsigned char c = (unsigned char) value[i];
+    if(c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    WriteRaw(value.data()+start, i-start);
+    start = i+1;
+    switch(c) {
+      case '"':  WriteRaw("\\\"", 2); break;
+      case '\\': WriteRaw("\\\\", 2); break;
+      case '\n': WriteRaw("\\n", 2);  break;
+      case '\r': WriteRaw("\\r", 2);  break;
+      case '\t': WriteRaw("\\t", 2);  break;
+      default: {
+        char escaped[6] = { '\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xf] };
+        WriteRaw(escaped, 6);
+      }
+    }
+  }
+  WriteRaw(value.data()+start, value.size()-start);
+  WriteRaw("\"", 1);
+}
+
+void JsonStreamWriter::WriteDouble(double value) {
+  if(!std::isfinite(value)) {
+    WriteRaw("null", 4);
+    return;
+  }
+
+  // Formatted in place, so a number is never split across two buffers.
+  Reserve(MAX_DOUBLE_LENGTH);
+  Commit(FormatDouble(value, m_buffer->GetEnd()));
+}
+
+void JsonStreamWriter::WriteInteger(long value) {
+  Reserve(MAX_DOUBLE_LENGTH);
+  Commit(std::snprintf(m_buffer->GetEnd(), MAX_DOUBLE_LENGTH, "%ld", value));
+}
+
+std::string JsonStreamWriter::WriteToString(const std::function<void(JsonStreamWriter&)>& write) {
+  std::string text;
+  JsonStreamWriter writer(OutputBufferPool::GetSharedInstance(),
+                          [&text](const OutputBufferPtr& buffer) { text.append(buffer->GetData(), buffer->GetSize()); });
+  write(writer);
+  writer.Flush();
+  return text;
+}
+
+int JsonStreamWriter::FormatDouble(double value, char* buffer) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  std::to_chars_result result = std::to_chars(buffer, buffer+MAX_DOUBLE_LENGTH, value);
+  return (int) (result.ptr-buffer);
+#else
+  return FormatDoubleByPrecision(value, buffer);
+#endif
+}
+
+int JsonStreamWriter::FormatDoubleByPrecision(double value, char* buffer) {
+  // Add significant digits until the text reads back as value. A decimal of 15 or
+  // fewer digits survives the trip through a double, so if value has one %.15g
+  // finds it, with %g dropping the trailing zeros. 17 digits always read back exactly.
+  int length = 0;
+  for(int precision=15; precision<=17; precision++) {
+    length = std::snprintf(buffer, MAX_DOUBLE_LENGTH, "%.*g", precision, value);
+    if(precision == 17 || std::strtod(buffer, NULL) == value) {
+      break;
+    }
+  }
+  return length;
+}
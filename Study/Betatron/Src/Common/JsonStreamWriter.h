@@ -0,0 +1,71 @@
+/**********************************************************************
+
+File     : JsonStreamWriter.h
+Project  : Bach Betatron Library
+Purpose  : Header file for a JSON writer that streams into pooled output buffers.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Text is written straight into OutputBuffers from a pool. Each
+           buffer is handed on as soon as it is full, so a large result can
+           be sent while the rest of it is still being written, and nothing
+           is ever copied into one contiguous string.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_JSON_STREAM_WRITER_H__
+#define __BACH_JSON_STREAM_WRITER_H__
+
+#include "BachDefs.h"
+#include "OutputBufferPool.h"
+#include <cstring>
+#include <functional>
+#include <string>
+
+namespace Bach {
+
+  //********************
+  //* JsonStreamWriter *
+  //********************
+
+  class JsonStreamWriter : public OutputBufferWriter {
+  public:
+    // Enough for any double written by FormatDouble, sign and exponent included.
+    static const int MAX_DOUBLE_LENGTH = 32;
+
+    static boost::shared_ptr<JsonStreamWriter> CreateInstance(const boost::shared_ptr<OutputBufferPool>& pool,
+                                                              const BufferHandler& handler);
+
+    // Text that is already JSON, such as punctuation and member names known to need no escaping.
+    void WriteRaw(const char* text, size_t length) { WriteBytes(text, length); }
+    void WriteRaw(const char* text) { WriteRaw(text, std::strlen(text)); }
+    void WriteRaw(const std::string& text) { WriteRaw(text.data(), text.size()); }
+
+    // A quoted JSON string, escaped as needed.
+    void WriteString(const std::string& value);
+
+    // The shortest number that reads back as exactly value. JSON has no infinities
+    // or NaNs, so those are written as null.
+    void WriteDouble(double value);
+
+    void WriteInteger(long value);
+
+    // Run write on a writer whose buffers are joined into the returned string.
+    static std::string WriteToString(const std::function<void(JsonStreamWriter&)>& write);
+
+    // Write the shortest decimal form of value that parses back to the same double
+    // into buffer, which must hold MAX_DOUBLE_LENGTH characters. Returns the length.
+    static int FormatDouble(double value, char* buffer);
+
+    // FormatDouble's fallback where std::to_chars is missing, built everywhere so that
+    // it can be tested. The text reads back exactly but isn't always the shortest.
+    static int FormatDoubleByPrecision(double value, char* buffer);
+
+  protected:
+    JsonStreamWriter(const boost::shared_ptr<OutputBufferPool>& pool, const BufferHandler& handler);
+  };
+};
+
+#endif // __BACH_JSON_STREAM_WRITER_H__
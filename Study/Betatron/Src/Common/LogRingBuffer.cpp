@@ -0,0 +1,204 @@
+/**********************************************************************
+
+File     : LogRingBuffer.cpp
+Project  : Bach Betatron Library
+Purpose  : Source file for the queue behind leveled logging.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "LogRingBuffer.h"
+#include <chrono>
+#include <cstdio>
+#include <cwchar>
+
+using namespace Bach;
+using namespace boost;
+
+namespace {
+  const int FORMAT_LENGTH = 512;
+
+  // How long the drain thread sleeps when the ring is empty.
+  const std::chrono::milliseconds IDLE_WAIT(1);
+
+  // Log format strings take a wide string for %s, which vswprintf calls %ls. Flags, width and
+  // precision may come between, as in %-20s or %*.*s.
+  const wchar_t* WidenStringConversions(const wchar_t* formatString, wchar_t* buffer) {
+    if(wcschr(formatString, L's') == NULL) {
+      return formatString;
+    }
+    int length = 0;
+    for(const wchar_t* c=formatString; *c != L'\0' && length < FORMAT_LENGTH-2; c++) {
+      buffer[length++] = *c;
+      if(*c != L'%') {
+        continue;
+      }
+      if(*(c+1) == L'%') {
+        buffer[length++] = *(++c);
+        continue;
+      }
+      while(*(c+1) != L'\0' && wcschr(L"-+ #0123456789.*", *(c+1)) != NULL && length < FORMAT_LENGTH-2) {
+        buffer[length++] = *(++c);
+      }
+      if(*(c+1) == L's') {
+        buffer[length++] = L'l';
+      }
+    }
+    buffer[length] = L'\0';
+    return buffer;
+  }
+}
+
+void Bach::LogAtLevel(LogLevel level, const wchar_t* formatString, ...) {
+  shared_ptr<LogRingBuffer> ring = LogRingBuffer::GetSharedInstance();
+  va_list vaArgs;
+  va_start(vaArgs, formatString);
+  if(level != LogLevelError) {
+    ring->Push(level, formatString, vaArgs);
+    va_end(vaArgs);
+    return;
+  }
+
+  // An error is almost always followed by a throw, and if nothing catches it the process
+  // ends without the drain thread writing what explains it. So it is written before
+  // returning, and queued again once there's room if the ring was full.
+  va_list retryArgs;
+  va_copy(retryArgs, vaArgs);
+  if(!ring->Push(level, formatString, vaArgs)) {
+    ring->Flush();
+    ring->Push(level, formatString, retryArgs);
+  }
+  ring->Flush();
+  va_end(retryArgs);
+  va_end(vaArgs);
+}
+
+  //*****************
+  //* LogRingBuffer *
+  //*****************
+
+shared_ptr<LogRingBuffer> LogRingBuffer::GetSharedInstance() {
+  static shared_ptr<LogRingBuffer> s_sharedInstance(new LogRingBuffer());
+  return s_sharedInstance;
+}
+
+LogRingBuffer::LogRingBuffer() :
+  m_enqueuePosition(0),
+  m_dequeuePosition(0),
+  m_numberDropped(0),
+  m_numberDroppedReported(0),
+  m_stopping(false)
+{
+  for(size_t i=0; i<CAPACITY; i++) {
+    m_slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  m_drainThread = std::thread(&LogRingBuffer::Drain, this);
+}
+
+LogRingBuffer::~LogRingBuffer() {
+  m_stopping = true;
+  m_drainThread.join();
+}
+
+void LogRingBuffer::SetSink(shared_ptr<ILog> sink) {
+  m_sink = sink;
+}
+
+bool LogRingBuffer::Push(LogLevel level, const wchar_t* formatString, va_list vaList) {
+  // Claim the slot at the enqueue position, unless the drain thread hasn't emptied it yet.
+  size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+  Slot* slot;
+  for(;;) {
+    slot = &m_slots[position & (CAPACITY-1)];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    ptrdiff_t difference = (ptrdiff_t) sequence-(ptrdiff_t) position;
+    if(difference == 0) {
+      if(m_enqueuePosition.compare_exchange_weak(position, position+1, std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    else if(difference < 0) {
+      m_numberDropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    else {
+      position = m_enqueuePosition.load(std::memory_order_relaxed);
+    }
+  }
+
+  FormatMessage(slot->message, formatString, vaList);
+  slot->level = level;
+  slot->sequence.store(position+1, std::memory_order_release);
+  return true;
+}
+
+void LogRingBuffer::FormatMessage(wchar_t* message, const wchar_t* formatString, va_list vaList) {
+  wchar_t format[FORMAT_LENGTH];
+  if(vswprintf(message, MESSAGE_LENGTH, WidenStringConversions(formatString, format), vaList) < 0) {
+    // Too long, or a bad conversion; vswprintf leaves it unterminated.
+    message[MESSAGE_LENGTH-1] = L'\0';
+  }
+}
+
+void LogRingBuffer::Flush() {
+  size_t end = m_enqueuePosition.load(std::memory_order_acquire);
+  while(m_dequeuePosition.load(std::memory_order_acquire) < end) {
+    std::this_thread::yield();
+  }
+}
+
+void LogRingBuffer::Drain() {
+  for(;;) {
+    if(WriteNext()) {
+      continue;
+    }
+    if(m_stopping) {
+      // Whatever is left, then stop.
+      while(WriteNext()) {}
+      return;
+    }
+    std::this_thread::sleep_for(IDLE_WAIT);
+  }
+}
+
+bool LogRingBuffer::WriteNext() {
+  size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+  Slot& slot = m_slots[position & (CAPACITY-1)];
+  if(slot.sequence.load(std::memory_order_acquire) != position+1) {
+    return false;
+  }
+  Write(slot.level, slot.message);
+  slot.sequence.store(position+CAPACITY, std::memory_order_release);
+  m_dequeuePosition.store(position+1, std::memory_order_release);
+
+  unsigned long numberDropped = m_numberDropped.load(std::memory_order_relaxed);
+  if(numberDropped != m_numberDroppedReported) {
+    wchar_t message[MESSAGE_LENGTH];
+    swprintf(message, MESSAGE_LENGTH, L"LogRingBuffer: %lu messages dropped with the ring full", numberDropped-m_numberDroppedReported);
+    m_numberDroppedReported = numberDropped;
+    Write(LogLevelWarning, message);
+  }
+  return true;
+}
+
+void LogRingBuffer::Write(LogLevel level, const wchar_t* message) {
+  const wchar_t* prefix = L"";
+  switch(level) {
+    case LogLevelError :   prefix = L"ERROR: ";   break;
+    case LogLevelWarning : prefix = L"WARNING: "; break;
+    default : break;
+  }
+
+  if(m_sink) {
+    std::wstring text(prefix);
+    text.append(message);
+    m_sink->Write(text.c_str());
+  }
+  else {
+    fwprintf(stderr, L"%ls%ls\n", prefix, message);
+  }
+}
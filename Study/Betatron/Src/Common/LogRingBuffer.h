@@ -0,0 +1,94 @@
+/**********************************************************************
+
+File     : LogRingBuffer.h
+Project  : Bach Betatron Library
+Purpose  : Header file for the queue behind leveled logging.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           BACH_LOG_ERROR and the other level macros in BachDefs.h format
+           the message on the calling thread into a slot of a fixed size
+           ring and return. A background thread takes messages off the ring
+           and writes them to the sink, so an integrator that logs never
+           waits on a lock or on I/O. Any number of threads can log at once;
+           the ring is the bounded multiple producer queue of Dmitry Vyukov,
+           with a sequence number per slot. When it is full a message is
+           dropped and counted rather than waited for, and the count is
+           written out once there's room.
+
+           Errors are flushed before LogAtLevel returns, as an uncaught
+           throw after one ends the process without the drain thread.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_LOG_RING_BUFFER_H__
+#define __BACH_LOG_RING_BUFFER_H__
+
+#include "BachDefs.h"
+#include <atomic>
+#include <cstdarg>
+#include <thread>
+
+namespace Bach {
+
+  //*****************
+  //* LogRingBuffer *
+  //*****************
+
+  class LogRingBuffer {
+  public:
+    static const int CAPACITY = 512;        // A power of two.
+    static const int MESSAGE_LENGTH = 512;  // Longer messages are cut short, as Log does.
+
+    // One ring shared by the whole process, created on first use.
+    static boost::shared_ptr<LogRingBuffer> GetSharedInstance();
+
+    ~LogRingBuffer();
+
+    // Format a message, %s taking a wide string as for Log, and queue it. Returns false if the
+    // ring was full and the message was dropped.
+    bool Push(LogLevel level, const wchar_t* formatString, va_list vaList);
+
+    // Format a message into one of MESSAGE_LENGTH characters, %s taking a wide string as for
+    // Log. One too long is cut short.
+    static void FormatMessage(wchar_t* message, const wchar_t* formatString, va_list vaList);
+
+    // Where messages are written, stderr by default.
+    void SetSink(boost::shared_ptr<ILog> sink);
+
+    // Wait until every message queued before the call has been written.
+    void Flush();
+
+    unsigned long GetNumberDropped() const { return m_numberDropped.load(std::memory_order_relaxed); }
+
+  protected:
+    struct Slot {
+      std::atomic<size_t> sequence;
+      LogLevel level;
+      wchar_t message[MESSAGE_LENGTH];
+    };
+
+    LogRingBuffer();
+
+    void Drain();
+    bool WriteNext();
+    void Write(LogLevel level, const wchar_t* message);
+
+    Slot m_slots[CAPACITY];
+    std::atomic<size_t> m_enqueuePosition;
+    std::atomic<size_t> m_dequeuePosition;   // Only moved by the drain thread.
+    std::atomic<unsigned long> m_numberDropped;
+    unsigned long m_numberDroppedReported;
+
+    // Set before the first message is written; SetSink is for start up.
+    boost::shared_ptr<ILog> m_sink;
+
+    std::atomic<bool> m_stopping;
+    std::thread m_drainThread;
+  };
+};
+
+#endif // __BACH_LOG_RING_BUFFER_H__
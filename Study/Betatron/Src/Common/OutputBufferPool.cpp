@@ -0,0 +1,169 @@
+/**********************************************************************
+
+File     : OutputBufferPool.cpp
+Project  : Bach Betatron Library
+Purpose  : Source file for a pool of reusable fixed capacity output buffers,
+           and the base of the writers that fill them.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "OutputBufferPool.h"
+
+using namespace Bach;
+using namespace boost;
+
+size_t Bach::GetChainSize(const OutputBufferChain& chain) {
+  size_t size = 0;
+  for(size_t i=0; i<chain.size(); i++) {
+    size += chain[i]->GetSize();
+  }
+  return size;
+}
+
+size_t Bach::GetChainCapacity(const OutputBufferChain& chain) {
+  size_t capacity = 0;
+  for(size_t i=0; i<chain.size(); i++) {
+    capacity += chain[i]->GetCapacity();
+  }
+  return capacity;
+}
+
+std::string Bach::ChainToString(const OutputBufferChain& chain) {
+  std::string joined;
+  joined.reserve(GetChainSize(chain));
+  for(size_t i=0; i<chain.size(); i++) {
+    joined.append(chain[i]->GetData(), chain[i]->GetSize());
+  }
+  return joined;
+}
+
+  //******************************
+  //* OutputBufferPool::Recycler *
+  //******************************
+
+// The deleter of every buffer handed out. It holds the pool weakly so that buffers
+// still referenced when the pool goes away are simply deleted.
+class OutputBufferPool::Recycler {
+public:
+  Recycler(const shared_ptr<OutputBufferPool>& pool) : m_pool(pool) {}
+
+  void operator()(OutputBuffer* buffer) {
+    shared_ptr<OutputBufferPool> pool = m_pool.lock();
+    if(pool) {
+      pool->Recycle(buffer);
+    }
+    else {
+      delete buffer;
+    }
+  }
+
+private:
+  weak_ptr<OutputBufferPool> m_pool;
+};
+
+  //********************
+  //* OutputBufferPool *
+  //********************
+
+shared_ptr<OutputBufferPool> OutputBufferPool::CreateInstance(size_t bufferCapacity, size_t maximumFreeBuffers) {
+  shared_ptr<OutputBufferPool> instance(new OutputBufferPool(bufferCapacity, maximumFreeBuffers));
+  return instance;
+}
+
+shared_ptr<OutputBufferPool> OutputBufferPool::GetSharedInstance() {
+  static shared_ptr<OutputBufferPool> s_sharedInstance = CreateInstance();
+  return s_sharedInstance;
+}
+
+OutputBufferPool::OutputBufferPool(size_t bufferCapacity, size_t maximumFreeBuffers) :
+  m_bufferCapacity(bufferCapacity > 0 ? bufferCapacity : DEFAULT_BUFFER_CAPACITY),
+  m_maximumFreeBuffers(maximumFreeBuffers),
+  m_numberOfAllocations(0) {
+}
+
+OutputBufferPool::~OutputBufferPool() {
+  for(size_t i=0; i<m_freeBuffers.size(); i++) {
+    delete m_freeBuffers[i];
+  }
+}
+
+OutputBufferPtr OutputBufferPool::Acquire() {
+  OutputBuffer* buffer = NULL;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(!m_freeBuffers.empty()) {
+      buffer = m_freeBuffers.back();
+      m_freeBuffers.pop_back();
+    }
+    else {
+      m_numberOfAllocations++;
+    }
+  }
+
+  if(buffer == NULL) {
+    buffer = new OutputBuffer(m_bufferCapacity);
+  }
+  return OutputBufferPtr(buffer, Recycler(shared_from_this()));
+}
+
+void OutputBufferPool::Recycle(OutputBuffer* buffer) {
+  buffer->Clear();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_freeBuffers.size() < m_maximumFreeBuffers) {
+      m_freeBuffers.push_back(buffer);
+      return;
+    }
+  }
+  delete buffer;
+}
+
+size_t OutputBufferPool::GetNumberOfFreeBuffers() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_freeBuffers.size();
+}
+
+size_t OutputBufferPool::GetNumberOfAllocations() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_numberOfAllocations;
+}
+
+  //**********************
+  //* OutputBufferWriter *
+  //**********************
+
+OutputBufferWriter::OutputBufferWriter(const shared_ptr<OutputBufferPool>& pool, const BufferHandler& handler) :
+  m_pool(pool),
+  m_handler(handler),
+  m_numberOfBytesWritten(0) {
+}
+
+void OutputBufferWriter::WriteBytes(const void* data, size_t length) {
+  const char* bytes = (const char*) data;
+  m_numberOfBytesWritten += length;
+  while(length > 0) {
+    Reserve(1);
+    size_t part = (length < m_buffer->GetAvailable() ? length : m_buffer->GetAvailable());
+    m_buffer->Append(bytes, part);
+    bytes += part;
+    length -= part;
+  }
+}
+
+void OutputBufferWriter::StartBuffer() {
+  Flush();
+  m_buffer = m_pool->Acquire();
+}
+
+void OutputBufferWriter::Flush() {
+  if(m_buffer && m_buffer->GetSize() > 0) {
+    OutputBufferPtr full = m_buffer;
+    m_buffer.reset();
+    m_handler(full);
+  }
+}
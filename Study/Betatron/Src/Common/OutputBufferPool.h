@@ -0,0 +1,158 @@
+/**********************************************************************
+
+File     : OutputBufferPool.h
+Project  : Bach Betatron Library
+Purpose  : Header file for a pool of reusable fixed capacity output buffers,
+           and the base of the writers that fill them.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Serialized results are written into a chain of these buffers
+           rather than one growing string. A buffer goes back to its pool
+           when the last reference to it is released, so a response that
+           has been sent, or a cache entry that has been evicted, hands its
+           memory to the next response.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_OUTPUT_BUFFER_POOL_H__
+#define __BACH_OUTPUT_BUFFER_POOL_H__
+
+#include "BachDefs.h"
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace Bach {
+
+  //****************
+  //* OutputBuffer *
+  //****************
+
+  class OutputBuffer {
+  public:
+    const char* GetData() const { return &m_storage[0]; }
+    size_t GetSize() const { return m_size; }
+    size_t GetCapacity() const { return m_storage.size(); }
+    size_t GetAvailable() const { return m_storage.size()-m_size; }
+
+    // Copy length bytes to the end, which must be no more than GetAvailable().
+    void Append(const char* data, size_t length) {
+      std::memcpy(&m_storage[m_size], data, length);
+      m_size += length;
+    }
+
+    // The unused space, for writing into directly before calling Commit.
+    char* GetEnd() { return &m_storage[m_size]; }
+    void Commit(size_t length) { m_size += length; }
+
+    void Clear() { m_size = 0; }
+
+  protected:
+    friend class OutputBufferPool;
+
+    OutputBuffer(size_t capacity) : m_storage(capacity), m_size(0) {}
+
+    std::vector<char> m_storage;
+    size_t m_size;
+  };
+
+  typedef boost::shared_ptr<OutputBuffer> OutputBufferPtr;
+  typedef std::vector<OutputBufferPtr> OutputBufferChain;
+
+  // The bytes held by a chain, and the chain's contents joined into one string.
+  size_t GetChainSize(const OutputBufferChain& chain);
+  size_t GetChainCapacity(const OutputBufferChain& chain);
+  std::string ChainToString(const OutputBufferChain& chain);
+
+  //********************
+  //* OutputBufferPool *
+  //********************
+
+  class OutputBufferPool : public boost::enable_shared_from_this<OutputBufferPool> {
+  public:
+    static const size_t DEFAULT_BUFFER_CAPACITY = 64*1024;
+    static const size_t DEFAULT_MAXIMUM_FREE_BUFFERS = 64;
+
+    static boost::shared_ptr<OutputBufferPool> CreateInstance(size_t bufferCapacity = DEFAULT_BUFFER_CAPACITY,
+                                                              size_t maximumFreeBuffers = DEFAULT_MAXIMUM_FREE_BUFFERS);
+
+    // One pool shared by the whole process, created on first use.
+    static boost::shared_ptr<OutputBufferPool> GetSharedInstance();
+
+    ~OutputBufferPool();
+
+    // An empty buffer, reused if one is free. It returns to the pool when its last
+    // reference is released, or is deleted if the pool already holds enough free buffers.
+    OutputBufferPtr Acquire();
+
+    size_t GetBufferCapacity() const { return m_bufferCapacity; }
+    size_t GetNumberOfFreeBuffers() const;
+
+    // Buffers allocated since creation, as opposed to reused.
+    size_t GetNumberOfAllocations() const;
+
+  protected:
+    class Recycler;
+
+    OutputBufferPool(size_t bufferCapacity, size_t maximumFreeBuffers);
+
+    void Recycle(OutputBuffer* buffer);
+
+    size_t m_bufferCapacity;
+    size_t m_maximumFreeBuffers;
+
+    mutable std::mutex m_mutex;
+    std::vector<OutputBuffer*> m_freeBuffers;
+    size_t m_numberOfAllocations;
+  };
+
+  //**********************
+  //* OutputBufferWriter *
+  //**********************
+
+  // Fills buffers from a pool and hands each one on once it is full.
+  class OutputBufferWriter {
+  public:
+    // Receives each buffer once it is full, and the last one from Flush.
+    typedef std::function<void(const OutputBufferPtr&)> BufferHandler;
+
+    virtual ~OutputBufferWriter() {}
+
+    void WriteBytes(const void* data, size_t length);
+
+    // Hand on the partly filled buffer, if it holds anything.
+    void Flush();
+
+    size_t GetNumberOfBytesWritten() const { return m_numberOfBytesWritten; }
+
+  protected:
+    OutputBufferWriter(const boost::shared_ptr<OutputBufferPool>& pool, const BufferHandler& handler);
+
+    // Make sure the current buffer has at least length bytes free, for writing
+    // directly into its end. length must not exceed the pool's buffer capacity.
+    void Reserve(size_t length) {
+      if(!m_buffer || m_buffer->GetAvailable() < length) {
+        StartBuffer();
+      }
+    }
+
+    // Count length bytes written at the end of the current buffer.
+    void Commit(size_t length) {
+      m_buffer->Commit(length);
+      m_numberOfBytesWritten += length;
+    }
+
+    void StartBuffer();
+
+    boost::shared_ptr<OutputBufferPool> m_pool;
+    BufferHandler m_handler;
+    OutputBufferPtr m_buffer;
+    size_t m_numberOfBytesWritten;
+  };
+};
+
+#endif // __BACH_OUTPUT_BUFFER_POOL_H__
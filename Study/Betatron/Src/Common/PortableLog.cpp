@@ -0,0 +1,64 @@
+/**********************************************************************
+
+File     : PortableLog.cpp
+Project  : Bach Betatron Library
+Purpose  : Source file for a log that builds with any C++ compiler.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "PortableLog.h"
+#include "LogRingBuffer.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cwchar>
+
+using namespace Bach;
+using namespace boost;
+
+  //*********************
+  //* Bach::PortableLog *
+  //*********************
+
+shared_ptr<ILog> PortableLog::CreateInstance() {
+  static shared_ptr<ILog> s_sharedInstance(new PortableLog());
+  return s_sharedInstance;
+}
+
+PortableLog::PortableLog() {
+}
+
+PortableLog::~PortableLog() {
+}
+
+void PortableLog::Write(const wchar_t* message) {
+  std::fwprintf(stderr, L"%ls\n", message);
+}
+
+void PortableLog::WritePlain(const wchar_t* message) {
+  std::fwprintf(stderr, L"%ls", message);
+}
+
+void Bach::Log(const wchar_t* formatString, ...) {
+  va_list vaArgs;
+  va_start(vaArgs, formatString);
+  LogVaArgs(formatString, vaArgs);
+  va_end(vaArgs);
+}
+
+void Bach::LogPlain(const wchar_t* formatString, ...) {
+  va_list vaArgs;
+  va_start(vaArgs, formatString);
+  LogVaArgs(formatString, vaArgs);
+  va_end(vaArgs);
+}
+
+void Bach::LogVaArgs(const wchar_t* formatString, va_list vaList) {
+  wchar_t message[LogRingBuffer::MESSAGE_LENGTH];
+  LogRingBuffer::FormatMessage(message, formatString, vaList);
+  PortableLog::CreateInstance()->Write(message);
+}
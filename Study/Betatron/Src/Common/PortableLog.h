@@ -0,0 +1,43 @@
+/**********************************************************************
+
+File     : PortableLog.h
+Project  : Bach Betatron Library
+Purpose  : Header file for a log that builds with any C++ compiler.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           AppleLog.mm and AppleStringUtilities.mm need Foundation, so the
+           CMake build links this log and PortableStringUtilities.cpp in
+           their place. It defines the same Log functions and, as AppleLog,
+           writes each message to stderr. Only one of the two may be linked.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_PORTABLE_LOG_H__
+#define __BACH_PORTABLE_LOG_H__
+
+#include "BachDefs.h"
+
+namespace Bach {
+
+  //*********************
+  //* Bach::PortableLog *
+  //*********************
+
+  class PortableLog : public ILog {
+  public:
+    static boost::shared_ptr<ILog> CreateInstance();
+
+    virtual ~PortableLog();
+
+    virtual void Write(const wchar_t* message);
+    virtual void WritePlain(const wchar_t* message);
+
+  protected:
+    PortableLog();
+  };
+};
+
+#endif // __BACH_PORTABLE_LOG_H__
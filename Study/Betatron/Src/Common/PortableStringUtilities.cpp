@@ -0,0 +1,90 @@
+/**********************************************************************
+
+File     : PortableStringUtilities.cpp
+Project  : Bach Betatron Library
+Purpose  : Source file for the string conversions used with PortableLog.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The conversions of AppleStringUtilities.mm without Foundation.
+           A wchar_t holds a whole code point on Linux and macOS, so wide
+           strings are UTF-32 and there are no surrogate pairs to handle.
+           Bytes that aren't valid UTF-8 become U+FFFD.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BachDefs.h"
+
+using namespace Bach;
+
+namespace {
+  const wchar_t REPLACEMENT_CHARACTER = 0xfffd;
+}
+
+std::wstring Bach::WideStringFromUTF8(const std::string& in) {
+  std::wstring out;
+  out.reserve(in.size());
+  size_t i = 0;
+  while(i < in.size()) {
+    unsigned char lead = (unsigned char) in[i++];
+    if(lead < 0x80) {
+      out.push_back((wchar_t) lead);
+      continue;
+    }
+
+    int length;
+    unsigned long code;
+    if((lead & 0xe0) == 0xc0) {
+      length = 1;
+      code = lead & 0x1f;
+    }
+    else if((lead & 0xf0) == 0xe0) {
+      length = 2;
+      code = lead & 0x0f;
+    }
+    else if((lead & 0xf8) == 0xf0) {
+      length = 3;
+      code = lead & 0x07;
+    }
+    else {
+      out.push_back(REPLACEMENT_CHARACTER);
+      continue;
+    }
+
+    int j = 0;
+    for(; j<length && i<in.size() && (in[i] & 0xc0) == 0x80; j++) {
+      code = (code << 6) | (in[i++] & 0x3f);
+    }
+    out.push_back(j == length ? (wchar_t) code : REPLACEMENT_CHARACTER);
+  }
+  return out;
+}
+
+std::string Bach::UTF8FromWideString(const std::wstring& in) {
+  std::string out;
+  out.reserve(in.size());
+  for(size_t i=0; i<in.size(); i++) {
+    unsigned long code = (unsigned long) in[i];
+    if(code < 0x80) {
+      out.push_back((char) code);
+    }
+    else if(code < 0x800) {
+      out.push_back((char) (0xc0 | (code >> 6)));
+      out.push_back((char) (0x80 | (code & 0x3f)));
+    }
+    else if(code < 0x10000) {
+      out.push_back((char) (0xe0 | (code >> 12)));
+      out.push_back((char) (0x80 | ((code >> 6) & 0x3f)));
+      out.push_back((char) (0x80 | (code & 0x3f)));
+    }
+    else {
+      out.push_back((char) (0xf0 | (code >> 18)));
+      out.push_back((char) (0x80 | ((code >> 12) & 0x3f)));
+      out.push_back((char) (0x80 | ((code >> 6) & 0x3f)));
+      out.push_back((char) (0x80 | (code & 0x3f)));
+    }
+  }
+  return out;
+}
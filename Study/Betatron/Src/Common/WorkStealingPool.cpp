@@ -0,0 +1,219 @@
+/**********************************************************************
+
+File     : WorkStealingPool.cpp
+Project  : Bach Betatron Library
+Purpose  : Source file for a work stealing thread pool.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "WorkStealingPool.h"
+
+using namespace Bach;
+using namespace boost;
+
+namespace {
+  // Lets Submit and GetWorkerIndex tell which pool, if any, the calling thread works for.
+  thread_local const WorkStealingPool* t_workerPool = NULL;
+  thread_local int t_workerIndex = -1;
+}
+
+  //********************
+  //* WorkStealingPool *
+  //********************
+
+shared_ptr<WorkStealingPool> WorkStealingPool::CreateInstance(int numThreads) {
+  if(numThreads <= 0) {
+    numThreads = (int) std::thread::hardware_concurrency();
+    numThreads = (numThreads > 0 ? numThreads : 1);
+  }
+  shared_ptr<WorkStealingPool> instance(new WorkStealingPool(numThreads));
+  return instance;
+}
+
+shared_ptr<WorkStealingPool> WorkStealingPool::GetSharedInstance() {
+  static shared_ptr<WorkStealingPool> s_sharedInstance = CreateInstance();
+  return s_sharedInstance;
+}
+
+WorkStealingPool::WorkStealingPool(int numThreads) :
+  m_numQueued(0),
+  m_numPending(0),
+  m_nextQueue(0),
+  m_stopping(false)
+{
+  for(int i=0; i<numThreads; i++) {
+    m_queues.push_back(new WorkerQueue());
+  }
+  for(int i=0; i<numThreads; i++) {
+    m_threads.push_back(std::thread(&WorkStealingPool::RunWorker, this, i));
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_workAvailable.notify_all();
+
+  for(size_t i=0; i<m_threads.size(); i++) {
+    m_threads[i].join();
+  }
+  for(size_t i=0; i<m_queues.size(); i++) {
+    delete m_queues[i];
+  }
+}
+
+int WorkStealingPool::GetWorkerIndex() const {
+  return (t_workerPool == this ? t_workerIndex : -1);
+}
+
+void WorkStealingPool::Submit(const Task& task) {
+  int index = GetWorkerIndex();
+  if(index < 0) {
+    index = (int) (m_nextQueue++ % m_queues.size());
+  }
+
+  m_numPending++;
+  {
+    std::lock_guard<std::mutex> queueLock(m_queues[index]->mutex);
+    m_queues[index]->tasks.push_back(task);
+  }
+  {
+    // Taken so that a worker cannot miss the notification between checking and waiting.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_numQueued++;
+  }
+  m_workAvailable.notify_one();
+}
+
+void WorkStealingPool::Wait() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_allDone.wait(lock, [this] { return m_numPending == 0; });
+
+  if(m_firstException) {
+    std::exception_ptr exception = m_firstException;
+    m_firstException = std::exception_ptr();
+    std::rethrow_exception(exception);
+  }
+}
+
+void WorkStealingPool::ParallelFor(int count, const std::function<void(int)>& body) {
+  std::mutex mutex;
+  std::condition_variable done;
+  int remaining = count;
+  std::exception_ptr firstException;
+
+  for(int i=0; i<count; i++) {
+    Submit([&, i] {
+      std::exception_ptr exception;
+      try {
+        body(i);
+      }
+      catch(...) {
+        exception = std::current_exception();
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      if(exception && !firstException) {
+        firstException = exception;
+      }
+      if(--remaining == 0) {
+        done.notify_all();
+      }
+    });
+  }
+
+  // Help with the queued work rather than block, so a task may itself call ParallelFor.
+  int index = GetWorkerIndex();
+  Task task;
+  while((index >= 0 && PopTask(index, task)) || StealTask(index, task)) {
+    RunTask(task);
+    std::lock_guard<std::mutex> lock(mutex);
+    if(remaining == 0) {
+      break;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [&remaining] { return remaining == 0; });
+  if(firstException) {
+    std::rethrow_exception(firstException);
+  }
+}
+
+void WorkStealingPool::RunWorker(int index) {
+  t_workerPool = this;
+  t_workerIndex = index;
+
+  Task task;
+  for(;;) {
+    if(PopTask(index, task) || StealTask(index, task)) {
+      RunTask(task);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_workAvailable.wait(lock, [this] { return m_stopping || m_numQueued > 0; });
+    if(m_stopping && m_numQueued == 0) {
+      return;
+    }
+  }
+}
+
+void WorkStealingPool::RunTask(Task& task) {
+  try {
+    task();
+  }
+  catch(...) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(!m_firstException) {
+      m_firstException = std::current_exception();
+    }
+  }
+  task = Task();
+
+  if(--m_numPending == 0) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_allDone.notify_all();
+  }
+}
+
+bool WorkStealingPool::PopTask(int index, Task& task) {
+  // The newest task on our own queue is the one most likely to still be in cache.
+  WorkerQueue* queue = m_queues[index];
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  if(queue->tasks.empty()) {
+    return false;
+  }
+  task = queue->tasks.back();
+  queue->tasks.pop_back();
+  m_numQueued--;
+  return true;
+}
+
+bool WorkStealingPool::StealTask(int index, Task& task) {
+  // Start with the next worker along so that thieves spread over the queues.
+  int numQueues = (int) m_queues.size();
+  for(int i=0; i<numQueues; i++) {
+    int victim = (index+1+i) % numQueues;
+    if(victim == index) {
+      continue;
+    }
+
+    WorkerQueue* queue = m_queues[victim];
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if(!queue->tasks.empty()) {
+      task = queue->tasks.front();
+      queue->tasks.pop_front();
+      m_numQueued--;
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,89 @@
+/**********************************************************************
+
+File     : WorkStealingPool.h
+Project  : Bach Betatron Library
+Purpose  : Header file for a work stealing thread pool.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Each worker has its own queue. Tasks submitted from a worker go
+           on that worker's queue, other tasks are spread round robin, and
+           a worker with nothing to do takes the oldest task from another.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_WORK_STEALING_POOL_H__
+#define __BACH_WORK_STEALING_POOL_H__
+
+#include "BachDefs.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Bach {
+
+  //********************
+  //* WorkStealingPool *
+  //********************
+
+  class WorkStealingPool {
+  public:
+    typedef std::function<void()> Task;
+
+    // A numThreads of zero uses one thread per hardware thread.
+    static boost::shared_ptr<WorkStealingPool> CreateInstance(int numThreads = 0);
+
+    // One pool shared by the whole process, created on first use.
+    static boost::shared_ptr<WorkStealingPool> GetSharedInstance();
+
+    ~WorkStealingPool();
+
+    void Submit(const Task& task);
+
+    // Block until every submitted task has run. Rethrows the first exception a task threw.
+    void Wait();
+
+    // Run body(0) to body(count-1) on the pool and wait for them all. The calling
+    // thread runs queued tasks while it waits, so this may be called from a task.
+    void ParallelFor(int count, const std::function<void(int)>& body);
+
+    int GetNumberOfThreads() const { return (int) m_threads.size(); }
+
+    // The index of the calling worker in this pool, or -1 when called from another thread.
+    int GetWorkerIndex() const;
+
+  protected:
+    struct WorkerQueue {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+
+    WorkStealingPool(int numThreads);
+
+    void RunWorker(int index);
+    bool PopTask(int index, Task& task);
+    bool StealTask(int index, Task& task);
+    void RunTask(Task& task);
+
+    std::vector<WorkerQueue*> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_workAvailable;
+    std::condition_variable m_allDone;
+    std::atomic<int> m_numQueued;   // Tasks sitting in a queue.
+    std::atomic<int> m_numPending;  // Tasks submitted and not yet finished.
+    std::atomic<unsigned int> m_nextQueue;
+    std::exception_ptr m_firstException;
+    bool m_stopping;
+  };
+};
+
+#endif // __BACH_WORK_STEALING_POOL_H__
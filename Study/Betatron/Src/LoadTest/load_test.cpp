@@ -0,0 +1,347 @@
+//
+// load_test.cpp
+// ~~~~~~~~~~~~~
+//
+// Measures how many requests per second the simulation server answers when
+// every request opens its own connection, when connections are kept alive
+// and when requests are pipelined on kept alive connections.
+//
+
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <asio.hpp>
+
+namespace {
+
+enum mode { close_each, keep_alive, pipelined };
+
+const char* mode_name(mode m)
+{
+  switch (m)
+  {
+  case close_each:
+    return "close";
+  case keep_alive:
+    return "keep-alive";
+  default:
+    return "pipelined";
+  }
+}
+
+struct options
+{
+  std::string host;
+  std::string port;
+  std::string target;
+  std::size_t connections;
+  std::size_t requests_per_connection;
+};
+
+std::string make_request(const options& opts, bool keep_alive)
+{
+  std::string request = "GET " + opts.target + " HTTP/1.1\r\n";
+  request += "Host: " + opts.host + "\r\n";
+  request += (keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n");
+  request += "\r\n";
+  return request;
+}
+
+/// Thrown when a response can not be framed, after which nothing more on the
+/// connection can be read.
+class framing_error : public std::runtime_error
+{
+public:
+  explicit framing_error(const std::string& what)
+    : std::runtime_error("misframed response: " + what)
+  {
+  }
+};
+
+bool iequals(const std::string& a, const std::string& b)
+{
+  if (a.size() != b.size())
+    return false;
+  for (std::size_t i = 0; i < a.size(); ++i)
+    if (std::tolower(static_cast<unsigned char>(a[i])) !=
+        std::tolower(static_cast<unsigned char>(b[i])))
+      return false;
+  return true;
+}
+
+/// Remove and return the first bytes of the streambuf.
+std::string take(asio::streambuf& input, std::size_t bytes)
+{
+  std::string text(asio::buffers_begin(input.data()),
+      asio::buffers_begin(input.data()) + bytes);
+  input.consume(bytes);
+  return text;
+}
+
+/// Read a line ending in CRLF, without the CRLF.
+std::string read_line(asio::ip::tcp::socket& socket, asio::streambuf& input)
+{
+  std::size_t bytes = asio::read_until(socket, input, "\r\n");
+  std::string line = take(input, bytes);
+  line.resize(line.size() - 2);
+  return line;
+}
+
+void read_bytes(asio::ip::tcp::socket& socket, asio::streambuf& input,
+    std::size_t bytes)
+{
+  if (input.size() < bytes)
+    asio::read(socket, input, asio::transfer_exactly(bytes - input.size()));
+}
+
+/// Parse a size of hex or decimal digits, all of the text up to any of the
+/// terminators.
+std::size_t parse_size(const std::string& text, int base,
+    const char* terminators)
+{
+  char* end = 0;
+  errno = 0;
+  unsigned long long size = std::strtoull(text.c_str(), &end, base);
+  if (text.empty() || end == text.c_str() || errno == ERANGE ||
+      (*end != '\0' && std::strchr(terminators, *end) == 0) ||
+      !std::isxdigit(static_cast<unsigned char>(text[0])))
+    throw framing_error("bad size \"" + text + "\"");
+  return static_cast<std::size_t>(size);
+}
+
+/// Read one response from the socket, leaving any bytes of the next one in
+/// the streambuf. The content is framed by chunked transfer coding, by its
+/// Content-Length or, on a connection that is closing, by the end of the
+/// stream. Returns false if the status was not 200 and throws framing_error
+/// if the response can not be framed.
+bool read_response(asio::ip::tcp::socket& socket, asio::streambuf& input)
+{
+  std::string status_line = read_line(socket, input);
+  if (status_line.compare(0, 7, "HTTP/1.") != 0 || status_line.size() < 12 ||
+      status_line[8] != ' ')
+    throw framing_error("bad status line \"" + status_line + "\"");
+  bool http_1_0 = (status_line[7] == '0');
+  bool ok = (status_line.compare(9, 3, "200") == 0);
+
+  bool chunked = false;
+  bool has_length = false;
+  bool closing = http_1_0;
+  std::size_t content_length = 0;
+  for (;;)
+  {
+    std::string line = read_line(socket, input);
+    if (line.empty())
+      break;
+    std::size_t colon = line.find(':');
+    if (colon == std::string::npos)
+      throw framing_error("bad header \"" + line + "\"");
+    std::string name = line.substr(0, colon);
+    std::size_t value_start = line.find_first_not_of(" \t", colon + 1);
+    std::string value =
+        (value_start == std::string::npos ? "" : line.substr(value_start));
+
+    if (iequals(name, "Content-Length"))
+    {
+      std::size_t length = parse_size(value, 10, "");
+      if (has_length && length != content_length)
+        throw framing_error("conflicting Content-Length headers");
+      has_length = true;
+      content_length = length;
+    }
+    else if (iequals(name, "Transfer-Encoding"))
+    {
+      if (!iequals(value, "chunked"))
+        throw framing_error("unsupported Transfer-Encoding " + value);
+      chunked = true;
+    }
+    else if (iequals(name, "Connection"))
+    {
+      closing = iequals(value, "close");
+    }
+  }
+
+  if (chunked)
+  {
+    // A chunked body's own framing wins over any Content-Length.
+    for (;;)
+    {
+      std::size_t size = parse_size(read_line(socket, input), 16, "; \t");
+      if (size == 0)
+        break;
+      read_bytes(socket, input, size + 2);
+      input.consume(size);
+      if (take(input, 2) != "\r\n")
+        throw framing_error("chunk not followed by CRLF");
+    }
+    // Trailers, if any, up to an empty line.
+    while (!read_line(socket, input).empty())
+      ;
+  }
+  else if (has_length)
+  {
+    read_bytes(socket, input, content_length);
+    input.consume(content_length);
+  }
+  else if (closing)
+  {
+    asio::error_code ec;
+    asio::read(socket, input, asio::transfer_all(), ec);
+    if (ec != asio::error::eof)
+      throw framing_error("content not ended by the connection closing: " +
+          ec.message());
+    input.consume(input.size());
+  }
+  else
+  {
+    throw framing_error("no length on a persistent connection");
+  }
+  return ok;
+}
+
+/// Send the requests of one client and return how many were answered with 200.
+std::size_t run_client(const options& opts, mode m)
+{
+  asio::io_service io_service;
+  asio::ip::tcp::resolver resolver(io_service);
+  asio::ip::tcp::resolver::iterator endpoints =
+      resolver.resolve({opts.host, opts.port});
+
+  std::size_t succeeded = 0;
+  if (m == close_each)
+  {
+    std::string request = make_request(opts, false);
+    for (std::size_t i = 0; i < opts.requests_per_connection; ++i)
+    {
+      asio::ip::tcp::socket socket(io_service);
+      asio::connect(socket, endpoints);
+      asio::write(socket, asio::buffer(request));
+      asio::streambuf input;
+      if (read_response(socket, input))
+        ++succeeded;
+    }
+    return succeeded;
+  }
+
+  asio::ip::tcp::socket socket(io_service);
+  asio::connect(socket, endpoints);
+  asio::ip::tcp::no_delay no_delay(true);
+  socket.set_option(no_delay);
+  asio::streambuf input;
+  std::string request = make_request(opts, true);
+
+  if (m == keep_alive)
+  {
+    for (std::size_t i = 0; i < opts.requests_per_connection; ++i)
+    {
+      asio::write(socket, asio::buffer(request));
+      if (read_response(socket, input))
+        ++succeeded;
+    }
+  }
+  else
+  {
+    // Every request is written before the first response is read.
+    std::string requests;
+    for (std::size_t i = 0; i < opts.requests_per_connection; ++i)
+      requests += request;
+    asio::write(socket, asio::buffer(requests));
+    for (std::size_t i = 0; i < opts.requests_per_connection; ++i)
+    {
+      if (read_response(socket, input))
+        ++succeeded;
+    }
+  }
+  return succeeded;
+}
+
+void run(const options& opts, mode m)
+{
+  std::atomic<std::size_t> succeeded(0);
+  std::atomic<std::size_t> failed_clients(0);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::vector<std::thread> clients;
+  for (std::size_t i = 0; i < opts.connections; ++i)
+  {
+    clients.push_back(std::thread([&]()
+        {
+          try
+          {
+            succeeded += run_client(opts, m);
+          }
+          catch (std::exception& e)
+          {
+            ++failed_clients;
+            std::cerr << mode_name(m) << ": " << e.what() << "\n";
+          }
+        }));
+  }
+  for (std::size_t i = 0; i < clients.size(); ++i)
+    clients[i].join();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  std::size_t requests = opts.connections * opts.requests_per_connection;
+  std::printf("%-11s %8zu requests %8zu ok %3zu failed clients %8.3f s %10.1f requests/s\n",
+      mode_name(m), requests, std::size_t(succeeded), std::size_t(failed_clients),
+      elapsed.count(), succeeded / elapsed.count());
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  if (argc < 4 || argc > 7)
+  {
+    std::cerr << "Usage: load_test <host> <port> <target> [<connections> [<requests_per_connection> [close|keep-alive|pipelined]]]\n";
+    std::cerr << "  For example:\n";
+    std::cerr << "    load_test 127.0.0.1 8080 /stats 4 1000\n";
+    std::cerr << "  Without a mode all three are run in turn.\n";
+    return 1;
+  }
+
+  options opts;
+  opts.host = argv[1];
+  opts.port = argv[2];
+  opts.target = argv[3];
+  opts.connections = (argc > 4 ? std::stoul(argv[4]) : 4);
+  opts.requests_per_connection = (argc > 5 ? std::stoul(argv[5]) : 1000);
+
+  std::vector<mode> modes;
+  if (argc > 6)
+  {
+    std::string name = argv[6];
+    if (name == mode_name(close_each))
+      modes.push_back(close_each);
+    else if (name == mode_name(keep_alive))
+      modes.push_back(keep_alive);
+    else if (name == mode_name(pipelined))
+      modes.push_back(pipelined);
+    else
+    {
+      std::cerr << "Unknown mode " << name << "\n";
+      return 1;
+    }
+  }
+  else
+  {
+    modes.push_back(close_each);
+    modes.push_back(keep_alive);
+    modes.push_back(pipelined);
+  }
+
+  for (std::size_t i = 0; i < modes.size(); ++i)
+    run(opts, modes[i]);
+
+  return 0;
+}
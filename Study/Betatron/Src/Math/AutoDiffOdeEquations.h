@@ -0,0 +1,61 @@
+/**********************************************************************
+
+File     : AutoDiffOdeEquations.h
+Project  : Bach Simulation
+Purpose  : Header file for equations that can be differentiated automatically.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           An OdeEquations subclass opts in by also deriving from
+           AutoDiffOdeEquationsT<Itself> and providing a templated
+           EvaluateT<Scalar>. OdeSolverWithDerivs then uses
+           OdeAutoDiffDerivatives instead of numerical differencing.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_AUTO_DIFF_ODE_EQUATIONS_H__
+#define __BACH_AUTO_DIFF_ODE_EQUATIONS_H__
+
+#include "DualNumber.h"
+
+namespace Bach {
+
+  //************************
+  //* AutoDiffOdeEquations *
+  //************************
+
+  class AutoDiffOdeEquations {
+  public:
+    // The gradient covers every state plus the independent variable.
+    enum { MAX_GRADIENT_SIZE = 16 };
+
+    typedef DualNumber<MAX_GRADIENT_SIZE> Dual;
+    typedef Eigen::Matrix<Dual, Eigen::Dynamic, 1, 0, MAX_GRADIENT_SIZE, 1> DualVector;
+
+    virtual ~AutoDiffOdeEquations() {}
+
+    // The derivatives of the states, without the storing or logging Evaluate does.
+    virtual void EvaluateDual(const Dual& x, const DualVector& y, DualVector& dydx) = 0;
+
+    static bool Supports(int stateLength) { return stateLength+1 <= MAX_GRADIENT_SIZE; }
+  };
+
+  //*************************
+  //* AutoDiffOdeEquationsT *
+  //*************************
+
+  // Equations must provide
+  //   template<class Scalar, class Vector>
+  //   void EvaluateT(const Scalar& x, const Vector& y, Vector& dydx);
+  template<class Equations>
+  class AutoDiffOdeEquationsT : public AutoDiffOdeEquations {
+  public:
+    virtual void EvaluateDual(const Dual& x, const DualVector& y, DualVector& dydx) {
+      static_cast<Equations*>(this)->EvaluateT(x, y, dydx);
+    }
+  };
+};
+
+#endif // __BACH_AUTO_DIFF_ODE_EQUATIONS_H__
@@ -24,6 +24,7 @@ All Rights Reserved.
 #include "OdeDerivatives.h"
 #include "OdeData.h"
 #include "OdeAccuracySpec.h"
+#include "OdeSolverTelemetry.h"
 
 using namespace Bach;
 using namespace boost;
@@ -39,6 +40,11 @@ namespace {
   const double TINY=1.0e-30;
   const double SCALMX=0.1;
 
+  // Where along a step the defect of its dense output is measured, and the derivative
+  // of t^3*(1-t)^3 there.
+  const double DENSE_DEFECT_FRACTION = 0.2;
+  const double DENSE_DEFECT_SLOPE = 0.04608;
+
   double min(double a, double b) { return (a < b ? a : b); }
   double max(double a, double b) { return (a > b ? a : b); }
 }
@@ -54,6 +60,8 @@ double BaderDeuflhardOde::s_defaultMakeBiggerFactor  = 1.20;
 
 BaderDeuflhardOde::BaderDeuflhardOde() :
   m_initialized(false),
+  m_denseOutput(false),
+  m_haveJacobianAtStart(false),
   m_first(1),
   m_xInterpTable(KMAXX),
   m_fxInterpTable(s_defaultUsedStepIncrements),
@@ -105,7 +113,6 @@ void BaderDeuflhardOde::Solve(boost::shared_ptr<OdeData> odeData, bool reset) {
 
     m_dfdx.resize(size);
     m_dfdy.resize(size, size);
-    m_aSimStep.resize(size, size);
 
     m_y.resize(size);
     m_ySav.resize(size);
@@ -117,9 +124,19 @@ void BaderDeuflhardOde::Solve(boost::shared_ptr<OdeData> odeData, bool reset) {
     m_ySum.resize(size);
     m_delta.resize(size);
     m_extrapC.resize(size);
+    m_d2ydx2.resize(size);
+    m_dydxEnd.resize(size);
+    m_dfdxEnd.resize(size);
+    m_dfdyEnd.resize(size, size);
+    m_yDense.resize(size);
+    m_dydxDense.resize(size);
+    m_defect.resize(size);
     m_yScale.resize(size);
     m_yScale.fill(1.0);
   }
+  if(!m_linearSolver || m_linearSolver->GetSize() != size) {
+    m_linearSolver = LinearSolveWorkspace::CreateInstance(size);
+  }
 
   if(reset || !m_initialized) {
     m_initialized = true;
@@ -133,6 +150,10 @@ void BaderDeuflhardOde::Solve(boost::shared_ptr<OdeData> odeData, bool reset) {
     m_nextStepSize = direction*fabs(m_nextStepSize);
 
     m_numberGood = m_numberRetried = m_numberAtMinimum = m_numberAtMaximum = 0;
+    m_linearSolver->ResetNumberOfFactorizations();
+    if(m_telemetry) {
+      m_telemetry->Reset();
+    }
   }
 
   InitializeAccuracySpec(odeData);
@@ -146,21 +167,61 @@ void BaderDeuflhardOde::Solve(boost::shared_ptr<OdeData> odeData, bool reset) {
 
   boost::shared_ptr<OdeEquations> system = odeData->GetOdeSystem();
 
+  // Events are located on the dense output.
+  bool hasEvents = (system->GetNumberOfEvents() > 0);
+  if(hasEvents) {
+    m_eventLocator.Start(x, m_y, system);
+  }
+  m_denseOutput = (odeData->WantsDenseOutput() || hasEvents);
+  m_haveJacobianAtStart = false;
+  odeData->SetStopFlag(false);
+
   for(;;) {
     odeData->SetStoringThisCall(true);
-    system->Evaluate(x, m_y, m_dydx, odeData);
-    odeData->StoreData(x, m_y, m_dydx);
+    EvaluateSystem(system, x, m_y, m_dydx, odeData);
+    StoreData(odeData, x, m_y, m_dydx);
     odeData->SetStoringThisCall(false);
 
+    // As in odeint, a step taken at the size tried is good, a reduced one was retried.
+    double triedStepSize = m_stepSize;
     SolveStep(x, odeData);
+    if(m_lastStepSize == triedStepSize) {
+      m_numberGood++;
+    }
+    else {
+      m_numberRetried++;
+    }
     m_stepSize = m_nextStepSize;
+
+    double xEvent;
+    bool stopAtEvent = (hasEvents && m_eventLocator.HandleEvents(m_denseStep, odeData, xEvent, m_y));
+    if(m_denseOutput) {
+      StoreDenseStep(odeData, m_denseStep);
+    }
+
+    // An event that stops the integration is its last sample.
+    if(stopAtEvent) {
+      x = xEvent;
+      odeData->SetStoringThisCall(true);
+      EvaluateSystem(system, x, m_y, m_dydx, odeData);
+      StoreData(odeData, x, m_y, m_dydx);
+      odeData->SetStoringThisCall(false);
+      odeData->SetStopFlag(true);
+      break;
+    }
+
     x += m_lastStepSize;
-    if(x > odeData->GetEndTime()) {
+    if(x > odeData->GetEndTime() || odeData->GetStopFlag()) {
       break;
     }
   }
 }
 
+double BaderDeuflhardOde::GetFactorizationsPerStep() const {
+  int numberOfSteps = m_numberGood+m_numberRetried;
+  return (numberOfSteps > 0 ? (double) GetNumberOfFactorizations()/numberOfSteps : 0.0);
+}
+
 void BaderDeuflhardOde::SolveStep(double x, boost::shared_ptr<OdeData> odeData) {
   boost::shared_ptr<OdeEquations> system = odeData->GetOdeSystem();
   bool exitFlag = false;
@@ -209,7 +270,17 @@ void BaderDeuflhardOde::SolveStep(double x, boost::shared_ptr<OdeData> odeData)
   }
 
   // was jacobn_s(x,m_y,dfdx,dfdy);
-  m_differentiator->GetDerivatives(x, m_y, m_dfdx, m_dfdy, odeData);
+  if(!m_haveJacobianAtStart) {
+    GetJacobian(x, m_y, m_dfdx, m_dfdy, odeData);
+  }
+  m_haveJacobianAtStart = false;
+
+  double denseError = 0.0;
+  if(m_denseOutput) {
+    m_d2ydx2.noalias() = m_dfdy*m_dydx;
+    m_d2ydx2 += m_dfdx;
+    m_denseStep.SetStart(x, m_y, m_dydx, m_d2ydx2);
+  }
 
   if(x != m_xnew || m_stepSize != m_nextStepSize) {
     m_first=1;
@@ -220,7 +291,7 @@ void BaderDeuflhardOde::SolveStep(double x, boost::shared_ptr<OdeData> odeData)
     for(k=0;k<=kmax;k++) {
       m_xnew=x+m_stepSize;
       if(m_xnew == x) {
-        LogPlain(L"ERROR: BaderDeuflhardOde::SolveStep: Step size underflow");
+        BACH_LOG_ERROR(L"BaderDeuflhardOde::SolveStep: Step size underflow");
         throw std::exception();
       }
 
@@ -231,7 +302,10 @@ void BaderDeuflhardOde::SolveStep(double x, boost::shared_ptr<OdeData> odeData)
       xest = m_stepSize/m_stepSequence(k);
       xest *= xest;
       // was pzextr(k,xest,m_yResult,m_y,m_yError);
-      Extrapolate(k, xest, m_yResult, m_y, m_yError);
+      {
+        OdeSolverTelemetry::Timer timer(m_telemetry, OdeSolverTelemetry::ExtrapolationPhase);
+        Extrapolate(k, xest, m_yResult, m_y, m_yError);
+      }
       if(k != 0) {
         errmax=TINY;
         for(int i=0;i<nv;i++) {
@@ -264,7 +338,19 @@ void BaderDeuflhardOde::SolveStep(double x, boost::shared_ptr<OdeData> odeData)
         }
       }
     }
-    if(exitFlag) break;
+    if(exitFlag) {
+      if(!m_denseOutput) {
+        break;
+      }
+
+      // The step is only good if its interpolant is as well.
+      denseError = FinishDenseStep(m_xnew, odeData);
+      if(denseError <= 1.0) {
+        break;
+      }
+      exitFlag = false;
+      red = SAFE2*pow(denseError, -1.0/6.0);
+    }
     red = min(red,REDMIN);
     red = max(red,REDMAX);
     m_stepSize *= red;
@@ -272,11 +358,17 @@ void BaderDeuflhardOde::SolveStep(double x, boost::shared_ptr<OdeData> odeData)
       m_stepSize = m_maxStepSize;
     }
     reduct = 1;
+    if(m_telemetry) {
+      m_telemetry->CountRejectedStep();
+    }
   }
 
   x = m_xnew;
   m_lastStepSize = m_stepSize;
   m_first = 0;
+  if(m_telemetry) {
+    m_telemetry->CountAcceptedStep(m_kopt);
+  }
   double wrkmin=1.0e35;
   for(int kk=0;kk<=km;kk++) {
     fact = max(m_err(kk),SCALMX);
@@ -298,9 +390,40 @@ void BaderDeuflhardOde::SolveStep(double x, boost::shared_ptr<OdeData> odeData)
     }
   }
 
+  // Don't grow past the step the interpolant would allow, its error being O(h^6).
+  if(denseError > 0.0) {
+    m_nextStepSize = min(fabs(m_nextStepSize), fabs(m_stepSize)*SAFE2*pow(denseError, -1.0/6.0))*(m_ascending ? 1.0 : -1.0);
+  }
+
   if(m_nextStepSize > m_maxStepSize) {
     m_nextStepSize = m_maxStepSize;
   }
+
+  if(m_denseOutput) {
+    m_dfdx.swap(m_dfdxEnd);
+    m_dfdy.swap(m_dfdyEnd);
+    m_haveJacobianAtStart = true;
+  }
+}
+
+double BaderDeuflhardOde::FinishDenseStep(double xEnd, shared_ptr<OdeData> odeData) {
+  EvaluateSystem(odeData->GetOdeSystem(), xEnd, m_y, m_dydxEnd, odeData);
+  GetJacobian(xEnd, m_y, m_dfdxEnd, m_dfdyEnd, odeData);
+  m_d2ydx2.noalias() = m_dfdyEnd*m_dydxEnd;
+  m_d2ydx2 += m_dfdxEnd;
+  m_denseStep.SetEnd(xEnd, m_y, m_dydxEnd, m_d2ydx2);
+
+  // The interpolant's error is close to e = C*(x-x0)^3*(x1-x)^3, and its defect
+  // f(x, P(x))-P'(x) close to -de/dx, which gives C from one evaluation. e peaks
+  // at C*h^6/64 in the middle of the step.
+  double h = xEnd-m_denseStep.GetStartTime();
+  double xDefect = m_denseStep.GetStartTime()+DENSE_DEFECT_FRACTION*h;
+  m_denseStep.Evaluate(xDefect, m_yDense, m_dydxDense);
+  EvaluateSystem(odeData->GetOdeSystem(), xDefect, m_yDense, m_defect, odeData);
+  m_defect -= m_dydxDense;
+
+  double errorScale = fabs(h)/(64.0*DENSE_DEFECT_SLOPE*m_eps);
+  return errorScale*(m_defect.array().abs()/m_yScale.array()).maxCoeff();
 }
 
 void BaderDeuflhardOde::TakeSemiImplicitStep(
@@ -315,41 +438,49 @@ void BaderDeuflhardOde::TakeSemiImplicitStep(
 
   double subStepSize = m_stepSize/numberOfSteps;
 
-  m_aSimStep = -subStepSize*m_dfdy;
-  m_aSimStep.diagonal().array() += 1.0;
+  // The matrix depends on the sub-step size, so each level needs its own factorization,
+  // but it is done once here in preallocated storage and shared by all the sub-steps.
+  {
+    OdeSolverTelemetry::Timer timer(m_telemetry, OdeSolverTelemetry::LinearSolvePhase);
+    m_linearSolver->Factor(subStepSize, m_dfdy);
+  }
+  if(m_telemetry) {
+    m_telemetry->CountFactorization();
+  }
 
-  // was using this... FloatGenFact decomp(m_aSimStep);
   m_yTemp2 = (dyIn.array()+subStepSize*m_dfdx.array()).array()*subStepSize;
-
-  ColPivHouseholderQR<MatrixXd> aDecomposition = m_aSimStep.colPivHouseholderQr();
-  m_yTemp = aDecomposition.solve(m_yTemp2);
+  SolveLinear(m_yTemp2, m_yTemp);
   m_delta = m_yTemp;
   m_ySum = yIn+m_delta;
 
   // This is the first step.
   double x = xStart+subStepSize;
-  system->Evaluate(x, m_ySum, m_yTemp, odeData);
+  EvaluateSystem(system, x, m_ySum, m_yTemp, odeData);
 
   // The remainder of the steps.
   for(int j=1;j<numberOfSteps;j++) {
     m_yTemp *= subStepSize;
     m_yTemp -= m_delta;
-    m_yTemp2 = m_yTemp;
-    m_yTemp = aDecomposition.solve(m_yTemp2);
+    SolveLinear(m_yTemp, m_yTemp);
     m_delta += 2.0*m_yTemp;
     m_ySum += m_delta;
     x += subStepSize;
 
-    system->Evaluate(x, m_ySum, m_yTemp, odeData);
+    EvaluateSystem(system, x, m_ySum, m_yTemp, odeData);
   }
 
   // The last step.
   m_yTemp *= subStepSize;
   m_yTemp -= m_delta;
-  yToReturn = aDecomposition.solve(m_yTemp);
+  SolveLinear(m_yTemp, yToReturn);
   yToReturn += m_ySum;
 }
 
+void BaderDeuflhardOde::SolveLinear(const VectorXd& b, VectorXd& x) {
+  OdeSolverTelemetry::Timer timer(m_telemetry, OdeSolverTelemetry::LinearSolvePhase);
+  m_linearSolver->Solve(b, x);
+}
+
 void BaderDeuflhardOde::Extrapolate(int iFromStep, double xFromStep, const VectorXd& yFromStep, VectorXd& yToReturn, VectorXd& yErrorEstimate) {
 
   double q;
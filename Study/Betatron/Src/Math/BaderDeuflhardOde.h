@@ -25,6 +25,9 @@ All Rights Reserved.
 
 #include "BachDefs.h"
 #include "OdeSolverWithDerivs.h"
+#include "LinearSolveWorkspace.h"
+#include "OdeDenseOutput.h"
+#include "OdeEventLocator.h"
 
 namespace Bach {
 
@@ -48,6 +51,15 @@ namespace Bach {
     int GetNumberAtMinimum()  {  return m_numberAtMinimum;  }
     int GetNumberAtMaximum()  {  return m_numberAtMaximum;  }
 
+    // The factorization and solves of (I - h*dfdy). By default LinearSolveWorkspace::CreateInstance
+    // chooses one for the state size; one set here is kept while its size matches the state's.
+    void SetLinearSolveWorkspace(boost::shared_ptr<LinearSolveWorkspace> linearSolver) { m_linearSolver = linearSolver; }
+    boost::shared_ptr<LinearSolveWorkspace> GetLinearSolveWorkspace() { return m_linearSolver; }
+
+    // One factorization of (I - h*dfdy) per extrapolation level tried, shared by all of its sub-steps.
+    int GetNumberOfFactorizations() const  {  return (m_linearSolver ? m_linearSolver->GetNumberOfFactorizations() : 0);  }
+    double GetFactorizationsPerStep() const;
+
   protected:
 
     BaderDeuflhardOde();
@@ -56,6 +68,14 @@ namespace Bach {
     void TakeSemiImplicitStep(int numberOfSteps, double xStart,const Eigen::VectorXd& yIn,const Eigen::VectorXd& dyIn, Eigen::VectorXd& yToReturn, boost::shared_ptr<OdeData> odeData);
     virtual void Extrapolate(int iFromStep, double xFromStep, const Eigen::VectorXd& yFromStep, Eigen::VectorXd& yToReturn, Eigen::VectorXd& yErrorEstimate);
 
+    // The workspace's Solve, timed with telemetry.
+    void SolveLinear(const Eigen::VectorXd& b, Eigen::VectorXd& x);
+
+    // With dense output, finish the interpolant of a step that has met the tolerance and
+    // check that the interpolant meets it too. The Jacobian found at the end of the step is
+    // kept for the next one. Returns the error of the interpolant relative to the tolerance.
+    double FinishDenseStep(double xEnd, boost::shared_ptr<OdeData> odeData);
+
     boost::weak_ptr<BaderDeuflhardOde> m_weakThis;
 
     bool m_initialized;
@@ -80,7 +100,7 @@ namespace Bach {
     Eigen::VectorXd m_dfdx;
     Eigen::MatrixXd m_dfdy;
     Eigen::MatrixXd m_alf;
-    Eigen::MatrixXd m_aSimStep;
+    boost::shared_ptr<LinearSolveWorkspace> m_linearSolver;
     Eigen::VectorXd m_a;
 
     Eigen::VectorXd m_y;
@@ -95,6 +115,19 @@ namespace Bach {
     Eigen::VectorXd m_yScale;
     Eigen::VectorXd m_extrapC;
 
+    bool m_denseOutput;
+    bool m_haveJacobianAtStart;
+    OdeDenseOutput m_denseStep;
+    Eigen::VectorXd m_d2ydx2;
+    Eigen::VectorXd m_dydxEnd;
+    Eigen::VectorXd m_dfdxEnd;
+    Eigen::MatrixXd m_dfdyEnd;
+    Eigen::VectorXd m_yDense;
+    Eigen::VectorXd m_dydxDense;
+    Eigen::VectorXd m_defect;
+
+    OdeEventLocator m_eventLocator;
+
     int m_numberGood;
     int m_numberRetried;
     int m_numberAtMinimum;
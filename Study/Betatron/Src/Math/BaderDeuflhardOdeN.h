@@ -0,0 +1,357 @@
+/**********************************************************************
+
+File     : BaderDeuflhardOdeN.h
+Project  : Bach Simulation
+Purpose  : Header file for the Bader-Deuflhard solver with a state length fixed at compile time.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The same semi-implicit extrapolation method as BaderDeuflhardOde,
+           see Numerical Recipes, 2nd Edition, pp 735-739, but templated on
+           the state length and the equations. Every workspace is a fixed
+           size member, the equations and their Jacobian are called without
+           virtual dispatch, and nothing is allocated while solving.
+
+           Each step start is passed to an observer rather than stored in
+           an OdeData, so the caller decides what, if anything, to keep.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_BADER_DEUFLHARD_ODE_N_H__
+#define __BACH_BADER_DEUFLHARD_ODE_N_H__
+
+#include "BachDefs.h"
+#include "OdeEquationsN.h"
+#include <cmath>
+
+namespace Bach {
+
+  //**********************
+  //* BaderDeuflhardOdeN *
+  //**********************
+
+  // Equations derives from OdeEquationsN<N, Equations>.
+  template<int N, class Equations>
+  class BaderDeuflhardOdeN {
+  public:
+    typedef Eigen::Matrix<double, N, 1> VectorN;
+    typedef Eigen::Matrix<double, N, N> MatrixN;
+
+    // Observers are called as observer(x, y, dydx) at the start of every step.
+    struct NullObserver {
+      void operator()(double, const VectorN&, const VectorN&) {}
+    };
+
+    BaderDeuflhardOdeN() :
+      m_tolerance(0.0001),
+      m_initialStepSize(0.001),
+      m_maxStepSize(1.0e32),
+      m_numberGood(0),
+      m_numberRetried(0),
+      m_numberOfFactorizations(0),
+      m_numberOfEvaluations(0)
+    {
+      m_yScale.fill(1.0);
+      const int stepSequence[IMAXX] = { 2, 6, 10, 14, 22, 34, 50, 70 };
+      for(int i=0; i<IMAXX; i++) {
+        m_stepSequence[i] = stepSequence[i];
+      }
+    }
+
+    void SetTolerance(double tolerance)          {  m_tolerance = std::fabs(tolerance);  }
+    void SetStepSize(double stepSize)            {  m_initialStepSize = stepSize;  }
+    void SetMaximumStepSize(double maxStepSize)  {  m_maxStepSize = maxStepSize;  }
+
+    // The error of each state is divided by its scale before comparing with the tolerance.
+    void SetScale(const VectorN& yScale)         {  m_yScale = yScale;  }
+
+    int GetNumberGood() const               {  return m_numberGood;  }
+    int GetNumberRetried() const            {  return m_numberRetried;  }
+    int GetNumberOfFactorizations() const   {  return m_numberOfFactorizations;  }
+    int GetNumberOfEvaluations() const      {  return m_numberOfEvaluations;  }
+
+    // Integrates y from xStart until x passes xEnd, leaving the last state in y.
+    void Solve(Equations& equations, double xStart, double xEnd, VectorN& y) {
+      NullObserver observer;
+      Solve(equations, xStart, xEnd, y, observer);
+    }
+
+    template<class Observer>
+    void Solve(Equations& equations, double xStart, double xEnd, VectorN& y, Observer& observer) {
+      double direction = (xEnd-xStart > 0.0 ? 1.0 : -1.0);
+      m_stepSize = direction*std::fabs(m_initialStepSize);
+      m_maxStepSize = direction*std::fabs(m_maxStepSize);
+      m_nextStepSize = m_xNew = -1.0e29;
+      m_numberGood = m_numberRetried = m_numberOfFactorizations = m_numberOfEvaluations = 0;
+
+      InitializeWorkCoefficients();
+
+      double x = xStart;
+      m_y = y;
+      for(;;) {
+        Evaluate(equations, x, m_y, m_dydx);
+        observer(x, m_y, m_dydx);
+
+        // As in BaderDeuflhardOde, a step taken at the size tried is good, a reduced one was retried.
+        double triedStepSize = m_stepSize;
+        SolveStep(equations, x);
+        if(m_lastStepSize == triedStepSize) {
+          m_numberGood++;
+        }
+        else {
+          m_numberRetried++;
+        }
+        m_stepSize = m_nextStepSize;
+        x += m_lastStepSize;
+        if(x > xEnd) {
+          break;
+        }
+      }
+      y = m_y;
+    }
+
+  protected:
+    enum { KMAXX = 7, IMAXX = 8 };
+
+    void Evaluate(Equations& equations, double x, const VectorN& y, VectorN& dydx) {
+      m_numberOfEvaluations++;
+      equations.EvaluateN(x, y, dydx);
+    }
+
+    void InitializeWorkCoefficients() {
+      const double SAFE1 = 0.25;
+      double eps1 = SAFE1*m_tolerance;
+      m_alf.setZero();
+
+      m_a[0] = m_stepSequence[0]+1;
+      for(int k=0; k<KMAXX; k++) {
+        m_a[k+1] = m_a[k]+m_stepSequence[k+1];
+      }
+
+      for(int iq=1; iq<KMAXX; iq++) {
+        for(int k=0; k<iq; k++) {
+          m_alf(k, iq) = std::pow(eps1, (m_a[k+1]-m_a[iq+1])/((m_a[iq+1]-m_a[0]+1.0)*(2*k+3)));
+        }
+      }
+
+      m_a[0] += N;
+      for(int k=0; k<KMAXX; k++) {
+        m_a[k+1] = m_a[k]+m_stepSequence[k+1];
+      }
+      for(m_kopt=1; m_kopt<KMAXX-1; m_kopt++) {
+        if(m_a[m_kopt+1] > m_a[m_kopt]*m_alf(m_kopt-1, m_kopt)) {
+          break;
+        }
+      }
+      m_kmax = m_kopt;
+      m_first = true;
+    }
+
+    void SolveStep(Equations& equations, double x) {
+      const double SAFE1 = 0.25;
+      const double SAFE2 = 0.7;
+      const double REDMAX = 1.0e-5;
+      const double REDMIN = 0.7;
+      const double TINY = 1.0e-30;
+      const double SCALMX = 0.1;
+
+      bool exitFlag = false;
+      double red = 0.0;
+      double errmax = 0.0;
+      double scale = 0.0;
+      bool reduct = false;
+      int km = -1;
+      int k;
+
+      m_ySav = m_y;
+      equations.GetDerivativesN(x, m_y, m_dfdx, m_dfdy);
+
+      if(x != m_xNew || m_stepSize != m_nextStepSize) {
+        m_first = true;
+        m_kopt = m_kmax;
+      }
+
+      for(;;) {
+        for(k=0; k<=m_kmax; k++) {
+          m_xNew = x+m_stepSize;
+          if(m_xNew == x) {
+            BACH_LOG_ERROR(L"BaderDeuflhardOdeN::SolveStep: Step size underflow");
+            throw std::exception();
+          }
+
+          TakeSemiImplicitStep(equations, m_stepSequence[k], x);
+
+          double xest = m_stepSize/m_stepSequence[k];
+          xest *= xest;
+          Extrapolate(k, xest);
+          if(k != 0) {
+            errmax = ((m_yError.array()/m_yScale.array()).abs().maxCoeff())/m_tolerance;
+            errmax = (errmax > TINY/m_tolerance ? errmax : TINY/m_tolerance);
+            km = k-1;
+            m_err[km] = std::pow(errmax/SAFE1, 1.0/(2*km+3));
+          }
+          if(k != 0 && (k >= m_kopt-1 || m_first)) {
+            if(errmax < 1.0) {
+              exitFlag = true;
+              break;
+            }
+            if(k == m_kmax || k == m_kopt+1) {
+              red = SAFE2/m_err[km];
+              break;
+            }
+            else if(k == m_kopt && m_alf(m_kopt-1, m_kopt) < m_err[km]) {
+              red = 1.0/m_err[km];
+              break;
+            }
+            else if(m_kopt == m_kmax && m_alf(km, m_kmax-1) < m_err[km]) {
+              red = m_alf(km, m_kmax-1)*SAFE2/m_err[km];
+              break;
+            }
+            else if(m_alf(km, m_kopt) < m_err[km]) {
+              red = m_alf(km, m_kopt-1)/m_err[km];
+              break;
+            }
+          }
+        }
+        if(exitFlag) break;
+        red = (red < REDMIN ? red : REDMIN);
+        red = (red > REDMAX ? red : REDMAX);
+        m_stepSize *= red;
+        if(m_stepSize > m_maxStepSize) {
+          m_stepSize = m_maxStepSize;
+        }
+        reduct = true;
+      }
+
+      m_lastStepSize = m_stepSize;
+      m_first = false;
+      double wrkmin = 1.0e35;
+      for(int kk=0; kk<=km; kk++) {
+        double fact = (m_err[kk] > SCALMX ? m_err[kk] : SCALMX);
+        double work = fact*m_a[kk+1];
+        if(work < wrkmin) {
+          scale = fact;
+          wrkmin = work;
+          m_kopt = kk+1;
+        }
+      }
+
+      m_nextStepSize = m_stepSize/scale;
+
+      if(m_kopt >= k && m_kopt != m_kmax && !reduct) {
+        double fact = scale/m_alf(m_kopt-1, m_kopt);
+        fact = (fact > SCALMX ? fact : SCALMX);
+        if(m_a[m_kopt+1]*fact <= wrkmin) {
+          m_nextStepSize = m_stepSize/fact;
+          m_kopt++;
+        }
+      }
+
+      if(m_nextStepSize > m_maxStepSize) {
+        m_nextStepSize = m_maxStepSize;
+      }
+    }
+
+    // One level of the extrapolation, numberOfSteps sub-steps from m_ySav into m_yResult.
+    void TakeSemiImplicitStep(Equations& equations, int numberOfSteps, double xStart) {
+      double subStepSize = m_stepSize/numberOfSteps;
+
+      m_aSimStep = -subStepSize*m_dfdy;
+      m_aSimStep.diagonal().array() += 1.0;
+      m_lu.compute(m_aSimStep);
+      m_numberOfFactorizations++;
+
+      m_yTemp = (m_dydx+subStepSize*m_dfdx)*subStepSize;
+      m_delta = m_lu.solve(m_yTemp);
+      m_ySum = m_ySav+m_delta;
+
+      double x = xStart+subStepSize;
+      Evaluate(equations, x, m_ySum, m_yTemp);
+
+      for(int j=1; j<numberOfSteps; j++) {
+        m_yTemp = m_yTemp*subStepSize-m_delta;
+        m_delta += 2.0*m_lu.solve(m_yTemp);
+        m_ySum += m_delta;
+        x += subStepSize;
+        Evaluate(equations, x, m_ySum, m_yTemp);
+      }
+
+      m_yTemp = m_yTemp*subStepSize-m_delta;
+      m_yResult = m_lu.solve(m_yTemp);
+      m_yResult += m_ySum;
+    }
+
+    // Polynomial extrapolation of m_yResult into m_y, with the error estimate in m_yError.
+    void Extrapolate(int iFromStep, double xFromStep) {
+      m_xInterpTable[iFromStep] = xFromStep;
+      m_yError = m_yResult;
+      m_y = m_yResult;
+
+      if(iFromStep == 0) {
+        m_interpTable.col(0) = m_yResult;
+        return;
+      }
+
+      m_extrapC = m_yResult;
+      for(int k1=0; k1<iFromStep; k1++) {
+        double delta = 1.0/(m_xInterpTable[iFromStep-k1-1]-xFromStep);
+        double f1 = xFromStep*delta;
+        double f2 = m_xInterpTable[iFromStep-k1-1]*delta;
+        for(int j=0; j<N; j++) {
+          double q = m_interpTable(j, k1);
+          m_interpTable(j, k1) = m_yError(j);
+          delta = m_extrapC(j)-q;
+          m_yError(j) = f1*delta;
+          m_extrapC(j) = f2*delta;
+          m_y(j) += m_yError(j);
+        }
+      }
+      m_interpTable.col(iFromStep) = m_yError;
+    }
+
+    double m_tolerance;
+    double m_initialStepSize;
+    double m_maxStepSize;
+    double m_stepSize;
+    double m_lastStepSize;
+    double m_nextStepSize;
+    double m_xNew;
+
+    int m_stepSequence[IMAXX];
+    double m_a[IMAXX+1];
+    double m_err[KMAXX];
+    double m_xInterpTable[KMAXX+1];
+    Eigen::Matrix<double, KMAXX, KMAXX> m_alf;
+    Eigen::Matrix<double, N, KMAXX+1> m_interpTable;
+    int m_kmax;
+    int m_kopt;
+    bool m_first;
+
+    VectorN m_y;
+    VectorN m_ySav;
+    VectorN m_dydx;
+    VectorN m_dfdx;
+    MatrixN m_dfdy;
+    MatrixN m_aSimStep;
+    Eigen::PartialPivLU<MatrixN> m_lu;
+    VectorN m_yTemp;
+    VectorN m_ySum;
+    VectorN m_delta;
+    VectorN m_yResult;
+    VectorN m_yError;
+    VectorN m_yScale;
+    VectorN m_extrapC;
+
+    int m_numberGood;
+    int m_numberRetried;
+    int m_numberOfFactorizations;
+    int m_numberOfEvaluations;
+
+  public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+};
+
+#endif // __BACH_BADER_DEUFLHARD_ODE_N_H__
@@ -0,0 +1,107 @@
+/**********************************************************************
+
+File     : BarycentricInterp.cpp
+Project  : Bach Simulation
+Purpose  : Source file for a polynomial interpolation of many columns at once.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BarycentricInterp.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+  //*********************
+  //* BarycentricInterp *
+  //*********************
+
+BarycentricInterp::BarycentricInterp(int numberOfPoints) :
+  m_numberOfPoints(numberOfPoints),
+  m_basisGood(false),
+  m_basisTarget(0.0),
+  m_x(numberOfPoints),
+  m_weights(numberOfPoints),
+  m_basis(numberOfPoints)
+{
+}
+
+void BarycentricInterp::SetNumberOfPoints(int n) {
+  m_numberOfPoints = n;
+  m_x.resize(n);
+  m_weights.resize(n);
+  m_basis.resize(n);
+  m_basisGood = false;
+}
+
+bool BarycentricInterp::SetAbscissae(const VectorXd& x, int index) {
+  m_x = x.segment(index, m_numberOfPoints);
+  m_basisGood = false;
+
+  for(int j=0; j<m_numberOfPoints; j++) {
+    double product = 1.0;
+    for(int k=0; k<m_numberOfPoints; k++) {
+      if(k != j) {
+        product *= m_x(j)-m_x(k);
+      }
+    }
+    if(product == 0.0) {
+      return false;
+    }
+    m_weights(j) = 1.0/product;
+  }
+  return true;
+}
+
+void BarycentricInterp::Interpolate(double xTarget, const MatrixXd& y, VectorXd& yResult) {
+  SetBasis(xTarget);
+  yResult.noalias() = y*m_basis;
+}
+
+double BarycentricInterp::Interpolate(double xTarget, const MatrixXd& y, int yIndex) {
+  SetBasis(xTarget);
+  return y.row(yIndex).dot(m_basis);
+}
+
+void BarycentricInterp::Interpolate(const VectorXd& xTargets, int first, int count, const MatrixXd& y, MatrixXd& yResult) {
+  if(m_blockBasis.rows() != m_numberOfPoints || m_blockBasis.cols() < count) {
+    m_blockBasis.resize(m_numberOfPoints, count);
+  }
+  for(int k=0; k<count; k++) {
+    GetBasis(xTargets(first+k), m_blockBasis.col(k).data());
+  }
+  yResult.middleCols(first, count).noalias() = y*m_blockBasis.leftCols(count);
+}
+
+void BarycentricInterp::SetBasis(double xTarget) {
+  if(m_basisGood && m_basisTarget == xTarget) {
+    return;
+  }
+  m_basisGood = true;
+  m_basisTarget = xTarget;
+  GetBasis(xTarget, m_basis.data());
+}
+
+void BarycentricInterp::GetBasis(double xTarget, double* basis) const {
+  // On an abscissa the value there is returned exactly, as PolynomialInterp does.
+  double sum = 0.0;
+  for(int j=0; j<m_numberOfPoints; j++) {
+    double difference = xTarget-m_x(j);
+    if(difference == 0.0) {
+      for(int k=0; k<m_numberOfPoints; k++) {
+        basis[k] = (k == j ? 1.0 : 0.0);
+      }
+      return;
+    }
+    basis[j] = m_weights(j)/difference;
+    sum += basis[j];
+  }
+  for(int j=0; j<m_numberOfPoints; j++) {
+    basis[j] /= sum;
+  }
+}
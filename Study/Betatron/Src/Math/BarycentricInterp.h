@@ -0,0 +1,71 @@
+/**********************************************************************
+
+File     : BarycentricInterp.h
+Project  : Bach Simulation
+Purpose  : Header file for a polynomial interpolation of many columns at once.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The same polynomial as PolynomialInterp, in the barycentric form.
+           The weights depend only on the abscissae, so they are set once for
+           a window of points and then each target costs one pass over the
+           points for the basis and one matrix-vector product for all of the
+           columns, rather than a Neville tableau per column.
+           See Berrut and Trefethen, Barycentric Lagrange Interpolation,
+           SIAM Review 46(3), 2004, pp 501-517.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_BARYCENTRIC_INTERP_H__
+#define __BACH_BARYCENTRIC_INTERP_H__
+
+#include "BachDefs.h"
+
+namespace Bach {
+
+  //*********************
+  //* BarycentricInterp *
+  //*********************
+
+  class BarycentricInterp {
+  public:
+    BarycentricInterp(int numberOfPoints = 3);
+
+    int GetNumberOfPoints() const { return m_numberOfPoints; }
+    void SetNumberOfPoints(int n);
+
+    // Set the abscissae from x(index) on and their weights. Returns false if two of
+    // them are equal, when there is no interpolating polynomial through them.
+    bool SetAbscissae(const Eigen::VectorXd& x, int index = 0);
+
+    // The value at xTarget of each row of y, which has one column per abscissa.
+    void Interpolate(double xTarget, const Eigen::MatrixXd& y, Eigen::VectorXd& yResult);
+
+    // The value at xTarget of row yIndex of y alone.
+    double Interpolate(double xTarget, const Eigen::MatrixXd& y, int yIndex);
+
+    // The values at count targets from xTargets(first) on, into the same columns of
+    // yResult, with the bases of all of them applied to y in one matrix product.
+    void Interpolate(const Eigen::VectorXd& xTargets, int first, int count, const Eigen::MatrixXd& y, Eigen::MatrixXd& yResult);
+
+  protected:
+    // The Lagrange basis at xTarget into m_basis, unless it is already there.
+    void SetBasis(double xTarget);
+
+    // The Lagrange basis at xTarget, m_numberOfPoints values.
+    void GetBasis(double xTarget, double* basis) const;
+
+    int m_numberOfPoints;
+    bool m_basisGood;
+    double m_basisTarget;
+
+    Eigen::VectorXd m_x;
+    Eigen::VectorXd m_weights;
+    Eigen::VectorXd m_basis;
+    Eigen::MatrixXd m_blockBasis;
+  };
+};
+
+#endif // __BACH_BARYCENTRIC_INTERP_H__
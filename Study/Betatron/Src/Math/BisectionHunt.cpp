@@ -35,7 +35,7 @@ using namespace Eigen;
   //* BisectionHunt *
   //*****************
 
-int BisectionHunt::Find(double xTarget, const Eigen::VectorXd& x) {
+int BisectionHunt::Find(double xTarget, const Eigen::Ref<const Eigen::VectorXd>& x) {
   m_size = (int) x.rows();
   m_ascending = (x(m_size-1) > x(0));
 
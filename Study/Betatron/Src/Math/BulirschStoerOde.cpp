@@ -0,0 +1,355 @@
+/**********************************************************************
+
+File     : BulirschStoerOde.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the explicit Bulirsch-Stoer solver.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BulirschStoerOde.h"
+#include "OdeData.h"
+#include "OdeAccuracySpec.h"
+#include "OdeSolverTelemetry.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const int KMAXX = 8;
+  const int IMAXX = KMAXX+1;
+  const double SAFE1 = 0.25;
+  const double SAFE2 = 0.7;
+  const double REDMAX = 1.0e-5;
+  const double REDMIN = 0.7;
+  const double TINY = 1.0e-30;
+  const double SCALMX = 0.1;
+
+  double min(double a, double b) { return (a < b ? a : b); }
+  double max(double a, double b) { return (a > b ? a : b); }
+}
+
+  //********************
+  //* BulirschStoerOde *
+  //********************
+
+shared_ptr<BulirschStoerOde> BulirschStoerOde::CreateInstance() {
+  shared_ptr<BulirschStoerOde> instance(new BulirschStoerOde());
+  instance->m_weakThis = instance;
+  return instance;
+}
+
+BulirschStoerOde::BulirschStoerOde() :
+  m_initialized(false),
+  m_maxStepSize(1.0e32),
+  m_initialStepSize(0.001),
+  m_lastStepSize(0.0),
+  m_nextStepSize(0.0),
+  m_ascending(true),
+  m_numberGood(0),
+  m_numberRetried(0),
+  m_stepSequence(IMAXX),
+  m_a(IMAXX),
+  m_alf(KMAXX, KMAXX),
+  m_err(KMAXX),
+  m_xInterpTable(IMAXX),
+  m_first(1),
+  m_kmax(0),
+  m_kopt(0),
+  m_eps(0.0),
+  m_epsold(-1.0),
+  m_xnew(0.0)
+{
+  m_stepSequence << 2, 4, 6, 8, 10, 12, 14, 16, 18;
+  m_a.fill(0.0);
+  m_alf.fill(0.0);
+  m_stepSize = m_initialStepSize;
+}
+
+BulirschStoerOde::~BulirschStoerOde() {
+}
+
+void BulirschStoerOde::Solve(shared_ptr<OdeData> odeData, bool reset) {
+  shared_ptr<OdeEquations> system = odeData->GetOdeSystem();
+  if(odeData->WantsDenseOutput() || system->GetNumberOfEvents() > 0) {
+    BACH_LOG_ERROR(L"BulirschStoerOde::Solve: There is no dense output for grid sampling or events, use DormandPrinceOde or BaderDeuflhardOde");
+    throw std::exception();
+  }
+
+  int size = odeData->GetStateLength();
+  if(m_y.rows() != size) {
+    m_interpTable.resize(size, IMAXX);
+    m_y.resize(size);
+    m_ySav.resize(size);
+    m_dydx.resize(size);
+    m_yResult.resize(size);
+    m_yError.resize(size);
+    m_yScale.resize(size);
+    m_yMid.resize(size);
+    m_yNext.resize(size);
+    m_extrapC.resize(size);
+  }
+
+  if(reset || !m_initialized) {
+    m_initialized = true;
+    odeData->ResetStorage();
+    m_ascending = (odeData->GetEndTime()-odeData->GetStartTime() > 0.0 ? true : false);
+
+    double direction = m_ascending ? 1.0 : -1.0;
+    m_stepSize = direction*fabs(m_initialStepSize);
+    m_maxStepSize = direction*fabs(m_maxStepSize);
+
+    m_numberGood = m_numberRetried = 0;
+    if(m_telemetry) {
+      m_telemetry->Reset();
+    }
+  }
+
+  InitializeAccuracySpec(odeData);
+  m_eps = GetAccuracySpec()->GetTolerance();
+
+  double x = odeData->GetStartTime();
+  double end = odeData->GetEndTime();
+  double direction = m_ascending ? 1.0 : -1.0;
+  m_y = odeData->GetInitialConditions();
+  odeData->SetStopFlag(false);
+
+  odeData->SetStoringThisCall(true);
+  EvaluateSystem(system, x, m_y, m_dydx, odeData);
+  StoreData(odeData, x, m_y, m_dydx);
+  odeData->SetStoringThisCall(false);
+
+  while((end-x)*direction > 0.0) {
+    // The last step is cut short to finish at the end time.
+    bool lastStep = ((x+m_stepSize-end)*direction >= 0.0);
+    if(lastStep) {
+      m_stepSize = end-x;
+    }
+
+    double triedStepSize = m_stepSize;
+    SolveStep(x, odeData);
+    if(m_lastStepSize == triedStepSize) {
+      m_numberGood++;
+    }
+    else {
+      m_numberRetried++;
+    }
+    m_stepSize = m_nextStepSize;
+    x = (lastStep && m_lastStepSize == triedStepSize ? end : x+m_lastStepSize);
+
+    // The derivative at the end of the step is the start of the next one.
+    odeData->SetStoringThisCall(true);
+    EvaluateSystem(system, x, m_y, m_dydx, odeData);
+    StoreData(odeData, x, m_y, m_dydx);
+    odeData->SetStoringThisCall(false);
+
+    if(odeData->GetStopFlag()) {
+      break;
+    }
+  }
+}
+
+void BulirschStoerOde::SolveStep(double x, shared_ptr<OdeData> odeData) {
+  bool exitFlag = false;
+
+  double red = 0.0;
+  double fact;
+  double errmax = 0.0;
+  double eps1;
+  double scale = 0.0;
+  double work;
+  double xest;
+  int reduct;
+  int km = -1;
+  int k;
+
+  if(m_eps != m_epsold) {
+    m_nextStepSize = m_xnew = -1.0e29;
+    eps1 = SAFE1*m_eps;
+    m_a(0) = m_stepSequence(0)+1;
+    for(k=0;k<KMAXX;k++) {
+      m_a(k+1) = m_a(k)+m_stepSequence(k+1);
+    }
+
+    for(int iq=1;iq<KMAXX;iq++) {
+      for(k=0;k<iq;k++) {
+        m_alf(k, iq) = pow(eps1,(m_a(k+1)-m_a(iq+1))/((m_a(iq+1)-m_a(0)+1.0)*(2*k+3)));
+      }
+    }
+    m_epsold = m_eps;
+    for(m_kopt=1;m_kopt<KMAXX-1;m_kopt++) {
+      if(m_a(m_kopt+1) > m_a(m_kopt)*m_alf(m_kopt-1, m_kopt)) {
+        break;
+      }
+    }
+    m_kmax = m_kopt;
+  }
+
+  m_ySav = m_y;
+
+  if(x != m_xnew || m_stepSize != m_nextStepSize) {
+    m_first = 1;
+    m_kopt = m_kmax;
+  }
+  reduct = 0;
+  for(;;) {
+    for(k=0;k<=m_kmax;k++) {
+      m_xnew = x+m_stepSize;
+      if(m_xnew == x) {
+        BACH_LOG_ERROR(L"BulirschStoerOde::SolveStep: Step size underflow");
+        throw std::exception();
+      }
+
+      TakeModifiedMidpointStep(m_stepSequence(k), x, m_ySav, m_dydx, m_yResult, odeData);
+
+      xest = m_stepSize/m_stepSequence(k);
+      xest *= xest;
+      {
+        OdeSolverTelemetry::Timer timer(m_telemetry, OdeSolverTelemetry::ExtrapolationPhase);
+        Extrapolate(k, xest, m_yResult, m_y, m_yError);
+      }
+      if(k != 0) {
+        // Relative to the larger of the state's size at either end of the step.
+        m_yScale = m_ySav.cwiseAbs().cwiseMax(m_y.cwiseAbs());
+        errmax = max(GetAccuracySpec()->GetNormalizedError(m_yError, m_yScale), TINY);
+        km = k-1;
+        m_err(km) = pow(errmax/SAFE1,1.0/(2*km+3));
+      }
+      if(k != 0 && (k >= m_kopt-1 || m_first)) {
+        if(errmax < 1.0) {
+          exitFlag = true;
+          break;
+        }
+        if(k == m_kmax || k == m_kopt+1) {
+          red = SAFE2/m_err(km);
+          break;
+        }
+        else if(k == m_kopt && m_alf(m_kopt-1, m_kopt) < m_err(km)) {
+          red = 1.0/m_err(km);
+          break;
+        }
+        else if(m_kopt == m_kmax && m_alf(km, m_kmax-1) < m_err(km)) {
+          red = m_alf(km, m_kmax-1)*SAFE2/m_err(km);
+          break;
+        }
+        else if(m_alf(km, m_kopt) < m_err(km)) {
+          red = m_alf(km, m_kopt-1)/m_err(km);
+          break;
+        }
+      }
+    }
+    if(exitFlag) {
+      break;
+    }
+    red = min(red,REDMIN);
+    red = max(red,REDMAX);
+    m_stepSize *= red;
+    reduct = 1;
+    if(m_telemetry) {
+      m_telemetry->CountRejectedStep();
+    }
+  }
+
+  m_lastStepSize = m_stepSize;
+  m_first = 0;
+  if(m_telemetry) {
+    m_telemetry->CountAcceptedStep(m_kopt);
+  }
+  double wrkmin = 1.0e35;
+  for(int kk=0;kk<=km;kk++) {
+    fact = max(m_err(kk),SCALMX);
+    work = fact*m_a(kk+1);
+    if(work < wrkmin) {
+      scale = fact;
+      wrkmin = work;
+      m_kopt = kk+1;
+    }
+  }
+
+  m_nextStepSize = m_stepSize/scale;
+
+  if(m_kopt >= k && m_kopt != m_kmax && !reduct) {
+    fact = max(scale/m_alf(m_kopt-1, m_kopt), SCALMX);
+    if(m_a(m_kopt+1)*fact <= wrkmin) {
+      m_nextStepSize = m_stepSize/fact;
+      m_kopt++;
+    }
+  }
+
+  if(fabs(m_nextStepSize) > fabs(m_maxStepSize)) {
+    m_nextStepSize = m_maxStepSize;
+  }
+}
+
+void BulirschStoerOde::TakeModifiedMidpointStep(int numberOfSteps, double xStart, const VectorXd& yIn, const VectorXd& dyIn, VectorXd& yToReturn, shared_ptr<OdeData> odeData) {
+  shared_ptr<OdeEquations> system = odeData->GetOdeSystem();
+  double subStepSize = m_stepSize/numberOfSteps;
+
+  // The first step is Euler's.
+  m_yMid = yIn;
+  m_yNext = yIn+subStepSize*dyIn;
+  double x = xStart+subStepSize;
+  EvaluateSystem(system, x, m_yNext, yToReturn, odeData);
+
+  // The remainder step over each other point, from the one before.
+  double twoSubSteps = 2.0*subStepSize;
+  for(int n=1;n<numberOfSteps;n++) {
+    m_yMid += twoSubSteps*yToReturn;
+    m_yMid.swap(m_yNext);
+    x += subStepSize;
+    EvaluateSystem(system, x, m_yNext, yToReturn, odeData);
+  }
+
+  // The last step smooths the two interleaved sequences.
+  yToReturn = 0.5*(m_yMid+m_yNext+subStepSize*yToReturn);
+}
+
+void BulirschStoerOde::Extrapolate(int iFromStep, double xFromStep, const VectorXd& yFromStep, VectorXd& yToReturn, VectorXd& yErrorEstimate) {
+  // Polynomial extrapolation to zero sub-step size, as BaderDeuflhardOde::Extrapolate.
+  double q;
+  double f2;
+  double f1;
+  double delta;
+
+  int nv = (int) yToReturn.rows();
+
+  m_xInterpTable(iFromStep) = xFromStep;
+
+  int j;
+  for(j=0;j<nv;j++) {
+    yErrorEstimate(j) = yToReturn(j) = yFromStep(j);
+  }
+
+  if(iFromStep == 0) {
+    for(j=0;j<nv;j++) {
+      m_interpTable(j, 0) = yFromStep(j);
+    }
+  }
+  else {
+    for(j=0;j<nv;j++) {
+      m_extrapC(j) = yFromStep(j);
+    }
+
+    for(int k1=0;k1<iFromStep;k1++) {
+      delta = 1.0/(m_xInterpTable(iFromStep-k1-1)-xFromStep);
+      f1 = xFromStep*delta;
+      f2 = m_xInterpTable(iFromStep-k1-1)*delta;
+      for(j=0;j<nv;j++) {
+        q = m_interpTable(j, k1);
+        m_interpTable(j, k1) = yErrorEstimate(j);
+        delta = m_extrapC(j)-q;
+        yErrorEstimate(j) = f1*delta;
+        m_extrapC(j) = f2*delta;
+        yToReturn(j) += yErrorEstimate(j);
+      }
+    }
+    for(j=0;j<nv;j++) {
+      m_interpTable(j, iFromStep) = yErrorEstimate(j);
+    }
+  }
+}
@@ -0,0 +1,97 @@
+/**********************************************************************
+
+File     : BulirschStoerOde.h
+Project  : Bach Simulation
+Purpose  : Header file for the explicit Bulirsch-Stoer solver.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The classic Bulirsch-Stoer method for smooth systems that are
+           not stiff. Each step is taken with the modified midpoint rule
+           at an increasing number of sub-steps and the results are
+           extrapolated to zero sub-step size, with the order and the step
+           size chosen together to minimize the work. It is the explicit
+           counterpart of BaderDeuflhardOde and needs no Jacobian.
+           See Numerical Recipes, 2nd Edition, pp 724-732.
+
+           Steps are stored at their ends and the last one is shortened to
+           finish exactly at the end time. There is no dense output, so
+           neither grid sampling nor events are supported.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_BULIRSCH_STOER_ODE_H__
+#define __BACH_BULIRSCH_STOER_ODE_H__
+
+#include "BachDefs.h"
+#include "OdeSolver.h"
+
+namespace Bach {
+
+  //********************
+  //* BulirschStoerOde *
+  //********************
+
+  class BulirschStoerOde : public OdeSolver {
+  public:
+    static boost::shared_ptr<BulirschStoerOde> CreateInstance();
+    virtual ~BulirschStoerOde();
+
+    void Solve(boost::shared_ptr<OdeData> odeData, bool reset = true);
+
+    void SetStepSize(double stepSize)            {  m_initialStepSize = stepSize;  }
+    void SetMaximumStepSize(double maxStepSize)  {  m_maxStepSize = maxStepSize;  }
+
+    int GetNumberGood()       {  return m_numberGood;  }
+    int GetNumberRetried()    {  return m_numberRetried;  }
+
+  protected:
+    BulirschStoerOde();
+
+    void SolveStep(double x, boost::shared_ptr<OdeData> odeData);
+    void TakeModifiedMidpointStep(int numberOfSteps, double xStart, const Eigen::VectorXd& yIn, const Eigen::VectorXd& dyIn, Eigen::VectorXd& yToReturn, boost::shared_ptr<OdeData> odeData);
+    void Extrapolate(int iFromStep, double xFromStep, const Eigen::VectorXd& yFromStep, Eigen::VectorXd& yToReturn, Eigen::VectorXd& yErrorEstimate);
+
+    boost::weak_ptr<BulirschStoerOde> m_weakThis;
+
+    bool m_initialized;
+
+    double m_maxStepSize;
+    double m_initialStepSize;
+    double m_lastStepSize;
+    double m_nextStepSize;
+    bool   m_ascending;
+
+    int m_numberGood;
+    int m_numberRetried;
+
+    Eigen::VectorXi m_stepSequence;
+    Eigen::VectorXd m_a;
+    Eigen::MatrixXd m_alf;
+    Eigen::VectorXd m_err;
+
+    Eigen::MatrixXd m_interpTable;
+    Eigen::VectorXd m_xInterpTable;
+
+    Eigen::VectorXd m_y;
+    Eigen::VectorXd m_ySav;
+    Eigen::VectorXd m_dydx;
+    Eigen::VectorXd m_yResult;
+    Eigen::VectorXd m_yError;
+    Eigen::VectorXd m_yScale;
+    Eigen::VectorXd m_yMid;
+    Eigen::VectorXd m_yNext;
+    Eigen::VectorXd m_extrapC;
+
+    int m_first;
+    int m_kmax;
+    int m_kopt;
+    double m_eps;
+    double m_epsold;
+    double m_xnew;
+  };
+};
+
+#endif // __BACH_BULIRSCH_STOER_ODE_H__
@@ -0,0 +1,269 @@
+/**********************************************************************
+
+File     : DormandPrinceOde.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the Dormand-Prince 5(4) explicit Runge-Kutta solver.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "DormandPrinceOde.h"
+#include "OdeData.h"
+#include "OdeAccuracySpec.h"
+#include "OdeSolverTelemetry.h"
+#include <algorithm>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  // The Butcher tableau.
+  const double C2 = 1.0/5.0, C3 = 3.0/10.0, C4 = 4.0/5.0, C5 = 8.0/9.0;
+  const double A21 = 1.0/5.0;
+  const double A31 = 3.0/40.0, A32 = 9.0/40.0;
+  const double A41 = 44.0/45.0, A42 = -56.0/15.0, A43 = 32.0/9.0;
+  const double A51 = 19372.0/6561.0, A52 = -25360.0/2187.0, A53 = 64448.0/6561.0, A54 = -212.0/729.0;
+  const double A61 = 9017.0/3168.0, A62 = -355.0/33.0, A63 = 46732.0/5247.0, A64 = 49.0/176.0, A65 = -5103.0/18656.0;
+  const double A71 = 35.0/384.0, A73 = 500.0/1113.0, A74 = 125.0/192.0, A75 = -2187.0/6784.0, A76 = 11.0/84.0;
+
+  // The difference between the fifth and fourth order solutions.
+  const double E1 = 71.0/57600.0, E3 = -71.0/16695.0, E4 = 71.0/1920.0, E5 = -17253.0/339200.0, E6 = 22.0/525.0, E7 = -1.0/40.0;
+
+  // The continuous extension.
+  const double D1 = -12715105075.0/11282082432.0, D3 = 87487479700.0/32700410799.0, D4 = -10690763975.0/1880347072.0,
+               D5 = 701980252875.0/199316789632.0, D6 = -1453857185.0/822651844.0, D7 = 69997945.0/29380423.0;
+
+  // The PI step size controller.
+  const double SAFETY = 0.9;
+  const double BETA = 0.04;
+  const double ALPHA = 0.2-0.75*BETA;
+  const double MIN_SCALE = 0.2;
+  const double MAX_SCALE = 10.0;
+  const double MIN_LAST_ERROR = 1.0e-4;
+}
+
+  //********************
+  //* DormandPrinceOde *
+  //********************
+
+shared_ptr<DormandPrinceOde> DormandPrinceOde::CreateInstance() {
+  shared_ptr<DormandPrinceOde> instance(new DormandPrinceOde());
+  instance->m_weakThis = instance;
+  return instance;
+}
+
+DormandPrinceOde::DormandPrinceOde() :
+  m_initialized(false),
+  m_maxStepSize(1.0e32),
+  m_initialStepSize(0.001),
+  m_lastStepSize(0.0),
+  m_nextStepSize(0.0),
+  m_ascending(true),
+  m_lastError(MIN_LAST_ERROR),
+  m_numberGood(0),
+  m_numberRetried(0),
+  m_denseOutput(false)
+{
+  m_stepSize = m_initialStepSize;
+}
+
+DormandPrinceOde::~DormandPrinceOde() {
+}
+
+void DormandPrinceOde::Solve(shared_ptr<OdeData> odeData, bool reset) {
+  int size = odeData->GetStateLength();
+  if(m_y.rows() != size) {
+    m_y.resize(size);
+    m_dydx.resize(size);
+    m_yNew.resize(size);
+    m_dydxNew.resize(size);
+    m_yTemp.resize(size);
+    m_yError.resize(size);
+    m_yScale.resize(size);
+    m_k2.resize(size);
+    m_k3.resize(size);
+    m_k4.resize(size);
+    m_k5.resize(size);
+    m_k6.resize(size);
+  }
+
+  if(reset || !m_initialized) {
+    m_initialized = true;
+    odeData->ResetStorage();
+    m_ascending = (odeData->GetEndTime()-odeData->GetStartTime() > 0.0 ? true : false);
+
+    double direction = m_ascending ? 1.0 : -1.0;
+    m_stepSize = direction*fabs(m_initialStepSize);
+    m_maxStepSize = direction*fabs(m_maxStepSize);
+    m_lastError = MIN_LAST_ERROR;
+
+    m_numberGood = m_numberRetried = 0;
+    if(m_telemetry) {
+      m_telemetry->Reset();
+    }
+  }
+
+  InitializeAccuracySpec(odeData);
+
+  double x = odeData->GetStartTime();
+  double end = odeData->GetEndTime();
+  double direction = m_ascending ? 1.0 : -1.0;
+  m_y = odeData->GetInitialConditions();
+
+  shared_ptr<OdeEquations> system = odeData->GetOdeSystem();
+
+  bool hasEvents = (system->GetNumberOfEvents() > 0);
+  if(hasEvents) {
+    m_eventLocator.Start(x, m_y, system);
+  }
+  m_denseOutput = (odeData->WantsDenseOutput() || hasEvents);
+  odeData->SetStopFlag(false);
+
+  odeData->SetStoringThisCall(true);
+  EvaluateSystem(system, x, m_y, m_dydx, odeData);
+  StoreData(odeData, x, m_y, m_dydx);
+  odeData->SetStoringThisCall(false);
+
+  while((end-x)*direction > 0.0) {
+    // The last step is cut short to finish at the end time.
+    bool lastStep = ((x+m_stepSize-end)*direction >= 0.0);
+    if(lastStep) {
+      m_stepSize = end-x;
+    }
+
+    double triedStepSize = m_stepSize;
+    SolveStep(x, odeData);
+    if(m_lastStepSize == triedStepSize) {
+      m_numberGood++;
+    }
+    else {
+      m_numberRetried++;
+    }
+    m_stepSize = m_nextStepSize;
+
+    double xNew = (lastStep && m_lastStepSize == triedStepSize ? end : x+m_lastStepSize);
+    double xEvent;
+    bool stopAtEvent = false;
+    if(m_denseOutput) {
+      SetDenseStep(x, xNew);
+      stopAtEvent = (hasEvents && m_eventLocator.HandleEvents(m_denseStep, odeData, xEvent, m_yNew));
+      StoreDenseStep(odeData, m_denseStep);
+    }
+
+    x = (stopAtEvent ? xEvent : xNew);
+    m_y.swap(m_yNew);
+    m_dydx.swap(m_dydxNew);
+
+    // The last stage was evaluated at the end of the step with storing on, so the internal
+    // values are already there, unless the step was cut short at an event or a collector
+    // sampling the dense output has evaluated the equations since.
+    if(stopAtEvent || odeData->WantsDenseOutput()) {
+      odeData->SetStoringThisCall(true);
+      EvaluateSystem(system, x, m_y, m_dydx, odeData);
+      odeData->SetStoringThisCall(false);
+    }
+    StoreData(odeData, x, m_y, m_dydx);
+
+    if(stopAtEvent) {
+      odeData->SetStopFlag(true);
+      break;
+    }
+    if(odeData->GetStopFlag()) {
+      break;
+    }
+  }
+}
+
+void DormandPrinceOde::SolveStep(double x, shared_ptr<OdeData> odeData) {
+  shared_ptr<OdeEquations> system = odeData->GetOdeSystem();
+  double h = m_stepSize;
+  bool rejected = false;
+
+  for(;;) {
+    if(x+h == x) {
+      BACH_LOG_ERROR(L"DormandPrinceOde::SolveStep: Step size underflow");
+      throw std::exception();
+    }
+
+    m_yTemp = m_y+h*A21*m_dydx;
+    EvaluateSystem(system, x+C2*h, m_yTemp, m_k2, odeData);
+    m_yTemp = m_y+h*(A31*m_dydx+A32*m_k2);
+    EvaluateSystem(system, x+C3*h, m_yTemp, m_k3, odeData);
+    m_yTemp = m_y+h*(A41*m_dydx+A42*m_k2+A43*m_k3);
+    EvaluateSystem(system, x+C4*h, m_yTemp, m_k4, odeData);
+    m_yTemp = m_y+h*(A51*m_dydx+A52*m_k2+A53*m_k3+A54*m_k4);
+    EvaluateSystem(system, x+C5*h, m_yTemp, m_k5, odeData);
+    m_yTemp = m_y+h*(A61*m_dydx+A62*m_k2+A63*m_k3+A64*m_k4+A65*m_k5);
+    EvaluateSystem(system, x+h, m_yTemp, m_k6, odeData);
+    m_yNew = m_y+h*(A71*m_dydx+A73*m_k3+A74*m_k4+A75*m_k5+A76*m_k6);
+
+    // The last stage is the derivative at the end, which is stored with the step if it is
+    // accepted and is the first stage of the next one.
+    odeData->SetStoringThisCall(true);
+    EvaluateSystem(system, x+h, m_yNew, m_dydxNew, odeData);
+    odeData->SetStoringThisCall(false);
+
+    m_yError = h*(E1*m_dydx+E3*m_k3+E4*m_k4+E5*m_k5+E6*m_k6+E7*m_dydxNew);
+    double error = GetError();
+    if(error <= 1.0) {
+      double scale = MAX_SCALE;
+      if(error > 0.0) {
+        scale = SAFETY*pow(error, -ALPHA)*pow(m_lastError, BETA);
+        scale = std::min(std::max(scale, MIN_SCALE), MAX_SCALE);
+      }
+
+      // Don't grow straight after a rejection.
+      if(rejected) {
+        scale = std::min(scale, 1.0);
+      }
+      m_lastError = std::max(error, MIN_LAST_ERROR);
+      m_lastStepSize = h;
+      m_nextStepSize = h*scale;
+      if(fabs(m_nextStepSize) > fabs(m_maxStepSize)) {
+        m_nextStepSize = m_maxStepSize;
+      }
+      if(m_telemetry) {
+        m_telemetry->CountAcceptedStep();
+      }
+      return;
+    }
+
+    h *= std::max(SAFETY*pow(error, -ALPHA), MIN_SCALE);
+    rejected = true;
+    if(m_telemetry) {
+      m_telemetry->CountRejectedStep();
+    }
+  }
+}
+
+double DormandPrinceOde::GetError() {
+  // Relative to the larger of the state's size at either end of the step.
+  m_yScale = m_y.cwiseAbs().cwiseMax(m_yNew.cwiseAbs());
+  return GetAccuracySpec()->GetNormalizedError(m_yError, m_yScale);
+}
+
+void DormandPrinceOde::SetDenseStep(double x, double xEnd) {
+  double h = m_lastStepSize;
+  m_denseStep.SetStep(x, xEnd, (int) m_y.size());
+  Matrix<double, Dynamic, 6>& c = m_denseStep.GetCoefficients();
+
+  // The continuous extension is
+  //   y(x+t*h) = r1+t*(r2+(1-t)*(r3+t*(r4+(1-t)*r5)))
+  // with
+  //   r1 = y0, r2 = y1-y0, r3 = h*f0-r2, r4 = r2-h*f1-r3
+  // and r5 from the stages, which multiplied out into powers of t is
+  //   r1+(r2+r3)*t+(r4+r5-r3)*t^2-(r4+2*r5)*t^3+r5*t^4
+  c.col(0) = m_y;
+  c.col(1) = h*m_dydx;
+  c.col(2) = c.col(1)-(m_yNew-m_y);
+  c.col(3) = (m_yNew-m_y)-h*m_dydxNew-c.col(2);
+  c.col(4) = h*(D1*m_dydx+D3*m_k3+D4*m_k4+D5*m_k5+D6*m_k6+D7*m_dydxNew);
+  c.col(2) = c.col(3)+c.col(4)-c.col(2);
+  c.col(3) = -c.col(3)-2.0*c.col(4);
+  c.col(5).setZero();
+}
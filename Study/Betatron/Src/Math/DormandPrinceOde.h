@@ -0,0 +1,103 @@
+/**********************************************************************
+
+File     : DormandPrinceOde.h
+Project  : Bach Simulation
+Purpose  : Header file for the Dormand-Prince 5(4) explicit Runge-Kutta solver.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           An embedded explicit Runge-Kutta pair for systems that are not
+           stiff. The fifth order solution is kept and the fourth order one
+           gives the error estimate. The last stage is evaluated at the end
+           of the step, so it is also the first stage of the next one and
+           each step costs six evaluations of the equations, with no
+           Jacobian. Step sizes follow a PI controller.
+           See Hairer, Norsett and Wanner, Solving Ordinary Differential
+           Equations I, 2nd Edition, pp 178-179 and 191-193.
+
+           Steps are stored at their ends and the last one is shortened to
+           finish exactly at the end time. The continuous extension of the
+           pair gives the dense output, for grid sampling and events.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_DORMAND_PRINCE_ODE_H__
+#define __BACH_DORMAND_PRINCE_ODE_H__
+
+#include "BachDefs.h"
+#include "OdeSolver.h"
+#include "OdeDenseOutput.h"
+#include "OdeEventLocator.h"
+
+namespace Bach {
+
+  //********************
+  //* DormandPrinceOde *
+  //********************
+
+  class DormandPrinceOde : public OdeSolver {
+  public:
+    static boost::shared_ptr<DormandPrinceOde> CreateInstance();
+    virtual ~DormandPrinceOde();
+
+    void Solve(boost::shared_ptr<OdeData> odeData, bool reset = true);
+
+    void SetStepSize(double stepSize)            {  m_initialStepSize = stepSize;  }
+    void SetMaximumStepSize(double maxStepSize)  {  m_maxStepSize = maxStepSize;  }
+
+    int GetNumberGood()       {  return m_numberGood;  }
+    int GetNumberRetried()    {  return m_numberRetried;  }
+
+  protected:
+    DormandPrinceOde();
+
+    // Take one step from x, with m_dydx the derivative there, shrinking it until its error
+    // meets the tolerance. Leaves the end in m_yNew and m_dydxNew.
+    void SolveStep(double x, boost::shared_ptr<OdeData> odeData);
+
+    // The error of the step in m_yError relative to the accuracy spec.
+    double GetError();
+
+    // The continuous extension of the step just taken, from x to xEnd.
+    void SetDenseStep(double x, double xEnd);
+
+    boost::weak_ptr<DormandPrinceOde> m_weakThis;
+
+    bool m_initialized;
+
+    double m_maxStepSize;
+    double m_initialStepSize;
+    double m_lastStepSize;
+    double m_nextStepSize;
+    bool   m_ascending;
+
+    // The error of the last accepted step, for the PI controller.
+    double m_lastError;
+
+    int m_numberGood;
+    int m_numberRetried;
+
+    Eigen::VectorXd m_y;
+    Eigen::VectorXd m_dydx;
+    Eigen::VectorXd m_yNew;
+    Eigen::VectorXd m_dydxNew;
+    Eigen::VectorXd m_yTemp;
+    Eigen::VectorXd m_yError;
+    Eigen::VectorXd m_yScale;
+
+    // The second to sixth stages. The first is m_dydx and the seventh m_dydxNew.
+    Eigen::VectorXd m_k2;
+    Eigen::VectorXd m_k3;
+    Eigen::VectorXd m_k4;
+    Eigen::VectorXd m_k5;
+    Eigen::VectorXd m_k6;
+
+    bool m_denseOutput;
+    OdeDenseOutput m_denseStep;
+    OdeEventLocator m_eventLocator;
+  };
+};
+
+#endif // __BACH_DORMAND_PRINCE_ODE_H__
@@ -0,0 +1,160 @@
+/**********************************************************************
+
+File     : DualNumber.h
+Project  : Bach Simulation
+Purpose  : Header file for dual numbers used in forward mode automatic differentiation.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           A dual number carries a value and its gradient with respect to
+           every seeded input. The gradient has a fixed maximum size so the
+           arithmetic stays on the stack.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_DUAL_NUMBER_H__
+#define __BACH_DUAL_NUMBER_H__
+
+#include "BachDefs.h"
+
+namespace Bach {
+  // The class and its math functions live in their own namespace so that they are found by
+  // argument dependent lookup without hiding the standard functions from the rest of Bach.
+  namespace AutoDiff {
+
+    //**************
+    //* DualNumber *
+    //**************
+
+    template<int MaxSize>
+    class DualNumber {
+    public:
+      typedef Eigen::Matrix<double, Eigen::Dynamic, 1, 0, MaxSize, 1> Gradient;
+
+      DualNumber() : m_value(0.0) {}
+      DualNumber(double value) : m_value(value) {}
+      DualNumber(double value, const Gradient& gradient) : m_value(value), m_gradient(gradient) {}
+
+      // An independent variable, the index'th of size inputs.
+      static DualNumber Variable(double value, int index, int size) {
+        DualNumber result(value, Gradient::Zero(size));
+        result.m_gradient(index) = 1.0;
+        return result;
+      }
+
+      double Value() const { return m_value; }
+      const Gradient& GetGradient() const { return m_gradient; }
+
+      // The derivative with respect to input index. Constants have an empty gradient.
+      double Derivative(int index) const { return (index < m_gradient.rows() ? m_gradient(index) : 0.0); }
+
+      // value = f(x) with f'(x) = derivative, for functions that only have a double version.
+      DualNumber Chain(double value, double derivative) const { return DualNumber(value, derivative*m_gradient); }
+
+      DualNumber& operator+=(const DualNumber& b) { AddScaled(1.0, b); m_value += b.m_value; return *this; }
+      DualNumber& operator-=(const DualNumber& b) { AddScaled(-1.0, b); m_value -= b.m_value; return *this; }
+      DualNumber& operator*=(const DualNumber& b) { *this = *this*b; return *this; }
+      DualNumber& operator/=(const DualNumber& b) { *this = *this/b; return *this; }
+
+      DualNumber operator-() const { return DualNumber(-m_value, -m_gradient); }
+
+      friend DualNumber operator+(const DualNumber& a, const DualNumber& b) { DualNumber r(a); r += b; return r; }
+      friend DualNumber operator-(const DualNumber& a, const DualNumber& b) { DualNumber r(a); r -= b; return r; }
+
+      friend DualNumber operator*(const DualNumber& a, const DualNumber& b) {
+        DualNumber r(a.m_value*b.m_value, b.m_value*a.m_gradient);
+        r.AddScaled(a.m_value, b);
+        return r;
+      }
+
+      friend DualNumber operator/(const DualNumber& a, const DualNumber& b) {
+        double inv = 1.0/b.m_value;
+        DualNumber r(a.m_value*inv, inv*a.m_gradient);
+        r.AddScaled(-a.m_value*inv*inv, b);
+        return r;
+      }
+
+      friend DualNumber operator*(double a, const DualNumber& b) { return DualNumber(a*b.m_value, a*b.m_gradient); }
+      friend DualNumber operator*(const DualNumber& a, double b) { return DualNumber(a.m_value*b, b*a.m_gradient); }
+      friend DualNumber operator/(const DualNumber& a, double b) { return DualNumber(a.m_value/b, a.m_gradient/b); }
+
+      friend bool operator<(const DualNumber& a, const DualNumber& b)  { return a.m_value < b.m_value; }
+      friend bool operator>(const DualNumber& a, const DualNumber& b)  { return a.m_value > b.m_value; }
+      friend bool operator<=(const DualNumber& a, const DualNumber& b) { return a.m_value <= b.m_value; }
+      friend bool operator>=(const DualNumber& a, const DualNumber& b) { return a.m_value >= b.m_value; }
+      friend bool operator==(const DualNumber& a, const DualNumber& b) { return a.m_value == b.m_value; }
+      friend bool operator!=(const DualNumber& a, const DualNumber& b) { return a.m_value != b.m_value; }
+
+    private:
+      // gradient += scale*b.gradient, where either side may be a constant with an empty gradient.
+      void AddScaled(double scale, const DualNumber& b) {
+        if(b.m_gradient.rows() == 0) {
+          return;
+        }
+        if(m_gradient.rows() == 0) {
+          m_gradient = scale*b.m_gradient;
+        }
+        else {
+          m_gradient += scale*b.m_gradient;
+        }
+      }
+
+      double m_value;
+      Gradient m_gradient;
+    };
+
+    template<int N> inline DualNumber<N> sqrt(const DualNumber<N>& a) {
+      double root = std::sqrt(a.Value());
+      return a.Chain(root, 0.5/root);
+    }
+
+    template<int N> inline DualNumber<N> sin(const DualNumber<N>& a)  { return a.Chain(std::sin(a.Value()), std::cos(a.Value())); }
+    template<int N> inline DualNumber<N> cos(const DualNumber<N>& a)  { return a.Chain(std::cos(a.Value()), -std::sin(a.Value())); }
+    template<int N> inline DualNumber<N> exp(const DualNumber<N>& a)  { double e = std::exp(a.Value()); return a.Chain(e, e); }
+    template<int N> inline DualNumber<N> log(const DualNumber<N>& a)  { return a.Chain(std::log(a.Value()), 1.0/a.Value()); }
+    template<int N> inline DualNumber<N> abs(const DualNumber<N>& a)  { return (a.Value() < 0.0 ? -a : a); }
+
+    template<int N> inline DualNumber<N> pow(const DualNumber<N>& a, double b) {
+      double p = std::pow(a.Value(), b);
+      return a.Chain(p, b*std::pow(a.Value(), b-1.0));
+    }
+
+    template<int N> inline DualNumber<N> atan2(const DualNumber<N>& y, const DualNumber<N>& x) {
+      double r2 = x.Value()*x.Value()+y.Value()*y.Value();
+      return (x*y.Chain(0.0, 1.0)-y*x.Chain(0.0, 1.0))/r2+std::atan2(y.Value(), x.Value());
+    }
+
+    template<int N> inline DualNumber<N> Square(const DualNumber<N>& a) { return a*a; }
+  };
+
+  using AutoDiff::DualNumber;
+
+  // Lets code templated on the scalar type handle double and DualNumber alike.
+  inline double ValueOf(double a) { return a; }
+  template<int N> inline double ValueOf(const DualNumber<N>& a) { return a.Value(); }
+
+  inline double Chain(double, double value, double) { return value; }
+  template<int N> inline DualNumber<N> Chain(const DualNumber<N>& a, double value, double derivative) { return a.Chain(value, derivative); }
+};
+
+namespace Eigen {
+  template<int N> struct NumTraits<Bach::DualNumber<N> > : NumTraits<double> {
+    typedef Bach::DualNumber<N> Real;
+    typedef Bach::DualNumber<N> NonInteger;
+    typedef Bach::DualNumber<N> Nested;
+    typedef double Literal;
+    enum {
+      IsComplex = 0,
+      IsInteger = 0,
+      IsSigned = 1,
+      RequireInitialization = 1,
+      ReadCost = 1,
+      AddCost = N,
+      MulCost = 2*N
+    };
+  };
+};
+
+#endif // __BACH_DUAL_NUMBER_H__
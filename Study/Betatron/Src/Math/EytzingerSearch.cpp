@@ -0,0 +1,193 @@
+/**********************************************************************
+
+File     : EytzingerSearch.cpp
+Project  : Bach Simulation
+Purpose  : Source file for a table search of uniform or cache friendly layouts.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "EytzingerSearch.h"
+#include <algorithm>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  // How far, as a fraction of the spacing, a value may be from an even grid for the table to
+  // count as uniform. The index from the spacing is checked against the values either side,
+  // so this only keeps that to a step.
+  const double UNIFORM_TOLERANCE = 1.0e-6;
+
+  // The descendants of a node three levels down, which are next to each other and fill a
+  // cache line, are fetched while the levels between are searched.
+  const int PREFETCH_DESCENDANTS = 8;
+
+  inline void Prefetch(const double* layout, int node, int size) {
+#if defined(__GNUC__)
+    __builtin_prefetch(layout+std::min(PREFETCH_DESCENDANTS*node, size));
+#endif
+  }
+
+  // Shift off the trailing ones of node and the zero before them.
+  inline int BackUp(int node) {
+#if defined(__GNUC__)
+    return node >> __builtin_ffs(~node);
+#else
+    while(node & 1) {
+      node >>= 1;
+    }
+    return node >> 1;
+#endif
+  }
+}
+
+  //*******************
+  //* EytzingerSearch *
+  //*******************
+
+EytzingerSearch::EytzingerSearch() :
+  TableSearch(-1),
+  m_tableData(0),
+  m_layoutSize(0),
+  m_uniform(false),
+  m_start(0.0),
+  m_inverseSpacing(0.0)
+{
+  m_ascending = true;
+}
+
+int EytzingerSearch::Find(double x, const Ref<const VectorXd>& y) {
+  int size = (int) y.rows();
+  if(size == 0) {
+    m_indexLow = -1;
+    return m_indexLow;
+  }
+
+  bool ascending = (y(size-1) > y(0));
+  if(y.data() != m_tableData || ascending != m_ascending || size < m_layoutSize || size >= 2*m_layoutSize) {
+    m_ascending = ascending;
+    Build(y);
+  }
+  m_size = size;
+
+  int index = (m_uniform ? FindUniform(x, y) : FindInLayout(x));
+
+  // After the last value in the layout, so among those added since.
+  if(index == m_layoutSize-1 && size > m_layoutSize) {
+    m_indexLow = index;
+    m_indexHigh = size;
+    Bisection(x, y);
+    index = m_indexLow;
+  }
+
+  m_indexLow = index;
+  return m_indexLow;
+}
+
+void EytzingerSearch::TableChanged() {
+  m_tableData = 0;
+  m_layoutSize = 0;
+}
+
+void EytzingerSearch::Build(const Ref<const VectorXd>& y) {
+  m_tableData = y.data();
+  m_layoutSize = (int) y.rows();
+
+  m_uniform = false;
+  if(m_layoutSize > 1) {
+    double spacing = (y(m_layoutSize-1)-y(0))/(m_layoutSize-1);
+    m_uniform = (spacing != 0.0);
+    for(int i=1; i<m_layoutSize-1 && m_uniform; i++) {
+      m_uniform = (fabs(y(i)-(y(0)+i*spacing)) <= UNIFORM_TOLERANCE*fabs(spacing));
+    }
+    m_start = y(0);
+    m_inverseSpacing = (m_uniform ? 1.0/spacing : 0.0);
+  }
+  if(m_uniform) {
+    return;
+  }
+
+  m_layout.resize(m_layoutSize+1);
+  m_layoutIndex.resize(m_layoutSize+1);
+  FillLayout(y, 0, 1);
+}
+
+int EytzingerSearch::FillLayout(const Ref<const VectorXd>& y, int index, int node) {
+  // In order through the tree, so the values go in in the order of the table.
+  if(node <= m_layoutSize) {
+    index = FillLayout(y, index, 2*node);
+    m_layout(node) = (m_ascending ? y(index) : -y(index));
+    m_layoutIndex[node] = index;
+    index = FillLayout(y, index+1, 2*node+1);
+  }
+  return index;
+}
+
+int EytzingerSearch::FindUniform(double x, const Ref<const VectorXd>& y) const {
+  int last = m_layoutSize-1;
+  double position = (x-m_start)*m_inverseSpacing;
+
+  int index;
+  if(!(position > 0.0)) {
+    index = -1;
+  }
+  else if(position > last) {
+    index = last;
+  }
+  else {
+    index = (int) ceil(position)-1;
+  }
+
+  // The spacing is only close to even, so the values either side have the last word.
+  if(m_ascending) {
+    while(index < last && y(index+1) < x) {
+      index++;
+    }
+    while(index >= 0 && !(y(index) < x)) {
+      index--;
+    }
+  }
+  else {
+    while(index < last && y(index+1) >= x) {
+      index++;
+    }
+    while(index >= 0 && !(y(index) >= x)) {
+      index--;
+    }
+  }
+  return index;
+}
+
+int EytzingerSearch::FindInLayout(double x) const {
+  const double* layout = m_layout.data();
+  double key = (m_ascending ? x : -x);
+  int size = m_layoutSize;
+
+  // Left where the value is not before the target, right where it is. As with bisection an
+  // equal value is before the target in a descending table but not in an ascending one.
+  int node = 1;
+  if(m_ascending) {
+    while(node <= size) {
+      Prefetch(layout, node, size);
+      node = 2*node+(layout[node] < key);
+    }
+  }
+  else {
+    while(node <= size) {
+      Prefetch(layout, node, size);
+      node = 2*node+(layout[node] <= key);
+    }
+  }
+
+  // Back up past the last right turns and the left turn before them, to the first value
+  // that is not before the target, or to zero if they all are.
+  node = BackUp(node);
+
+  return (node == 0 ? size : m_layoutIndex[node])-1;
+}
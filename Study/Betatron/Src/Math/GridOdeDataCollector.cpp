@@ -0,0 +1,125 @@
+/**********************************************************************
+
+File     : GridOdeDataCollector.cpp
+Project  : Bach Simulation
+Purpose  : Source file for an ODE data collector that samples on a fixed grid.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "GridOdeDataCollector.h"
+#include "OdeDenseOutput.h"
+#include "OdeEquations.h"
+#include "OdeData.h"
+#include "SampledDerivedData.h"
+#include "SampledData.h"
+#include <algorithm>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  // A time this close to the end, relative to the interval, is taken as the end.
+  const double END_TOLERANCE = 1.0e-9;
+}
+
+  //************************
+  //* GridOdeDataCollector *
+  //************************
+
+GridOdeDataCollector::GridOdeDataCollector(const std::vector<double>& times) :
+  m_times(times),
+  m_interval(0.0),
+  m_nextIndex(0)
+{
+}
+
+GridOdeDataCollector::GridOdeDataCollector(double interval) :
+  m_interval(fabs(interval)),
+  m_nextIndex(0)
+{
+  if(m_interval == 0.0) {
+    BACH_LOG_ERROR(L"GridOdeDataCollector: The sample interval must not be zero");
+    throw std::exception();
+  }
+}
+
+GridOdeDataCollector::~GridOdeDataCollector() {
+}
+
+void GridOdeDataCollector::Restart() {
+  OdeDataCollector::Restart();
+  m_nextIndex = 0;
+}
+
+void GridOdeDataCollector::StoreData(double time, const VectorXd& states, const VectorXd& derivs, shared_ptr<OdeData> odeData) {
+  if(!m_stateData || !m_internalData) {
+    InitializeWithSizes(odeData->GetStateLength(), odeData->GetInternalLength());
+  }
+}
+
+void GridOdeDataCollector::StoreDenseStep(const OdeDenseOutput& step, shared_ptr<OdeData> odeData) {
+  long numberOfTimes = GetNumberOfGridTimes(odeData);
+  shared_ptr<OdeEquations> system = odeData->GetOdeSystem();
+  m_dydx.resize(odeData->GetStateLength());
+
+  // Times before the start of the solve are skipped.
+  double direction = (odeData->GetEndTime() >= odeData->GetStartTime() ? 1.0 : -1.0);
+  while(m_nextIndex < numberOfTimes && direction*(GetGridTime(m_nextIndex, odeData)-step.GetStartTime()) < 0.0) {
+    m_nextIndex++;
+  }
+
+  while(m_nextIndex < numberOfTimes) {
+    double x = GetGridTime(m_nextIndex, odeData);
+    if(!step.Contains(x)) {
+      break;
+    }
+
+    step.Evaluate(x, m_y);
+    odeData->SetStoringThisCall(true);
+    system->Evaluate(x, m_y, m_dydx, odeData);
+    odeData->SetStoringThisCall(false);
+
+    StoreStates(x, m_y, m_dydx, odeData);
+    StoreInternals(x, odeData);
+    m_nextIndex++;
+  }
+}
+
+long GridOdeDataCollector::GetNumberOfGridTimes(shared_ptr<OdeData> odeData) {
+  if(m_interval == 0.0) {
+    return (long) m_times.size();
+  }
+  double span = fabs(odeData->GetEndTime()-odeData->GetStartTime());
+  return (long) floor(span/m_interval+END_TOLERANCE)+1;
+}
+
+double GridOdeDataCollector::GetGridTime(long index, shared_ptr<OdeData> odeData) {
+  if(m_interval == 0.0) {
+    return m_times[index];
+  }
+
+  // Multiplied rather than accumulated, so the spacing does not drift. The last time can
+  // land just past the end, as 3*0.1 does past 0.3, and is then the end itself.
+  double start = odeData->GetStartTime();
+  double end = odeData->GetEndTime();
+  double direction = (end >= start ? 1.0 : -1.0);
+  double time = start+direction*index*m_interval;
+  if(direction*(time-end) > 0.0) {
+    time = end;
+  }
+  return time;
+}
+
+int GridOdeDataCollector::GetNewStateSamplesSize(double x, shared_ptr<OdeData> odeData) {
+  return std::max((int) GetNumberOfGridTimes(odeData), m_stateData->GetNumberOfSamples()+1);
+}
+
+int GridOdeDataCollector::GetNewInternalSamplesSize(double x, shared_ptr<OdeData> odeData) {
+  return std::max((int) GetNumberOfGridTimes(odeData), m_internalData->GetNumberOfSamples()+1);
+}
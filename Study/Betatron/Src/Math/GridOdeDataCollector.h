@@ -0,0 +1,69 @@
+/**********************************************************************
+
+File     : GridOdeDataCollector.h
+Project  : Bach Simulation
+Purpose  : Header file for an ODE data collector that samples on a fixed grid.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Rather than storing the solver's step end points, the states are
+           taken from the dense output of each step at the times of a grid
+           chosen by the caller, so the solver can take long steps while the
+           output keeps its resolution. The equations are evaluated once at
+           each grid time, storing, so the derivatives and internal values
+           are those of the equations rather than interpolated.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_GRID_ODE_DATA_COLLECTOR_H__
+#define __BACH_GRID_ODE_DATA_COLLECTOR_H__
+
+#include "OdeDataCollector.h"
+#include <vector>
+
+namespace Bach {
+
+  //************************
+  //* GridOdeDataCollector *
+  //************************
+
+  class GridOdeDataCollector : public OdeDataCollector {
+  public:
+    // Samples at each of the times, which must run in the direction of the solve.
+    GridOdeDataCollector(const std::vector<double>& times);
+
+    // Samples every interval from the start time of the solve to its end time.
+    GridOdeDataCollector(double interval);
+
+    virtual ~GridOdeDataCollector();
+
+    // The step end points are not stored.
+    void StoreData(double time, const Eigen::VectorXd& states, const Eigen::VectorXd& derivs, boost::shared_ptr<OdeData> odeData);
+
+    bool WantsDenseOutput() { return true; }
+    void StoreDenseStep(const OdeDenseOutput& step, boost::shared_ptr<OdeData> odeData);
+
+    void Restart();
+
+    // The number of grid times within the solve.
+    long GetNumberOfGridTimes(boost::shared_ptr<OdeData> odeData);
+
+  protected:
+    double GetGridTime(long index, boost::shared_ptr<OdeData> odeData);
+
+    // The storage grows straight to the size of the grid.
+    virtual int GetNewStateSamplesSize(double x, boost::shared_ptr<OdeData> odeData);
+    virtual int GetNewInternalSamplesSize(double x, boost::shared_ptr<OdeData> odeData);
+
+    std::vector<double> m_times;
+    double m_interval;
+    long m_nextIndex;
+
+    Eigen::VectorXd m_y;
+    Eigen::VectorXd m_dydx;
+  };
+};
+
+#endif // __BACH_GRID_ODE_DATA_COLLECTOR_H__
@@ -83,6 +83,25 @@ void HermiteInterp::Interpolate(
   yResult = coeff1*y0 + coeff2*y1 + coeff3*dy0 + coeff4*dy1;
 }
 
+void HermiteInterp::Interpolate(const Eigen::VectorXd& xTargets, int first, int count, double x0, double x1, const Eigen::MatrixXd& y, Eigen::MatrixXd& coefficients, Eigen::MatrixXd& yResult) {
+  if(coefficients.rows() != 4 || coefficients.cols() < count) {
+    coefficients.resize(4, count);
+  }
+
+  double range = x1-x0;
+  for(int k=0; k<count; k++) {
+    double d1 = (xTargets(first+k)-x0)/range;
+    double d2 = d1*d1;
+    double d3 = d2*d1;
+    coefficients(1, k) = 3.0*d2-2.0*d3;
+    coefficients(0, k) = 1.0-coefficients(1, k);
+    coefficients(3, k) = (d3-d2)*range;
+    coefficients(2, k) = coefficients(3, k)+(d1-d2)*range;
+  }
+
+  yResult.middleCols(first, count).noalias() = y*coefficients.leftCols(count);
+}
+
   //*******************
   //* HermiteInterp1D *
   //*******************
@@ -39,6 +39,11 @@ namespace Bach {
     static Real Interpolate(Real xTarget, Real x0, Real x1, Real y0, Real y1, Real dy0, Real dy1);
     static Real Interpolate(Real xTarget, const Eigen::VectorXd& x, const Eigen::VectorXd& y, const Eigen::VectorXd& dy, int index = 0);
     static void   Interpolate(Real xTarget, Real x0, Real x1, const Eigen::VectorXd& y0, const Eigen::VectorXd& y1, const Eigen::VectorXd& dy0, const Eigen::VectorXd& dy1, Eigen::VectorXd& yResult);
+
+    // The values at count targets from xTargets(first) on, into the same columns of yResult. The
+    // columns of y are y0, y1, dy0 and dy1, and the coefficients of each target are gathered into
+    // coefficients so that all of them are applied in one matrix product.
+    static void   Interpolate(const Eigen::VectorXd& xTargets, int first, int count, Real x0, Real x1, const Eigen::MatrixXd& y, Eigen::MatrixXd& coefficients, Eigen::MatrixXd& yResult);
   };
 
   //*******************
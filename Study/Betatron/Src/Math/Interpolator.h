@@ -66,7 +66,7 @@ namespace Bach {
       bool ascending = x(0) < x(m_interpSize-1);
 
       if((ascending && (x(m_interpSize-1) < xTarget && xTarget < x(0))) || (!ascending && (x(0) < xTarget && xTarget <= x(m_interpSize-1)))) {
-        Bach::Log(L"WARNING: Interpolator::CheckForExtrapolation: Attempted extrapolation to %f (range %f to %f)", xTarget, x(0), x(m_interpSize-1));
+        BACH_LOG_WARNING(L"Interpolator::CheckForExtrapolation: Attempted extrapolation to %f (range %f to %f)", xTarget, x(0), x(m_interpSize-1));
       }
     }
     void SetCheckExtrapolationFlag(bool f) { m_checkExtrapFlag = f; }
@@ -9,6 +9,8 @@ Revisions: Original definition by Lawrence Gunn.
            Updated by Lawrence Gunn.
            2013/01/28
 
+           The columns found at once on a pool.
+           2026/10/18
 
 Copyright (c) 1992-2013 by Lawrence Gunn
 All Rights Reserved.
@@ -17,6 +19,8 @@ All Rights Reserved.
 
 #include "Jacobian.h"
 #include "MultivariateDerivatives.h"
+#include "WorkStealingPool.h"
+#include <thread>
 
 using namespace Bach;
 using namespace boost;
@@ -27,14 +31,7 @@ using namespace Eigen;
   //************
 
 void Jacobian::Start(const Eigen::VectorXd& t, const Eigen::VectorXd& step) {
-  if(m_numberOfColumns != m_derivativeFinder->GetLength()) {
-    m_numberOfColumns = m_derivativeFinder->GetLength();
-
-    m_jacobian.resize(m_numberOfColumns, m_numberOfColumns);
-    m_errorMatrix.resize(m_numberOfColumns, m_numberOfColumns);
-    m_target.resize(m_numberOfColumns);
-    m_stepSize.resize(m_numberOfColumns);
-  }
+  Resize();
 
   m_target = t;
   m_stepSize = step;
@@ -73,3 +70,118 @@ void Jacobian::SetFunctionValues(const Eigen::VectorXd& f) {
 bool Jacobian::GetIsFinished() {
   return m_complete;
 }
+
+void Jacobian::Find(const VectorXd& t, const VectorXd& step, const Function& function, const FunctionFactory& makeFunction) {
+  Resize();
+  m_target = t;
+  m_stepSize = step;
+
+  Function first;
+  if(m_pool && makeFunction && CreateSlots()) {
+    first = makeFunction();
+  }
+
+  if(!first) {
+    m_values.resize(m_numberOfColumns);
+    Eigen::VectorXd target;
+    for(int column=0; column<m_numberOfColumns; column++) {
+      FindColumn(column, *m_derivativeFinder, m_accuracySpec, function, target, m_values);
+    }
+    m_complete = true;
+    return;
+  }
+
+  // Each thread copies the function the first time it finds a column, and the accuracy spec
+  // too as it keeps the last normalized error. The copies of this call's function are
+  // dropped at the end, as the function may not be the same next time.
+  for(size_t i=0; i<m_slots.size(); i++) {
+    m_slots[i].accuracySpec.reset();
+  }
+  m_slots[m_pool->GetWorkerIndex()+1].function = first;
+
+  // Slot 0 is the caller's alone. Other threads off the pool, waiting on batches of their own,
+  // may take a column too, and find it with a slot made for just that column.
+  std::thread::id callerId = std::this_thread::get_id();
+
+  try {
+    m_pool->ParallelFor(m_numberOfColumns, [this, &makeFunction, callerId](int column) {
+      int index = m_pool->GetWorkerIndex();
+      ColumnSlot stolen;
+      if(index < 0 && std::this_thread::get_id() != callerId) {
+        stolen.finder = m_derivativeFinder->Clone();
+        stolen.values.resize(m_numberOfColumns);
+      }
+      ColumnSlot& slot = (stolen.finder ? stolen : m_slots[index+1]);
+      if(!slot.function) {
+        slot.function = makeFunction();
+        if(!slot.function) {
+          BACH_LOG_ERROR(L"Jacobian::Find: The function could be copied once but not again");
+          throw std::exception();
+        }
+      }
+      if(!slot.accuracySpec && m_accuracySpec) {
+        slot.accuracySpec = m_accuracySpec->Clone();
+      }
+      FindColumn(column, *slot.finder, slot.accuracySpec, slot.function, slot.target, slot.values);
+    });
+  }
+  catch(...) {
+    ReleaseFunctions();
+    throw;
+  }
+
+  ReleaseFunctions();
+  m_complete = true;
+}
+
+void Jacobian::ReleaseFunctions() {
+  for(size_t i=0; i<m_slots.size(); i++) {
+    m_slots[i].function = Function();
+  }
+}
+
+void Jacobian::Resize() {
+  if(m_numberOfColumns != m_derivativeFinder->GetLength()) {
+    m_numberOfColumns = m_derivativeFinder->GetLength();
+
+    m_jacobian.resize(m_numberOfColumns, m_numberOfColumns);
+    m_errorMatrix.resize(m_numberOfColumns, m_numberOfColumns);
+    m_target.resize(m_numberOfColumns);
+    m_stepSize.resize(m_numberOfColumns);
+  }
+}
+
+bool Jacobian::CreateSlots() {
+  // The derivative finders are kept between calls, as Start clears everything they hold.
+  int numSlots = m_pool->GetNumberOfThreads()+1;
+  if((int) m_slots.size() == numSlots) {
+    return true;
+  }
+
+  m_slots.clear();
+  std::vector<ColumnSlot> slots(numSlots);
+  for(int i=0; i<numSlots; i++) {
+    slots[i].finder = m_derivativeFinder->Clone();
+    if(!slots[i].finder) {
+      return false;
+    }
+    slots[i].values.resize(m_numberOfColumns);
+  }
+  m_slots.swap(slots);
+  return true;
+}
+
+void Jacobian::FindColumn(int column, MultivariateDerivatives& finder, const shared_ptr<NDimAccuracySpec>& spec,
+                          const Function& function, VectorXd& target, VectorXd& values) {
+  // The same steps as Start, GetNewValue and SetFunctionValues take for the column.
+  target = m_target;
+  finder.Start(m_target(column), m_stepSize(column));
+  do {
+    target(column) = finder.GetNewValue();
+    function(target, values);
+    finder.SetFunctionValues(values);
+  } while(!finder.GetIsFinished(spec));
+
+  m_jacobian.col(column) = finder.GetDerivatives();
+  m_errorMatrix.col(column) = finder.GetError();
+}
@@ -9,6 +9,10 @@ Revisions: Original definition by Lawrence Gunn.
            Updated by Lawrence Gunn.
            2013/01/31
 
+           Find evaluates the columns at once on a WorkStealingPool, each
+           thread with its own copy of the function.
+           2026/10/18
+
 Copyright (c) 1992-2013 by Lawrence Gunn
 All Rights Reserved.
 
@@ -18,9 +22,13 @@ All Rights Reserved.
 #define __BACH_JACOBIAN_H__
 
 #include "BachDefs.h"
+#include <functional>
+#include <vector>
 
 namespace Bach {
 
+  class WorkStealingPool;
+
   //************
   //* Jacobian *
   //************
@@ -30,9 +38,25 @@ namespace Bach {
     Jacobian() : m_complete(true), m_numberOfColumns(0) {}
     ~Jacobian() {}
 
-    void SetDerivativeFinder(boost::shared_ptr<MultivariateDerivatives> derivativeFinder) { m_derivativeFinder = derivativeFinder; }
+    void SetDerivativeFinder(boost::shared_ptr<MultivariateDerivatives> derivativeFinder) { m_derivativeFinder = derivativeFinder; m_slots.clear(); }
     void SetAccuracySpec(boost::shared_ptr<NDimAccuracySpec> accuracySpec) { m_accuracySpec = accuracySpec; }
 
+    // The pool Find evaluates the columns on. Without one they are evaluated in turn.
+    void SetPool(boost::shared_ptr<WorkStealingPool> pool) { m_pool = pool; m_slots.clear(); }
+    boost::shared_ptr<WorkStealingPool> GetPool() { return m_pool; }
+
+    // The function values f at y.
+    typedef std::function<void(const Eigen::VectorXd& y, Eigen::VectorXd& f)> Function;
+
+    // Makes a function that can be called on one thread while those made before are called on
+    // others, or returns an empty one when the function can't be copied.
+    typedef std::function<Function()> FunctionFactory;
+
+    // The whole Jacobian about target, the same as from Start and the calls below. With a pool,
+    // and a derivative finder and function that can be copied, the columns are found at once,
+    // each thread with its own copies made by makeFunction. Otherwise function finds them in turn.
+    void Find(const Eigen::VectorXd& target, const Eigen::VectorXd& step, const Function& function, const FunctionFactory& makeFunction);
+
     void Start(const Eigen::VectorXd& target, const Eigen::VectorXd& step);
 
     const Eigen::VectorXd& GetNewValue();
@@ -44,6 +68,26 @@ namespace Bach {
     bool GetIsFinished();
 
   protected:
+    void Resize();
+    bool CreateSlots();
+    void ReleaseFunctions();
+    void FindColumn(int column, MultivariateDerivatives& finder, const boost::shared_ptr<NDimAccuracySpec>& spec,
+                    const Function& function, Eigen::VectorXd& target, Eigen::VectorXd& values);
+
+    // What a thread needs to find columns of its own. Slot 0 is for the caller of Find from off
+    // the pool and slot i+1 for worker i.
+    struct ColumnSlot {
+      boost::shared_ptr<MultivariateDerivatives> finder;
+      boost::shared_ptr<NDimAccuracySpec> accuracySpec;
+      Function function;
+      Eigen::VectorXd target;
+      Eigen::VectorXd values;
+    };
+
+    boost::shared_ptr<WorkStealingPool> m_pool;
+    std::vector<ColumnSlot> m_slots;
+    Eigen::VectorXd m_values;
+
     boost::shared_ptr<MultivariateDerivatives> m_derivativeFinder;
     boost::shared_ptr<NDimAccuracySpec> m_accuracySpec;
     Eigen::MatrixXd m_jacobian;
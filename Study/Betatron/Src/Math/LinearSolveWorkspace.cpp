@@ -0,0 +1,55 @@
+/**********************************************************************
+
+File     : LinearSolveWorkspace.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the preallocated linear solves of the semi-implicit ODE steps.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "LinearSolveWorkspace.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+  //************************
+  //* LinearSolveWorkspace *
+  //************************
+
+shared_ptr<LinearSolveWorkspace> LinearSolveWorkspace::CreateInstance(int size) {
+  // Add a case here to give another state size its own fixed size workspace.
+  switch(size) {
+    case 6 :
+      return shared_ptr<LinearSolveWorkspace>(new FixedLinearSolveWorkspace<6>());
+    default :
+      return shared_ptr<LinearSolveWorkspace>(new DynamicLinearSolveWorkspace(size));
+  }
+}
+
+  //*******************************
+  //* DynamicLinearSolveWorkspace *
+  //*******************************
+
+DynamicLinearSolveWorkspace::DynamicLinearSolveWorkspace(int size) :
+  m_a(size, size),
+  m_lu(size),
+  m_b(size)
+{
+}
+
+void DynamicLinearSolveWorkspace::Factor(double stepSize, const MatrixXd& dfdy) {
+  m_a = -stepSize*dfdy;
+  m_a.diagonal().array() += 1.0;
+  m_lu.compute(m_a);
+  m_numberOfFactorizations++;
+}
+
+void DynamicLinearSolveWorkspace::Solve(const VectorXd& b, VectorXd& x) {
+  m_b = b;
+  x = m_lu.solve(m_b);
+}
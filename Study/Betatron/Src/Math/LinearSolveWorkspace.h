@@ -0,0 +1,113 @@
+/**********************************************************************
+
+File     : LinearSolveWorkspace.h
+Project  : Bach Simulation
+Purpose  : Header file for the preallocated linear solves of the semi-implicit ODE steps.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Factors (I - h*dfdy) with a partial pivot LU held in storage that is
+           allocated once, then solves against it for every sub-step. Small
+           state sizes use fixed size Eigen matrices so the factorization and
+           solves are unrolled and never touch the heap.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_LINEAR_SOLVE_WORKSPACE_H__
+#define __BACH_LINEAR_SOLVE_WORKSPACE_H__
+
+#include "BachDefs.h"
+
+namespace Bach {
+
+  //************************
+  //* LinearSolveWorkspace *
+  //************************
+
+  class LinearSolveWorkspace {
+  public:
+    // Chooses a fixed size workspace when one is compiled in for size, a dynamic one otherwise.
+    static boost::shared_ptr<LinearSolveWorkspace> CreateInstance(int size);
+
+    virtual ~LinearSolveWorkspace() {}
+
+    // Factor (I - stepSize*dfdy).
+    virtual void Factor(double stepSize, const Eigen::MatrixXd& dfdy) = 0;
+
+    // x = (I - stepSize*dfdy)^-1 b for the last factorization. x and b may be the same vector.
+    virtual void Solve(const Eigen::VectorXd& b, Eigen::VectorXd& x) = 0;
+
+    virtual int GetSize() const = 0;
+    virtual bool IsFixedSize() const = 0;
+
+    int GetNumberOfFactorizations() const  {  return m_numberOfFactorizations;  }
+    void ResetNumberOfFactorizations()     {  m_numberOfFactorizations = 0;  }
+
+  protected:
+    LinearSolveWorkspace() : m_numberOfFactorizations(0) {}
+
+    int m_numberOfFactorizations;
+  };
+
+  //*****************************
+  //* FixedLinearSolveWorkspace *
+  //*****************************
+
+  template<int Size>
+  class FixedLinearSolveWorkspace : public LinearSolveWorkspace {
+  public:
+    typedef Eigen::Matrix<double, Size, Size> Matrix;
+    typedef Eigen::Matrix<double, Size, 1> Vector;
+
+    FixedLinearSolveWorkspace() {}
+
+    void Factor(double stepSize, const Eigen::MatrixXd& dfdy) {
+      m_a = -stepSize*dfdy;
+      m_a.diagonal().array() += 1.0;
+      m_lu.compute(m_a);
+      m_numberOfFactorizations++;
+    }
+
+    void Solve(const Eigen::VectorXd& b, Eigen::VectorXd& x) {
+      m_b = b;
+      m_x = m_lu.solve(m_b);
+      x = m_x;
+    }
+
+    int GetSize() const      {  return Size;  }
+    bool IsFixedSize() const {  return true;  }
+
+  protected:
+    Matrix m_a;
+    Eigen::PartialPivLU<Matrix> m_lu;
+    Vector m_b;
+    Vector m_x;
+
+  public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  //*******************************
+  //* DynamicLinearSolveWorkspace *
+  //*******************************
+
+  class DynamicLinearSolveWorkspace : public LinearSolveWorkspace {
+  public:
+    DynamicLinearSolveWorkspace(int size);
+
+    void Factor(double stepSize, const Eigen::MatrixXd& dfdy);
+    void Solve(const Eigen::VectorXd& b, Eigen::VectorXd& x);
+
+    int GetSize() const      {  return (int) m_a.rows();  }
+    bool IsFixedSize() const {  return false;  }
+
+  protected:
+    Eigen::MatrixXd m_a;
+    Eigen::PartialPivLU<Eigen::MatrixXd> m_lu;
+    Eigen::VectorXd m_b;
+  };
+};
+
+#endif // __BACH_LINEAR_SOLVE_WORKSPACE_H__
@@ -40,6 +40,9 @@ namespace Bach {
     virtual void SetFunctionValues(const Eigen::VectorXd& values) = 0;
     virtual bool GetIsFinished(boost::shared_ptr<NDimAccuracySpec> spec) = 0;
 
+    // A copy that can be used on another thread, or an empty pointer if there's none.
+    virtual boost::shared_ptr<MultivariateDerivatives> Clone() const { return boost::shared_ptr<MultivariateDerivatives>(); }
+
     const Eigen::VectorXd& GetDerivatives() { return m_extrapolatedValue; }
     const Eigen::VectorXd& GetError()       { return m_errorVec; }
 
@@ -32,6 +32,9 @@ namespace Bach {
 
     virtual ~NDimAccuracySpec();
 
+    // A copy for another thread, as GetNormalizedError keeps the error vector it finds.
+    virtual boost::shared_ptr<NDimAccuracySpec> Clone() const { return boost::shared_ptr<NDimAccuracySpec>(new NDimAccuracySpec(*this)); }
+
     virtual double GetNormalizedError(const Eigen::VectorXd& error, const Eigen::VectorXd& y);
     Eigen::VectorXd GetNormalizedErrorVector() { return m_normalizedError; }
 
@@ -32,6 +32,8 @@ namespace Bach {
     OdeAccuracySpec(unsigned int size, double tolerance = 0.0001);
     virtual ~OdeAccuracySpec() {}
 
+    virtual boost::shared_ptr<NDimAccuracySpec> Clone() const { return boost::shared_ptr<NDimAccuracySpec>(new OdeAccuracySpec(*this)); }
+
     virtual double GetNormalizedError(const Eigen::VectorXd& error, const Eigen::VectorXd& y);
     virtual double GetOdeNormalizedError(const Eigen::VectorXd& error, const Eigen::VectorXd& y, boost::shared_ptr<OdeSolver> solver, boost::shared_ptr<OdeData> odeData);
 
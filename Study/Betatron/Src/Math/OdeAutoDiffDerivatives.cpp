@@ -0,0 +1,58 @@
+/**********************************************************************
+
+File     : OdeAutoDiffDerivatives.cpp
+Project  : Bach Simulation
+Purpose  : Source file for ODE derivatives found by forward mode automatic differentiation.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "OdeAutoDiffDerivatives.h"
+#include "OdeEquations.h"
+#include "OdeData.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+  //**************************
+  //* OdeAutoDiffDerivatives *
+  //**************************
+
+OdeAutoDiffDerivatives::OdeAutoDiffDerivatives(int size) :
+  m_y(size),
+  m_dydx(size)
+{
+  if(!AutoDiffOdeEquations::Supports(size)) {
+    BACH_LOG_ERROR(L"OdeAutoDiffDerivatives: %d states is more than the gradient can hold", size);
+    throw std::exception();
+  }
+}
+
+void OdeAutoDiffDerivatives::GetDerivatives(double x, const Eigen::VectorXd& y, Eigen::VectorXd& dfdx, Eigen::MatrixXd& dfdy, shared_ptr<OdeData> odeData) {
+  AutoDiffOdeEquations* system = dynamic_cast<AutoDiffOdeEquations*>(odeData->GetOdeSystem().get());
+  if(!system) {
+    BACH_LOG_ERROR(L"OdeAutoDiffDerivatives::GetDerivatives: The equations do not support automatic differentiation");
+    throw std::exception();
+  }
+
+  // Inputs 0 to n-1 are the states, input n is the independent variable.
+  int n = (int) y.rows();
+  for(int i=0; i<n; i++) {
+    m_y(i) = AutoDiffOdeEquations::Dual::Variable(y(i), i, n+1);
+  }
+  AutoDiffOdeEquations::Dual xDual = AutoDiffOdeEquations::Dual::Variable(x, n, n+1);
+
+  system->EvaluateDual(xDual, m_y, m_dydx);
+
+  for(int i=0; i<n; i++) {
+    for(int j=0; j<n; j++) {
+      dfdy(i, j) = m_dydx(i).Derivative(j);
+    }
+    dfdx(i) = m_dydx(i).Derivative(n);
+  }
+}
@@ -0,0 +1,42 @@
+/**********************************************************************
+
+File     : OdeAutoDiffDerivatives.h
+Project  : Bach Simulation
+Purpose  : Header file for ODE derivatives found by forward mode automatic differentiation.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Seeds every state and the independent variable as a dual number
+           and makes one call to EvaluateDual, which gives dfdy and dfdx
+           exactly instead of the many Evaluate calls of Ridders differencing.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_ODE_AUTO_DIFF_DERIVATIVES_H__
+#define __BACH_ODE_AUTO_DIFF_DERIVATIVES_H__
+
+#include "OdeDerivatives.h"
+#include "AutoDiffOdeEquations.h"
+
+namespace Bach {
+
+  //**************************
+  //* OdeAutoDiffDerivatives *
+  //**************************
+
+  class OdeAutoDiffDerivatives : public OdeDerivatives {
+  public:
+    OdeAutoDiffDerivatives(int size);
+    virtual ~OdeAutoDiffDerivatives() {}
+
+    virtual void GetDerivatives(double x, const Eigen::VectorXd& y, Eigen::VectorXd& dfdx, Eigen::MatrixXd& dfdy, boost::shared_ptr<OdeData> odeData);
+
+  protected:
+    AutoDiffOdeEquations::DualVector m_y;
+    AutoDiffOdeEquations::DualVector m_dydx;
+  };
+};
+
+#endif // __BACH_ODE_AUTO_DIFF_DERIVATIVES_H__
@@ -55,3 +55,19 @@ void OdeData::StoreData(double x,const Eigen::VectorXd& y, const Eigen::VectorXd
     m_collector->StoreData(x, y, dy, m_weakThis.lock());
   }
 }
+
+bool OdeData::WantsDenseOutput() {
+  return (m_collector ? m_collector->WantsDenseOutput() : false);
+}
+
+void OdeData::StoreDenseStep(const OdeDenseOutput& step) {
+  if(m_collector) {
+    m_collector->StoreDenseStep(step, m_weakThis.lock());
+  }
+}
+
+void OdeData::StoreEvent(int index, double x, const Eigen::VectorXd& y) {
+  if(m_collector) {
+    m_collector->StoreEvent(index, m_system->GetEventName(index), x, y, m_weakThis.lock());
+  }
+}
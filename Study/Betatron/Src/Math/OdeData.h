@@ -62,6 +62,13 @@ namespace Bach {
     void SetStoringThisCall(bool f) { m_storingThisCallFlag = f; }
     bool StoringThisCall() { return m_storingThisCallFlag; }
 
+    // Whether the collector samples between steps, and the interpolant of each accepted step if so.
+    bool WantsDenseOutput();
+    void StoreDenseStep(const OdeDenseOutput& step);
+
+    // An event of the equations, located by the solver.
+    void StoreEvent(int index, double x, const Eigen::VectorXd& y);
+
   private:
     OdeData(boost::shared_ptr<OdeEquations> system);
 
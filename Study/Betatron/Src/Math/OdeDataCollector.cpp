@@ -20,6 +20,8 @@ All Rights Reserved.
 #include "OdeData.h"
 #include "SampledDerivedData.h"
 #include "SampledData.h"
+#include "JsonStreamWriter.h"
+#include "OdeSolverTelemetry.h"
 
 using namespace Bach;
 using namespace boost;
@@ -53,6 +55,15 @@ void OdeDataCollector::Restart() {
   if(m_internalData) {
     m_internalData->Reset();
   }
+  m_eventIndices.clear();
+  m_eventNames.clear();
+  m_eventTimes.clear();
+}
+
+void OdeDataCollector::StoreEvent(int index, const std::string& name, double time, const Eigen::VectorXd& states, boost::shared_ptr<OdeData> odeData) {
+  m_eventIndices.push_back(index);
+  m_eventNames.push_back(name);
+  m_eventTimes.push_back(time);
 }
 
 void OdeDataCollector::StoreData(double x, const Eigen::VectorXd& y, const Eigen::VectorXd& dy, boost::shared_ptr<OdeData> odeData) {
@@ -119,8 +130,57 @@ int OdeDataCollector::GetNewInternalSamplesSize(double time, boost::shared_ptr<O
 }
 
 std::string OdeDataCollector::AsJson() {
-  std::string stateJson = m_stateData->AsJson();
-  std::string internalJson = m_internalData->AsJson();
-  std::string json = "{ \"state\": "+stateJson+", \"additional\": "+internalJson+" }";
-  return json;
+  return JsonStreamWriter::WriteToString([this](JsonStreamWriter& writer) { WriteJson(writer); });
+}
+
+void OdeDataCollector::WriteJson(JsonStreamWriter& writer) {
+  writer.WriteRaw("{ \"state\": ");
+  m_stateData->WriteJson(writer);
+  writer.WriteRaw(", \"additional\": ");
+  m_internalData->WriteJson(writer);
+  WriteEventsJson(writer);
+  WriteTelemetryJson(writer);
+  writer.WriteRaw(" }");
+}
+
+void OdeDataCollector::WriteColumnLayout(JsonStreamWriter& writer) {
+  writer.WriteRaw("{ \"state\": ");
+  m_stateData->WriteColumnLayout(writer);
+  writer.WriteRaw(", \"additional\": ");
+  m_internalData->WriteColumnLayout(writer);
+  WriteEventsJson(writer);
+  WriteTelemetryJson(writer);
+  writer.WriteRaw(" }");
+}
+
+void OdeDataCollector::WriteEventsJson(JsonStreamWriter& writer) {
+  if(m_eventTimes.empty()) {
+    return;
+  }
+
+  writer.WriteRaw(", \"events\": [");
+  for(size_t i=0; i<m_eventTimes.size(); i++) {
+    writer.WriteRaw(i == 0 ? " { \"name\": " : ", { \"name\": ");
+    writer.WriteString(m_eventNames[i]);
+    writer.WriteRaw(", \"index\": ");
+    writer.WriteInteger(m_eventIndices[i]);
+    writer.WriteRaw(", \"time\": ");
+    writer.WriteDouble(m_eventTimes[i]);
+    writer.WriteRaw(" }");
+  }
+  writer.WriteRaw(" ]");
+}
+
+void OdeDataCollector::WriteTelemetryJson(JsonStreamWriter& writer) {
+  if(!m_telemetry) {
+    return;
+  }
+
+  writer.WriteRaw(", \"telemetry\": ");
+  m_telemetry->WriteJson(writer);
+}
+
+void OdeDataCollector::WriteColumns(BinaryColumnWriter& writer) {
+  m_stateData->WriteColumns(writer);
+  m_internalData->WriteColumns(writer);
 }
@@ -20,6 +20,7 @@ All Rights Reserved.
 #define __BACH_ODE_DATA_COLLECTOR_H__
 
 #include "BachDefs.h"
+#include <string>
 
 namespace Bach {
 
@@ -30,11 +31,24 @@ namespace Bach {
   class OdeDataCollector {
   public:
     OdeDataCollector();
-    ~OdeDataCollector();
+    virtual ~OdeDataCollector();
 
-    void InitializeWithSizes(long numStates, long numInternal);
+    virtual void InitializeWithSizes(long numStates, long numInternal);
 
-    void StoreData(double time, const Eigen::VectorXd& states, const Eigen::VectorXd& derivs, boost::shared_ptr<OdeData> odeData);
+    virtual void StoreData(double time, const Eigen::VectorXd& states, const Eigen::VectorXd& derivs, boost::shared_ptr<OdeData> odeData);
+
+    // A collector that samples between the solver's steps asks for dense output, and is then
+    // given the interpolant of each step as the solver accepts it.
+    virtual bool WantsDenseOutput() { return false; }
+    virtual void StoreDenseStep(const OdeDenseOutput& step, boost::shared_ptr<OdeData> odeData) {}
+
+    // Events located by the solver, kept in the order they happened.
+    virtual void StoreEvent(int index, const std::string& name, double time, const Eigen::VectorXd& states, boost::shared_ptr<OdeData> odeData);
+
+    int GetNumberOfEvents() const                { return (int) m_eventTimes.size(); }
+    int GetEventIndex(int i) const               { return m_eventIndices[i]; }
+    const std::string& GetEventName(int i) const { return m_eventNames[i]; }
+    double GetEventTime(int i) const             { return m_eventTimes[i]; }
 
     void SetStateData(boost::shared_ptr<SampledDerivedData> sd) { m_stateData = sd; }
     void SetInternalData(boost::shared_ptr<SampledData> id)   { m_internalData = id; }
@@ -42,16 +56,41 @@ namespace Bach {
     boost::shared_ptr<SampledDerivedData> GetStateData() { return m_stateData; }
     boost::shared_ptr<SampledData> GetInternalData() { return m_internalData; }
 
-    void Restart();
+    // Telemetry to write with the results, none by default.
+    void SetTelemetry(boost::shared_ptr<OdeSolverTelemetry> telemetry) { m_telemetry = telemetry; }
+    boost::shared_ptr<OdeSolverTelemetry> GetTelemetry() { return m_telemetry; }
+
+    virtual void Restart();
 
     std::string AsJson();
 
+    // The same JSON as AsJson, streamed into writer's buffers. Events, if there were any,
+    // follow the data as an array of their names, indices and times, then the telemetry if
+    // it was set.
+    void WriteJson(JsonStreamWriter& writer);
+
+    // The layout and columns of the binary column format, state data first.
+    void WriteColumnLayout(JsonStreamWriter& writer);
+    void WriteColumns(BinaryColumnWriter& writer);
+
   protected:
     boost::shared_ptr<SampledDerivedData> m_stateData;
     boost::shared_ptr<SampledData> m_internalData;
 
+    std::vector<int> m_eventIndices;
+    std::vector<std::string> m_eventNames;
+    std::vector<double> m_eventTimes;
+
+    boost::shared_ptr<OdeSolverTelemetry> m_telemetry;
+
+    // The events as a JSON member, if there are any, and the telemetry, if it was set.
+    void WriteEventsJson(JsonStreamWriter& writer);
+    void WriteTelemetryJson(JsonStreamWriter& writer);
+
     void SetStateStorageIsStopped(bool f) { m_stateStorageIsStopped = f; }
     void SetInternalStorageIsStopped(bool f) { m_internalStorageIsStopped = f; }
+    bool GetStateStorageIsStopped() const    { return m_stateStorageIsStopped; }
+    bool GetInternalStorageIsStopped() const { return m_internalStorageIsStopped; }
 
     virtual void StoreStates(double x, const Eigen::VectorXd& y, const Eigen::VectorXd& dy, boost::shared_ptr<OdeData> odeData);
     virtual void StoreInternals(double x, boost::shared_ptr<OdeData> odeData);
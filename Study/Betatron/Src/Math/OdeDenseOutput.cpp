@@ -0,0 +1,88 @@
+/**********************************************************************
+
+File     : OdeDenseOutput.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the continuous interpolant of one ODE solver step.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "OdeDenseOutput.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+  //******************
+  //* OdeDenseOutput *
+  //******************
+
+OdeDenseOutput::OdeDenseOutput() :
+  m_xStart(0.0),
+  m_xEnd(0.0)
+{
+}
+
+void OdeDenseOutput::SetStart(double x, const VectorXd& y, const VectorXd& dydx, const VectorXd& d2ydx2) {
+  m_xStart = x;
+  m_yStart = y;
+  m_dydxStart = dydx;
+  m_d2ydx2Start = d2ydx2;
+}
+
+void OdeDenseOutput::SetEnd(double x, const VectorXd& y, const VectorXd& dydx, const VectorXd& d2ydx2) {
+  m_xEnd = x;
+  double h = m_xEnd-m_xStart;
+  double hh = h*h;
+
+  // The quintic Hermite basis, multiplied out into powers of t.
+  m_coefficients.resize(y.size(), 6);
+  VectorXd dy = y-m_yStart;
+  m_coefficients.col(0) = m_yStart;
+  m_coefficients.col(1) = h*m_dydxStart;
+  m_coefficients.col(2) = 0.5*hh*m_d2ydx2Start;
+  m_coefficients.col(3) = 10.0*dy-h*(6.0*m_dydxStart+4.0*dydx)-hh*(1.5*m_d2ydx2Start-0.5*d2ydx2);
+  m_coefficients.col(4) = -15.0*dy+h*(8.0*m_dydxStart+7.0*dydx)+hh*(1.5*m_d2ydx2Start-d2ydx2);
+  m_coefficients.col(5) = 6.0*dy-3.0*h*(m_dydxStart+dydx)-0.5*hh*(m_d2ydx2Start-d2ydx2);
+}
+
+void OdeDenseOutput::SetStep(double xStart, double xEnd, int stateLength) {
+  m_xStart = xStart;
+  m_xEnd = xEnd;
+  m_coefficients.resize(stateLength, 6);
+}
+
+void OdeDenseOutput::Truncate(double x) {
+  // t scales by the fraction of the step kept, so the t^k coefficient by its k-th power.
+  double fraction = (x-m_xStart)/(m_xEnd-m_xStart);
+  double scale = 1.0;
+  for(int k=1; k<6; k++) {
+    scale *= fraction;
+    m_coefficients.col(k) *= scale;
+  }
+  m_xEnd = x;
+}
+
+void OdeDenseOutput::Evaluate(double x, VectorXd& y) const {
+  double t = (x-m_xStart)/(m_xEnd-m_xStart);
+  y = m_coefficients.col(5);
+  for(int k=4; k>=0; k--) {
+    y = y*t+m_coefficients.col(k);
+  }
+}
+
+void OdeDenseOutput::Evaluate(double x, VectorXd& y, VectorXd& dydx) const {
+  double h = m_xEnd-m_xStart;
+  double t = (x-m_xStart)/h;
+  y = m_coefficients.col(5);
+  dydx = 5.0*m_coefficients.col(5);
+  for(int k=4; k>=1; k--) {
+    y = y*t+m_coefficients.col(k);
+    dydx = dydx*t+k*m_coefficients.col(k);
+  }
+  y = y*t+m_coefficients.col(0);
+  dydx /= h;
+}
@@ -0,0 +1,75 @@
+/**********************************************************************
+
+File     : OdeDenseOutput.h
+Project  : Bach Simulation
+Purpose  : Header file for the continuous interpolant of one ODE solver step.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           A quintic Hermite polynomial through both ends of an accepted
+           step, matching y, y' and y'' at each. The second derivative is
+           y'' = df/dx + df/dy*f, from the Jacobian the solver has already
+           found for the step. Its error is O(h^6), so the solver can take
+           steps much longer than the spacing the output is wanted at.
+           Solvers with a continuous extension of their own, such as
+           DormandPrinceOde, set the polynomial's coefficients directly.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_ODE_DENSE_OUTPUT_H__
+#define __BACH_ODE_DENSE_OUTPUT_H__
+
+#include "BachDefs.h"
+
+namespace Bach {
+
+  //******************
+  //* OdeDenseOutput *
+  //******************
+
+  class OdeDenseOutput {
+  public:
+    OdeDenseOutput();
+
+    // The start of the step, then its end. SetEnd builds the polynomial.
+    void SetStart(double x, const Eigen::VectorXd& y, const Eigen::VectorXd& dydx, const Eigen::VectorXd& d2ydx2);
+    void SetEnd(double x, const Eigen::VectorXd& y, const Eigen::VectorXd& dydx, const Eigen::VectorXd& d2ydx2);
+
+    // A polynomial of at most fifth degree found by the solver, set with SetStep and then
+    // filled in through GetCoefficients.
+    void SetStep(double xStart, double xEnd, int stateLength);
+    Eigen::Matrix<double, Eigen::Dynamic, 6>& GetCoefficients() { return m_coefficients; }
+
+    double GetStartTime() const { return m_xStart; }
+    double GetEndTime() const   { return m_xEnd; }
+    int GetStateLength() const  { return (int) m_coefficients.rows(); }
+
+    // True if x is within the step, whichever direction it was taken in.
+    bool Contains(double x) const {
+      return (m_xStart <= m_xEnd ? (x >= m_xStart && x <= m_xEnd) : (x <= m_xStart && x >= m_xEnd));
+    }
+
+    // Cut the step short at x, keeping the same polynomial.
+    void Truncate(double x);
+
+    // The state, and optionally its derivative, anywhere within the step.
+    void Evaluate(double x, Eigen::VectorXd& y) const;
+    void Evaluate(double x, Eigen::VectorXd& y, Eigen::VectorXd& dydx) const;
+
+  protected:
+    double m_xStart;
+    double m_xEnd;
+
+    // The start of the step, kept until SetEnd has the other end.
+    Eigen::VectorXd m_yStart;
+    Eigen::VectorXd m_dydxStart;
+    Eigen::VectorXd m_d2ydx2Start;
+
+    // Column k multiplies t^k, with t running from 0 to 1 across the step.
+    Eigen::Matrix<double, Eigen::Dynamic, 6> m_coefficients;
+  };
+};
+
+#endif // __BACH_ODE_DENSE_OUTPUT_H__
@@ -20,6 +20,7 @@ All Rights Reserved.
 #define __BACH_ODE_EQUATIONS_H__
 
 #include "BachDefs.h"
+#include <string>
 
 namespace Bach {
 
@@ -30,16 +31,44 @@ namespace Bach {
   class OdeEquations {
   public:
     OdeEquations() : m_numEquations(0), m_numInternals(0), m_doLog(true) {}
-    OdeEquations(OdeEquations const & copy) { }
+    OdeEquations(OdeEquations const & copy) : m_doLog(copy.m_doLog), m_numEquations(copy.m_numEquations), m_numInternals(copy.m_numInternals) { }
     
     virtual ~OdeEquations() {}
 
     virtual void Initialize(boost::shared_ptr<OdeData> odeData)  { }
     virtual void Evaluate(double x, const Eigen::VectorXd& yIn, Eigen::VectorXd& yOut, boost::shared_ptr<OdeData> odeData) = 0;
 
+    // A copy whose Evaluate can be called on another thread at the same time as this one's,
+    // for a numerical Jacobian found a column per thread. Empty when the equations can't be
+    // copied, and they are then evaluated in turn.
+    virtual boost::shared_ptr<OdeEquations> Clone() const { return boost::shared_ptr<OdeEquations>(); }
+
     int GetStateLength()    const {  return m_numEquations; }
     int GetInternalLength() const {  return m_numInternals; }
 
+    // Events are zero crossings of functions of the state. The solver brackets a sign change
+    // between the ends of a step and locates it on the step's dense output. A function that
+    // starts a step at exactly zero does not count as crossing in it.
+    enum EventDirection {
+      EventEither  = 0,
+      EventRising  = 1,  // From below zero to zero or above.
+      EventFalling = -1  // From above zero to zero or below.
+    };
+
+    enum EventAction {
+      ContinueAtEvent,
+      StopAtEvent
+    };
+
+    virtual int GetNumberOfEvents() const { return 0; }
+    virtual void EvaluateEvents(double x, const Eigen::VectorXd& y, Eigen::VectorXd& g) {}
+    virtual EventDirection GetEventDirection(int index) const { return EventEither; }
+    virtual std::string GetEventName(int index) const { return ""; }
+
+    // Called at each event once it is located, in the order they happen. Stopping ends
+    // the integration with the event as its last sample.
+    virtual EventAction HandleEvent(int index, double x, const Eigen::VectorXd& y, boost::shared_ptr<OdeData> odeData) { return StopAtEvent; }
+
     void SetLogging(bool doLog) { m_doLog = doLog; }
 
   protected:
@@ -0,0 +1,67 @@
+/**********************************************************************
+
+File     : OdeEquationsN.h
+Project  : Bach Simulation
+Purpose  : Header file for ordinary differential equations with a state length fixed at compile time.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The counterpart of OdeEquations for BaderDeuflhardOdeN. The
+           solver is templated on the equations, so the right hand side is
+           called directly and can be inlined, and every vector is a fixed
+           size Eigen type that lives on the stack.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_ODE_EQUATIONS_N_H__
+#define __BACH_ODE_EQUATIONS_N_H__
+
+#include "BachDefs.h"
+#include <cmath>
+#include <limits>
+
+namespace Bach {
+
+  //*****************
+  //* OdeEquationsN *
+  //*****************
+
+  // Equations must provide
+  //   void EvaluateN(double x, const VectorN& y, VectorN& dydx);
+  // and may provide
+  //   void GetDerivativesN(double x, const VectorN& y, VectorN& dfdx, MatrixN& dfdy);
+  // to replace the forward differenced Jacobian below.
+  template<int N, class Equations>
+  class OdeEquationsN {
+  public:
+    enum { StateLength = N };
+
+    typedef Eigen::Matrix<double, N, 1> VectorN;
+    typedef Eigen::Matrix<double, N, N> MatrixN;
+
+    void GetDerivativesN(double x, const VectorN& y, VectorN& dfdx, MatrixN& dfdy) {
+      Equations* equations = static_cast<Equations*>(this);
+      const double relativeStep = std::sqrt(std::numeric_limits<double>::epsilon());
+
+      VectorN f0, f1, yStep;
+      equations->EvaluateN(x, y, f0);
+
+      double h = relativeStep*(std::fabs(x) > 1.0 ? std::fabs(x) : 1.0);
+      equations->EvaluateN(x+h, y, f1);
+      dfdx = (f1-f0)/h;
+
+      yStep = y;
+      for(int j=0; j<N; j++) {
+        h = relativeStep*(std::fabs(y(j)) > 1.0 ? std::fabs(y(j)) : 1.0);
+        yStep(j) = y(j)+h;
+        equations->EvaluateN(x, yStep, f1);
+        dfdy.col(j) = (f1-f0)/h;
+        yStep(j) = y(j);
+      }
+    }
+  };
+};
+
+#endif // __BACH_ODE_EQUATIONS_N_H__
@@ -0,0 +1,153 @@
+/**********************************************************************
+
+File     : OdeEventLocator.cpp
+Project  : Bach Simulation
+Purpose  : Source file for locating the events of ODE equations within a step.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "OdeEventLocator.h"
+#include "OdeDenseOutput.h"
+#include "OdeData.h"
+#include <algorithm>
+#include <limits>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const int MAX_ITERATIONS = 100;
+
+  // The bracket is closed to a few rounding errors of x.
+  const double X_TOLERANCE = 4.0*std::numeric_limits<double>::epsilon();
+}
+
+  //*******************
+  //* OdeEventLocator *
+  //*******************
+
+OdeEventLocator::OdeEventLocator() :
+  m_xLow(0.0),
+  m_xHigh(0.0)
+{
+}
+
+void OdeEventLocator::Start(double x, const VectorXd& y, shared_ptr<OdeEquations> system) {
+  int numberOfEvents = system->GetNumberOfEvents();
+  m_gLow.resize(numberOfEvents);
+  m_gHigh.resize(numberOfEvents);
+  m_g.resize(numberOfEvents);
+
+  m_xLow = m_xHigh = x;
+  if(numberOfEvents > 0) {
+    system->EvaluateEvents(x, y, m_gLow);
+  }
+}
+
+bool OdeEventLocator::FindNextEvent(const OdeDenseOutput& step, shared_ptr<OdeEquations> system, int& index, double& x, VectorXd& y) {
+  if(m_gLow.size() == 0) {
+    return false;
+  }
+
+  // A new step, so evaluate at its end. The end of the last step is the start of this one.
+  if(m_xHigh != step.GetEndTime()) {
+    m_xHigh = step.GetEndTime();
+    step.Evaluate(m_xHigh, m_y);
+    system->EvaluateEvents(m_xHigh, m_y, m_gHigh);
+  }
+
+  // The earliest of the crossings, in the direction of the step.
+  double direction = (step.GetEndTime() >= step.GetStartTime() ? 1.0 : -1.0);
+  index = -1;
+  for(int i=0; i<m_gLow.size(); i++) {
+    if(IsCrossing(m_gLow(i), m_gHigh(i), system->GetEventDirection(i))) {
+      double xCrossing = Locate(i, m_xLow, m_gLow(i), m_xHigh, m_gHigh(i), step, system);
+      if(index < 0 || direction*(xCrossing-x) < 0.0) {
+        index = i;
+        x = xCrossing;
+      }
+    }
+  }
+
+  if(index < 0) {
+    m_xLow = m_xHigh;
+    m_gLow = m_gHigh;
+    return false;
+  }
+
+  // Search on from the event, with the event found taken as being exactly at zero there.
+  step.Evaluate(x, y);
+  m_xLow = x;
+  system->EvaluateEvents(x, y, m_gLow);
+  m_gLow(index) = 0.0;
+  return true;
+}
+
+bool OdeEventLocator::HandleEvents(OdeDenseOutput& step, shared_ptr<OdeData> odeData, double& x, VectorXd& y) {
+  shared_ptr<OdeEquations> system = odeData->GetOdeSystem();
+  int index;
+  while(FindNextEvent(step, system, index, x, m_yEvent)) {
+    odeData->StoreEvent(index, x, m_yEvent);
+    if(system->HandleEvent(index, x, m_yEvent, odeData) == OdeEquations::StopAtEvent) {
+      step.Truncate(x);
+      y = m_yEvent;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool OdeEventLocator::IsCrossing(double gLow, double gHigh, OdeEquations::EventDirection direction) {
+  bool rising  = (gLow < 0.0 && gHigh >= 0.0);
+  bool falling = (gLow > 0.0 && gHigh <= 0.0);
+  switch(direction) {
+    case OdeEquations::EventRising:  return rising;
+    case OdeEquations::EventFalling: return falling;
+    default:                         return rising || falling;
+  }
+}
+
+double OdeEventLocator::Locate(int index, double xLow, double gLow, double xHigh, double gHigh, const OdeDenseOutput& step, shared_ptr<OdeEquations> system) {
+  // Illinois: regula falsi, halving the retained end's value when the same end is kept
+  // twice running, so the bracket closes from both sides.
+  int lastKept = 0;
+  for(int iteration=0; iteration<MAX_ITERATIONS; iteration++) {
+    if(gHigh == 0.0 || fabs(xHigh-xLow) <= X_TOLERANCE*std::max(fabs(xLow), fabs(xHigh))) {
+      break;
+    }
+
+    double x = xHigh-gHigh*(xHigh-xLow)/(gHigh-gLow);
+    if(!((x-xLow)*(xHigh-x) > 0.0)) {
+      x = 0.5*(xLow+xHigh);
+    }
+
+    step.Evaluate(x, m_y);
+    system->EvaluateEvents(x, m_y, m_g);
+    double g = m_g(index);
+
+    // Keep the crossing between low and high, high being at or past it.
+    if((g < 0.0) == (gLow < 0.0) && g != 0.0) {
+      xLow = x;
+      gLow = g;
+      if(lastKept == -1) {
+        gHigh *= 0.5;
+      }
+      lastKept = -1;
+    }
+    else {
+      xHigh = x;
+      gHigh = g;
+      if(lastKept == 1) {
+        gLow *= 0.5;
+      }
+      lastKept = 1;
+    }
+  }
+  return xHigh;
+}
@@ -0,0 +1,65 @@
+/**********************************************************************
+
+File     : OdeEventLocator.h
+Project  : Bach Simulation
+Purpose  : Header file for locating the events of ODE equations within a step.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The event functions of OdeEquations are evaluated at the end of
+           each step. A sign change in the direction an event asks for is
+           then located on the step's dense output with the Illinois variant
+           of regula falsi, which needs no derivatives and keeps the bracket.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_ODE_EVENT_LOCATOR_H__
+#define __BACH_ODE_EVENT_LOCATOR_H__
+
+#include "OdeEquations.h"
+
+namespace Bach {
+
+  //*******************
+  //* OdeEventLocator *
+  //*******************
+
+  class OdeEventLocator {
+  public:
+    OdeEventLocator();
+
+    // Evaluate the event functions where the integration starts.
+    void Start(double x, const Eigen::VectorXd& y, boost::shared_ptr<OdeEquations> system);
+
+    // The first event between the last point and the end of step, if there is one. Once it
+    // has been handled the search continues from it, so call again until this returns false.
+    bool FindNextEvent(const OdeDenseOutput& step, boost::shared_ptr<OdeEquations> system, int& index, double& x, Eigen::VectorXd& y);
+
+    // Pass the events within step to the equations and odeData in order, as they are found.
+    // Returns true if one stops the integration, with step cut short there and x and y set
+    // to the event.
+    bool HandleEvents(OdeDenseOutput& step, boost::shared_ptr<OdeData> odeData, double& x, Eigen::VectorXd& y);
+
+    int GetNumberOfEvents() const { return (int) m_gLow.size(); }
+
+  protected:
+    static bool IsCrossing(double gLow, double gHigh, OdeEquations::EventDirection direction);
+    double Locate(int index, double xLow, double gLow, double xHigh, double gHigh, const OdeDenseOutput& step, boost::shared_ptr<OdeEquations> system);
+
+    // The last point searched from, and the event functions there.
+    double m_xLow;
+    Eigen::VectorXd m_gLow;
+
+    // The event functions at the end of the step being searched.
+    double m_xHigh;
+    Eigen::VectorXd m_gHigh;
+
+    Eigen::VectorXd m_y;
+    Eigen::VectorXd m_g;
+    Eigen::VectorXd m_yEvent;
+  };
+};
+
+#endif // __BACH_ODE_EVENT_LOCATOR_H__
@@ -11,6 +11,8 @@ Revisions: Original definition by Lawrence Gunn.
            Updated by Lawrence Gunn.
            2013/01/27
 
+           The Jacobian can be found on a WorkStealingPool.
+           2026/10/18
 
 Copyright (c) 1992-2013 by Lawrence Gunn
 All Rights Reserved.
@@ -76,6 +78,10 @@ void OdeNumericalDerivatives::SetTolerance(double tol) {
   m_accuracySpec->SetTolerance(tol);
 }
 
+void OdeNumericalDerivatives::SetPool(shared_ptr<WorkStealingPool> pool) {
+  m_jacobian->SetPool(pool);
+}
+
 void OdeNumericalDerivatives::GetTimeDeriv(double x,const Eigen::VectorXd& y, shared_ptr<OdeData> odeData) {
   shared_ptr<OdeEquations> system = odeData->GetOdeSystem();
   m_derivatives->Start(x, m_xStepSize);
@@ -88,10 +94,13 @@ void OdeNumericalDerivatives::GetTimeDeriv(double x,const Eigen::VectorXd& y, sh
 
 void OdeNumericalDerivatives::GetJacobian(double x,const Eigen::VectorXd& y, shared_ptr<OdeData> odeData) {
   shared_ptr<OdeEquations> system = odeData->GetOdeSystem();
-  m_jacobian->Start(y, m_stepSize);
-
-  while(!m_jacobian->GetIsFinished()) {
-    system->Evaluate(x, m_jacobian->GetNewValue(), m_tempValues, odeData);
-    m_jacobian->SetFunctionValues(m_tempValues);
-  }
+  m_jacobian->Find(y, m_stepSize,
+    [&](const VectorXd& yIn, VectorXd& f) { system->Evaluate(x, yIn, f, odeData); },
+    [&]() {
+      shared_ptr<OdeEquations> clone = system->Clone();
+      if(!clone) {
+        return Jacobian::Function();
+      }
+      return Jacobian::Function([clone, x, &odeData](const VectorXd& yIn, VectorXd& f) { clone->Evaluate(x, yIn, f, odeData); });
+    });
 }
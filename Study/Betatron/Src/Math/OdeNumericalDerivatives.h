@@ -11,6 +11,8 @@ Revisions: Original definition by Lawrence Gunn.
            Updated by Lawrence Gunn.
            2013/01/27
 
+           The Jacobian can be found on a WorkStealingPool.
+           2026/10/18
 
 Copyright (c) 1992-2013 by Lawrence Gunn
 All Rights Reserved.
@@ -24,6 +26,8 @@ All Rights Reserved.
 
 namespace Bach {
 
+  class WorkStealingPool;
+
   //***************************
   //* OdeNumericalDerivatives *
   //***************************
@@ -40,6 +44,9 @@ namespace Bach {
     void SetXStepSize(double ss)    {  m_xStepSize = ss;  }
     void SetTolerance(double tol);
 
+    // Find the columns of the Jacobian at once on pool, for equations with a Clone.
+    void SetPool(boost::shared_ptr<WorkStealingPool> pool);
+
     boost::shared_ptr<MultivariateDerivatives> GetMVDerivative() { return m_derivatives; }
     boost::shared_ptr<NDimAccuracySpec> GetAccuracySpec() { return m_accuracySpec; }
 
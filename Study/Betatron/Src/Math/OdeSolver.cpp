@@ -19,6 +19,8 @@ All Rights Reserved.
 #include "OdeSolver.h"
 #include "OdeData.h"
 #include "OdeAccuracySpec.h"
+#include "OdeEquations.h"
+#include "OdeSolverTelemetry.h"
 
 using namespace Bach;
 using namespace boost;
@@ -37,3 +39,18 @@ void OdeSolver::InitializeAccuracySpec(shared_ptr<OdeData> odeData) {
     m_accuracySpec = shared_ptr<OdeAccuracySpec>(new OdeAccuracySpec(odeData->GetStateLength()));
   }
 }
+
+void OdeSolver::EvaluateSystem(const shared_ptr<OdeEquations>& system, double x, const VectorXd& y, VectorXd& dydx, const shared_ptr<OdeData>& odeData) {
+  OdeSolverTelemetry::Timer timer(m_telemetry, OdeSolverTelemetry::EvaluatePhase);
+  system->Evaluate(x, y, dydx, odeData);
+}
+
+void OdeSolver::StoreData(const shared_ptr<OdeData>& odeData, double x, const VectorXd& y, const VectorXd& dydx) {
+  OdeSolverTelemetry::Timer timer(m_telemetry, OdeSolverTelemetry::StorePhase);
+  odeData->StoreData(x, y, dydx);
+}
+
+void OdeSolver::StoreDenseStep(const shared_ptr<OdeData>& odeData, const OdeDenseOutput& step) {
+  OdeSolverTelemetry::Timer timer(m_telemetry, OdeSolverTelemetry::StorePhase);
+  odeData->StoreDenseStep(step);
+}
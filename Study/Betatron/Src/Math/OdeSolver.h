@@ -37,14 +37,29 @@ namespace Bach {
     virtual bool DerivativesRequired() { return false; }
     virtual bool AccuracySpecRequired() { return true; }
 
+    // Steps taken at the size first tried, and steps that had to be made smaller.
+    virtual int GetNumberGood()    { return 0; }
+    virtual int GetNumberRetried() { return 0; }
+
     void SetAccuracySpec(boost::shared_ptr<OdeAccuracySpec> accuracySpec) { m_accuracySpec = accuracySpec; }
     boost::shared_ptr<OdeAccuracySpec> GetAccuracySpec() { return m_accuracySpec; }
 
+    // Counts and times the solve's work when set, see OdeSolverTelemetry. It is added to by
+    // each call to Solve and cleared with a reset.
+    void SetTelemetry(boost::shared_ptr<OdeSolverTelemetry> telemetry) { m_telemetry = telemetry; }
+    boost::shared_ptr<OdeSolverTelemetry> GetTelemetry() { return m_telemetry; }
+
   protected:
     boost::shared_ptr<OdeAccuracySpec> m_accuracySpec;
+    boost::shared_ptr<OdeSolverTelemetry> m_telemetry;
 
     void InitializeAccuracySpec(boost::shared_ptr<OdeData> odeData);
 
+    // The system's Evaluate and the collector's stores, counted and timed with telemetry.
+    void EvaluateSystem(const boost::shared_ptr<OdeEquations>& system, double x, const Eigen::VectorXd& y, Eigen::VectorXd& dydx, const boost::shared_ptr<OdeData>& odeData);
+    void StoreData(const boost::shared_ptr<OdeData>& odeData, double x, const Eigen::VectorXd& y, const Eigen::VectorXd& dydx);
+    void StoreDenseStep(const boost::shared_ptr<OdeData>& odeData, const OdeDenseOutput& step);
+
     double m_stepSize;
   };
 }
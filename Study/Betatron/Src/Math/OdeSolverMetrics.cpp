@@ -0,0 +1,136 @@
+/**********************************************************************
+
+File     : OdeSolverMetrics.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the process-wide totals of ODE solver telemetry.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "OdeSolverMetrics.h"
+#include <sstream>
+
+using namespace Bach;
+using namespace boost;
+
+namespace {
+  void WriteHeading(std::ostringstream& out, const char* name, const char* help) {
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " counter\n";
+  }
+}
+
+const char* const OdeSolverMetrics::MEDIA_TYPE = "text/plain; version=0.0.4";
+
+  //********************
+  //* OdeSolverMetrics *
+  //********************
+
+shared_ptr<OdeSolverMetrics> OdeSolverMetrics::CreateInstance() {
+  shared_ptr<OdeSolverMetrics> instance(new OdeSolverMetrics());
+  return instance;
+}
+
+shared_ptr<OdeSolverMetrics> OdeSolverMetrics::GetSharedInstance() {
+  static shared_ptr<OdeSolverMetrics> instance = CreateInstance();
+  return instance;
+}
+
+OdeSolverMetrics::OdeSolverMetrics() {
+}
+
+void OdeSolverMetrics::Record(const OdeSolverTelemetry& telemetry) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  TotalsMap::iterator found = m_totals.find(telemetry.GetSolverName());
+  if(found == m_totals.end()) {
+    m_totals.insert(std::make_pair(telemetry.GetSolverName(), Totals(telemetry)));
+  }
+  else {
+    found->second.numberOfSolves++;
+    found->second.telemetry.Add(telemetry);
+  }
+}
+
+long OdeSolverMetrics::GetNumberOfSolves(const std::string& solverName) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  TotalsMap::iterator found = m_totals.find(solverName);
+  return (found == m_totals.end() ? 0 : found->second.numberOfSolves);
+}
+
+OdeSolverTelemetry OdeSolverMetrics::GetTotals(const std::string& solverName) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  TotalsMap::iterator found = m_totals.find(solverName);
+  return (found == m_totals.end() ? OdeSolverTelemetry(solverName) : found->second.telemetry);
+}
+
+std::string OdeSolverMetrics::GetPrometheusText() {
+  TotalsMap totals;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    totals = m_totals;
+  }
+
+  typedef TotalsMap::const_iterator Iterator;
+  typedef long (OdeSolverTelemetry::*CountGetter)() const;
+  struct Counter {
+    const char* name;
+    const char* help;
+    CountGetter getter;
+  };
+  static const Counter counters[] = {
+    { "bach_ode_evaluations_total",          "Evaluations of the equations by the solvers.",  &OdeSolverTelemetry::GetNumberOfEvaluations },
+    { "bach_ode_jacobian_evaluations_total", "Jacobians of the equations found.",             &OdeSolverTelemetry::GetNumberOfJacobians },
+    { "bach_ode_factorizations_total",       "LU factorizations for semi-implicit steps.",    &OdeSolverTelemetry::GetNumberOfFactorizations },
+    { "bach_ode_accepted_steps_total",       "Steps that met the tolerance.",                 &OdeSolverTelemetry::GetNumberAccepted },
+    { "bach_ode_rejected_steps_total",       "Steps tried and made smaller.",                 &OdeSolverTelemetry::GetNumberRejected }
+  };
+
+  std::ostringstream out;
+  out.precision(17);
+  WriteHeading(out, "bach_ode_solves_total", "ODE solves run.");
+  for(Iterator i=totals.begin(); i!=totals.end(); ++i) {
+    out << "bach_ode_solves_total{solver=\"" << i->first << "\"} " << i->second.numberOfSolves << "\n";
+  }
+  for(size_t c=0; c<sizeof(counters)/sizeof(counters[0]); c++) {
+    WriteHeading(out, counters[c].name, counters[c].help);
+    for(Iterator i=totals.begin(); i!=totals.end(); ++i) {
+      out << counters[c].name << "{solver=\"" << i->first << "\"} " << (i->second.telemetry.*counters[c].getter)() << "\n";
+    }
+  }
+
+  WriteHeading(out, "bach_ode_order_steps_total", "Accepted extrapolation steps by the order chosen.");
+  for(Iterator i=totals.begin(); i!=totals.end(); ++i) {
+    const std::vector<long>& orders = i->second.telemetry.GetOrderCounts();
+    for(size_t order=0; order<orders.size(); order++) {
+      if(orders[order] > 0) {
+        out << "bach_ode_order_steps_total{solver=\"" << i->first << "\",order=\"" << order << "\"} " << orders[order] << "\n";
+      }
+    }
+  }
+
+  WriteHeading(out, "bach_ode_phase_calls_total", "Calls made by the solvers in each phase of a solve.");
+  for(Iterator i=totals.begin(); i!=totals.end(); ++i) {
+    for(int phase=0; phase<OdeSolverTelemetry::NumberOfPhases; phase++) {
+      out << "bach_ode_phase_calls_total{solver=\"" << i->first << "\",phase=\"" << OdeSolverTelemetry::GetPhaseName((OdeSolverTelemetry::Phase) phase) << "\"} "
+          << i->second.telemetry.GetNumberOfCalls((OdeSolverTelemetry::Phase) phase) << "\n";
+    }
+  }
+
+  WriteHeading(out, "bach_ode_phase_seconds_total", "Seconds spent by the solvers in each phase of a solve.");
+  for(Iterator i=totals.begin(); i!=totals.end(); ++i) {
+    for(int phase=0; phase<OdeSolverTelemetry::NumberOfPhases; phase++) {
+      out << "bach_ode_phase_seconds_total{solver=\"" << i->first << "\",phase=\"" << OdeSolverTelemetry::GetPhaseName((OdeSolverTelemetry::Phase) phase) << "\"} "
+          << i->second.telemetry.GetPhaseSeconds((OdeSolverTelemetry::Phase) phase) << "\n";
+    }
+  }
+
+  WriteHeading(out, "bach_ode_solve_seconds_total", "Seconds spent in whole solves.");
+  for(Iterator i=totals.begin(); i!=totals.end(); ++i) {
+    out << "bach_ode_solve_seconds_total{solver=\"" << i->first << "\"} " << i->second.telemetry.GetSolveSeconds() << "\n";
+  }
+  return out.str();
+}
@@ -0,0 +1,66 @@
+/**********************************************************************
+
+File     : OdeSolverMetrics.h
+Project  : Bach Simulation
+Purpose  : Header file for the process-wide totals of ODE solver telemetry.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The telemetry of each solve is added to totals kept per solver,
+           which are written in the Prometheus text exposition format for
+           a scraper. All the totals only ever grow, so they are counters.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_ODE_SOLVER_METRICS_H__
+#define __BACH_ODE_SOLVER_METRICS_H__
+
+#include "BachDefs.h"
+#include "OdeSolverTelemetry.h"
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace Bach {
+
+  //********************
+  //* OdeSolverMetrics *
+  //********************
+
+  class OdeSolverMetrics {
+  public:
+    // The media type of the text GetPrometheusText returns.
+    static const char* const MEDIA_TYPE;
+
+    static boost::shared_ptr<OdeSolverMetrics> CreateInstance();
+
+    // The totals the solvers record into.
+    static boost::shared_ptr<OdeSolverMetrics> GetSharedInstance();
+
+    // Add a solve's telemetry to the totals of its solver. Safe from any thread.
+    void Record(const OdeSolverTelemetry& telemetry);
+
+    // The number of solves recorded for a solver, and a copy of their totals.
+    long GetNumberOfSolves(const std::string& solverName);
+    OdeSolverTelemetry GetTotals(const std::string& solverName);
+
+    std::string GetPrometheusText();
+
+  protected:
+    OdeSolverMetrics();
+
+    struct Totals {
+      Totals(const OdeSolverTelemetry& first) : numberOfSolves(1), telemetry(first) {}
+      long numberOfSolves;
+      OdeSolverTelemetry telemetry;
+    };
+    typedef std::map<std::string, Totals> TotalsMap;
+
+    std::mutex m_mutex;
+    TotalsMap m_totals;
+  };
+};
+
+#endif // __BACH_ODE_SOLVER_METRICS_H__
@@ -0,0 +1,147 @@
+/**********************************************************************
+
+File     : OdeSolverTelemetry.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the counters and phase timings of an ODE solve.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "OdeSolverTelemetry.h"
+#include "JsonStreamWriter.h"
+
+using namespace Bach;
+using namespace boost;
+
+namespace {
+  const int CLOCK_CALIBRATION_READS = 1000;
+
+  double MeasureClockSeconds() {
+    typedef OdeSolverTelemetry::Clock Clock;
+    Clock::duration fastest = Clock::duration::max();
+    for(int i=0; i<CLOCK_CALIBRATION_READS; i++) {
+      Clock::time_point start = Clock::now();
+      Clock::duration read = Clock::now()-start;
+      if(read < fastest) {
+        fastest = read;
+      }
+    }
+    return std::chrono::duration<double>(fastest).count();
+  }
+}
+
+  //**********************
+  //* OdeSolverTelemetry *
+  //**********************
+
+shared_ptr<OdeSolverTelemetry> OdeSolverTelemetry::CreateInstance(const std::string& solverName) {
+  shared_ptr<OdeSolverTelemetry> instance(new OdeSolverTelemetry(solverName));
+  return instance;
+}
+
+OdeSolverTelemetry::OdeSolverTelemetry(const std::string& solverName) :
+  m_solverName(solverName),
+  m_random(2463534242u)
+{
+  Reset();
+}
+
+void OdeSolverTelemetry::Reset() {
+  for(int i=0; i<NumberOfPhases; i++) {
+    m_numberOfCalls[i] = 0;
+    m_numberTimed[i] = 0;
+    m_timedSeconds[i] = 0.0;
+  }
+  m_numberOfFactorizations = 0;
+  m_numberAccepted = 0;
+  m_numberRejected = 0;
+  m_orderCounts.clear();
+  m_solveSeconds = 0.0;
+}
+
+void OdeSolverTelemetry::Add(const OdeSolverTelemetry& other) {
+  for(int i=0; i<NumberOfPhases; i++) {
+    m_numberOfCalls[i] += other.m_numberOfCalls[i];
+    m_numberTimed[i] += other.m_numberTimed[i];
+    m_timedSeconds[i] += other.m_timedSeconds[i];
+  }
+  m_numberOfFactorizations += other.m_numberOfFactorizations;
+  m_numberAccepted += other.m_numberAccepted;
+  m_numberRejected += other.m_numberRejected;
+  if(m_orderCounts.size() < other.m_orderCounts.size()) {
+    m_orderCounts.resize(other.m_orderCounts.size(), 0);
+  }
+  for(size_t i=0; i<other.m_orderCounts.size(); i++) {
+    m_orderCounts[i] += other.m_orderCounts[i];
+  }
+  m_solveSeconds += other.m_solveSeconds;
+}
+
+void OdeSolverTelemetry::CountAcceptedStep(int order) {
+  m_numberAccepted++;
+  if(order > 0) {
+    if((int) m_orderCounts.size() <= order) {
+      m_orderCounts.resize(order+1, 0);
+    }
+    m_orderCounts[order]++;
+  }
+}
+
+double OdeSolverTelemetry::GetPhaseSeconds(Phase phase) const {
+  if(m_numberTimed[phase] == 0) {
+    return 0.0;
+  }
+  double seconds = m_timedSeconds[phase]-m_numberTimed[phase]*GetClockSeconds();
+  return (seconds > 0.0 ? seconds*((double) m_numberOfCalls[phase]/m_numberTimed[phase]) : 0.0);
+}
+
+double OdeSolverTelemetry::GetClockSeconds() {
+  static const double clockSeconds = MeasureClockSeconds();
+  return clockSeconds;
+}
+
+const char* OdeSolverTelemetry::GetPhaseName(Phase phase) {
+  switch(phase) {
+    case EvaluatePhase :      return "evaluate";
+    case DerivativesPhase :   return "derivatives";
+    case LinearSolvePhase :   return "linearSolve";
+    case ExtrapolationPhase : return "extrapolation";
+    case StorePhase :         return "store";
+    default :                 return "";
+  }
+}
+
+void OdeSolverTelemetry::WriteJson(JsonStreamWriter& writer) const {
+  writer.WriteRaw("{ \"solver\": ");
+  writer.WriteString(m_solverName);
+  writer.WriteRaw(", \"evaluations\": ");
+  writer.WriteInteger(GetNumberOfEvaluations());
+  writer.WriteRaw(", \"jacobianEvaluations\": ");
+  writer.WriteInteger(GetNumberOfJacobians());
+  writer.WriteRaw(", \"factorizations\": ");
+  writer.WriteInteger(m_numberOfFactorizations);
+  writer.WriteRaw(", \"linearSolves\": ");
+  writer.WriteInteger(m_numberOfCalls[LinearSolvePhase]-m_numberOfFactorizations);
+  writer.WriteRaw(", \"acceptedSteps\": ");
+  writer.WriteInteger(m_numberAccepted);
+  writer.WriteRaw(", \"rejectedSteps\": ");
+  writer.WriteInteger(m_numberRejected);
+  writer.WriteRaw(", \"orders\": [");
+  for(size_t i=0; i<m_orderCounts.size(); i++) {
+    writer.WriteRaw(i == 0 ? " " : ", ");
+    writer.WriteInteger(m_orderCounts[i]);
+  }
+  writer.WriteRaw(" ], \"seconds\": { \"solve\": ");
+  writer.WriteDouble(m_solveSeconds);
+  for(int i=0; i<NumberOfPhases; i++) {
+    writer.WriteRaw(", \"");
+    writer.WriteRaw(GetPhaseName((Phase) i));
+    writer.WriteRaw("\": ");
+    writer.WriteDouble(GetPhaseSeconds((Phase) i));
+  }
+  writer.WriteRaw(" } }");
+}
@@ -0,0 +1,159 @@
+/**********************************************************************
+
+File     : OdeSolverTelemetry.h
+Project  : Bach Simulation
+Purpose  : Header file for the counters and phase timings of an ODE solve.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           A solver given one with OdeSolver::SetTelemetry counts the calls
+           it makes and the time they take, by phase: evaluating the
+           equations, finding their Jacobian, factoring and solving the
+           linear systems of a semi-implicit step, extrapolating, and
+           storing results with the collector. It also counts accepted and
+           rejected steps and, for the extrapolation solvers, how often each
+           order is chosen. Without one a solver only tests a null pointer.
+
+           Calls are counted exactly, but reading the clock costs about as
+           much as evaluating a small system, so only one call in
+           TIMING_PERIOD is timed, at random so the calls timed don't follow
+           the pattern of a solver's steps. A phase's seconds are the
+           mean of its timed calls, less the time taken to read the clock,
+           times the number of calls.
+
+           Only calls the solver makes itself are counted. Evaluations made
+           for a numerical Jacobian are part of the derivatives phase, and
+           those of a collector sampling the dense output are part of the
+           store phase.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_ODE_SOLVER_TELEMETRY_H__
+#define __BACH_ODE_SOLVER_TELEMETRY_H__
+
+#include "BachDefs.h"
+#include <chrono>
+#include <stdint.h>
+#include <string>
+
+namespace Bach {
+
+  //**********************
+  //* OdeSolverTelemetry *
+  //**********************
+
+  class OdeSolverTelemetry {
+  public:
+    enum Phase {
+      EvaluatePhase = 0,
+      DerivativesPhase = 1,
+      LinearSolvePhase = 2,
+      ExtrapolationPhase = 3,
+      StorePhase = 4,
+      NumberOfPhases = 5
+    };
+
+    typedef std::chrono::steady_clock Clock;
+
+    // A power of two.
+    static const long TIMING_PERIOD = 32;
+
+    // Counts a call of a phase, from its construction to its destruction, and times it if it
+    // is one of the calls sampled. Does nothing without telemetry.
+    class Timer {
+    public:
+      Timer(const boost::shared_ptr<OdeSolverTelemetry>& telemetry, Phase phase) : m_telemetry(telemetry.get()), m_phase(phase), m_timed(false) {
+        if(m_telemetry) {
+          m_timed = ((m_telemetry->NextRandom() & (TIMING_PERIOD-1)) == 0);
+          if(m_timed) {
+            m_start = Clock::now();
+          }
+        }
+      }
+      ~Timer() {
+        if(m_timed) {
+          m_telemetry->AddTimedCall(m_phase, Clock::now()-m_start);
+        }
+        else if(m_telemetry) {
+          m_telemetry->m_numberOfCalls[m_phase]++;
+        }
+      }
+
+    private:
+      OdeSolverTelemetry* m_telemetry;
+      Phase m_phase;
+      bool m_timed;
+      Clock::time_point m_start;
+    };
+
+    static boost::shared_ptr<OdeSolverTelemetry> CreateInstance(const std::string& solverName);
+
+    OdeSolverTelemetry(const std::string& solverName = "");
+
+    // Clear the counts, keeping the name.
+    void Reset();
+
+    // Add another solve's counts to these.
+    void Add(const OdeSolverTelemetry& other);
+
+    void AddTimedCall(Phase phase, Clock::duration duration) {
+      m_numberOfCalls[phase]++;
+      m_numberTimed[phase]++;
+      m_timedSeconds[phase] += std::chrono::duration<double>(duration).count();
+    }
+    void CountFactorization()          { m_numberOfFactorizations++; }
+    void CountRejectedStep()           { m_numberRejected++; }
+
+    // An order of zero is for solvers that don't choose one.
+    void CountAcceptedStep(int order = 0);
+
+    // Time for the whole solve, set by whoever runs it.
+    void AddSolveSeconds(double seconds) { m_solveSeconds += seconds; }
+
+    const std::string& GetSolverName() const     { return m_solverName; }
+    long GetNumberOfCalls(Phase phase) const     { return m_numberOfCalls[phase]; }
+    double GetPhaseSeconds(Phase phase) const;
+    long GetNumberOfEvaluations() const          { return m_numberOfCalls[EvaluatePhase]; }
+    long GetNumberOfJacobians() const            { return m_numberOfCalls[DerivativesPhase]; }
+    long GetNumberOfFactorizations() const       { return m_numberOfFactorizations; }
+    long GetNumberAccepted() const               { return m_numberAccepted; }
+    long GetNumberRejected() const               { return m_numberRejected; }
+    double GetSolveSeconds() const               { return m_solveSeconds; }
+
+    // Accepted steps at each order, from zero.
+    const std::vector<long>& GetOrderCounts() const { return m_orderCounts; }
+
+    static const char* GetPhaseName(Phase phase);
+
+    // Seconds between two reads of the clock with nothing between them, measured once.
+    static double GetClockSeconds();
+
+    // { "solver": ..., "evaluations": ..., ..., "orders": [ counts from order zero ],
+    //   "seconds": { "solve": ..., "evaluate": ..., ... } }
+    void WriteJson(JsonStreamWriter& writer) const;
+
+  protected:
+    // Marsaglia's xorshift32.
+    uint32_t NextRandom() {
+      m_random ^= m_random << 13;
+      m_random ^= m_random >> 17;
+      m_random ^= m_random << 5;
+      return m_random;
+    }
+
+    std::string m_solverName;
+    long m_numberOfCalls[NumberOfPhases];
+    long m_numberTimed[NumberOfPhases];
+    double m_timedSeconds[NumberOfPhases];
+    long m_numberOfFactorizations;
+    long m_numberAccepted;
+    long m_numberRejected;
+    std::vector<long> m_orderCounts;
+    double m_solveSeconds;
+    uint32_t m_random;
+  };
+};
+
+#endif // __BACH_ODE_SOLVER_TELEMETRY_H__
@@ -20,7 +20,9 @@ All Rights Reserved.
 
 #include "OdeSolverWithDerivs.h"
 #include "OdeNumericalDerivatives.h"
+#include "OdeAutoDiffDerivatives.h"
 #include "OdeData.h"
+#include "OdeSolverTelemetry.h"
 
 using namespace Bach;
 using namespace boost;
@@ -32,6 +34,17 @@ using namespace Eigen;
 
 void OdeSolverWithDerivs::InitializeDifferentiator(shared_ptr<OdeData> odeData) {
   if(!m_differentiator) {
-    m_differentiator = shared_ptr<OdeNumericalDerivatives>(new OdeNumericalDerivatives(odeData->GetStateLength()));
+    // Equations that can be differentiated automatically get exact derivatives from a single evaluation.
+    if(dynamic_cast<AutoDiffOdeEquations*>(odeData->GetOdeSystem().get()) && AutoDiffOdeEquations::Supports(odeData->GetStateLength())) {
+      m_differentiator = shared_ptr<OdeAutoDiffDerivatives>(new OdeAutoDiffDerivatives(odeData->GetStateLength()));
+    }
+    else {
+      m_differentiator = shared_ptr<OdeNumericalDerivatives>(new OdeNumericalDerivatives(odeData->GetStateLength()));
+    }
   }
 }
+
+void OdeSolverWithDerivs::GetJacobian(double x, const VectorXd& y, VectorXd& dfdx, MatrixXd& dfdy, const shared_ptr<OdeData>& odeData) {
+  OdeSolverTelemetry::Timer timer(m_telemetry, OdeSolverTelemetry::DerivativesPhase);
+  m_differentiator->GetDerivatives(x, y, dfdx, dfdy, odeData);
+}
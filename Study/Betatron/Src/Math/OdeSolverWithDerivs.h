@@ -41,6 +41,9 @@ namespace Bach {
     boost::shared_ptr<OdeDerivatives> GetDifferentiator() { return m_differentiator; }
 
   protected:
+    // The differentiator's Jacobian, counted and timed with telemetry.
+    void GetJacobian(double x, const Eigen::VectorXd& y, Eigen::VectorXd& dfdx, Eigen::MatrixXd& dfdy, const boost::shared_ptr<OdeData>& odeData);
+
     boost::shared_ptr<OdeDerivatives> m_differentiator;
   };
 };
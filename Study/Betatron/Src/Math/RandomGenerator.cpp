@@ -58,7 +58,8 @@ void RandomGenerator::ReinitializeArray() {
     m_seedSet = true;
   }
 
-  long temp = m_seed;
+  // The arithmetic wraps, which is only defined for unsigned integers.
+  unsigned long temp = (unsigned long) m_seed;
   long index;
   for(index=0; index<4; index++) {
     temp = temp*84589+45989;            // Warm up.
@@ -66,7 +67,7 @@ void RandomGenerator::ReinitializeArray() {
 
   for(index=NXRG_TABLESIZE; index--;) {
     temp = 45989 + temp*84589;
-    m_alTable[(index * 21) % NXRG_TABLESIZE] = temp;   // Fill and shuffle.
+    m_alTable[(index * 21) % NXRG_TABLESIZE] = (long) temp;   // Fill and shuffle.
   }
 
   m_index = 0;
@@ -93,9 +94,9 @@ long RandomGenerator::GetRandomInteger() {
   }
 
   m_index = (m_index + 1) % NXRG_TABLESIZE;
-  m_alTable[m_index] =
-    m_alTable[(m_index + 23) % NXRG_TABLESIZE] +
-    m_alTable[(m_index + 54) % NXRG_TABLESIZE];
+  m_alTable[m_index] = (long) (
+    (unsigned long) m_alTable[(m_index + 23) % NXRG_TABLESIZE] +
+    (unsigned long) m_alTable[(m_index + 54) % NXRG_TABLESIZE]);
 
   return m_alTable[m_index];
 }
@@ -183,6 +183,6 @@ void RandomNormal::ZigguratInitialize(unsigned long jsrSeed) {
 
 void RandomNormal::Test() {
   for(int i=0; i<3000; i++) {
-    LogPlain(L"%f", GetRandomNum(5.0f, 2.0f));
+    BACH_LOG_INFO(L"%f", GetRandomNum(5.0f, 2.0f));
   }
 }
@@ -9,6 +9,8 @@ Revisions: Original definition by Lawrence Gunn.
            Updated by Lawrence Gunn.
            2013/01/28
 
+           The test to stop moved after the row of the tableau is finished.
+           2026/10/18
 
 Copyright (c) 1992-2013 by Lawrence Gunn
 All Rights Reserved.
@@ -40,6 +42,15 @@ RiddersExtrapolation::RiddersExtrapolation(int size) :
 
   m_decreaseFactor = 1.4;
   m_decreaseFactorSquared = m_decreaseFactor*m_decreaseFactor;
+
+  // Set properly by Start, but copies are made before that.
+  m_xTarget = 0.0;
+  m_initialStepSize = 0.0;
+  m_stepSize = 0.0;
+  m_firstHalf = true;
+  m_iteration = 0;
+  m_leftToFinish = 0;
+  m_isFinished.fill(false);
 }
 
 RiddersExtrapolation::~RiddersExtrapolation() {
@@ -102,10 +113,12 @@ void RiddersExtrapolation::SetFunctionValues(const Eigen::VectorXd& f) {
           m_extrapolatedValue(number) = (*a)(j,i);
           m_errorVec(number) = errorThisStep;
         }
-        if(fabs((*a)(i,i)-(*a)(i-1,i-1)) >= 2.0*m_errorVec(number)) {
-          m_isFinished(number) = true;
-          m_leftToFinish--;
-        }
+      }
+
+      // Once the whole row is in, so the test doesn't read what an earlier derivative left.
+      if(i > 0 && fabs((*a)(i,i)-(*a)(i-1,i-1)) >= 2.0*m_errorVec(number)) {
+        m_isFinished(number) = true;
+        m_leftToFinish--;
       }
     }
 
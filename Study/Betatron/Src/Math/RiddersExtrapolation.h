@@ -37,6 +37,7 @@ namespace Bach {
     virtual void SetFunctionValues(const Eigen::VectorXd& values);
 
     virtual bool GetIsFinished(boost::shared_ptr<NDimAccuracySpec> spec);
+    virtual boost::shared_ptr<MultivariateDerivatives> Clone() const { return boost::shared_ptr<MultivariateDerivatives>(new RiddersExtrapolation(*this)); }
     bool AccuracySpecTest(boost::shared_ptr<NDimAccuracySpec> spec);
 
   protected:
@@ -10,6 +10,9 @@ Revisions: Original definition by Lawrence Gunn.
            Updated by Lawrence Gunn.
            2013/02/13
 
+           The Jacobian can be found on a WorkStealingPool.
+           2026/10/18
+
 Copyright (c) 1992-2013 by Lawrence Gunn
 All Rights Reserved.
 
@@ -39,7 +42,6 @@ RootSolverEquationsOdeWrapper::RootSolverEquationsOdeWrapper(shared_ptr<OdeData>
 
   m_stepSizeVector.resize(GetStateLength());
   m_stepSizeVector.fill(stepSize);
-  m_tempValues.resize(m_odeData->GetStateLength());
 
   m_jacobianFinder = shared_ptr<Jacobian>(new Jacobian());
   shared_ptr<MultivariateDerivatives> derivatives = shared_ptr<MultivariateDerivatives>(new RiddersExtrapolation(m_odeData->GetStateLength()));
@@ -50,6 +52,10 @@ void RootSolverEquationsOdeWrapper::SetJacobianAccuracySpec(boost::shared_ptr<ND
   m_jacobianFinder->SetAccuracySpec(accuracySpec);
 }
 
+void RootSolverEquationsOdeWrapper::SetPool(shared_ptr<WorkStealingPool> pool) {
+  m_jacobianFinder->SetPool(pool);
+}
+
 void RootSolverEquationsOdeWrapper::Initialize() {
   m_odeData->GetOdeSystem()->Initialize(m_odeData);
 }
@@ -71,12 +77,17 @@ Eigen::VectorXd RootSolverEquationsOdeWrapper::GetEquationValues(const Eigen::Ve
 Eigen::MatrixXd RootSolverEquationsOdeWrapper::GetJacobian(const Eigen::VectorXd& y) {
 
   shared_ptr<OdeEquations> system = m_odeData->GetOdeSystem();
-  m_jacobianFinder->Start(y, m_stepSizeVector);
-
-  while(!m_jacobianFinder->GetIsFinished()) {
-    system->Evaluate(m_x, m_jacobianFinder->GetNewValue(), m_tempValues, m_odeData);
-    m_jacobianFinder->SetFunctionValues(m_tempValues);
-  }
+  double x = m_x;
+  shared_ptr<OdeData>& odeData = m_odeData;
+  m_jacobianFinder->Find(y, m_stepSizeVector,
+    [&](const VectorXd& yIn, VectorXd& f) { system->Evaluate(x, yIn, f, odeData); },
+    [&]() {
+      shared_ptr<OdeEquations> clone = system->Clone();
+      if(!clone) {
+        return Jacobian::Function();
+      }
+      return Jacobian::Function([clone, x, &odeData](const VectorXd& yIn, VectorXd& f) { clone->Evaluate(x, yIn, f, odeData); });
+    });
 
   return m_jacobianFinder->GetDerivatives();
 }
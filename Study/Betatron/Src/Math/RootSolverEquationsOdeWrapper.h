@@ -10,6 +10,9 @@ Revisions: Original definition by Lawrence Gunn.
            Updated by Lawrence Gunn.
            2013/02/13
 
+           The Jacobian can be found on a WorkStealingPool.
+           2026/10/18
+
 Copyright (c) 1990-2013 by Lawrence Gunn
 All Rights Reserved.
 
@@ -22,6 +25,8 @@ All Rights Reserved.
 
 namespace Bach {
 
+  class WorkStealingPool;
+
   //*********************************
   //* RootSolverEquationsOdeWrapper *
   //*********************************
@@ -34,6 +39,9 @@ namespace Bach {
 
     void SetJacobianAccuracySpec(boost::shared_ptr<NDimAccuracySpec> accuracySpec);
 
+    // Find the columns of the Jacobian at once on pool, for ODE systems with a Clone.
+    void SetPool(boost::shared_ptr<WorkStealingPool> pool);
+
     void SetXForEvalutations(double x) { m_x = x; }
 
     // **** RootSolverEquations ***
@@ -51,7 +59,6 @@ namespace Bach {
     double m_x;
     double m_stepSize;
     Eigen::VectorXd m_stepSizeVector;
-    Eigen::VectorXd m_tempValues;
     boost::shared_ptr<OdeData> m_odeData;
     boost::shared_ptr<Jacobian> m_jacobianFinder;
   };
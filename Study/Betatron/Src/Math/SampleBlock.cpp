@@ -0,0 +1,72 @@
+/**********************************************************************
+
+File     : SampleBlock.cpp
+Project  : Bach Simulation
+Purpose  : Source file for a contiguous block of sampled values.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "SampleBlock.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+  //***************
+  //* SampleBlock *
+  //***************
+
+SampleBlock::SampleBlock(int numVariables, int capacity, Layout layout) :
+  m_data(numVariables*capacity),
+  m_numberOfVariables(numVariables),
+  m_capacity(capacity),
+  m_layout(layout)
+{
+}
+
+void SampleBlock::Resize(int capacity) {
+  if(capacity == m_capacity) {
+    return;
+  }
+
+  if(m_layout == SampleContiguous) {
+    // The samples are already in order so the block only needs to grow or shrink at the end.
+    m_data.conservativeResize(m_numberOfVariables*capacity);
+  }
+  else {
+    // Each variable's history starts at a multiple of the capacity, so every column moves.
+    int numToKeep = (capacity < m_capacity ? capacity : m_capacity);
+    Eigen::VectorXd data(m_numberOfVariables*capacity);
+    for(int j=0; j<m_numberOfVariables; j++) {
+      data.segment(j*capacity, numToKeep) = m_data.segment(j*m_capacity, numToKeep);
+    }
+    m_data.swap(data);
+  }
+  m_capacity = capacity;
+}
+
+void SampleBlock::SetSample(int sample, const Eigen::VectorXd& values, int firstVariable) {
+  BACH_PRECONDITION(sample < m_capacity && firstVariable+values.rows() <= m_numberOfVariables);
+
+  int numValues = (int) values.rows();
+  if(m_layout == SampleContiguous) {
+    m_data.segment(sample*m_numberOfVariables+firstVariable, numValues) = values;
+  }
+  else {
+    double* target = m_data.data()+firstVariable*m_capacity+sample;
+    for(int j=0; j<numValues; j++, target += m_capacity) {
+      *target = values(j);
+    }
+  }
+}
+
+void SampleBlock::GetSample(int sample, Eigen::VectorXd& values, int firstVariable) const {
+  BACH_PRECONDITION(sample < m_capacity && firstVariable+values.rows() <= m_numberOfVariables);
+
+  values = Sample(sample, firstVariable, (int) values.rows());
+}
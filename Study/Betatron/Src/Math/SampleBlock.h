@@ -0,0 +1,78 @@
+/**********************************************************************
+
+File     : SampleBlock.h
+Project  : Bach Simulation
+Purpose  : Header file for a contiguous block of sampled values.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Replaces the one heap allocated vector per sample that SampledData
+           and SampledDerivedData used. All samples live in one block which is
+           either laid out sample by sample or variable by variable.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_SAMPLE_BLOCK_H__
+#define __BACH_SAMPLE_BLOCK_H__
+
+#include "BachDefs.h"
+
+namespace Bach {
+
+  //***************
+  //* SampleBlock *
+  //***************
+
+  class SampleBlock {
+  public:
+    enum Layout {
+      SampleContiguous = 0,  // Row-major, the values of one sample are adjacent.
+      VariableContiguous = 1 // Column-major, the history of one variable is adjacent.
+    };
+
+    typedef Eigen::Map<const Eigen::VectorXd, 0, Eigen::InnerStride<> > ConstStridedVector;
+
+    SampleBlock(int numVariables, int capacity, Layout layout = VariableContiguous);
+
+    // Change the number of samples that can be held, keeping the existing values.
+    void Resize(int capacity);
+
+    int GetNumberOfVariables() const { return m_numberOfVariables; }
+    int GetCapacity() const          { return m_capacity; }
+    Layout GetLayout() const         { return m_layout; }
+
+    double operator()(int sample, int variable) const { return m_data(Offset(sample, variable)); }
+    double& operator()(int sample, int variable)      { return m_data(Offset(sample, variable)); }
+
+    // Copy a sample in or out, optionally only the variables starting at firstVariable.
+    void SetSample(int sample, const Eigen::VectorXd& values, int firstVariable = 0);
+    void GetSample(int sample, Eigen::VectorXd& values, int firstVariable = 0) const;
+
+    // Views onto the block without copying. Variable views are unit stride with
+    // the VariableContiguous layout, sample views with the SampleContiguous layout.
+    ConstStridedVector Sample(int sample, int firstVariable, int numVariables) const {
+      return ConstStridedVector(m_data.data()+Offset(sample, firstVariable), numVariables, Eigen::InnerStride<>(VariableStride()));
+    }
+
+    ConstStridedVector Variable(int variable, int firstSample, int numSamples) const {
+      return ConstStridedVector(m_data.data()+Offset(firstSample, variable), numSamples, Eigen::InnerStride<>(SampleStride()));
+    }
+
+  protected:
+    int Offset(int sample, int variable) const {
+      return (m_layout == VariableContiguous ? variable*m_capacity+sample : sample*m_numberOfVariables+variable);
+    }
+
+    int SampleStride() const   { return (m_layout == VariableContiguous ? 1 : m_numberOfVariables); }
+    int VariableStride() const { return (m_layout == VariableContiguous ? m_capacity : 1); }
+
+    Eigen::VectorXd m_data;
+    int m_numberOfVariables;
+    int m_capacity;
+    Layout m_layout;
+  };
+};
+
+#endif // __BACH_SAMPLE_BLOCK_H__
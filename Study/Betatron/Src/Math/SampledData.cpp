@@ -29,7 +29,8 @@ All Rights Reserved.
 #include "SampledData.h"
 #include "InterpolationIndex.h"
 #include "SequentialAccessHunt.h"
-#include "PolynomialInterp.h"
+#include "JsonStreamWriter.h"
+#include "BinaryColumnWriter.h"
 #include <boost/lexical_cast.hpp>
 
 using namespace Bach;
@@ -40,60 +41,49 @@ using namespace Eigen;
   //* SampledData *
   //***************
 
-SampledData::SampledData(int numDependent, int maxNumberOfSamples) :
+SampledData::SampledData(int numDependent, int maxNumberOfSamples, SampleBlock::Layout layout) :
+  m_y(numDependent, maxNumberOfSamples, layout),
   m_maxNumberOfSamples(maxNumberOfSamples),
   m_numberOfSamples(0)
 {
   m_numberOfDependent = numDependent;
 
   m_x.resize(m_maxNumberOfSamples);
-  m_yArray.resize(m_maxNumberOfSamples);
 
   m_interpVectorsGood = false;
   m_lastInterpIndex = 0;
 
   m_indexHunter = boost::shared_ptr<TableSearch>(new SequentialAccessHunt());
-  m_interpolator = boost::shared_ptr<Interpolator>(new PolynomialInterp());
-
-  int interpolationSize = m_interpolator->GetInterpolationSize();
+  m_interpWindow.resize(m_numberOfDependent, m_interpolator.GetNumberOfPoints());
 
   m_independentName = "time";
   m_independentUnits = "seconds";
-  m_interpVectorArray.resize(m_numberOfDependent);
   for(int i=0; i<numDependent; i++) {
-    m_interpVectorArray[i].resize(interpolationSize);
     m_arrayColumnNames.push_back("data"+lexical_cast<std::string>(i));
     m_arrayColumnUnits.push_back("");
   }
 }
 
 SampledData::~SampledData() {
-  size_t numYArray = m_yArray.size();
-  for(size_t i=0; i<numYArray; i++) {
-    if(m_yArray[i] != NULL) {
-      delete m_yArray[i];
-      m_yArray[i] = NULL;
-    }
-    else {
-      break;
-    }
-  }
 }
 
 void SampledData::Store(double x, const Eigen::VectorXd& dependent) {
   if(m_numberOfSamples >= m_maxNumberOfSamples)  {
-    Log(L"ERROR: SampledData::Store: Attempt to store too many m_x/states (%u)",m_numberOfSamples);
+    BACH_LOG_ERROR(L"SampledData::Store: Attempt to store too many m_x/states (%u)",m_numberOfSamples);
     throw std::exception();
   }
 
   m_x(m_numberOfSamples) = x;
-  m_yArray[m_numberOfSamples] = new Eigen::VectorXd(dependent);
+  m_y.SetSample(m_numberOfSamples, dependent);
   m_numberOfSamples++;
+  if(m_spline) {
+    m_spline->Append(x, dependent);
+  }
 }
 
 double SampledData::operator()(int n) const {
   if(!CheckBounds(n)) {
-    Log(L"ERROR: SampledData::operator()(int): Bounds error at %u [0 to %d]", n, m_numberOfSamples-1);
+    BACH_LOG_ERROR(L"SampledData::operator()(int): Bounds error at %u [0 to %d]", n, m_numberOfSamples-1);
     throw std::exception();
   }
 
@@ -102,109 +92,176 @@ double SampledData::operator()(int n) const {
 
 double SampledData::operator()(int i, int j) const {
   if(!CheckBounds(i,j)) {
-    Log(L"ERROR: SampledData::operator()(int i,int j): State bounds error at (%u,%u) [is (0,0) to (%u,%u)]", i, j, m_numberOfSamples-1, m_numberOfDependent-1);
+    BACH_LOG_ERROR(L"SampledData::operator()(int i,int j): State bounds error at (%u,%u) [is (0,0) to (%u,%u)]", i, j, m_numberOfSamples-1, m_numberOfDependent-1);
     throw std::exception();
   }
-  return (*m_yArray[i])(j);
+  return m_y(i, j);
 }
 
 void SampledData::Retrieve(int index, double& x, Eigen::VectorXd& y) const {
   if(!CheckBounds(index)) {
-    Log(L"ERROR: SampledData::Retrieve(i,d,v): Bounds error at %u [0 to %d]", index, m_numberOfSamples-1);
+    BACH_LOG_ERROR(L"SampledData::Retrieve(i,d,v): Bounds error at %u [0 to %d]", index, m_numberOfSamples-1);
     throw std::exception();
   }
 
   x = m_x(index);
-  y = (*m_yArray[index]);
+  y.resize(m_numberOfDependent);
+  m_y.GetSample(index, y);
 }
 
 double SampledData::Retrieve(double xTarget, int yIndex) {
   if(!CheckBounds(0, yIndex)) {
-    Log(L"ERROR: SampledData::Retrieve(d,i): State bounds error at %u [0 to %d]", yIndex, m_numberOfSamples-1);
+    BACH_LOG_ERROR(L"SampledData::Retrieve(d,i): State bounds error at %u [0 to %d]", yIndex, m_numberOfSamples-1);
     throw std::exception();
   }
 
   // Only do the search within the block that is from 0 to the current number if of samples stored.
   int indexLow = m_indexHunter->Find(xTarget, m_x.block(0, 0, m_numberOfSamples, 1));
-  indexLow = InterpolationIndex::ChooseInterpolationIndex(m_numberOfSamples, indexLow, m_interpolator->GetInterpolationSize());
+  if(m_spline) {
+    return m_spline->Interpolate(xTarget, indexLow, yIndex);
+  }
+  indexLow = InterpolationIndex::ChooseInterpolationIndex(m_numberOfSamples, indexLow, m_interpolator.GetNumberOfPoints());
   SetInterpVectors(indexLow);
 
-  return m_interpolator->Interpolate(xTarget, m_x.block(indexLow, 0, m_interpolator->GetInterpolationSize(), 1), m_interpVectorArray[yIndex]);
+  return m_interpolator.Interpolate(xTarget, m_interpWindow, yIndex);
 }
 
 void SampledData::Retrieve(double xTarget, Eigen::VectorXd& y) {
-  int order = m_interpolator->GetInterpolationSize();
   if(m_numberOfDependent != y.rows()) {
-    Log(L"ERROR: SampledData::Retrieve(d,v): State bounds error (%u vs %d)", y.rows(), m_numberOfDependent);
+    BACH_LOG_ERROR(L"SampledData::Retrieve(d,v): State bounds error (%u vs %d)", y.rows(), m_numberOfDependent);
     throw std::exception();
   }
 
   int indexLow = m_indexHunter->Find(xTarget, m_x.block(0, 0, m_numberOfSamples, 1));
-  indexLow = InterpolationIndex::ChooseInterpolationIndex(m_numberOfSamples, indexLow, m_interpolator->GetInterpolationSize());
+  if(m_spline) {
+    m_spline->Interpolate(xTarget, indexLow, y);
+    return;
+  }
+  indexLow = InterpolationIndex::ChooseInterpolationIndex(m_numberOfSamples, indexLow, m_interpolator.GetNumberOfPoints());
   SetInterpVectors(indexLow);
 
-  for(int i=0;i<m_numberOfDependent;i++) {
-    y(i) = m_interpolator->Interpolate(xTarget, m_x.block(indexLow, 0, order, 1),m_interpVectorArray[i]);
+  m_interpolator.Interpolate(xTarget, m_interpWindow, y);
+}
+
+void SampledData::Retrieve(const Eigen::VectorXd& xTargets, Eigen::MatrixXd& y) {
+  int numTargets = (int) xTargets.rows();
+  y.resize(m_numberOfDependent, numTargets);
+  if(numTargets == 0) {
+    return;
+  }
+
+  SequentialAccessHunt hunter;
+  if(m_spline) {
+    for(int k=0; k<numTargets; k++) {
+      m_spline->Interpolate(xTargets(k), hunter.Find(xTargets(k), m_x.head(m_numberOfSamples)), y.col(k));
+    }
+    return;
+  }
+
+  int order = m_interpolator.GetNumberOfPoints();
+  if(m_numberOfSamples < order) {
+    BACH_LOG_ERROR(L"SampledData::Retrieve(v,m): Number of times stored less than order of interpolation");
+    throw std::exception();
+  }
+
+  int first = 0;
+  int indexLow = -1;
+  for(int k=0; k<numTargets; k++) {
+    int index = hunter.Find(xTargets(k), m_x.head(m_numberOfSamples));
+    index = InterpolationIndex::ChooseInterpolationIndex(m_numberOfSamples, index, order);
+    if(index != indexLow) {
+      if(k > first) {
+        m_interpolator.Interpolate(xTargets, first, k-first, m_interpWindow, y);
+      }
+      SetInterpVectors(index);
+      indexLow = index;
+      first = k;
+    }
   }
+  m_interpolator.Interpolate(xTargets, first, numTargets-first, m_interpWindow, y);
 }
 
 void SampledData::SetInterpVectors(int newIndex) {
-  int order = m_interpolator->GetInterpolationSize();
+  int order = m_interpolator.GetNumberOfPoints();
 
   if(m_interpVectorsGood && (m_lastInterpIndex == newIndex)) {
     return;
   }
 
   if(m_numberOfSamples < order) {
-    Log(L"ERROR: SampledData::SetInterpVectors(d,v): Number of times stored less than order of interpolation");
+    BACH_LOG_ERROR(L"SampledData::SetInterpVectors(d,v): Number of times stored less than order of interpolation");
     throw std::exception();
   }
 
-  for(int i=0; i<m_numberOfDependent; i++) {
+  if(!m_interpolator.SetAbscissae(m_x, newIndex)) {
+    BACH_LOG_ERROR(L"SampledData::SetInterpVectors: Two samples interpolated between from %d on have the same x", newIndex);
+    throw std::exception();
+  }
+
+  // Gathered along whichever direction the block is contiguous in.
+  if(m_y.GetLayout() == SampleBlock::SampleContiguous) {
     for(int j=0; j<order; j++) {
-      m_interpVectorArray[i](j) = (*m_yArray[newIndex+j])(i);
+      m_interpWindow.col(j) = m_y.Sample(newIndex+j, 0, m_numberOfDependent);
     }
   }
-
+  else {
+    for(int i=0; i<m_numberOfDependent; i++) {
+      m_interpWindow.row(i) = m_y.Variable(i, newIndex, order).transpose();
+    }
+  }
+  m_interpVectorsGood = true;
   m_lastInterpIndex = newIndex;
 }
 
+void SampledData::SetSpline(const shared_ptr<SplineInterp>& spline) {
+  m_spline = spline;
+  if(m_spline) {
+    FitSpline();
+  }
+}
+
+void SampledData::FitSpline() {
+  VectorXd y(m_numberOfDependent);
+  m_spline->Reset(m_numberOfDependent);
+  for(int i=0; i<m_numberOfSamples; i++) {
+    m_y.GetSample(i, y);
+    m_spline->Append(m_x(i), y);
+  }
+}
+
 void SampledData::Reset() {
   m_numberOfSamples = 0;
+  m_indexHunter->TableChanged();
   m_interpVectorsGood = false;
   m_lastInterpIndex = 0;
+  if(m_spline) {
+    m_spline->Reset(m_numberOfDependent);
+  }
 }
 
 void SampledData::Resize(int newSize) {
   // Increase the size.
   if(newSize > m_maxNumberOfSamples) {
-    Eigen::VectorXd copy = m_x.block(0, 0, m_numberOfSamples, 1);
-    m_x.resize(newSize);
-    m_x.block(0, 0, m_numberOfSamples, 1) = copy;
-
-    //Eigen::VectorXd** newState = new Eigen::VectorXd*[newSize];
-    m_yArray.resize(newSize, NULL);
+    m_x.conservativeResize(newSize);
+    m_y.Resize(newSize);
 
     m_maxNumberOfSamples = newSize;
   }
 
     // Decrease the size;
   else if(newSize < m_maxNumberOfSamples) {
-    // Copy but keep the existing values.
-    Eigen::VectorXd copy = m_x.block(0, 0, newSize, 1);
-    m_x.resize(newSize);
-    m_x.block(0, 0, newSize, 1) = copy;
-
-    for(int i=newSize-1; i<m_numberOfSamples; i++)  {
-      delete m_yArray[i];
-    }
+    // Keep the values that still fit.
+    m_x.conservativeResize(newSize);
+    m_y.Resize(newSize);
 
-    m_yArray.resize(newSize, NULL);
-
-    if(m_numberOfSamples < newSize) {
+    if(m_numberOfSamples > newSize) {
       m_numberOfSamples = newSize;
+      if(m_spline) {
+        FitSpline();
+      }
     }
-    m_maxNumberOfSamples = newSize; 
+    m_maxNumberOfSamples = newSize;
+    m_interpVectorsGood = false;
   }
 }
 
@@ -228,75 +285,103 @@ int SampledData::Max(int nstate) const {
   }
 
   int index = 0;
-  double maxValue = (*m_yArray[0])(nstate);
-
-  for(int i=1;i<m_numberOfSamples;i++)  {
-    if(maxValue < (*m_yArray[i])(nstate))  {
-      maxValue = (*m_yArray[i])(nstate);
-      index = i;
-    }
-  }
+  m_y.Variable(nstate, 0, m_numberOfSamples).maxCoeff(&index);
   return index;
 }
 
 int SampledData::Min(int nstate) const {
-  int index = 0;
-  double minValue = (*m_yArray[0])(nstate);
-
-  for(int i=1;i<m_numberOfSamples;i++)  {
-    if(minValue > (*m_yArray[i])(nstate))  {
-      minValue = (*m_yArray[i])(nstate);
-      index = i;
-    }
+  if(m_numberOfSamples < 1) {
+    return -1;
   }
+
+  int index = 0;
+  m_y.Variable(nstate, 0, m_numberOfSamples).minCoeff(&index);
   return index;
 }
 
 std::string SampledData::AsJson() {
 
-  std::string json = "{\n \"independent\": { \"name\": \""+m_independentName+"\", \"units\": \""+m_independentUnits+"\", \"values\": [ ";
-  char buffer[256];
-  for(long i=0; i<m_numberOfSamples; i++) {
-    if(i != 0) { json += ","; }
-    std::sprintf(buffer, "%10.10e", m_x(i));
-    json += buffer;
-  }
+  return JsonStreamWriter::WriteToString([this](JsonStreamWriter& writer) { WriteJson(writer); });
+}
 
-  json += "]\n},\n \"dependent\": [\n ";
+void SampledData::WriteJson(JsonStreamWriter& writer) {
+  WriteJsonStructure(writer, true);
+}
 
-  for(long j=0; j<m_numberOfDependent; j++) {
-    if(j != 0) { json += ","; }
-    json += "{\n \"name\": \""+m_arrayColumnNames[j]+"\", \"units\": \""+m_arrayColumnUnits[j]+"\", \"values\": [ ";
+void SampledData::WriteColumnLayout(JsonStreamWriter& writer) {
+  WriteJsonStructure(writer, false);
+}
+
+void SampledData::WriteJsonStructure(JsonStreamWriter& writer, bool withValues) {
+  writer.WriteRaw("{\n \"independent\": { \"name\": ");
+  writer.WriteString(m_independentName);
+  writer.WriteRaw(", \"units\": ");
+  writer.WriteString(m_independentUnits);
+  writer.WriteRaw(", \"values\": ");
+  if(withValues) {
+    writer.WriteRaw("[ ");
     for(long i=0; i<m_numberOfSamples; i++) {
-      if(i != 0) { json += ","; }
-      double value = (*m_yArray[i])(j);
-      std::sprintf(buffer, "%10.10e", value);
-      json += buffer;
+      if(i != 0) { writer.WriteRaw(",", 1); }
+      writer.WriteDouble(m_x(i));
     }
-    json += "]\n}\n";
+    writer.WriteRaw("]");
+  }
+  else {
+    writer.WriteInteger(m_numberOfSamples);
   }
 
+  writer.WriteRaw("\n},\n \"dependent\": [\n ");
+
+  for(long j=0; j<m_numberOfDependent; j++) {
+    if(j != 0) { writer.WriteRaw(",", 1); }
+    writer.WriteRaw("{\n \"name\": ");
+    writer.WriteString(m_arrayColumnNames[j]);
+    writer.WriteRaw(", \"units\": ");
+    writer.WriteString(m_arrayColumnUnits[j]);
+    writer.WriteRaw(", \"values\": ");
+    if(withValues) {
+      writer.WriteRaw("[ ");
+      for(long i=0; i<m_numberOfSamples; i++) {
+        if(i != 0) { writer.WriteRaw(",", 1); }
+        writer.WriteDouble(m_y(i, j));
+      }
+      writer.WriteRaw("]");
+    }
+    else {
+      writer.WriteInteger(m_numberOfSamples);
+    }
+    writer.WriteRaw("\n}\n");
+  }
 
-  json += "]\n}\n";
+  writer.WriteRaw("]\n}\n");
+}
 
-  return json;
+void SampledData::WriteColumns(BinaryColumnWriter& writer) {
+  for(long i=0; i<m_numberOfSamples; i++) {
+    writer.WriteValue(m_x(i));
+  }
+  for(long j=0; j<m_numberOfDependent; j++) {
+    for(long i=0; i<m_numberOfSamples; i++) {
+      writer.WriteValue(m_y(i, j));
+    }
+  }
 }
 
 void SampledData::WriteToLog() {
   wchar_t buffer[256];
-  long num = m_yArray[0]->size();
+  long num = m_numberOfDependent;
 
-  for(long j=0; j<m_yArray.size() && m_yArray[j]; j++) {
+  for(long j=0; j<m_numberOfSamples; j++) {
 
     std::swprintf(buffer, 256, L"x: %5.5e  y:", m_x(j));
     std::wstring output(buffer);
 
     for(long i=0; i<num; i++) {
-      double value = (*m_yArray[j])(i);
+      double value = m_y(j, i);
       std::swprintf(buffer, 256, L"  %5.5e", value);
       output.append(buffer);
     }
-    LogPlain(output.c_str());
+    BACH_LOG_INFO(L"%s", output.c_str());
   }
 }
 
@@ -31,6 +31,9 @@ All Rights Reserved.
 
 #include "DependentData.h"
 #include "InterpolationIndex.h"
+#include "SampleBlock.h"
+#include "BarycentricInterp.h"
+#include "SplineInterp.h"
 #include <vector>
 
 namespace Bach {
@@ -41,7 +44,7 @@ namespace Bach {
 
   class SampledData : public DependentData {
   public:
-    SampledData(int numDependent, int maxNumberOfSamples);
+    SampledData(int numDependent, int maxNumberOfSamples, SampleBlock::Layout layout = SampleBlock::VariableContiguous);
     ~SampledData();
 
     // Store a data set.
@@ -56,6 +59,10 @@ namespace Bach {
     void Retrieve(int index, double& x, Eigen::VectorXd& y) const;
     void Retrieve(double xTarget, Eigen::VectorXd& y);
 
+    // Column k of y is Retrieve(xTargets(k)). Targets in the order the samples were stored
+    // are found in one pass, and those between the same samples interpolated together.
+    void Retrieve(const Eigen::VectorXd& xTargets, Eigen::MatrixXd& y);
+
     void Reset();     // set all of the data to zero
     void Resize(int);
 
@@ -63,6 +70,14 @@ namespace Bach {
     int GetNumberOfSamples() const    {  return m_numberOfSamples;    }; // was GetLength()
     int GetMaxNumberOfSamples() const {  return m_maxNumberOfSamples; }; // was GetMaxLength()
 
+    // The search for the samples either side of a target, SequentialAccessHunt unless set.
+    void SetTableSearch(const boost::shared_ptr<TableSearch>& search) { m_indexHunter = search; }
+
+    // Interpolate with a spline through all of the samples, fitted as they are stored, rather
+    // than a polynomial through the few nearest each target. An empty pointer goes back to that.
+    void SetSpline(const boost::shared_ptr<SplineInterp>& spline);
+    boost::shared_ptr<SplineInterp> GetSpline() const { return m_spline; }
+
     void SetIndependentName(const std::string& name) { m_independentName = name; }
     void SetIndependentUnit(const std::string& unit) { m_independentUnits = unit; }
     void SetArrayColumnNames(const std::vector<std::string>& names);
@@ -75,12 +90,21 @@ namespace Bach {
     int Min() const;
 
     std::string AsJson();
+
+    // The same JSON as AsJson, streamed into writer's buffers.
+    void WriteJson(JsonStreamWriter& writer);
+
+    // The layout and columns of the binary column format. The layout is the JSON
+    // with each values array replaced by its length.
+    void WriteColumnLayout(JsonStreamWriter& writer);
+    void WriteColumns(BinaryColumnWriter& writer);
     void WriteToLog();
 
   protected:
+    void WriteJsonStructure(JsonStreamWriter& writer, bool withValues);
 
     Eigen::VectorXd m_x;
-    std::vector<Eigen::VectorXd*> m_yArray;
+    SampleBlock m_y;
 
     std::string m_independentName;
     std::string m_independentUnits;
@@ -91,7 +115,6 @@ namespace Bach {
     int m_maxNumberOfSamples;
 
     boost::shared_ptr<TableSearch> m_indexHunter;
-    boost::shared_ptr<Interpolator> m_interpolator;
 
     bool CheckBounds(int i) const {
       return (i < m_numberOfSamples ? true : false);
@@ -101,10 +124,17 @@ namespace Bach {
       return ((i < m_numberOfSamples && j < m_numberOfDependent) ? true : false);
     }
 
+    // The samples from m_lastInterpIndex on that the last retrieval interpolated between, one
+    // row per dependent variable, kept with their barycentric weights for the next retrieval
+    // from the same window.
     bool m_interpVectorsGood;
     int  m_lastInterpIndex;
-    std::vector<Eigen::VectorXd> m_interpVectorArray;
+    Eigen::MatrixXd m_interpWindow;
+    BarycentricInterp m_interpolator;
     void SetInterpVectors(int);
+
+    boost::shared_ptr<SplineInterp> m_spline;
+    void FitSpline();
   };
 };
 
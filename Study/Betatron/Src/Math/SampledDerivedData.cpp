@@ -25,6 +25,8 @@ All Rights Reserved.
 #include "SampledDerivedData.h"
 #include "HermiteInterp.h"
 #include "SequentialAccessHunt.h"
+#include "JsonStreamWriter.h"
+#include "BinaryColumnWriter.h"
 #include <boost/lexical_cast.hpp>
 
 using namespace Bach;
@@ -35,14 +37,19 @@ using namespace Eigen;
   //* SampledDerivedData *
   //**********************
 
-SampledDerivedData::SampledDerivedData(int numDependent, int maxNumberOfSamples) :
+SampledDerivedData::SampledDerivedData(int numDependent, int maxNumberOfSamples, SampleBlock::Layout layout) :
+  m_y(2*numDependent, maxNumberOfSamples, layout),
   m_maxNumberOfSamples(maxNumberOfSamples),
-  m_numberOfSamples(0)
+  m_numberOfSamples(0),
+  m_y0(numDependent),
+  m_y1(numDependent),
+  m_dy0(numDependent),
+  m_dy1(numDependent),
+  m_hermiteWindow(numDependent, 4)
 {
   m_numberOfDependent = numDependent;
 
   m_x.resize(m_maxNumberOfSamples);
-  m_yArray.resize(m_maxNumberOfSamples);
 
   m_indexHunter = boost::shared_ptr<TableSearch>(new SequentialAccessHunt());
 
@@ -55,35 +62,24 @@ SampledDerivedData::SampledDerivedData(int numDependent, int maxNumberOfSamples)
 }
 
 SampledDerivedData::~SampledDerivedData() {
-  size_t numYArray = m_yArray.size();
-  for(size_t i=0; i<numYArray; i++) {
-    if(m_yArray[i] != NULL) {
-      delete m_yArray[i];
-      m_yArray[i] = NULL;
-    }
-    else {
-      break;
-    }
-  }
 }
 
 void SampledDerivedData::Store(double x, const Eigen::VectorXd& y, const Eigen::VectorXd& dy) {
   if(m_numberOfSamples >= m_maxNumberOfSamples) {
-    Log(L"ERROR: SampledDerivedData::Store: Attempt to store too many m_x/states (%u)",m_numberOfSamples);
+    BACH_LOG_ERROR(L"SampledDerivedData::Store: Attempt to store too many m_x/states (%u)",m_numberOfSamples);
     throw std::exception();
   }
 
   m_x(m_numberOfSamples) = x;
 
-  m_yArray[m_numberOfSamples] = new Eigen::VectorXd(2*m_numberOfDependent);
-  m_yArray[m_numberOfSamples]->block(0, 0, m_numberOfDependent, 1) = y;
-  m_yArray[m_numberOfSamples]->block(m_numberOfDependent, 0, m_numberOfDependent, 1) = dy;
+  m_y.SetSample(m_numberOfSamples, y);
+  m_y.SetSample(m_numberOfSamples, dy, m_numberOfDependent);
   m_numberOfSamples++;
 }
 
 double SampledDerivedData::operator()(int index) const {
   if(!CheckBounds(index)) {
-    Log(L"ERROR: SampledDerivedData::operator()(int): Bounds error at %u [0 to %d]", index, m_numberOfSamples-1);
+    BACH_LOG_ERROR(L"SampledDerivedData::operator()(int): Bounds error at %u [0 to %d]", index, m_numberOfSamples-1);
     throw std::exception();
   }
   return m_x(index);
@@ -91,26 +87,26 @@ double SampledDerivedData::operator()(int index) const {
 
 double SampledDerivedData::operator()(int i, int j) const {
   if(!CheckBounds(i, j)) {
-    Log(L"ERROR: SampledDerivedData::operator()(int i,int j): State bounds error at (%u,%u) [is (0,0) to (%u,%u)]", i, j, m_numberOfSamples-1, m_numberOfDependent-1);
+    BACH_LOG_ERROR(L"SampledDerivedData::operator()(int i,int j): State bounds error at (%u,%u) [is (0,0) to (%u,%u)]", i, j, m_numberOfSamples-1, m_numberOfDependent-1);
     throw std::exception();
   }
-  return (*m_yArray[i])(j);
+  return m_y(i, j);
 }
 
 void SampledDerivedData::Retrieve(int index, double& x, Eigen::VectorXd& y, Eigen::VectorXd& dy) const {
   if(!CheckBounds(index)) {
-    Log(L"ERROR: SampledDerivedData::Retrieve(i,d,v,v): Bounds error at %u [0 to %d]", index, m_numberOfSamples-1);
+    BACH_LOG_ERROR(L"SampledDerivedData::Retrieve(i,d,v,v): Bounds error at %u [0 to %d]", index, m_numberOfSamples-1);
     throw std::exception();
   }
 
   x  = m_x(index);
-  y  = m_yArray[index]->block(0, 0, m_numberOfDependent, 1);
-  dy = m_yArray[index]->block(m_numberOfDependent, 0, m_numberOfDependent, 1);
+  y  = m_y.Sample(index, 0, m_numberOfDependent);
+  dy = m_y.Sample(index, m_numberOfDependent, m_numberOfDependent);
 }
 
 double SampledDerivedData::Retrieve(double xTarget, int yIndex) {
   if(!CheckBounds(0, yIndex*2)) {
-    Log(L"ERROR: SampledDerivedData::Retrieve(d,i): State bounds error at %u [0 to %d]", yIndex, m_numberOfSamples-1);
+    BACH_LOG_ERROR(L"SampledDerivedData::Retrieve(d,i): State bounds error at %u [0 to %d]", yIndex, m_numberOfSamples-1);
     throw std::exception();
   }
 
@@ -121,66 +117,86 @@ double SampledDerivedData::Retrieve(double xTarget, int yIndex) {
     xTarget,
     m_x(indexLow),
     m_x(indexLow+1),
-    (*m_yArray[indexLow])(yIndex),
-    (*m_yArray[indexLow+1])(yIndex),
-    (*m_yArray[indexLow])(yIndex+m_numberOfDependent),
-    (*m_yArray[indexLow+1])(yIndex+m_numberOfDependent));
+    m_y(indexLow, yIndex),
+    m_y(indexLow+1, yIndex),
+    m_y(indexLow, yIndex+m_numberOfDependent),
+    m_y(indexLow+1, yIndex+m_numberOfDependent));
 }
 
 void SampledDerivedData::Retrieve(double xTarget, Eigen::VectorXd& ydy) {
   if(m_numberOfDependent != ydy.rows()) {
-    Log(L"ERROR: SampledDerivedData::Retrieve(d,v): State bounds error (%u vs %d)", ydy.rows(), m_numberOfDependent);
+    BACH_LOG_ERROR(L"SampledDerivedData::Retrieve(d,v): State bounds error (%u vs %d)", ydy.rows(), m_numberOfDependent);
     throw std::exception();
   }
 
   int indexLow = m_indexHunter->Find(xTarget, m_x.block(0, 0, m_numberOfSamples, 1));
   indexLow = InterpolationIndex::ChooseInterpolationIndex(m_numberOfSamples, indexLow, 2);
 
-  HermiteInterp::Interpolate(
-    xTarget,
-    m_x(indexLow),
-    m_x(indexLow+1),
-    m_yArray[indexLow]->block(0, 0, m_numberOfDependent, 1),
-    m_yArray[indexLow+1]->block(0, 0, m_numberOfDependent, 1),
-    m_yArray[indexLow]->block(m_numberOfDependent, 0, m_numberOfDependent, 1),
-    m_yArray[indexLow+1]->block(m_numberOfDependent, 0, m_numberOfDependent, 1),
-    ydy);
+  m_y.GetSample(indexLow, m_y0);
+  m_y.GetSample(indexLow+1, m_y1);
+  m_y.GetSample(indexLow, m_dy0, m_numberOfDependent);
+  m_y.GetSample(indexLow+1, m_dy1, m_numberOfDependent);
+
+  HermiteInterp::Interpolate(xTarget, m_x(indexLow), m_x(indexLow+1), m_y0, m_y1, m_dy0, m_dy1, ydy);
+}
+
+void SampledDerivedData::Retrieve(const Eigen::VectorXd& xTargets, Eigen::MatrixXd& y) {
+  int numTargets = (int) xTargets.rows();
+  y.resize(m_numberOfDependent, numTargets);
+  if(numTargets == 0) {
+    return;
+  }
+
+  if(m_numberOfSamples < 2) {
+    BACH_LOG_ERROR(L"SampledDerivedData::Retrieve(v,m): At least two samples are needed to interpolate (%d)", m_numberOfSamples);
+    throw std::exception();
+  }
+
+  SequentialAccessHunt hunter;
+  int first = 0;
+  int indexLow = -1;
+  for(int k=0; k<numTargets; k++) {
+    int index = hunter.Find(xTargets(k), m_x.head(m_numberOfSamples));
+    index = InterpolationIndex::ChooseInterpolationIndex(m_numberOfSamples, index, 2);
+    if(index != indexLow) {
+      if(k > first) {
+        HermiteInterp::Interpolate(xTargets, first, k-first, m_x(indexLow), m_x(indexLow+1), m_hermiteWindow, m_hermiteCoefficients, y);
+      }
+      m_hermiteWindow.col(0) = m_y.Sample(index, 0, m_numberOfDependent);
+      m_hermiteWindow.col(1) = m_y.Sample(index+1, 0, m_numberOfDependent);
+      m_hermiteWindow.col(2) = m_y.Sample(index, m_numberOfDependent, m_numberOfDependent);
+      m_hermiteWindow.col(3) = m_y.Sample(index+1, m_numberOfDependent, m_numberOfDependent);
+      indexLow = index;
+      first = k;
+    }
+  }
+  HermiteInterp::Interpolate(xTargets, first, numTargets-first, m_x(indexLow), m_x(indexLow+1), m_hermiteWindow, m_hermiteCoefficients, y);
 }
 
 void SampledDerivedData::Reset() {
   m_numberOfSamples = 0;
+  m_indexHunter->TableChanged();
 }
 
 void SampledDerivedData::Resize(int newSize) {
   // Increase the size.
   if(newSize > m_maxNumberOfSamples) {
-    Eigen::VectorXd copy = m_x.block(0, 0, m_numberOfSamples, 1);
-    m_x.resize(newSize);
-    m_x.block(0, 0, m_numberOfSamples, 1) = copy;
-
-    //Eigen::VectorXd** newState = new Eigen::VectorXd*[newSize];
-    m_yArray.resize(newSize, NULL);
+    m_x.conservativeResize(newSize);
+    m_y.Resize(newSize);
 
     m_maxNumberOfSamples = newSize;
   }
 
     // Decrease the size;
   else if(newSize < m_maxNumberOfSamples) {
-    // Copy but keep the existing values.
-    Eigen::VectorXd copy = m_x.block(0, 0, newSize, 1);
-    m_x.resize(newSize);
-    m_x.block(0, 0, newSize, 1) = copy;
-
-    for(int i=newSize-1; i<m_numberOfSamples; i++)  {
-      delete m_yArray[i];
-    }
-
-    m_yArray.resize(newSize, NULL);
+    // Keep the values that still fit.
+    m_x.conservativeResize(newSize);
+    m_y.Resize(newSize);
 
-    if(m_numberOfSamples < newSize) {
+    if(m_numberOfSamples > newSize) {
       m_numberOfSamples = newSize;
     }
-    m_maxNumberOfSamples = newSize; 
+    m_maxNumberOfSamples = newSize;
   }
 }
 
@@ -204,58 +220,86 @@ int SampledDerivedData::Max(int nstate) const {
   }
 
   int index = 0;
-  double maxValue = (*m_yArray[0])(nstate);
-
-  for(int i=1;i<m_numberOfSamples;i++)  {
-    if(maxValue < (*m_yArray[i])(nstate))  {
-      maxValue = (*m_yArray[i])(nstate);
-      index = i;
-    }
-  }
+  m_y.Variable(nstate, 0, m_numberOfSamples).maxCoeff(&index);
   return index;
 }
 
 int SampledDerivedData::Min(int nstate) const {
-  int index = 0;
-  double minValue = (*m_yArray[0])(nstate);
-
-  for(int i=1;i<m_numberOfSamples;i++)  {
-    if(minValue > (*m_yArray[i])(nstate))  {
-      minValue = (*m_yArray[i])(nstate);
-      index = i;
-    }
+  if(m_numberOfSamples < 1) {
+    return -1;
   }
+
+  int index = 0;
+  m_y.Variable(nstate, 0, m_numberOfSamples).minCoeff(&index);
   return index;
 }
 
 std::string SampledDerivedData::AsJson() {
 
-  std::string json = "{\n \"independent\": { \"name\": \""+m_independentName+"\", \"units\": \""+m_independentUnits+"\", \"values\": [ ";
-  char buffer[256];
-  for(long i=0; i<m_numberOfSamples; i++) {
-    if(i != 0) { json += ","; }
-    std::sprintf(buffer, "%10.10e", m_x(i));
-    json += buffer;
-  }
+  return JsonStreamWriter::WriteToString([this](JsonStreamWriter& writer) { WriteJson(writer); });
+}
 
-  json += "]\n},\n \"dependent\": [\n ";
+void SampledDerivedData::WriteJson(JsonStreamWriter& writer) {
+  WriteJsonStructure(writer, true);
+}
 
-  for(long j=0; j<m_numberOfDependent; j++) {
-    if(j != 0) { json += ","; }
-    json += "{\n \"name\": \""+m_arrayColumnNames[j]+"\", \"units\": \""+m_arrayColumnUnits[j]+"\", \"values\": [ ";
+void SampledDerivedData::WriteColumnLayout(JsonStreamWriter& writer) {
+  WriteJsonStructure(writer, false);
+}
+
+void SampledDerivedData::WriteJsonStructure(JsonStreamWriter& writer, bool withValues) {
+  writer.WriteRaw("{\n \"independent\": { \"name\": ");
+  writer.WriteString(m_independentName);
+  writer.WriteRaw(", \"units\": ");
+  writer.WriteString(m_independentUnits);
+  writer.WriteRaw(", \"values\": ");
+  if(withValues) {
+    writer.WriteRaw("[ ");
     for(long i=0; i<m_numberOfSamples; i++) {
-      if(i != 0) { json += ","; }
-      double value = (*m_yArray[i])(j);
-      std::sprintf(buffer, "%10.10e", value);
-      json += buffer;
+      if(i != 0) { writer.WriteRaw(",", 1); }
+      writer.WriteDouble(m_x(i));
     }
-    json += "]\n}\n";
+    writer.WriteRaw("]");
+  }
+  else {
+    writer.WriteInteger(m_numberOfSamples);
   }
 
+  writer.WriteRaw("\n},\n \"dependent\": [\n ");
 
-  json += "]\n}\n";
+  for(long j=0; j<m_numberOfDependent; j++) {
+    if(j != 0) { writer.WriteRaw(",", 1); }
+    writer.WriteRaw("{\n \"name\": ");
+    writer.WriteString(m_arrayColumnNames[j]);
+    writer.WriteRaw(", \"units\": ");
+    writer.WriteString(m_arrayColumnUnits[j]);
+    writer.WriteRaw(", \"values\": ");
+    if(withValues) {
+      writer.WriteRaw("[ ");
+      for(long i=0; i<m_numberOfSamples; i++) {
+        if(i != 0) { writer.WriteRaw(",", 1); }
+        writer.WriteDouble(m_y(i, j));
+      }
+      writer.WriteRaw("]");
+    }
+    else {
+      writer.WriteInteger(m_numberOfSamples);
+    }
+    writer.WriteRaw("\n}\n");
+  }
+
+  writer.WriteRaw("]\n}\n");
+}
 
-  return json;
+void SampledDerivedData::WriteColumns(BinaryColumnWriter& writer) {
+  for(long i=0; i<m_numberOfSamples; i++) {
+    writer.WriteValue(m_x(i));
+  }
+  for(long j=0; j<m_numberOfDependent; j++) {
+    for(long i=0; i<m_numberOfSamples; i++) {
+      writer.WriteValue(m_y(i, j));
+    }
+  }
 }
 
 void SampledDerivedData::WriteToLog() {
@@ -263,7 +307,7 @@ void SampledDerivedData::WriteToLog() {
   Eigen::VectorXd y(m_numberOfDependent);
   for(int i=0; i<m_numberOfSamples; i++) {
     std::stringstream stream;
-    stream << m_x(i) << ", " << m_yArray[i]->format(fmt);
-    LogPlain(WideStringFromUTF8(stream.str()).c_str());
+    stream << m_x(i) << ", " << m_y.Sample(i, 0, 2*m_numberOfDependent).transpose().format(fmt);
+    BACH_LOG_INFO(L"%s", WideStringFromUTF8(stream.str()).c_str());
   }
 }
@@ -27,6 +27,7 @@ All Rights Reserved.
 
 #include "DependentData.h"
 #include "InterpolationIndex.h"
+#include "SampleBlock.h"
 #include <vector>
 
 namespace Bach {
@@ -37,7 +38,7 @@ namespace Bach {
 
   class SampledDerivedData : public DependentData {
   public:
-    SampledDerivedData(int numDependent, int maxNumberOfSamples);
+    SampledDerivedData(int numDependent, int maxNumberOfSamples, SampleBlock::Layout layout = SampleBlock::VariableContiguous);
      ~SampledDerivedData();
 
     void Store(double x, const Eigen::VectorXd& y, const Eigen::VectorXd& dy);
@@ -51,6 +52,10 @@ namespace Bach {
     void Retrieve(int index, double& x, Eigen::VectorXd& y) const;
     void Retrieve(double xTarget, Eigen::VectorXd& y);
 
+    // Column k of y is Retrieve(xTargets(k)). Targets in the order the samples were stored
+    // are found in one pass, and those between the same samples interpolated together.
+    void Retrieve(const Eigen::VectorXd& xTargets, Eigen::MatrixXd& y);
+
       // Retrieve values and derivatives.
     void Retrieve(int index, double&, Eigen::VectorXd& y, Eigen::VectorXd& dy) const;
 
@@ -61,6 +66,9 @@ namespace Bach {
     int GetNumberOfSamples() const    {  return m_numberOfSamples;    }; // was GetLength()
     int GetMaxNumberOfSamples() const {  return m_maxNumberOfSamples; }; // was GetMaxLength()
 
+    // The search for the samples either side of a target, SequentialAccessHunt unless set.
+    void SetTableSearch(const boost::shared_ptr<TableSearch>& search) { m_indexHunter = search; }
+
     void SetIndependentName(const std::string& name) { m_independentName = name; }
     void SetIndependentUnit(const std::string& unit) { m_independentUnits = unit; }
     void SetArrayColumnNames(const std::vector<std::string>& names);
@@ -73,11 +81,20 @@ namespace Bach {
     int Min() const;
 
     std::string AsJson();
+
+    // The same JSON as AsJson, streamed into writer's buffers.
+    void WriteJson(JsonStreamWriter& writer);
+
+    // The layout and columns of the binary column format. The layout is the JSON
+    // with each values array replaced by its length.
+    void WriteColumnLayout(JsonStreamWriter& writer);
+    void WriteColumns(BinaryColumnWriter& writer);
     void WriteToLog();
 
   protected:
+    void WriteJsonStructure(JsonStreamWriter& writer, bool withValues);
     Eigen::VectorXd m_x;
-    std::vector<Eigen::VectorXd*> m_yArray;
+    SampleBlock m_y; // The values in the first half of each sample, the derivatives in the second.
 
     std::string m_independentName;
     std::string m_independentUnits;
@@ -88,6 +105,17 @@ namespace Bach {
     int m_maxNumberOfSamples;
     boost::shared_ptr<TableSearch> m_indexHunter;
 
+    // Scratch space for the Hermite interpolation so that retrieval does not allocate.
+    Eigen::VectorXd m_y0;
+    Eigen::VectorXd m_y1;
+    Eigen::VectorXd m_dy0;
+    Eigen::VectorXd m_dy1;
+
+    // The same for the batch retrieval, the values and derivatives either side of a span of
+    // targets in the columns of m_hermiteWindow and their coefficients in m_hermiteCoefficients.
+    Eigen::MatrixXd m_hermiteWindow;
+    Eigen::MatrixXd m_hermiteCoefficients;
+
     bool CheckBounds(int i) const {
       return (i < m_numberOfSamples ? true : false);
     }
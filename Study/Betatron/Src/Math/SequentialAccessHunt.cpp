@@ -35,7 +35,7 @@ using namespace Eigen;
   //* SequentialAccessHunt *
   //************************
 
-int SequentialAccessHunt::Find(double xTarget, const Eigen::VectorXd& x) {
+int SequentialAccessHunt::Find(double xTarget, const Eigen::Ref<const Eigen::VectorXd>& x) {
   m_size = (int) x.rows();
   m_ascending = (x(m_size-1) > x(0));
 
@@ -64,7 +64,7 @@ int SequentialAccessHunt::Find(double xTarget, const Eigen::VectorXd& x) {
   return m_indexLow;
 }
 
-void SequentialAccessHunt::HuntUp(double xTarget, const Eigen::VectorXd& x) {
+void SequentialAccessHunt::HuntUp(double xTarget, const Eigen::Ref<const Eigen::VectorXd>& x) {
   int increment = 1;
   m_indexHigh = m_indexLow+1;
 
@@ -83,7 +83,7 @@ void SequentialAccessHunt::HuntUp(double xTarget, const Eigen::VectorXd& x) {
   }
 }
 
-void SequentialAccessHunt::HuntDown(double xTarget,const Eigen::VectorXd& x) {
+void SequentialAccessHunt::HuntDown(double xTarget, const Eigen::Ref<const Eigen::VectorXd>& x) {
   int increment = 1;
   m_indexHigh = m_indexLow;
   m_indexLow -= 1;
@@ -39,11 +39,11 @@ namespace Bach {
   public:
     SequentialAccessHunt(int i = 0) : TableSearch(i) {}
 
-    virtual int Find(double x,const Eigen::VectorXd& y);
+    virtual int Find(double x, const Eigen::Ref<const Eigen::VectorXd>& y);
 
   protected:
-    void HuntUp(double x, const Eigen::VectorXd& y);
-    void HuntDown(double x, const Eigen::VectorXd& y);
+    void HuntUp(double x, const Eigen::Ref<const Eigen::VectorXd>& y);
+    void HuntDown(double x, const Eigen::Ref<const Eigen::VectorXd>& y);
   };
 };
 
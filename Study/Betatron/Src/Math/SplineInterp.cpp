@@ -0,0 +1,287 @@
+/**********************************************************************
+
+File     : SplineInterp.cpp
+Project  : Bach Simulation
+Purpose  : Source file for a cubic spline through all of the samples of a table.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "SplineInterp.h"
+#include <algorithm>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  // Room for this many points at first, doubled whenever it runs out.
+  const int INITIAL_CAPACITY = 16;
+
+  // The largest slope, as a multiple of the secants either side, that keeps a cubic
+  // monotone, from the square 0 <= alpha, beta <= 3 of Fritsch and Carlson.
+  const double MONOTONE_LIMIT = 3.0;
+}
+
+  //****************
+  //* SplineInterp *
+  //****************
+
+SplineInterp::SplineInterp(Type type, int numColumns) :
+  m_type(type),
+  m_numColumns(0),
+  m_numPoints(0),
+  m_numFitted(0)
+{
+  Reset(numColumns);
+}
+
+void SplineInterp::SetType(Type type) {
+  m_type = type;
+  Rebuild();
+}
+
+void SplineInterp::SetEndSlopes(const VectorXd& start, const VectorXd& end) {
+  if(start.rows() != m_numColumns || end.rows() != m_numColumns) {
+    BACH_LOG_ERROR(L"SplineInterp::SetEndSlopes: Slopes for %d and %d columns, not %d", start.rows(), end.rows(), m_numColumns);
+    throw std::exception();
+  }
+  m_startSlopes = start;
+  m_endSlopes = end;
+  if(m_type == Clamped) {
+    Rebuild();
+  }
+}
+
+void SplineInterp::Reset(int numColumns) {
+  if(numColumns != m_numColumns) {
+    m_numColumns = numColumns;
+    m_startSlopes.setZero(numColumns);
+    m_endSlopes.setZero(numColumns);
+    m_slope.resize(numColumns);
+
+    m_x.resize(0);
+    m_values.resize(numColumns, 0);
+    m_slopes.resize(numColumns, 0);
+    m_upper.resize(0);
+    m_rightHandSides.resize(numColumns, 0);
+    m_inverseWidths.resize(0);
+    m_coefficients.resize(4*numColumns, 0);
+  }
+  m_numPoints = 0;
+  m_numFitted = 0;
+}
+
+void SplineInterp::Append(double x, const VectorXd& y) {
+  if(y.rows() != m_numColumns) {
+    BACH_LOG_ERROR(L"SplineInterp::Append: %d values for %d columns", y.rows(), m_numColumns);
+    throw std::exception();
+  }
+
+  int n = m_numPoints;
+  if(n > 0 && x == m_x(n-1)) {
+    BACH_LOG_ERROR(L"SplineInterp::Append: Point %d is at the same x as the one before, %f", n, x);
+    throw std::exception();
+  }
+  if(n > 1 && (x-m_x(n-1))*(m_x(n-1)-m_x(n-2)) < 0.0) {
+    BACH_LOG_ERROR(L"SplineInterp::Append: Point %d at %f turns back from those before it", n, x);
+    throw std::exception();
+  }
+
+  Reserve(n+1);
+  m_x(n) = x;
+  m_values.col(n) = y;
+  m_numPoints++;
+  Extend();
+}
+
+void SplineInterp::Interpolate(double xTarget, int index, Ref<VectorXd> yResult) {
+  if(yResult.rows() != m_numColumns) {
+    BACH_LOG_ERROR(L"SplineInterp::Interpolate: Result for %d columns, not %d", yResult.rows(), m_numColumns);
+    throw std::exception();
+  }
+
+  int interval = GetInterval(index);
+  Update();
+  double t = (xTarget-m_x(interval))*m_inverseWidths(interval);
+  int nc = m_numColumns;
+
+  const double* c = m_coefficients.col(interval).data();
+  for(int j=0; j<nc; j++) {
+    yResult(j) = c[j]+t*(c[nc+j]+t*(c[2*nc+j]+t*c[3*nc+j]));
+  }
+}
+
+double SplineInterp::Interpolate(double xTarget, int index, int yIndex) {
+  int interval = GetInterval(index);
+  Update();
+  double t = (xTarget-m_x(interval))*m_inverseWidths(interval);
+  int nc = m_numColumns;
+
+  const double* c = m_coefficients.col(interval).data()+yIndex;
+  return c[0]+t*(c[nc]+t*(c[2*nc]+t*c[3*nc]));
+}
+
+double SplineInterp::GetSlope(int i, int yIndex) {
+  Update();
+  return m_slopes(yIndex, i);
+}
+
+void SplineInterp::Reserve(int numPoints) {
+  int capacity = (int) m_x.rows();
+  if(numPoints <= capacity) {
+    return;
+  }
+
+  capacity = std::max(std::max(numPoints, 2*capacity), INITIAL_CAPACITY);
+  m_x.conservativeResize(capacity);
+  m_values.conservativeResize(NoChange, capacity);
+  m_slopes.conservativeResize(NoChange, capacity);
+  m_upper.conservativeResize(capacity);
+  m_rightHandSides.conservativeResize(NoChange, capacity);
+  m_inverseWidths.conservativeResize(capacity);
+  m_coefficients.conservativeResize(NoChange, capacity);
+}
+
+void SplineInterp::Rebuild() {
+  // The points are already in place, so they are fitted again one at a time.
+  int numPoints = m_numPoints;
+  m_numPoints = 0;
+  m_numFitted = 0;
+  while(m_numPoints < numPoints) {
+    m_numPoints++;
+    Extend();
+  }
+}
+
+void SplineInterp::Extend() {
+  int n = m_numPoints;
+  if(n < 2) {
+    return;
+  }
+
+  m_inverseWidths(n-2) = 1.0/(m_x(n-1)-m_x(n-2));
+  if(m_type == Monotone) {
+    SetMonotoneSlopes();
+    m_numFitted = n;
+  }
+  else {
+    EliminateRow();
+  }
+}
+
+void SplineInterp::EliminateRow() {
+  // The slopes m satisfy, between the end conditions,
+  //   h(i)*m(i-1)+2*(h(i-1)+h(i))*m(i)+h(i-1)*m(i+1) = 3*(h(i)*d(i-1)+h(i-1)*d(i))
+  // with h(i) the width of interval i and d(i) its secant. A natural spline has
+  //   2*m(0)+m(1) = 3*d(0) and m(n-2)+2*m(n-1) = 3*d(n-2)
+  // and a clamped one the slopes at the ends. Each row is divided through so that its
+  // diagonal is one and the row before is eliminated, leaving the upper diagonal in m_upper.
+  // The row of a point is known once the point after it is, and the last row is the end
+  // condition, which is only used in SolveNaturalOrClamped.
+  int row = m_numPoints-2;
+  double h1 = m_x(row+1)-m_x(row);
+  double w1 = m_inverseWidths(row);
+
+  if(row == 0) {
+    if(m_type == Clamped) {
+      m_upper(0) = 0.0;
+      m_rightHandSides.col(0) = m_startSlopes;
+    }
+    else {
+      m_upper(0) = 0.5;
+      m_rightHandSides.col(0) = 1.5*w1*(m_values.col(1)-m_values.col(0));
+    }
+  }
+  else {
+    double h0 = m_x(row)-m_x(row-1);
+    double w0 = m_inverseWidths(row-1);
+    double pivot = 2.0*(h0+h1)-h1*m_upper(row-1);
+    m_upper(row) = h0/pivot;
+    m_rightHandSides.col(row) = (3.0*(h1*w0*(m_values.col(row)-m_values.col(row-1))+h0*w1*(m_values.col(row+1)-m_values.col(row)))-
+                                 h1*m_rightHandSides.col(row-1))/pivot;
+  }
+}
+
+void SplineInterp::SolveNaturalOrClamped() {
+  int n = m_numPoints;
+  double w1 = m_inverseWidths(n-2);
+  if(m_type == Clamped) {
+    m_slopes.col(n-1) = m_endSlopes;
+  }
+  else {
+    m_slopes.col(n-1) = (3.0*w1*(m_values.col(n-1)-m_values.col(n-2))-m_rightHandSides.col(n-2))/(2.0-m_upper(n-2));
+  }
+
+  // Back up until a slope comes out as it was, which those up to the end of the last fit
+  // could have, since the end was the only one with a different row.
+  int i = n-2;
+  for(; i>=0; i--) {
+    m_slope = m_rightHandSides.col(i)-m_upper(i)*m_slopes.col(i+1);
+    if(i < m_numFitted-1 && (m_slope.array() == m_slopes.col(i).array()).all()) {
+      break;
+    }
+    m_slopes.col(i) = m_slope;
+  }
+
+  for(int interval=std::max(i, 0); interval<n-1; interval++) {
+    SetCoefficients(interval);
+  }
+  m_numFitted = n;
+}
+
+void SplineInterp::SetMonotoneSlopes() {
+  // The ends take the secant, so only the end before and its two intervals change.
+  int n = m_numPoints;
+  m_slopes.col(n-1) = m_inverseWidths(n-2)*(m_values.col(n-1)-m_values.col(n-2));
+  if(n == 2) {
+    m_slopes.col(0) = m_slopes.col(1);
+  }
+  else {
+    SetMonotoneSlope(n-2);
+    SetCoefficients(n-3);
+  }
+  SetCoefficients(n-2);
+}
+
+void SplineInterp::SetMonotoneSlope(int i) {
+  // The mean of the secants either side, zero at an extremum and limited to where the
+  // cubics either side stay monotone.
+  for(int j=0; j<m_numColumns; j++) {
+    double d0 = m_inverseWidths(i-1)*(m_values(j, i)-m_values(j, i-1));
+    double d1 = m_inverseWidths(i)*(m_values(j, i+1)-m_values(j, i));
+    double slope = 0.0;
+    if(d0*d1 > 0.0) {
+      slope = 0.5*(d0+d1);
+      double limit = MONOTONE_LIMIT*std::min(fabs(d0), fabs(d1));
+      if(fabs(slope) > limit) {
+        slope = (slope > 0.0 ? limit : -limit);
+      }
+    }
+    m_slopes(j, i) = slope;
+  }
+}
+
+void SplineInterp::SetCoefficients(int interval) {
+  // The cubic Hermite between the points, in powers of t = (x-x0)/(x1-x0).
+  int nc = m_numColumns;
+  double h = m_x(interval+1)-m_x(interval);
+  MatrixXd::ColXpr c = m_coefficients.col(interval);
+
+  c.segment(0, nc) = m_values.col(interval);
+  c.segment(nc, nc) = h*m_slopes.col(interval);
+  c.segment(2*nc, nc) = 3.0*(m_values.col(interval+1)-m_values.col(interval))-h*(2.0*m_slopes.col(interval)+m_slopes.col(interval+1));
+  c.segment(3*nc, nc) = 2.0*(m_values.col(interval)-m_values.col(interval+1))+h*(m_slopes.col(interval)+m_slopes.col(interval+1));
+}
+
+int SplineInterp::GetInterval(int index) const {
+  if(m_numPoints < 2) {
+    BACH_LOG_ERROR(L"SplineInterp::GetInterval: %d points, fewer than the two a spline needs", m_numPoints);
+    throw std::exception();
+  }
+  return std::min(std::max(index, 0), m_numPoints-2);
+}
@@ -0,0 +1,121 @@
+/**********************************************************************
+
+File     : SplineInterp.h
+Project  : Bach Simulation
+Purpose  : Header file for a cubic spline through all of the samples of a table.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           PolynomialInterp and RationalInterp fit a few points either side of
+           each target afresh. This spline is fitted once, as the points are
+           appended, and keeps the cubic of each interval, so once the interval
+           is found a value is a few multiplies whatever the order.
+
+           The slopes at the points are those of a natural spline, of a spline
+           clamped to given slopes at the ends, or the monotone slopes of
+           Fritsch and Carlson, Monotone Piecewise Cubic Interpolation, SIAM
+           Journal on Numerical Analysis 17(2), 1980, pp 238-246.
+
+           The natural and clamped slopes are the solution of a tridiagonal
+           system. Appending a point adds a row to the elimination, and the
+           next interpolation substitutes back from the new end, stopping at
+           the first slope that comes out the same as before, since those
+           before it are then the same too. The change at least halves from
+           each point to the one before, so that is a few tens of points back
+           from those appended, and the slopes are exactly those of fitting
+           the whole table at once.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_SPLINE_INTERP_H__
+#define __BACH_SPLINE_INTERP_H__
+
+#include "BachDefs.h"
+
+namespace Bach {
+
+  //****************
+  //* SplineInterp *
+  //****************
+
+  class SplineInterp {
+  public:
+    enum Type { Natural, Clamped, Monotone };
+
+    SplineInterp(Type type = Natural, int numColumns = 1);
+
+    Type GetType() const { return m_type; }
+    void SetType(Type type);
+
+    // The slopes at the first and last points of a clamped spline, one per column.
+    void SetEndSlopes(const Eigen::VectorXd& start, const Eigen::VectorXd& end);
+
+    int GetNumberOfColumns() const { return m_numColumns; }
+    int GetNumberOfPoints() const { return m_numPoints; }
+
+    // Clear the points, keeping the type and end slopes.
+    void Reset(int numColumns);
+
+    // Add a point after the last one, with one value per column. The points may go either
+    // way but two next to each other can't be at the same x.
+    void Append(double x, const Eigen::VectorXd& y);
+
+    // The value at xTarget of each column from the interval starting at point index, as a
+    // TableSearch finds it. Indices before the first interval or after the last are taken
+    // as those intervals, which extrapolate.
+    void Interpolate(double xTarget, int index, Eigen::Ref<Eigen::VectorXd> yResult);
+    double Interpolate(double xTarget, int index, int yIndex);
+
+    // The slope at point i of column yIndex.
+    double GetSlope(int i, int yIndex);
+
+  protected:
+    void Reserve(int numPoints);
+    void Rebuild();
+
+    // Add the last point stored, m_numPoints-1, to the fit.
+    void Extend();
+    void EliminateRow();
+
+    // Bring the slopes and coefficients up to the points appended since they were last set.
+    void Update() {
+      if(m_numFitted != m_numPoints && m_numPoints > 1) {
+        SolveNaturalOrClamped();
+      }
+    }
+    void SolveNaturalOrClamped();
+    void SetMonotoneSlopes();
+    void SetMonotoneSlope(int i);
+    void SetCoefficients(int interval);
+
+    int GetInterval(int index) const;
+
+    Type m_type;
+    int m_numColumns;
+    int m_numPoints;
+    int m_numFitted;
+
+    Eigen::VectorXd m_startSlopes;
+    Eigen::VectorXd m_endSlopes;
+
+    // A column per point.
+    Eigen::VectorXd m_x;
+    Eigen::MatrixXd m_values;
+    Eigen::MatrixXd m_slopes;
+
+    // The forward elimination of the rows before the last, whose right hand sides are
+    // one per column.
+    Eigen::VectorXd m_upper;
+    Eigen::MatrixXd m_rightHandSides;
+    Eigen::VectorXd m_slope;
+
+    // A column per interval, the coefficients of the powers of (x-x0)/(x1-x0) from the
+    // zeroth up, each a block of m_numColumns rows.
+    Eigen::VectorXd m_inverseWidths;
+    Eigen::MatrixXd m_coefficients;
+  };
+};
+
+#endif // __BACH_SPLINE_INTERP_H__
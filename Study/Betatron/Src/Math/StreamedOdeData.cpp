@@ -0,0 +1,243 @@
+/**********************************************************************
+
+File     : StreamedOdeData.cpp
+Project  : Bach Simulation
+Purpose  : Source file for reading the file written by StreamingOdeDataCollector.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "StreamedOdeData.h"
+#include "StreamingOdeDataCollector.h"
+#include "HermiteInterp.h"
+#include "InterpolationIndex.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+  //*******************
+  //* StreamedOdeData *
+  //*******************
+
+shared_ptr<StreamedOdeData> StreamedOdeData::CreateInstance(const std::string& filePath) {
+  shared_ptr<StreamedOdeData> instance(new StreamedOdeData());
+  instance->Open(filePath);
+  return instance;
+}
+
+StreamedOdeData::StreamedOdeData() :
+  m_fileDescriptor(-1),
+  m_mappedData(NULL),
+  m_mappedLength(0),
+  m_numberOfInternal(0),
+  m_numStateSamples(0),
+  m_numInternalSamples(0)
+{
+  m_numberOfDependent = 0;
+}
+
+StreamedOdeData::~StreamedOdeData() {
+  if(m_mappedData) {
+    munmap((void*) m_mappedData, m_mappedLength);
+  }
+  if(m_fileDescriptor >= 0) {
+    close(m_fileDescriptor);
+  }
+}
+
+void StreamedOdeData::Open(const std::string& filePath) {
+  m_filePath = filePath;
+
+  m_fileDescriptor = open(filePath.c_str(), O_RDONLY);
+  if(m_fileDescriptor < 0) {
+    BACH_LOG_ERROR(L"StreamedOdeData::Open: Unable to open %s", WideStringFromUTF8(filePath).c_str());
+    throw std::exception();
+  }
+
+  struct stat fileStatus;
+  if(fstat(m_fileDescriptor, &fileStatus) != 0 || fileStatus.st_size < (off_t) sizeof(StreamedOdeDataHeader)) {
+    BACH_LOG_ERROR(L"StreamedOdeData::Open: %s is too short to hold a header", WideStringFromUTF8(filePath).c_str());
+    throw std::exception();
+  }
+
+  m_mappedLength = (size_t) fileStatus.st_size;
+  void* mapped = mmap(NULL, m_mappedLength, PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+  if(mapped == MAP_FAILED) {
+    BACH_LOG_ERROR(L"StreamedOdeData::Open: Unable to map %s", WideStringFromUTF8(filePath).c_str());
+    throw std::exception();
+  }
+  m_mappedData = (const char*) mapped;
+
+  IndexChunks();
+
+  m_y0.resize(m_numberOfDependent);
+  m_y1.resize(m_numberOfDependent);
+  m_dy0.resize(m_numberOfDependent);
+  m_dy1.resize(m_numberOfDependent);
+}
+
+void StreamedOdeData::IndexChunks() {
+  const StreamedOdeDataHeader* header = (const StreamedOdeDataHeader*) m_mappedData;
+  if(memcmp(header->magic, STREAMED_ODE_DATA_MAGIC, sizeof(header->magic)) != 0 || header->version != STREAMED_ODE_DATA_VERSION) {
+    BACH_LOG_ERROR(L"StreamedOdeData::IndexChunks: %s is not a streamed ODE data file", WideStringFromUTF8(m_filePath).c_str());
+    throw std::exception();
+  }
+
+  m_numberOfDependent = header->numStates;
+  m_numberOfInternal = header->numInternal;
+
+  // Walk the chunk headers only, the values stay on disk until they are retrieved.
+  size_t offset = sizeof(StreamedOdeDataHeader);
+  while(offset+sizeof(StreamedOdeDataChunk) <= m_mappedLength) {
+    const StreamedOdeDataChunk* chunkHeader = (const StreamedOdeDataChunk*) (m_mappedData+offset);
+    size_t chunkLength = sizeof(StreamedOdeDataChunk)+sizeof(double)*(size_t) chunkHeader->numSamples*(1+chunkHeader->numColumns);
+    if(offset+chunkLength > m_mappedLength) {
+      // A solve that did not call Finish() can leave a partial chunk at the end.
+      BACH_LOG_WARNING(L"StreamedOdeData::IndexChunks: Ignoring a partial chunk at the end of %s", WideStringFromUTF8(m_filePath).c_str());
+      break;
+    }
+
+    if(chunkHeader->numSamples == 0) {
+      offset += chunkLength;
+      continue;
+    }
+
+    Chunk chunk;
+    chunk.numSamples = chunkHeader->numSamples;
+    chunk.x = (const double*) (m_mappedData+offset+sizeof(StreamedOdeDataChunk));
+    chunk.values = chunk.x+chunk.numSamples;
+
+    if(chunkHeader->kind == StreamedOdeDataChunk::StateChunk && chunkHeader->numColumns == 2*header->numStates) {
+      chunk.firstSample = m_numStateSamples;
+      m_numStateSamples += chunk.numSamples;
+      m_stateChunks.push_back(chunk);
+      m_stateChunkStarts.push_back(chunk.x[0]);
+    }
+    else if(chunkHeader->kind == StreamedOdeDataChunk::InternalChunk && chunkHeader->numColumns == header->numInternal) {
+      chunk.firstSample = m_numInternalSamples;
+      m_numInternalSamples += chunk.numSamples;
+      m_internalChunks.push_back(chunk);
+      m_internalChunkStarts.push_back(chunk.x[0]);
+    }
+    else {
+      BACH_LOG_ERROR(L"StreamedOdeData::IndexChunks: Unexpected chunk kind %u with %u columns", chunkHeader->kind, chunkHeader->numColumns);
+      throw std::exception();
+    }
+
+    offset += chunkLength;
+  }
+}
+
+int StreamedOdeData::FindIndex(const std::vector<Chunk>& chunks, const std::vector<double>& chunkStarts, double xTarget) const {
+  // The last chunk starting at or before xTarget, then the last sample in it at or before xTarget.
+  int chunkIndex = (int) (std::upper_bound(chunkStarts.begin(), chunkStarts.end(), xTarget)-chunkStarts.begin())-1;
+  chunkIndex = (chunkIndex > 0 ? chunkIndex : 0);
+
+  const Chunk& chunk = chunks[chunkIndex];
+  int sampleIndex = (int) (std::upper_bound(chunk.x, chunk.x+chunk.numSamples, xTarget)-chunk.x)-1;
+  sampleIndex = (sampleIndex > 0 ? sampleIndex : 0);
+
+  return chunk.firstSample+sampleIndex;
+}
+
+void StreamedOdeData::GetRecord(const std::vector<Chunk>& chunks, int numColumns, int index, double& x, const double*& record) const {
+  // The chunks are ordered by their first sample, so bisect for the one holding index.
+  int low = 0;
+  int high = (int) chunks.size()-1;
+  while(low < high) {
+    int mid = (low+high+1)/2;
+    if(chunks[mid].firstSample <= index) {
+      low = mid;
+    }
+    else {
+      high = mid-1;
+    }
+  }
+
+  const Chunk& chunk = chunks[low];
+  int sampleIndex = index-chunk.firstSample;
+  x = chunk.x[sampleIndex];
+  record = chunk.values+(size_t) sampleIndex*numColumns;
+}
+
+void StreamedOdeData::Retrieve(int index, double& x, Eigen::VectorXd& y, Eigen::VectorXd& dy) const {
+  if(index < 0 || index >= m_numStateSamples) {
+    BACH_LOG_ERROR(L"StreamedOdeData::Retrieve(i,d,v,v): Bounds error at %d [0 to %d]", index, m_numStateSamples-1);
+    throw std::exception();
+  }
+
+  const double* record;
+  GetRecord(m_stateChunks, 2*m_numberOfDependent, index, x, record);
+  y = Map<const VectorXd>(record, m_numberOfDependent);
+  dy = Map<const VectorXd>(record+m_numberOfDependent, m_numberOfDependent);
+}
+
+double StreamedOdeData::Retrieve(double xTarget, int yIndex) {
+  if(yIndex < 0 || yIndex >= m_numberOfDependent || m_numStateSamples < 2) {
+    BACH_LOG_ERROR(L"StreamedOdeData::Retrieve(d,i): State bounds error at %d [0 to %d] with %d samples", yIndex, m_numberOfDependent-1, m_numStateSamples);
+    throw std::exception();
+  }
+
+  int indexLow = FindIndex(m_stateChunks, m_stateChunkStarts, xTarget);
+  indexLow = InterpolationIndex::ChooseInterpolationIndex(m_numStateSamples, indexLow, 2);
+
+  double x0, x1;
+  const double* record0;
+  const double* record1;
+  GetRecord(m_stateChunks, 2*m_numberOfDependent, indexLow, x0, record0);
+  GetRecord(m_stateChunks, 2*m_numberOfDependent, indexLow+1, x1, record1);
+
+  return HermiteInterp::Interpolate(xTarget, x0, x1, record0[yIndex], record1[yIndex], record0[yIndex+m_numberOfDependent], record1[yIndex+m_numberOfDependent]);
+}
+
+void StreamedOdeData::Retrieve(double xTarget, Eigen::VectorXd& y) {
+  if(m_numberOfDependent != y.rows() || m_numStateSamples < 2) {
+    BACH_LOG_ERROR(L"StreamedOdeData::Retrieve(d,v): State bounds error (%d vs %d) with %d samples", (int) y.rows(), m_numberOfDependent, m_numStateSamples);
+    throw std::exception();
+  }
+
+  int indexLow = FindIndex(m_stateChunks, m_stateChunkStarts, xTarget);
+  indexLow = InterpolationIndex::ChooseInterpolationIndex(m_numStateSamples, indexLow, 2);
+
+  double x0, x1;
+  const double* record0;
+  const double* record1;
+  GetRecord(m_stateChunks, 2*m_numberOfDependent, indexLow, x0, record0);
+  GetRecord(m_stateChunks, 2*m_numberOfDependent, indexLow+1, x1, record1);
+
+  m_y0 = Map<const VectorXd>(record0, m_numberOfDependent);
+  m_y1 = Map<const VectorXd>(record1, m_numberOfDependent);
+  m_dy0 = Map<const VectorXd>(record0+m_numberOfDependent, m_numberOfDependent);
+  m_dy1 = Map<const VectorXd>(record1+m_numberOfDependent, m_numberOfDependent);
+
+  HermiteInterp::Interpolate(xTarget, x0, x1, m_y0, m_y1, m_dy0, m_dy1, y);
+}
+
+void StreamedOdeData::RetrieveInternal(double xTarget, Eigen::VectorXd& values) {
+  if(m_numberOfInternal != values.rows() || m_numInternalSamples < 2) {
+    BACH_LOG_ERROR(L"StreamedOdeData::RetrieveInternal: Bounds error (%d vs %d) with %d samples", (int) values.rows(), m_numberOfInternal, m_numInternalSamples);
+    throw std::exception();
+  }
+
+  int indexLow = FindIndex(m_internalChunks, m_internalChunkStarts, xTarget);
+  indexLow = InterpolationIndex::ChooseInterpolationIndex(m_numInternalSamples, indexLow, 2);
+
+  double x0, x1;
+  const double* record0;
+  const double* record1;
+  GetRecord(m_internalChunks, m_numberOfInternal, indexLow, x0, record0);
+  GetRecord(m_internalChunks, m_numberOfInternal, indexLow+1, x1, record1);
+
+  double fraction = (xTarget-x0)/(x1-x0);
+  values = (1.0-fraction)*Map<const VectorXd>(record0, m_numberOfInternal)+fraction*Map<const VectorXd>(record1, m_numberOfInternal);
+}
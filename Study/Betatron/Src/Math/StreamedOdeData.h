@@ -0,0 +1,83 @@
+/**********************************************************************
+
+File     : StreamedOdeData.h
+Project  : Bach Simulation
+Purpose  : Header file for reading the file written by StreamingOdeDataCollector.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The file is memory mapped rather than loaded, so only the pages
+           around the retrieved samples are read from disk.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_STREAMED_ODE_DATA_H__
+#define __BACH_STREAMED_ODE_DATA_H__
+
+#include "DependentData.h"
+#include <vector>
+
+namespace Bach {
+
+  //*******************
+  //* StreamedOdeData *
+  //*******************
+
+  class StreamedOdeData : public DependentData {
+  public:
+    static boost::shared_ptr<StreamedOdeData> CreateInstance(const std::string& filePath); // throws std::exception on error
+    virtual ~StreamedOdeData();
+
+    int GetNumberOfSamples() const         { return m_numStateSamples; }
+    int GetNumberOfInternalSamples() const { return m_numInternalSamples; }
+    int GetInternalLength() const          { return m_numberOfInternal; }
+
+    // The states and derivatives at a stored sample.
+    void Retrieve(int index, double& x, Eigen::VectorXd& y, Eigen::VectorXd& dy) const;
+
+    // Hermite interpolation of the states, as SampledDerivedData does.
+    double Retrieve(double xTarget, int yIndex);
+    void   Retrieve(double xTarget, Eigen::VectorXd& y);
+
+    // Linear interpolation of the internal values.
+    void RetrieveInternal(double xTarget, Eigen::VectorXd& values);
+
+  protected:
+    struct Chunk {
+      int firstSample;     // Index of the chunk's first sample within its kind.
+      int numSamples;
+      const double* x;
+      const double* values; // numSamples records of numColumns values.
+    };
+
+    StreamedOdeData();
+    void Open(const std::string& filePath);
+    void IndexChunks();
+
+    // Find the pair of samples that bracket xTarget, returned as the index of the lower one.
+    int FindIndex(const std::vector<Chunk>& chunks, const std::vector<double>& chunkStarts, double xTarget) const;
+    void GetRecord(const std::vector<Chunk>& chunks, int numColumns, int index, double& x, const double*& record) const;
+
+    std::string m_filePath;
+    int m_fileDescriptor;
+    const char* m_mappedData;
+    size_t m_mappedLength;
+
+    int m_numberOfInternal;
+    int m_numStateSamples;
+    int m_numInternalSamples;
+    std::vector<Chunk> m_stateChunks;
+    std::vector<Chunk> m_internalChunks;
+    std::vector<double> m_stateChunkStarts;    // The first x of each chunk, for the chunk search.
+    std::vector<double> m_internalChunkStarts;
+
+    Eigen::VectorXd m_y0;
+    Eigen::VectorXd m_y1;
+    Eigen::VectorXd m_dy0;
+    Eigen::VectorXd m_dy1;
+  };
+};
+
+#endif // __BACH_STREAMED_ODE_DATA_H__
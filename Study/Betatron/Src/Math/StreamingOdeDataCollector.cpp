@@ -0,0 +1,199 @@
+/**********************************************************************
+
+File     : StreamingOdeDataCollector.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the ODE data collector that streams to disk.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "StreamingOdeDataCollector.h"
+#include "OdeData.h"
+#include "SampledDerivedData.h"
+#include "SampledData.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+  //*****************************
+  //* StreamingOdeDataCollector *
+  //*****************************
+
+StreamingOdeDataCollector::StreamingOdeDataCollector(const std::string& filePath, int windowSize, int chunkSize) :
+  m_filePath(filePath),
+  m_file(NULL),
+  m_windowSize(windowSize),
+  m_chunkSize(chunkSize),
+  m_numStatesInChunk(0),
+  m_numStatesWritten(0),
+  m_numInternalsInChunk(0),
+  m_numInternalsWritten(0)
+{
+  if(m_windowSize < 2 || m_chunkSize < 1) {
+    BACH_LOG_ERROR(L"StreamingOdeDataCollector: Window size %d and chunk size %d must be at least 2 and 1", m_windowSize, m_chunkSize);
+    throw std::exception();
+  }
+}
+
+StreamingOdeDataCollector::~StreamingOdeDataCollector() {
+  if(m_file) {
+    try {
+      Finish();
+    }
+    catch(std::exception&) {
+      // Finish has already logged the failure.
+    }
+    CloseFile();
+  }
+}
+
+void StreamingOdeDataCollector::InitializeWithSizes(long numStates, long numInternal) {
+  m_stateData = shared_ptr<SampledDerivedData>(new SampledDerivedData((int) numStates, m_windowSize));
+  m_internalData = shared_ptr<SampledData>(new SampledData((int) numInternal, m_windowSize));
+  OpenFile((int) numStates, (int) numInternal);
+}
+
+void StreamingOdeDataCollector::StoreData(double x, const Eigen::VectorXd& y, const Eigen::VectorXd& dy, boost::shared_ptr<OdeData> odeData) {
+  if(!m_stateData || !m_internalData || !m_file) {
+    InitializeWithSizes(odeData->GetStateLength(), odeData->GetInternalLength());
+  }
+
+  OdeDataCollector::StoreData(x, y, dy, odeData);
+}
+
+void StreamingOdeDataCollector::Restart() {
+  OdeDataCollector::Restart();
+
+  if(m_stateData && m_internalData) {
+    CloseFile();
+    OpenFile(m_stateData->GetDependentLength(), m_internalData->GetDependentLength());
+  }
+}
+
+void StreamingOdeDataCollector::Finish() {
+  if(!m_file) {
+    return;
+  }
+
+  if(m_numStatesInChunk > 0) {
+    WriteChunk(StreamedOdeDataChunk::StateChunk, m_numStatesInChunk, m_stateX, m_stateValues);
+    m_numStatesInChunk = 0;
+  }
+  if(m_numInternalsInChunk > 0) {
+    WriteChunk(StreamedOdeDataChunk::InternalChunk, m_numInternalsInChunk, m_internalX, m_internalValues);
+    m_numInternalsInChunk = 0;
+  }
+  fflush(m_file);
+}
+
+void StreamingOdeDataCollector::StoreStates(double x, const Eigen::VectorXd& y, const Eigen::VectorXd& dy, boost::shared_ptr<OdeData> odeData) {
+  OdeDataCollector::StoreStates(x, y, dy, odeData);
+  if(GetStateStorageIsStopped()) {
+    return;
+  }
+
+  int n = (int) y.rows();
+  m_stateX(m_numStatesInChunk) = x;
+  m_stateValues.block(m_numStatesInChunk, 0, 1, n) = y.transpose();
+  m_stateValues.block(m_numStatesInChunk, n, 1, n) = dy.transpose();
+  m_numStatesInChunk++;
+
+  if(m_numStatesInChunk == m_chunkSize) {
+    WriteChunk(StreamedOdeDataChunk::StateChunk, m_numStatesInChunk, m_stateX, m_stateValues);
+    m_numStatesInChunk = 0;
+  }
+}
+
+void StreamingOdeDataCollector::StoreInternals(double x, boost::shared_ptr<OdeData> odeData) {
+  OdeDataCollector::StoreInternals(x, odeData);
+
+  if(GetInternalStorageIsStopped() || m_internalValues.cols() == 0) {
+    return;
+  }
+
+  m_internalX(m_numInternalsInChunk) = x;
+  m_internalValues.row(m_numInternalsInChunk) = odeData->GetInternalValueRef().transpose();
+  m_numInternalsInChunk++;
+
+  if(m_numInternalsInChunk == m_chunkSize) {
+    WriteChunk(StreamedOdeDataChunk::InternalChunk, m_numInternalsInChunk, m_internalX, m_internalValues);
+    m_numInternalsInChunk = 0;
+  }
+}
+
+void StreamingOdeDataCollector::HandleStateDataOverflow(double, boost::shared_ptr<OdeData>) {
+  // Everything in the window is already on its way to the file.
+  m_stateData->Reset();
+}
+
+void StreamingOdeDataCollector::HandlerInternalDataOverflow(double, boost::shared_ptr<OdeData>) {
+  m_internalData->Reset();
+}
+
+void StreamingOdeDataCollector::OpenFile(int numStates, int numInternal) {
+  if(m_file) {
+    return;
+  }
+
+  m_file = fopen(m_filePath.c_str(), "wb");
+  if(!m_file) {
+    BACH_LOG_ERROR(L"StreamingOdeDataCollector::OpenFile: Unable to open %s", WideStringFromUTF8(m_filePath).c_str());
+    throw std::exception();
+  }
+
+  StreamedOdeDataHeader header;
+  memcpy(header.magic, STREAMED_ODE_DATA_MAGIC, sizeof(header.magic));
+  header.version = STREAMED_ODE_DATA_VERSION;
+  header.numStates = numStates;
+  header.numInternal = numInternal;
+  header.reserved = 0;
+  if(fwrite(&header, sizeof(header), 1, m_file) != 1) {
+    BACH_LOG_ERROR(L"StreamingOdeDataCollector::OpenFile: Unable to write the header to %s", WideStringFromUTF8(m_filePath).c_str());
+    throw std::exception();
+  }
+
+  m_stateX.resize(m_chunkSize);
+  m_stateValues.resize(m_chunkSize, 2*numStates);
+  m_internalX.resize(m_chunkSize);
+  m_internalValues.resize(m_chunkSize, numInternal);
+  m_numStatesInChunk = 0;
+  m_numStatesWritten = 0;
+  m_numInternalsInChunk = 0;
+  m_numInternalsWritten = 0;
+}
+
+void StreamingOdeDataCollector::CloseFile() {
+  if(m_file) {
+    fclose(m_file);
+    m_file = NULL;
+  }
+}
+
+void StreamingOdeDataCollector::WriteChunk(uint32_t kind, int numSamples, const Eigen::VectorXd& x, const RecordMatrix& values) {
+  StreamedOdeDataChunk chunk;
+  chunk.kind = kind;
+  chunk.numSamples = numSamples;
+  chunk.numColumns = (uint32_t) values.cols();
+  chunk.reserved = 0;
+
+  // The rows are stored one after another so the first numSamples rows are contiguous.
+  size_t numValues = (size_t) numSamples*values.cols();
+  if(fwrite(&chunk, sizeof(chunk), 1, m_file) != 1 ||
+     fwrite(x.data(), sizeof(double), numSamples, m_file) != (size_t) numSamples ||
+     fwrite(values.data(), sizeof(double), numValues, m_file) != numValues) {
+    BACH_LOG_ERROR(L"StreamingOdeDataCollector::WriteChunk: Unable to write to %s", WideStringFromUTF8(m_filePath).c_str());
+    throw std::exception();
+  }
+
+  if(kind == StreamedOdeDataChunk::StateChunk) {
+    m_numStatesWritten += numSamples;
+  }
+  else {
+    m_numInternalsWritten += numSamples;
+  }
+}
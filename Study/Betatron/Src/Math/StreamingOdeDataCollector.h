@@ -0,0 +1,111 @@
+/**********************************************************************
+
+File     : StreamingOdeDataCollector.h
+Project  : Bach Simulation
+Purpose  : Header file for the ODE data collector that streams to disk.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Every accepted step is appended to a binary file as it is
+           stored, so a long solve only keeps a bounded window of samples
+           in memory. Use StreamedOdeData to read the file back.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_STREAMING_ODE_DATA_COLLECTOR_H__
+#define __BACH_STREAMING_ODE_DATA_COLLECTOR_H__
+
+#include "OdeDataCollector.h"
+#include <stdio.h>
+#include <stdint.h>
+
+namespace Bach {
+
+  // File layout, all values in native byte order:
+  //   StreamedOdeDataHeader
+  //   StreamedOdeDataChunk, x[numSamples], values[numSamples][numColumns]
+  //   StreamedOdeDataChunk, ...
+  // State chunks have 2*numStates columns (y then dy), internal chunks numInternal.
+  // Everything is a multiple of 8 bytes so a mapped file can be read as doubles.
+
+  struct StreamedOdeDataHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t numStates;
+    uint32_t numInternal;
+    uint32_t reserved;
+  };
+
+  struct StreamedOdeDataChunk {
+    enum Kind {
+      StateChunk = 1,
+      InternalChunk = 2
+    };
+
+    uint32_t kind;
+    uint32_t numSamples;
+    uint32_t numColumns;
+    uint32_t reserved;
+  };
+
+  const char STREAMED_ODE_DATA_MAGIC[8] = { 'B', 'A', 'C', 'H', 'O', 'D', 'E', '1' };
+  const uint32_t STREAMED_ODE_DATA_VERSION = 1;
+
+  //*****************************
+  //* StreamingOdeDataCollector *
+  //*****************************
+
+  class StreamingOdeDataCollector : public OdeDataCollector {
+  public:
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RecordMatrix;
+
+    StreamingOdeDataCollector(const std::string& filePath, int windowSize = 2000, int chunkSize = 4096);
+    virtual ~StreamingOdeDataCollector();
+
+    // The window holds windowSize samples in memory, the file is written chunkSize samples at a time.
+    void InitializeWithSizes(long numStates, long numInternal);
+    void StoreData(double time, const Eigen::VectorXd& states, const Eigen::VectorXd& derivs, boost::shared_ptr<OdeData> odeData);
+
+    // Write out the partially filled chunks. Call once the solve is complete.
+    void Finish();
+
+    // Truncate the file and empty the window.
+    void Restart();
+
+    const std::string& GetFilePath() const { return m_filePath; }
+    long GetNumberOfStatesWritten() const   { return m_numStatesWritten; }
+    long GetNumberOfInternalsWritten() const { return m_numInternalsWritten; }
+
+  protected:
+    virtual void StoreStates(double x, const Eigen::VectorXd& y, const Eigen::VectorXd& dy, boost::shared_ptr<OdeData> odeData);
+    virtual void StoreInternals(double x, boost::shared_ptr<OdeData> odeData);
+
+    // The window never grows, it starts over once full.
+    virtual void HandleStateDataOverflow(double, boost::shared_ptr<OdeData>);
+    virtual void HandlerInternalDataOverflow(double, boost::shared_ptr<OdeData>);
+
+    void OpenFile(int numStates, int numInternal);
+    void CloseFile();
+    void WriteChunk(uint32_t kind, int numSamples, const Eigen::VectorXd& x, const RecordMatrix& values);
+
+    std::string m_filePath;
+    FILE* m_file;
+    int m_windowSize;
+    int m_chunkSize;
+
+    // Chunks being filled, one row per sample so a row is written out as a record.
+    Eigen::VectorXd m_stateX;
+    RecordMatrix m_stateValues;
+    int m_numStatesInChunk;
+    long m_numStatesWritten;
+
+    Eigen::VectorXd m_internalX;
+    RecordMatrix m_internalValues;
+    int m_numInternalsInChunk;
+    long m_numInternalsWritten;
+  };
+};
+
+#endif // __BACH_STREAMING_ODE_DATA_COLLECTOR_H__
@@ -34,7 +34,7 @@ using namespace Eigen;
   //* TableSearch *
   //***************
 
-void TableSearch::Bisection(double xTarget,const Eigen::VectorXd& x) {
+void TableSearch::Bisection(double xTarget, const Eigen::Ref<const Eigen::VectorXd>& x) {
   while(m_indexHigh-m_indexLow != 1) {
     int indexMiddle = (m_indexHigh+m_indexLow) >> 1;
 
@@ -40,7 +40,11 @@ namespace Bach {
     TableSearch(int i = 0) : m_indexLow(i) {}
     virtual ~TableSearch() {}
 
-    virtual int Find(double x, const Eigen::VectorXd& y) = 0;
+    virtual int Find(double x, const Eigen::Ref<const Eigen::VectorXd>& y) = 0;
+
+    // Forget anything kept from earlier searches of the table, for when values that have
+    // already been searched are replaced rather than new ones added to the end.
+    virtual void TableChanged() {}
 
     int GetIndexLow() const { return m_indexLow; }
     void SetIndexLow(int i = 0) { m_indexLow = i; }
@@ -51,7 +55,7 @@ namespace Bach {
     bool m_ascending;
     int  m_size;
 
-    void Bisection(double x, const Eigen::VectorXd& y);
+    void Bisection(double x, const Eigen::Ref<const Eigen::VectorXd>& y);
   };
 };
 
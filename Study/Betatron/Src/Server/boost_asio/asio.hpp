@@ -0,0 +1,28 @@
+//
+// asio.hpp
+// ~~~~~~~~
+//
+// The server is written against standalone Asio. Where only Boost is
+// installed, the CMake build puts this directory on the include path so
+// that <asio.hpp> is Boost.Asio under the asio namespace.
+//
+
+#ifndef HTTP_BOOST_ASIO_HPP
+#define HTTP_BOOST_ASIO_HPP
+
+#include <system_error>
+#include <boost/asio.hpp>
+
+namespace asio {
+  using namespace boost::asio;
+  using boost::system::error_code;
+} // namespace asio
+
+// Standalone Asio's errors are std::error_codes, which the server compares
+// against asio::error values.
+namespace std {
+  template <>
+  struct is_error_code_enum<boost::asio::error::basic_errors> : true_type {};
+} // namespace std
+
+#endif // HTTP_BOOST_ASIO_HPP
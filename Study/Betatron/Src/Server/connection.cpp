@@ -9,6 +9,9 @@
 //
 
 #include "connection.hpp"
+#include <cctype>
+#include <cstdio>
+#include <string>
 #include <utility>
 #include <vector>
 #include "connection_manager.hpp"
@@ -17,77 +20,321 @@
 namespace http {
 namespace server {
 
-connection::connection(asio::ip::tcp::socket socket,
+namespace {
+
+const char crlf[] = { '\r', '\n' };
+const char last_chunk[] = { '0', '\r', '\n', '\r', '\n' };
+
+std::string to_lower(const std::string& s)
+{
+  std::string lower(s);
+  for (std::size_t i = 0; i < lower.size(); ++i)
+    lower[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(lower[i])));
+  return lower;
+}
+
+bool iequals(const std::string& a, const std::string& b)
+{
+  return a.size() == b.size() && to_lower(a) == to_lower(b);
+}
+
+} // namespace
+
+connection::connection(asio::io_service& io_service,
+    asio::ip::tcp::socket socket,
     connection_manager& manager, request_handler& handler)
-  : socket_(std::move(socket)),
+  : io_service_(io_service),
+    strand_(io_service),
+    socket_(std::move(socket)),
     connection_manager_(manager),
-    request_handler_(handler)
+    request_handler_(handler),
+    buffer_begin_(0),
+    buffer_end_(0),
+    keep_alive_(false),
+    streaming_(false),
+    chunked_encoding_(false),
+    headers_sent_(false),
+    writing_(false),
+    reply_complete_(false),
+    busy_(false),
+    last_activity_(0)
 {
+  touch();
 }
 
 void connection::start()
 {
+  // A reply is written in one go, so there is nothing for Nagle's algorithm to
+  // coalesce. Left on, it holds back a reply on a kept alive connection until
+  // the client's delayed acknowledgement of the previous one.
+  asio::error_code ignored_ec;
+  socket_.set_option(asio::ip::tcp::no_delay(true), ignored_ec);
+
   do_read();
 }
 
 void connection::stop()
 {
-  socket_.close();
+  // Closed on the strand so that it cannot race a handler on another thread.
+  auto self(shared_from_this());
+  strand_.dispatch([this, self]()
+      {
+        socket_.close();
+      });
+}
+
+bool connection::is_idle_since(std::chrono::steady_clock::time_point cutoff) const
+{
+  return !busy_ && last_activity_ < cutoff.time_since_epoch().count();
 }
 
 void connection::do_read()
 {
   auto self(shared_from_this());
-  socket_.async_read_some(asio::buffer(buffer_),
+  socket_.async_read_some(asio::buffer(buffer_), strand_.wrap(
       [this, self](std::error_code ec, std::size_t bytes_transferred)
       {
         if (!ec)
         {
-          request_parser::result_type result;
-          std::tie(result, std::ignore) = request_parser_.parse(
-              request_, buffer_.data(), buffer_.data() + bytes_transferred);
-
-          if (result == request_parser::good)
-          {
-            request_handler_.handle_request(request_, reply_);
-            do_write();
-          }
-          else if (result == request_parser::bad)
-          {
-            reply_ = reply::stock_reply(reply::bad_request);
-            do_write();
-          }
-          else
-          {
-            do_read();
-          }
+          touch();
+          buffer_begin_ = 0;
+          buffer_end_ = bytes_transferred;
+          handle_input();
         }
         else if (ec != asio::error::operation_aborted)
         {
           connection_manager_.stop(shared_from_this());
         }
-      });
+      }));
+}
+
+void connection::handle_input()
+{
+  request_parser::result_type result;
+  char* consumed;
+  std::tie(result, consumed) = request_parser_.parse(request_,
+      buffer_.data() + buffer_begin_, buffer_.data() + buffer_end_);
+  buffer_begin_ = consumed - buffer_.data();
+
+  if (result == request_parser::good)
+  {
+    keep_alive_ = wants_keep_alive(request_);
+    chunked_encoding_ = (request_.http_version_major > 1 ||
+        (request_.http_version_major == 1 && request_.http_version_minor >= 1));
+    busy_ = true;
+
+    // A simulation runs on the compute executor and its reply is written
+    // back on the strand, chunk by chunk as it is serialized or whole when
+    // it finishes. The work object keeps io_service::run() from returning
+    // in the meantime.
+    auto self(shared_from_this());
+    asio::io_service::work work(io_service_);
+    request_handler_.async_handle_request(request_, reply_,
+        strand_.wrap([this, self](const Bach::OutputBufferPtr& chunk)
+        {
+          queue_chunk(chunk);
+        }),
+        strand_.wrap([this, self, work](bool complete)
+        {
+          finish_reply(complete);
+        }));
+  }
+  else if (result == request_parser::bad)
+  {
+    // The rest of the input can not be framed, so the connection ends here.
+    keep_alive_ = false;
+    busy_ = true;
+    reply_ = reply::stock_reply(reply::bad_request);
+    do_write();
+  }
+  else
+  {
+    do_read();
+  }
 }
 
 void connection::do_write()
 {
+  add_connection_header();
+
   auto self(shared_from_this());
-  asio::async_write(socket_, reply_.to_buffers(),
+  asio::async_write(socket_, reply_.to_buffers(), strand_.wrap(
       [this, self](std::error_code ec, std::size_t)
       {
-        if (!ec)
+        handle_reply_written(ec);
+      }));
+}
+
+void connection::queue_chunk(const Bach::OutputBufferPtr& chunk)
+{
+  streaming_ = true;
+  pending_chunks_.push_back(chunk);
+  if (!writing_)
+    do_write_chunks();
+}
+
+void connection::finish_reply(bool complete)
+{
+  if (!streaming_)
+  {
+    do_write();
+  }
+  else if (!complete)
+  {
+    // The client can only tell that the content is cut short if the
+    // connection closes before the last chunk.
+    connection_manager_.stop(shared_from_this());
+  }
+  else
+  {
+    reply_complete_ = true;
+    if (!writing_)
+      do_write_chunks();
+  }
+}
+
+void connection::do_write_chunks()
+{
+  std::vector<asio::const_buffer> buffers;
+  if (!headers_sent_)
+  {
+    if (chunked_encoding_)
+    {
+      header encoding_header;
+      encoding_header.name = "Transfer-Encoding";
+      encoding_header.value = "chunked";
+      reply_.headers.push_back(encoding_header);
+    }
+    else
+    {
+      // An HTTP/1.0 client reads content without a length until the
+      // connection closes.
+      keep_alive_ = false;
+    }
+    add_connection_header();
+    buffers = reply_.to_buffers();
+    headers_sent_ = true;
+  }
+
+  // Everything queued while the last write was in progress goes in one write.
+  writing_chunks_.swap(pending_chunks_);
+  chunk_sizes_.resize(writing_chunks_.size());
+  for (std::size_t i = 0; i < writing_chunks_.size(); ++i)
+  {
+    const Bach::OutputBuffer& chunk = *writing_chunks_[i];
+    if (chunked_encoding_)
+    {
+      char size_line[24];
+      int length = std::snprintf(size_line, sizeof(size_line), "%zx\r\n",
+          chunk.GetSize());
+      chunk_sizes_[i].assign(size_line, length);
+      buffers.push_back(asio::buffer(chunk_sizes_[i]));
+    }
+    buffers.push_back(asio::buffer(chunk.GetData(), chunk.GetSize()));
+    if (chunked_encoding_)
+      buffers.push_back(asio::buffer(crlf));
+  }
+
+  bool last = reply_complete_;
+  if (last && chunked_encoding_)
+    buffers.push_back(asio::buffer(last_chunk));
+
+  if (buffers.empty())
+  {
+    handle_reply_written(std::error_code());
+    return;
+  }
+
+  writing_ = true;
+  auto self(shared_from_this());
+  asio::async_write(socket_, buffers, strand_.wrap(
+      [this, self, last](std::error_code ec, std::size_t)
+      {
+        writing_ = false;
+        writing_chunks_.clear();
+
+        if (ec || last)
         {
-          // Initiate graceful connection closure.
-          asio::error_code ignored_ec;
-          socket_.shutdown(asio::ip::tcp::socket::shutdown_both,
-            ignored_ec);
+          handle_reply_written(ec);
         }
-
-        if (ec != asio::error::operation_aborted)
+        else
         {
-          connection_manager_.stop(shared_from_this());
+          touch();
+          if (!pending_chunks_.empty() || reply_complete_)
+            do_write_chunks();
         }
-      });
+      }));
+}
+
+void connection::add_connection_header()
+{
+  header connection_header;
+  connection_header.name = "Connection";
+  connection_header.value = (keep_alive_ ? "keep-alive" : "close");
+  reply_.headers.push_back(connection_header);
+}
+
+void connection::handle_reply_written(std::error_code ec)
+{
+  if (!ec && keep_alive_)
+  {
+    // Answer any pipelined request already buffered before reading.
+    touch();
+    reset_for_next_request();
+    busy_ = false;
+    handle_input();
+    return;
+  }
+
+  if (!ec)
+  {
+    // Initiate graceful connection closure.
+    asio::error_code ignored_ec;
+    socket_.shutdown(asio::ip::tcp::socket::shutdown_both,
+      ignored_ec);
+  }
+
+  if (ec != asio::error::operation_aborted)
+  {
+    connection_manager_.stop(shared_from_this());
+  }
+}
+
+void connection::reset_for_next_request()
+{
+  request_ = request();
+  request_parser_.reset();
+  reply_ = reply();
+  streaming_ = false;
+  headers_sent_ = false;
+  reply_complete_ = false;
+  pending_chunks_.clear();
+}
+
+void connection::touch()
+{
+  last_activity_ = std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+bool connection::wants_keep_alive(const request& req)
+{
+  // HTTP/1.1 connections persist unless the client says otherwise, older
+  // ones only when the client asks.
+  bool keep_alive = (req.http_version_major > 1 ||
+      (req.http_version_major == 1 && req.http_version_minor >= 1));
+
+  for (std::size_t i = 0; i < req.headers.size(); ++i)
+  {
+    if (!iequals(req.headers[i].name, "Connection"))
+      continue;
+
+    std::string value = to_lower(req.headers[i].value);
+    if (value.find("close") != std::string::npos)
+      keep_alive = false;
+    else if (value.find("keep-alive") != std::string::npos)
+      keep_alive = true;
+  }
+  return keep_alive;
 }
 
 } // namespace server
@@ -12,8 +12,14 @@
 #define HTTP_CONNECTION_HPP
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <memory>
+#include <string>
+#include <vector>
 #include <asio.hpp>
+#include "OutputBufferPool.h"
 #include "reply.hpp"
 #include "request.hpp"
 #include "request_handler.hpp"
@@ -32,8 +38,10 @@ public:
   connection(const connection&) = delete;
   connection& operator=(const connection&) = delete;
 
-  /// Construct a connection with the given socket.
-  explicit connection(asio::ip::tcp::socket socket,
+  /// Construct a connection with the given socket, running its handlers on
+  /// the given io_service.
+  explicit connection(asio::io_service& io_service,
+      asio::ip::tcp::socket socket,
       connection_manager& manager, request_handler& handler);
 
   /// Start the first asynchronous operation for the connection.
@@ -42,13 +50,57 @@ public:
   /// Stop all asynchronous operations associated with the connection.
   void stop();
 
+  /// True if the connection is waiting for a request and nothing has been
+  /// read or written since cutoff. Called from the connection manager's
+  /// idle reaper on any thread.
+  bool is_idle_since(std::chrono::steady_clock::time_point cutoff) const;
+
 private:
   /// Perform an asynchronous read operation.
   void do_read();
 
+  /// Parse the buffered input that has not been consumed yet, reading more
+  /// when it does not hold a complete request.
+  void handle_input();
+
   /// Perform an asynchronous write operation.
   void do_write();
 
+  /// Queue a chunk of a streamed reply and write it unless a write is
+  /// already in progress.
+  void queue_chunk(const Bach::OutputBufferPtr& chunk);
+
+  /// Called when the request handler has finished the reply. A reply that
+  /// was not streamed is written whole.
+  void finish_reply(bool complete);
+
+  /// Write the headers of a streamed reply if not sent yet, the queued
+  /// chunks, and the last chunk once the reply is complete. HTTP/1.1 clients
+  /// get chunked transfer encoding; older ones read until the socket closes.
+  void do_write_chunks();
+
+  /// Add the Connection header for keep_alive_ to the reply.
+  void add_connection_header();
+
+  /// Read the next request or close the connection once a reply has gone.
+  void handle_reply_written(std::error_code ec);
+
+  /// Clear the request, parser and reply for the next request on the socket.
+  void reset_for_next_request();
+
+  /// Record that data was just read or written.
+  void touch();
+
+  /// Whether the client asked for the connection to stay open after the reply.
+  static bool wants_keep_alive(const request& req);
+
+  /// The io_service that runs the connection's handlers.
+  asio::io_service& io_service_;
+
+  /// Strand to ensure the connection's handlers are not called concurrently
+  /// when the io_service is run from several threads.
+  asio::io_service::strand strand_;
+
   /// Socket for the connection.
   asio::ip::tcp::socket socket_;
 
@@ -61,6 +113,43 @@ private:
   /// Buffer for incoming data.
   std::array<char, 8192> buffer_;
 
+  /// The part of buffer_ that has been read but not yet parsed. Pipelined
+  /// requests that arrive in one read wait here for the previous reply.
+  std::size_t buffer_begin_;
+  std::size_t buffer_end_;
+
+  /// Whether the connection stays open after the current reply.
+  bool keep_alive_;
+
+  /// True once the current reply's first chunk has arrived.
+  bool streaming_;
+
+  /// Whether a streamed reply is sent with chunked transfer encoding.
+  bool chunked_encoding_;
+
+  /// Whether the streamed reply's status line and headers have been written.
+  bool headers_sent_;
+
+  /// Whether a write of chunks is in progress.
+  bool writing_;
+
+  /// Set once the request handler has passed on the last chunk.
+  bool reply_complete_;
+
+  /// Chunks waiting for the write in progress to finish.
+  std::vector<Bach::OutputBufferPtr> pending_chunks_;
+
+  /// The chunks being written, and their size lines, kept until the write
+  /// completes.
+  std::vector<Bach::OutputBufferPtr> writing_chunks_;
+  std::vector<std::string> chunk_sizes_;
+
+  /// True from a complete request until its reply has been written.
+  std::atomic<bool> busy_;
+
+  /// Time of the last read or write, as steady_clock ticks.
+  std::atomic<std::chrono::steady_clock::rep> last_activity_;
+
   /// The incoming request.
   request request_;
 
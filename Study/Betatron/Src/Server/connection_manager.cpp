@@ -9,31 +9,102 @@
 //
 
 #include "connection_manager.hpp"
+#include <algorithm>
+#include <vector>
 
 namespace http {
 namespace server {
 
-connection_manager::connection_manager()
+namespace {
+
+/// The shortest time between reaps, so a tiny timeout can't spin the strand.
+const std::chrono::steady_clock::duration min_reap_period =
+    std::chrono::milliseconds(100);
+
+} // namespace
+
+connection_manager::connection_manager(asio::io_service& io_service,
+    std::chrono::steady_clock::duration idle_timeout)
+  : idle_timeout_(idle_timeout),
+    strand_(io_service),
+    reap_timer_(io_service),
+    stopped_(false)
 {
+  do_reap();
 }
 
 void connection_manager::start(connection_ptr c)
 {
-  connections_.insert(c);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_.insert(c);
+  }
   c->start();
 }
 
 void connection_manager::stop(connection_ptr c)
 {
-  connections_.erase(c);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_.erase(c);
+  }
   c->stop();
 }
 
 void connection_manager::stop_all()
 {
-  for (auto c: connections_)
+  std::set<connection_ptr> connections;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections.swap(connections_);
+  }
+  for (auto c: connections)
     c->stop();
-  connections_.clear();
+
+  strand_.dispatch([this]()
+      {
+        stopped_ = true;
+        reap_timer_.cancel();
+      });
+}
+
+void connection_manager::do_reap()
+{
+  // Checking twice per timeout closes an idle connection between one and one
+  // and a half timeouts after its last activity.
+  reap_timer_.expires_from_now(
+      std::max<std::chrono::steady_clock::duration>(idle_timeout_ / 2,
+          min_reap_period));
+  reap_timer_.async_wait(strand_.wrap(
+      [this](std::error_code ec)
+      {
+        if (stopped_ || ec == asio::error::operation_aborted)
+        {
+          return;
+        }
+
+        reap_idle();
+        do_reap();
+      }));
+}
+
+void connection_manager::reap_idle()
+{
+  std::chrono::steady_clock::time_point cutoff =
+      std::chrono::steady_clock::now() - idle_timeout_;
+
+  std::vector<connection_ptr> idle;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto c: connections_)
+    {
+      if (c->is_idle_since(cutoff))
+        idle.push_back(c);
+    }
+  }
+
+  for (auto c: idle)
+    stop(c);
 }
 
 } // namespace server
@@ -11,22 +11,27 @@
 #ifndef HTTP_CONNECTION_MANAGER_HPP
 #define HTTP_CONNECTION_MANAGER_HPP
 
+#include <chrono>
+#include <mutex>
 #include <set>
+#include <asio.hpp>
 #include "connection.hpp"
 
 namespace http {
 namespace server {
 
 /// Manages open connections so that they may be cleanly stopped when the server
-/// needs to shut down.
+/// needs to shut down, and closes kept alive connections that have gone idle.
 class connection_manager
 {
 public:
   connection_manager(const connection_manager&) = delete;
   connection_manager& operator=(const connection_manager&) = delete;
 
-  /// Construct a connection manager.
-  connection_manager();
+  /// Construct a connection manager that closes connections which have been
+  /// waiting for a request for longer than idle_timeout.
+  explicit connection_manager(asio::io_service& io_service,
+      std::chrono::steady_clock::duration idle_timeout);
 
   /// Add the specified connection to the manager and start it.
   void start(connection_ptr c);
@@ -34,12 +39,33 @@ public:
   /// Stop the specified connection.
   void stop(connection_ptr c);
 
-  /// Stop all connections.
+  /// Stop all connections and the idle reaper.
   void stop_all();
 
 private:
+  /// Wait for the next idle check.
+  void do_reap();
+
+  /// Stop the connections that have been idle for longer than the timeout.
+  void reap_idle();
+
   /// The managed connections.
   std::set<connection_ptr> connections_;
+
+  /// Guards connections_, which is changed from every I/O thread.
+  std::mutex mutex_;
+
+  /// How long a connection may wait for its next request.
+  std::chrono::steady_clock::duration idle_timeout_;
+
+  /// Serializes the reaper timer's handlers with stop_all.
+  asio::io_service::strand strand_;
+
+  /// Timer for the periodic idle check.
+  asio::steady_timer reap_timer_;
+
+  /// Set by stop_all so that the reaper does not start another wait.
+  bool stopped_;
 };
 
 } // namespace server
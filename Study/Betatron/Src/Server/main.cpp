@@ -8,6 +8,7 @@
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 //
 
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <asio.hpp>
@@ -18,18 +19,30 @@ int main(int argc, char* argv[])
   try
   {
     // Check command line arguments.
-    if (argc != 4)
+    if (argc < 4 || argc > 7)
     {
-      std::cerr << "Usage: http_server <address> <port> <doc_root>\n";
+      std::cerr << "Usage: http_server <address> <port> <doc_root> [<io_threads> [<compute_threads> [<idle_seconds>]]]\n";
       std::cerr << "  For IPv4, try:\n";
       std::cerr << "    receiver 0.0.0.0 80 .\n";
       std::cerr << "  For IPv6, try:\n";
       std::cerr << "    receiver 0::0 80 .\n";
+      std::cerr << "  io_threads defaults to 1, compute_threads to one per core and\n";
+      std::cerr << "  idle_seconds, how long a kept alive connection may wait, to 30.\n";
+      return 1;
+    }
+
+    std::size_t io_threads = (argc > 4 ? std::stoul(argv[4]) : 1);
+    std::size_t compute_threads = (argc > 5 ? std::stoul(argv[5]) : 0);
+    std::chrono::seconds idle_timeout(argc > 6 ? std::stol(argv[6]) : 30);
+    if (idle_timeout < std::chrono::seconds(1))
+    {
+      std::cerr << "idle_seconds must be at least 1\n";
       return 1;
     }
 
     // Initialise the server.
-    http::server::server s(argv[1], argv[2], argv[3]);
+    http::server::server s(argv[1], argv[2], argv[3], io_threads,
+        compute_threads, idle_timeout);
 
     // Run the server until stopped.
     s.run();
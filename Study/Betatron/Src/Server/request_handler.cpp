@@ -20,6 +20,10 @@
 #include "BetatronHandler.h"
 #include "TwoElectronRelativityHandler.h"
 #include "FieldFlowHandler.h"
+#include "WorkStealingPool.h"
+#include "JsonStreamWriter.h"
+#include "BinaryColumnWriter.h"
+#include "OdeSolverMetrics.h"
 
 using namespace Bach;
 using namespace Eigen;
@@ -27,8 +31,37 @@ using namespace Eigen;
 namespace http {
 namespace server {
 
-request_handler::request_handler(const std::string& doc_root)
-  : doc_root_(doc_root)
+namespace {
+  const char json_content_type[] = "application/json; charset=utf-8";
+
+  // Text answers are JSON unless run_request chose another type.
+  const std::string& text_content_type(const std::string& content_type)
+  {
+    static const std::string json(json_content_type);
+    return content_type.empty() ? json : content_type;
+  }
+
+  // Whether the one input, or any input of a sweep, asks for its telemetry.
+  bool asks_for_telemetry(const Json::Value& root)
+  {
+    const Json::Value& inputs = root["inputs"];
+    if (!inputs.isArray())
+      return inputs.get("telemetry", false).asBool();
+    for (Json::ArrayIndex i = 0; i < inputs.size(); ++i)
+    {
+      if (inputs[i].get("telemetry", false).asBool())
+        return true;
+    }
+    return false;
+  }
+}
+
+request_handler::request_handler(const std::string& doc_root,
+    std::size_t compute_thread_pool_size, std::size_t cache_budget_bytes)
+  : doc_root_(doc_root),
+    result_cache_(cache_budget_bytes),
+    output_buffer_pool_(OutputBufferPool::CreateInstance()),
+    compute_executor_(WorkStealingPool::CreateInstance((int) compute_thread_pool_size))
 {
 }
 
@@ -42,18 +75,99 @@ void request_handler::handle_request(const request& req, reply& rep)
     return;
   }
 
-  std::string origin = "";
-  for(long i=0; i<req.headers.size(); i++) {
-    std::string header = req.headers[i].name;
-    if(header == "Origin") {
-      origin = req.headers[i].value;
-    }
+  std::string output;
+  std::string streamed;
+  std::string content_type;
+  output_kind kind = run_request(request_path, get_header(req, "Accept"),
+      false, output, content_type,
+      [&streamed](const OutputBufferPtr& buffer)
+      {
+        streamed.append(buffer->GetData(), buffer->GetSize());
+      });
+  if (kind == streamed_output)
+    fill_reply(streamed, content_type, get_header(req, "Origin"), rep);
+  else
+    fill_reply(output, text_content_type(content_type), get_header(req, "Origin"), rep);
+}
+
+void request_handler::async_handle_request(const request& req, reply& rep,
+    const chunk_handler& chunk, const completion_handler& done)
+{
+  // Decode url to path.
+  std::string request_path;
+  if (!url_decode(req.uri, request_path))
+  {
+    rep = reply::stock_reply(reply::bad_request);
+    done(true);
+    return;
   }
 
-  std::string output = "{}";
+  // The headers go into rep just before the first chunk is passed on, by
+  // which time run_request has chosen the content type.
+  std::string origin = get_header(req, "Origin");
+  std::string accept = get_header(req, "Accept");
+  std::shared_ptr<bool> streaming = std::make_shared<bool>(false);
+  std::shared_ptr<std::string> content_type = std::make_shared<std::string>();
+  chunk_handler stream = [&rep, origin, chunk, streaming, content_type](const OutputBufferPtr& buffer)
+      {
+        if (!*streaming)
+        {
+          fill_streamed_reply(*content_type, origin, rep);
+          *streaming = true;
+        }
+        chunk(buffer);
+      };
+
+  // Errors, statistics and cached results are answered on the I/O thread.
+  std::string output;
+  output_kind kind = run_request(request_path, accept, true, output,
+      *content_type, stream);
+  if (kind != needs_compute)
+  {
+    if (!*streaming)
+      fill_reply(output, text_content_type(*content_type), origin, rep);
+    done(true);
+    return;
+  }
+
+  compute_executor_->Submit([this, request_path, accept, origin, &rep, stream, streaming, content_type, done]()
+      {
+        bool complete = true;
+        try
+        {
+          std::string output;
+          run_request(request_path, accept, false, output, *content_type, stream);
+          if (!*streaming)
+            fill_reply(output, text_content_type(*content_type), origin, rep);
+        }
+        catch (...)
+        {
+          // Once chunks have gone out the status can no longer be changed.
+          if (*streaming)
+            complete = false;
+          else
+            rep = reply::stock_reply(reply::internal_server_error);
+        }
+        done(complete);
+      });
+}
+
+request_handler::output_kind request_handler::run_request(
+    const std::string& request_path, const std::string& accept,
+    bool quick_only, std::string& output, std::string& content_type,
+    const chunk_handler& chunk)
+{
+  output = "{}";
 
   size_t doPos = request_path.find("do=");
-  if(doPos == std::string::npos) {
+  if(request_path == "/stats" || request_path.compare(0, 7, "/stats?") == 0) {
+    output = result_cache_.stats_as_json();
+  }
+  else if(request_path == "/metrics" || request_path.compare(0, 9, "/metrics?") == 0) {
+    output = OdeSolverMetrics::GetSharedInstance()->GetPrometheusText();
+    content_type = OdeSolverMetrics::MEDIA_TYPE;
+  }
+  else if(doPos == std::string::npos) {
     output = "{ \"error\": \"Request error\", \"errorMessage\": \"The 'do' parameter was not found in the URL.\" }";
   }
   else {
@@ -69,16 +183,75 @@ void request_handler::handle_request(const request& req, reply& rep)
       std::string system = root.get("system", "betatron").asString();
 
       if(system == "betatron") {
-        boost::shared_ptr<BetatronHandler> handler = BetatronHandler::CreateInstance();
-        output = handler->HandleRequest(root);
-        
+        // Binary columns if the request asks for them, either with a format
+        // member or through the Accept header.
+        std::string format = root.get("format", format_from_accept(accept)).asString();
+        if(format != "json" && format != "binary" && format != "binary32") {
+          output = "{ \"error\": \"Request format error\", \"errorMessage\": \"The format '"+format+"' is not json, binary or binary32.\" }";
+          return text_output;
+        }
+        content_type = (format == "json" ? json_content_type : BinaryColumnWriter::MEDIA_TYPE);
+
+        // Serialized straight into pooled buffers, each sent as soon as it fills. A sweep is
+        // solved on the compute executor too, rather than on a pool of its own.
+        root["system"] = system;
+        root["format"] = format;
+        boost::shared_ptr<OutputBufferPool> pool = output_buffer_pool_;
+        boost::shared_ptr<WorkStealingPool> executor = compute_executor_;
+        result_cache::producer produce = [&root, &format, pool, executor](const result_cache::chunk_handler& emit) {
+          boost::shared_ptr<BetatronHandler> handler = BetatronHandler::CreateInstance();
+          handler->SetPool(executor);
+          if(format == "json") {
+            boost::shared_ptr<JsonStreamWriter> writer = JsonStreamWriter::CreateInstance(pool, emit);
+            handler->HandleRequest(root, *writer);
+            writer->Flush();
+          }
+          else {
+            BinaryColumnWriter::Precision precision = (format == "binary32" ? BinaryColumnWriter::FLOAT32 : BinaryColumnWriter::FLOAT64);
+            boost::shared_ptr<BinaryColumnWriter> writer = BinaryColumnWriter::CreateInstance(pool, emit, precision);
+            handler->HandleRequest(root, *writer);
+            writer->Flush();
+          }
+        };
+
+        // Telemetry differs from run to run, and each solve adds its counts to /metrics, so
+        // those requests are always solved afresh.
+        if(asks_for_telemetry(root)) {
+          if(quick_only) {
+            return needs_compute;
+          }
+          produce(chunk);
+          return streamed_output;
+        }
+
+        // The simulation is otherwise deterministic, so identical requests share one result.
+        std::string key = result_cache::canonical_key(root);
+        if(quick_only) {
+          result_cache::result_ptr result = result_cache_.find(key);
+          if(!result) {
+            return needs_compute;
+          }
+          for(std::size_t i=0; i<result->size(); i++) {
+            chunk((*result)[i]);
+          }
+        }
+        else {
+          result_cache_.get_or_compute(key, produce, chunk);
+        }
+        return streamed_output;
       }
       else if(system == "twoElectronRelativity") {
+        if(quick_only) {
+          return needs_compute;
+        }
         boost::shared_ptr<TwoElectronRelativityHandler> handler = TwoElectronRelativityHandler::CreateInstance();
         output = handler->HandleRequest(root);
         
       }
       else if(system == "fieldFlow") {
+        if(quick_only) {
+          return needs_compute;
+        }
         boost::shared_ptr<FieldFlowHandler> handler = FieldFlowHandler::CreateInstance();
         output = handler->HandleRequest(root);
       }
@@ -87,13 +260,51 @@ void request_handler::handle_request(const request& req, reply& rep)
       }
     }
   }
+  return text_output;
+}
 
-  // Fill out the reply to be sent to the client.
+void request_handler::fill_streamed_reply(const std::string& content_type,
+    const std::string& origin, reply& rep)
+{
+  rep.status = reply::ok;
+  rep.content.clear();
+  rep.headers.resize(3);
+  rep.headers[0].name = "Content-Type";
+  rep.headers[0].value = content_type;
+  rep.headers[1].name = "Access-Control-Allow-Origin";
+  rep.headers[1].value = origin;
+  rep.headers[2].name = "Access-Control-Allow-Credentials";
+  rep.headers[2].value = "true";
+}
+
+std::string request_handler::get_header(const request& req, const std::string& name)
+{
+  std::string value = "";
+  for(long i=0; i<req.headers.size(); i++) {
+    std::string header = req.headers[i].name;
+    if(header == name) {
+      value = req.headers[i].value;
+    }
+  }
+  return value;
+}
+
+std::string request_handler::format_from_accept(const std::string& accept)
+{
+  if(accept.find(BinaryColumnWriter::MEDIA_TYPE) == std::string::npos) {
+    return "json";
+  }
+  return (accept.find("precision=32") != std::string::npos ? "binary32" : "binary");
+}
+
+void request_handler::fill_reply(const std::string& output,
+    const std::string& content_type, const std::string& origin, reply& rep)
+{
   rep.status = reply::ok;
   rep.content = output;
   rep.headers.resize(4);
   rep.headers[0].name = "Content-Type";
-  rep.headers[0].value = "application/json; charset=utf-8";
+  rep.headers[0].value = content_type;
   rep.headers[1].name = "Content-Length";
   rep.headers[1].value = boost::lexical_cast<std::string>(rep.content.size());
   rep.headers[2].name = "Access-Control-Allow-Origin";
@@ -11,7 +11,15 @@
 #ifndef HTTP_REQUEST_HANDLER_HPP
 #define HTTP_REQUEST_HANDLER_HPP
 
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <boost/shared_ptr.hpp>
+#include "result_cache.hpp"
+
+namespace Bach {
+  class WorkStealingPool;
+}
 
 namespace http {
 namespace server {
@@ -26,16 +34,81 @@ public:
   request_handler(const request_handler&) = delete;
   request_handler& operator=(const request_handler&) = delete;
 
-  /// Construct with a directory containing files to be served.
-  explicit request_handler(const std::string& doc_root);
+  /// Memory budget of the result cache unless the constructor is given one.
+  static const std::size_t default_cache_budget_bytes = 256 * 1024 * 1024;
+
+  /// Receives the content of a streamed reply a buffer at a time.
+  typedef result_cache::chunk_handler chunk_handler;
+
+  /// Called once the reply has been filled in or its last chunk handed over.
+  /// complete is false if a streamed reply failed part way through, in which
+  /// case the connection has to be closed to tell the client.
+  typedef std::function<void(bool complete)> completion_handler;
+
+  /// Construct with a directory containing files to be served. Simulations
+  /// run on compute_thread_pool_size threads, zero meaning one per core.
+  explicit request_handler(const std::string& doc_root,
+      std::size_t compute_thread_pool_size = 0,
+      std::size_t cache_budget_bytes = default_cache_budget_bytes);
 
   /// Handle a request and produce a reply.
   void handle_request(const request& req, reply& rep);
 
+  /// Handle a request without blocking the calling I/O thread on a
+  /// simulation. Requests that need one are run on the compute executor and
+  /// done is called from there; anything else is answered before returning.
+  /// Large results are streamed: the status and headers of rep are set
+  /// before the first call of chunk and the content is passed to chunk as it
+  /// is serialized. If chunk is never called, rep holds the whole reply.
+  void async_handle_request(const request& req, reply& rep,
+      const chunk_handler& chunk, const completion_handler& done);
+
 private:
   /// The directory containing the files to be served.
   std::string doc_root_;
 
+  /// Betatron results by canonical request, so repeated requests skip the simulation.
+  result_cache result_cache_;
+
+  /// Buffers that results are serialized into.
+  boost::shared_ptr<Bach::OutputBufferPool> output_buffer_pool_;
+
+  /// Threads for the simulations. Declared last so that it is destroyed, and
+  /// its threads joined, before anything its tasks use.
+  boost::shared_ptr<Bach::WorkStealingPool> compute_executor_;
+
+  /// How run_request answered.
+  enum output_kind
+  {
+    needs_compute,   // Only with quick_only: a simulation has to be run.
+    text_output,     // The whole answer is in output.
+    streamed_output  // The answer went to the chunk handler.
+  };
+
+  /// Produce the output for the decoded request path, either as text or
+  /// streamed to chunk. A streamed result is JSON or binary columns, as the
+  /// request or its Accept header asks, and content_type is set before the
+  /// first chunk. Text is JSON unless content_type is set, as it is for the
+  /// solver counters of /metrics. With quick_only set, return needs_compute instead of
+  /// running a simulation.
+  output_kind run_request(const std::string& request_path,
+      const std::string& accept, bool quick_only, std::string& output,
+      std::string& content_type, const chunk_handler& chunk);
+
+  /// The value of the named request header, or an empty string.
+  static std::string get_header(const request& req, const std::string& name);
+
+  /// The result format an Accept header asks for: json, binary or binary32.
+  static std::string format_from_accept(const std::string& accept);
+
+  /// Fill out the reply to be sent to the client.
+  static void fill_reply(const std::string& output,
+      const std::string& content_type, const std::string& origin, reply& rep);
+
+  /// Fill out the status and headers of a reply whose content is streamed.
+  static void fill_streamed_reply(const std::string& content_type,
+      const std::string& origin, reply& rep);
+
   /// Perform URL-decoding on a string. Returns false if the encoding was
   /// invalid.
   static bool url_decode(const std::string& in, std::string& out);
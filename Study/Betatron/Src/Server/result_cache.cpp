@@ -0,0 +1,245 @@
+//
+// result_cache.cpp
+// ~~~~~~~~~~~~~~~~
+//
+// Bounded cache of serialized simulation results, keyed on the canonical
+// form of the request JSON. Results are held as the chains of output
+// buffers they were serialized into.
+//
+
+#include "result_cache.hpp"
+#include <cstdio>
+#include <exception>
+
+namespace http {
+namespace server {
+
+namespace {
+  /// Bookkeeping per entry beyond the key and result buffers: the list node,
+  /// the hash node and the shared chain.
+  const std::size_t entry_overhead_bytes = 128;
+}
+
+result_cache::result_cache(std::size_t budget_bytes)
+  : budget_bytes_(budget_bytes),
+    bytes_(0),
+    hits_(0),
+    misses_(0),
+    evictions_(0),
+    coalesced_(0)
+{
+}
+
+result_cache::result_ptr result_cache::get_or_compute(const std::string& key,
+    const producer& produce, const chunk_handler& on_chunk)
+{
+  std::promise<result_ptr> promise;
+  result_ptr ready;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto found = entries_.find(key);
+    auto running = in_flight_.find(key);
+    if (found != entries_.end())
+    {
+      ++hits_;
+      lru_.splice(lru_.begin(), lru_, found->second.lru_position);
+      ready = found->second.result;
+    }
+    else if (running != in_flight_.end())
+    {
+      ++coalesced_;
+      std::shared_future<result_ptr> pending = running->second;
+      lock.unlock();
+      ready = pending.get();
+    }
+    else
+    {
+      ++misses_;
+      in_flight_[key] = promise.get_future().share();
+    }
+  }
+
+  if (ready)
+  {
+    for (std::size_t i = 0; i < ready->size(); ++i)
+      on_chunk((*ready)[i]);
+    return ready;
+  }
+
+  // Compute without the lock so that other keys are served meanwhile.
+  std::shared_ptr<Bach::OutputBufferChain> chain =
+      std::make_shared<Bach::OutputBufferChain>();
+  result_ptr result;
+  try
+  {
+    produce([&chain, &on_chunk](const Bach::OutputBufferPtr& buffer)
+        {
+          chain->push_back(buffer);
+          on_chunk(buffer);
+        });
+    result = chain;
+  }
+  catch (...)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    in_flight_.erase(key);
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  in_flight_.erase(key);
+  insert(key, result);
+  promise.set_value(result);
+  return result;
+}
+
+result_cache::result_ptr result_cache::find(const std::string& key)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = entries_.find(key);
+  if (found == entries_.end())
+    return result_ptr();
+
+  ++hits_;
+  lru_.splice(lru_.begin(), lru_, found->second.lru_position);
+  return found->second.result;
+}
+
+void result_cache::insert(const std::string& key, const result_ptr& result)
+{
+  std::size_t bytes = entry_bytes(key, *result);
+  if (bytes > budget_bytes_)
+  {
+    // Larger than the whole cache, so it would only push everything else out.
+    return;
+  }
+
+  lru_.push_front(key);
+  entry& added = entries_[key];
+  added.result = result;
+  added.bytes = bytes;
+  added.lru_position = lru_.begin();
+  bytes_ += bytes;
+
+  while (bytes_ > budget_bytes_)
+  {
+    auto oldest = entries_.find(lru_.back());
+    bytes_ -= oldest->second.bytes;
+    entries_.erase(oldest);
+    lru_.pop_back();
+    ++evictions_;
+  }
+}
+
+void result_cache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+  bytes_ = 0;
+}
+
+result_cache::stats result_cache::get_stats() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats current;
+  current.hits = hits_;
+  current.misses = misses_;
+  current.evictions = evictions_;
+  current.coalesced = coalesced_;
+  current.entries = entries_.size();
+  current.bytes = bytes_;
+  current.budget_bytes = budget_bytes_;
+  return current;
+}
+
+std::string result_cache::stats_as_json() const
+{
+  stats current = get_stats();
+  Json::Value root;
+  root["hits"] = Json::UInt64(current.hits);
+  root["misses"] = Json::UInt64(current.misses);
+  root["evictions"] = Json::UInt64(current.evictions);
+  root["coalesced"] = Json::UInt64(current.coalesced);
+  root["entries"] = Json::UInt64(current.entries);
+  root["bytes"] = Json::UInt64(current.bytes);
+  root["budgetBytes"] = Json::UInt64(current.budget_bytes);
+
+  Json::FastWriter writer;
+  writer.omitEndingLineFeed();
+  return writer.write(root);
+}
+
+std::size_t result_cache::entry_bytes(const std::string& key,
+    const Bach::OutputBufferChain& result)
+{
+  // The key is held by both the list and the map. Buffers are counted at
+  // their capacity, as that is the memory they keep from the pool.
+  return 2 * key.size() + Bach::GetChainCapacity(result)
+      + result.size() * sizeof(Bach::OutputBufferPtr) + entry_overhead_bytes;
+}
+
+std::string result_cache::canonical_key(const Json::Value& request)
+{
+  std::string key;
+  write_canonical(request, key);
+  return key;
+}
+
+void result_cache::write_canonical(const Json::Value& value, std::string& out)
+{
+  switch (value.type())
+  {
+  case Json::nullValue:
+    out += "null";
+    break;
+  case Json::intValue:
+  case Json::uintValue:
+  case Json::realValue:
+    {
+      // Every number as a double written with enough digits to round trip,
+      // so 1, 1.0 and 1e0 give the same key but neighbouring doubles do not.
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), "%.17g", value.asDouble());
+      out += buffer;
+    }
+    break;
+  case Json::stringValue:
+    out += Json::valueToQuotedString(value.asCString());
+    break;
+  case Json::booleanValue:
+    out += (value.asBool() ? "true" : "false");
+    break;
+  case Json::arrayValue:
+    out += '[';
+    for (Json::ArrayIndex i = 0; i < value.size(); ++i)
+    {
+      if (i > 0)
+        out += ',';
+      write_canonical(value[i], out);
+    }
+    out += ']';
+    break;
+  case Json::objectValue:
+    {
+      // getMemberNames returns the members sorted.
+      Json::Value::Members members = value.getMemberNames();
+      out += '{';
+      for (std::size_t i = 0; i < members.size(); ++i)
+      {
+        if (i > 0)
+          out += ',';
+        out += Json::valueToQuotedString(members[i].c_str());
+        out += ':';
+        write_canonical(value[members[i]], out);
+      }
+      out += '}';
+    }
+    break;
+  }
+}
+
+} // namespace server
+} // namespace http
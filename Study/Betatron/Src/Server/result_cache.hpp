@@ -0,0 +1,115 @@
+//
+// result_cache.hpp
+// ~~~~~~~~~~~~~~~~
+//
+// Bounded cache of serialized simulation results, keyed on the canonical
+// form of the request JSON. Results are held as the chains of output
+// buffers they were serialized into.
+//
+
+#ifndef HTTP_RESULT_CACHE_HPP
+#define HTTP_RESULT_CACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "json.h"
+#include "OutputBufferPool.h"
+
+namespace http {
+namespace server {
+
+/// Least recently used cache of results with a memory budget. Concurrent
+/// requests for a result that is still being computed wait for the one
+/// computation instead of starting their own.
+class result_cache
+{
+public:
+  typedef std::shared_ptr<const Bach::OutputBufferChain> result_ptr;
+
+  /// Receives the buffers of a result in order.
+  typedef std::function<void(const Bach::OutputBufferPtr&)> chunk_handler;
+
+  /// Computes a result, passing each buffer to the handler as it fills.
+  typedef std::function<void(const chunk_handler&)> producer;
+
+  struct stats
+  {
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t evictions;
+    std::size_t coalesced;   // Requests that waited for a computation already running.
+    std::size_t entries;
+    std::size_t bytes;
+    std::size_t budget_bytes;
+  };
+
+  result_cache(const result_cache&) = delete;
+  result_cache& operator=(const result_cache&) = delete;
+
+  /// Construct a cache holding at most budget_bytes of keys and results.
+  explicit result_cache(std::size_t budget_bytes);
+
+  /// Pass each buffer of the result for key to on_chunk and return the
+  /// result. It is taken from the cache if there, or else produced, in which
+  /// case each buffer is passed on as soon as produce hands it over. Only one
+  /// call of produce runs per key at a time. If it throws, every waiting
+  /// caller gets the exception and nothing is cached.
+  result_ptr get_or_compute(const std::string& key, const producer& produce,
+      const chunk_handler& on_chunk);
+
+  /// Return the result cached for key, counted as a hit, or null without
+  /// counting a miss.
+  result_ptr find(const std::string& key);
+
+  /// Drop every cached result. Computations in flight are unaffected.
+  void clear();
+
+  stats get_stats() const;
+
+  /// The statistics as a JSON object, for the stats endpoint.
+  std::string stats_as_json() const;
+
+  /// A key that is the same for requests that differ only in member order,
+  /// whitespace or how a number was written.
+  static std::string canonical_key(const Json::Value& request);
+
+private:
+  struct entry
+  {
+    result_ptr result;
+    std::size_t bytes;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  /// Add a finished result and evict from the old end until within budget.
+  void insert(const std::string& key, const result_ptr& result);
+
+  static std::size_t entry_bytes(const std::string& key,
+      const Bach::OutputBufferChain& result);
+  static void write_canonical(const Json::Value& value, std::string& out);
+
+  mutable std::mutex mutex_;
+  std::size_t budget_bytes_;
+  std::size_t bytes_;
+
+  /// Keys from most to least recently used.
+  std::list<std::string> lru_;
+  std::unordered_map<std::string, entry> entries_;
+  std::unordered_map<std::string, std::shared_future<result_ptr> > in_flight_;
+
+  std::size_t hits_;
+  std::size_t misses_;
+  std::size_t evictions_;
+  std::size_t coalesced_;
+};
+
+} // namespace server
+} // namespace http
+
+#endif // HTTP_RESULT_CACHE_HPP
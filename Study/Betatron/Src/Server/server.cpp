@@ -10,19 +10,24 @@
 
 #include "server.hpp"
 #include <signal.h>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace http {
 namespace server {
 
 server::server(const std::string& address, const std::string& port,
-    const std::string& doc_root)
-  : io_service_(),
+    const std::string& doc_root, std::size_t io_thread_pool_size,
+    std::size_t compute_thread_pool_size,
+    std::chrono::steady_clock::duration idle_timeout)
+  : io_thread_pool_size_(io_thread_pool_size > 0 ? io_thread_pool_size : 1),
+    io_service_(),
     signals_(io_service_),
     acceptor_(io_service_),
-    connection_manager_(),
+    connection_manager_(io_service_, idle_timeout),
     socket_(io_service_),
-    request_handler_(doc_root)
+    request_handler_(doc_root, compute_thread_pool_size)
 {
   // Register to handle the signals that indicate when the server should exit.
   // It is safe to register for the same signal multiple times in a program,
@@ -52,7 +57,32 @@ void server::run()
   // have finished. While the server is running, there is always at least one
   // asynchronous operation outstanding: the asynchronous accept call waiting
   // for new incoming connections.
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < io_thread_pool_size_; ++i)
+  {
+    threads.push_back(std::thread([this]() { io_service_.run(); }));
+  }
+
   io_service_.run();
+
+  for (std::size_t i = 0; i < threads.size(); ++i)
+  {
+    threads[i].join();
+  }
+}
+
+void server::stop()
+{
+  // Cancelling the wait for a signal runs its handler, which stops the server.
+  io_service_.post([this]()
+      {
+        signals_.cancel();
+      });
+}
+
+unsigned short server::port() const
+{
+  return acceptor_.local_endpoint().port();
 }
 
 void server::do_accept()
@@ -70,7 +100,8 @@ void server::do_accept()
         if (!ec)
         {
           connection_manager_.start(std::make_shared<connection>(
-              std::move(socket_), connection_manager_, request_handler_));
+              io_service_, std::move(socket_), connection_manager_,
+              request_handler_));
         }
 
         do_accept();
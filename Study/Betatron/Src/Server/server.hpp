@@ -12,6 +12,8 @@
 #define HTTP_SERVER_HPP
 
 #include <asio.hpp>
+#include <chrono>
+#include <cstddef>
 #include <string>
 #include "connection.hpp"
 #include "connection_manager.hpp"
@@ -28,13 +30,26 @@ public:
   server& operator=(const server&) = delete;
 
   /// Construct the server to listen on the specified TCP address and port, and
-  /// serve up files from the given directory.
+  /// serve up files from the given directory. The io_service is run from
+  /// io_thread_pool_size threads and simulations run on a separate pool of
+  /// compute_thread_pool_size threads, zero meaning one per core. Kept alive
+  /// connections are closed after idle_timeout without a request.
   explicit server(const std::string& address, const std::string& port,
-      const std::string& doc_root);
+      const std::string& doc_root, std::size_t io_thread_pool_size = 1,
+      std::size_t compute_thread_pool_size = 0,
+      std::chrono::steady_clock::duration idle_timeout = std::chrono::seconds(30));
 
-  /// Run the server's io_service loop.
+  /// Run the server's io_service loop on the I/O threads until it stops.
   void run();
 
+  /// Stop the server as a termination signal would. Safe to call from any
+  /// thread; run() returns once the replies in progress are finished.
+  void stop();
+
+  /// The port the server listens on, the one the system chose if the server
+  /// was given port "0".
+  unsigned short port() const;
+
 private:
   /// Perform an asynchronous accept operation.
   void do_accept();
@@ -42,6 +57,9 @@ private:
   /// Wait for a request to stop the server.
   void do_await_stop();
 
+  /// The number of threads that will call io_service::run().
+  std::size_t io_thread_pool_size_;
+
   /// The io_service used to perform asynchronous operations.
   asio::io_service io_service_;
 
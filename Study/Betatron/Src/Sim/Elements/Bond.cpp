@@ -118,13 +118,13 @@ Eigen::Vector3d Bond::GetEquilibriumEquationVector(shared_ptr<ForceVectors> forc
   BondForce::PositionType posType;
   Real bondForce = m_bondForce->GetForce(linPos, posType);
   if(posType != BondForce::BondUnbroken) {
-    Log(L"ERROR: Bond::GetEquilibriumEquationVector: bond broken");
+    BACH_LOG_ERROR(L"Bond::GetEquilibriumEquationVector: bond broken");
   }
   
   Eigen::Vector3d forces = m_bondDirection.array()*bondForce;
   if(forceVectorStorage) {
-    Log(L"LinPos (pm): %g", linPos*METERS_TO_PICOMETERS);
-    Log(L"LinForce (nN): %g", bondForce*NEWTONS_TO_NANONEWTONS);
+    BACH_LOG_DEBUG(L"LinPos (pm): %g", linPos*METERS_TO_PICOMETERS);
+    BACH_LOG_DEBUG(L"LinForce (nN): %g", bondForce*NEWTONS_TO_NANONEWTONS);
     forceVectorStorage->AddForceVector(GetName(), forces);
   }
   
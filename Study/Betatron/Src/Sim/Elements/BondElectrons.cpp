@@ -36,6 +36,11 @@ BondElectrons::BondElectrons(boost::shared_ptr<Bond> bond, int bondId) :
   Element(Element::ElectronPairElement),
   m_bond(bond),
   m_bondId(bondId),
+  m_linearPosition(0.0),
+  m_linearVelocity(0.0),
+  m_linearAcceleration(0.0),
+  m_magneticInducedForce(0.0),
+  m_bondForce(0.0),
   m_charge(-2.0)
 {
   m_chargeMagneticField = ChargeMagneticField::CreateInstance(m_charge);
@@ -152,12 +157,12 @@ Eigen::Vector3d BondElectrons::CalculateMagneticInducedForce(
     zero.fill(0.0f);
     return zero;
   }
-  Log(L"***********");
-  Log(L"direction B = %s", VecXdToString(directionB).c_str());
+  BACH_LOG_DEBUG(L"***********");
+  BACH_LOG_DEBUG(L"direction B = %s", VecXdToString(directionB).c_str());
   Eigen::Vector3d dBdt = m_chargeMagneticField->GetMagneticFieldChangeVector(chargePosition, chargeVelocity);
-  Log(L"dBdt = %s", VecXdToString(dBdt).c_str());
+  BACH_LOG_DEBUG(L"dBdt = %s", VecXdToString(dBdt).c_str());
   Eigen::Vector3d emf = directionB.cross(dBdt);
-  Log(L"emf = %s", VecXdToString(emf).c_str());
+  BACH_LOG_DEBUG(L"emf = %s", VecXdToString(emf).c_str());
   emf.array() *= charge;
 
   return emf;
@@ -56,6 +56,7 @@ namespace Bach {
 
     Real GetLinearPosition() { return m_linearPosition; }
     Real GetLinearVelocity() { return m_linearVelocity; }
+    Real GetLinearAcceleration() { return m_linearAcceleration; }
     
     Real GetMagneticInducedForce()   { return m_magneticInducedForce; }
     Real GetBondForce()              { return m_bondForce; }
@@ -41,7 +41,7 @@ namespace Bach {
   protected:
     Element(ElementType elementType) : m_elementType(elementType) {}
 
-    void SetName(const std::wstring& name) { m_name = name; Log(L"Name: %s", m_name.c_str()); }
+    void SetName(const std::wstring& name) { m_name = name; BACH_LOG_DEBUG(L"Name: %s", m_name.c_str()); }
     std::wstring m_name;
     ElementType m_elementType;
   };
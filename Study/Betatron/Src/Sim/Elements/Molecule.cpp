@@ -13,6 +13,8 @@ All Rights Reserved.
 
 #include "Molecule.h"
 #include "Bond.h"
+#include "BondElectrons.h"
+#include "SpOrbital.h"
 #include <sstream>
 
 using namespace Bach;
@@ -53,11 +55,11 @@ shared_ptr<Bond> Molecule::BondAtoms(int idFirst, int idSecond, int id) {
   shared_ptr<Atom> first = GetAtomById(idFirst);
   shared_ptr<Atom> second = GetAtomById(idSecond);
   if(!first) {
-    Log(L"ERROR: Molecule::BondAtoms: idFirst of %d incorrect", id);
+    BACH_LOG_ERROR(L"Molecule::BondAtoms: idFirst of %d incorrect", id);
     throw std::exception();
   }
   if(!second) {
-    Log(L"ERROR: Molecule::BondAtoms: idSecond of %d incorrect", id);
+    BACH_LOG_ERROR(L"Molecule::BondAtoms: idSecond of %d incorrect", id);
     throw std::exception();
   }
   
@@ -69,6 +71,32 @@ shared_ptr<Bond> Molecule::BondAtoms(int idFirst, int idSecond, int id) {
   return bond;
 }
 
+shared_ptr<Molecule> Molecule::Clone() {
+  shared_ptr<Molecule> clone = CreateInstance(m_moleculeType, m_id);
+
+  for(size_t i=0; i<m_atoms.size(); i++) {
+    shared_ptr<Atom> atom = m_atoms[i];
+    shared_ptr<Atom> atomCopy = clone->AddAtom(atom->GetAtomType(), atom->GetId(), atom->GetPosition(), atom->GetCharge(), atom->GetEffectiveNuclearCharge());
+    for(int j=0; j<atom->GetNumSpOrbitals(); j++) {
+      shared_ptr<SpOrbital> orbital = atom->GetSpOrbitalByIndex(j);
+      atomCopy->AddSpOrbital(orbital->GetPosition(), orbital->GetCharge(), orbital->GetOrbitalId());
+    }
+  }
+
+  for(size_t i=0; i<m_bonds.size(); i++) {
+    shared_ptr<Bond> bond = m_bonds[i];
+    shared_ptr<Bond> bondCopy = clone->BondAtoms(bond->GetFirst()->GetId(), bond->GetSecond()->GetId(), bond->GetId());
+    bondCopy->SetBondForce(bond->GetBondForceObject());
+
+    shared_ptr<BondElectrons> electrons = bond->GetBondElectrons();
+    shared_ptr<BondElectrons> electronsCopy = bondCopy->GetBondElectrons();
+    electronsCopy->SetLinearPosition(electrons->GetLinearPosition());
+    electronsCopy->SetLinearVelocity(electrons->GetLinearVelocity());
+    electronsCopy->SetLinearAcceleration(electrons->GetLinearAcceleration());
+  }
+  return clone;
+}
+
 shared_ptr<Atom> Molecule::GetAtomById(int id) {
   std::map< int, boost::shared_ptr<Atom> >::iterator iter = m_atomsById.find(id);
   if(iter != m_atomsById.end()) {
@@ -6,6 +6,9 @@ Purpose  : Header file for a sigma Molecule.
 Revisions: Original definition by Lawrence Gunn.
            2013/06/23
 
+           Clone copies the molecule, so that copies can be evaluated on
+           threads of their own.
+           2026/10/18
 
 Copyright (c) 2013 by Lawrence Gunn
 All Rights Reserved.
@@ -47,6 +50,10 @@ namespace Bach {
     
     Integer GetNumAtoms() { return (Integer) m_atoms.size(); }
     Integer GetNumBonds() { return (Integer) m_bonds.size(); }
+
+    // A copy with atoms, bonds and bond electrons of its own, the electrons where these are.
+    // The bond forces don't change once configured, so the copy shares them.
+    boost::shared_ptr<Molecule> Clone();
     
   protected:
     Molecule(const std::wstring& moleculeType, Integer id);
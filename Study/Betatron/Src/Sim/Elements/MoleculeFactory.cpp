@@ -124,7 +124,7 @@ shared_ptr<Molecule> MoleculeFactory::CreateWater(Integer moleculeId) {
 void MoleculeFactory::CreateOxHydBondForce(shared_ptr<Bond> bond) {
   shared_ptr<BondForce> bondForce = BondForce::CreateInstance(bond);
   Real len = bond->GetLength();
-  Log(L"LENGTH=%e", len);
+  BACH_LOG_DEBUG(L"LENGTH=%e", len);
   Real nominalBondLength = 94.69973e-12; // pm
 
  #if (__BOND_FORCE_VERSION__ == 2)
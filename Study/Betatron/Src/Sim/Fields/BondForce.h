@@ -75,6 +75,11 @@ namespace Bach {
 
     Real GetForce(Real x, PositionType& positionType);
 
+    // How far x is inside each limit. GetForce reports the bond broken towards the first or
+    // second atom once the margin on that side falls to zero.
+    Real GetFirstLimitMargin(Real x) const  { return x-m_firstLimitPosition; }
+    Real GetSecondLimitMargin(Real x) const { return m_secondLimitPosition-x; }
+
   protected:
     BondForce(boost::shared_ptr<Bond> bond);
 
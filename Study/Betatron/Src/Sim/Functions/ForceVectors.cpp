@@ -45,16 +45,16 @@ Eigen::Vector3d ForceVectors::GetForceVector(Integer index) {
 }
 
 void ForceVectors::WriteToLog() {
-  LogPlain(L"Force On: %s", m_targetName.c_str());
+  BACH_LOG_INFO(L"Force On: %s", m_targetName.c_str());
   if(m_targetTravelContraintSet) {
-    LogPlain(L"  Force Constraint: %s", Vec3dToString(m_targetTravelConstraint).c_str());
+    BACH_LOG_INFO(L"  Force Constraint: %s", Vec3dToString(m_targetTravelConstraint).c_str());
   }
   
   for(Integer i=0; i<m_forceVectors.size(); i++) {
     const wchar_t* padding = L"                                  ";
     int padLen = 25-m_forceNames[i].size();
     if(padLen < 0)  { padLen = 0; } // Avoid negative length
-    LogPlain(L"  %s%*.*s: %s", m_forceNames[i].c_str(), padLen, padLen, padding, Vec3dToStringFixed(m_forceVectors[i].array()*NEWTONS_TO_NANONEWTONS).c_str());
+    BACH_LOG_INFO(L"  %s%*.*s: %s", m_forceNames[i].c_str(), padLen, padLen, padding, Vec3dToStringFixed(m_forceVectors[i].array()*NEWTONS_TO_NANONEWTONS).c_str());
   }
 }
 
@@ -13,6 +13,7 @@ All Rights Reserved.
 
 #include "BetatronHandler.h"
 #include "BetatronEquationSolver.h"
+#include "BetatronBatchSolver.h"
 #include "BetatronFieldController.h"
 #include "NDimAccuracySpec.h"
 #include "SampledData.h"
@@ -20,11 +21,37 @@ All Rights Reserved.
 #include "BaderDeuflhardOde.h"
 #include "OdeData.h"
 #include "OdeDataCollector.h"
+#include "JsonStreamWriter.h"
+#include "BinaryColumnWriter.h"
 
 using namespace Bach;
 using namespace boost;
 using namespace Eigen;
 
+namespace {
+  // The "method" input, which defaults to the Bader-Deuflhard solver.
+  BetatronEquationSolver::OdeMethod GetOdeMethod(const Json::Value& inputs) {
+    std::string method = inputs.get("method", "baderDeuflhard").asString();
+    if(method == "baderDeuflhard") {
+      return BetatronEquationSolver::BaderDeuflhardMethod;
+    }
+    else if(method == "dormandPrince") {
+      return BetatronEquationSolver::DormandPrinceMethod;
+    }
+    else if(method == "bulirschStoer") {
+      return BetatronEquationSolver::BulirschStoerMethod;
+    }
+    else if(method == "boris") {
+      return BetatronEquationSolver::BorisMethod;
+    }
+    else if(method == "relativisticBoris") {
+      return BetatronEquationSolver::RelativisticBorisMethod;
+    }
+    BACH_LOG_ERROR(L"BetatronHandler: Unknown ODE method %s", std::wstring(method.begin(), method.end()).c_str());
+    throw std::exception();
+  }
+}
+
   //*******************
   //* BetatronHandler *
   //*******************
@@ -42,7 +69,54 @@ BetatronHandler::~BetatronHandler() {
 }
 
 std::string BetatronHandler::HandleRequest(Json::Value request) {
-  Json::Value inputs = request["inputs"];
+  return JsonStreamWriter::WriteToString([this, &request](JsonStreamWriter& writer) { HandleRequest(request, writer); });
+}
+
+void BetatronHandler::HandleRequest(Json::Value request, JsonStreamWriter& writer) {
+  std::vector< shared_ptr<OdeDataCollector> > results;
+  bool isSweep = Solve(request, results);
+
+  if(isSweep) { writer.WriteRaw("["); }
+  for(size_t i=0; i<results.size(); i++) {
+    if(i > 0) {
+      writer.WriteRaw(", ");
+    }
+    results[i]->WriteJson(writer);
+  }
+  if(isSweep) { writer.WriteRaw("]"); }
+}
+
+void BetatronHandler::HandleRequest(Json::Value request, BinaryColumnWriter& writer) {
+  std::vector< shared_ptr<OdeDataCollector> > results;
+  bool isSweep = Solve(request, results);
+
+  // The layout has the same shape as the JSON, so a sweep is an array here too.
+  std::string layout = JsonStreamWriter::WriteToString([&results, isSweep](JsonStreamWriter& layoutWriter) {
+    if(isSweep) { layoutWriter.WriteRaw("["); }
+    for(size_t i=0; i<results.size(); i++) {
+      if(i > 0) {
+        layoutWriter.WriteRaw(", ");
+      }
+      results[i]->WriteColumnLayout(layoutWriter);
+    }
+    if(isSweep) { layoutWriter.WriteRaw("]"); }
+  });
+
+  writer.WriteHeader(layout);
+  for(size_t i=0; i<results.size(); i++) {
+    results[i]->WriteColumns(writer);
+  }
+}
+
+bool BetatronHandler::Solve(const Json::Value& request, std::vector< shared_ptr<OdeDataCollector> >& results) {
+  const Json::Value& inputs = request["inputs"];
+
+  // An array of inputs is a parameter sweep, solved together and returned in the same order.
+  if(inputs.isArray()) {
+    SolveBatch(inputs, results);
+    return true;
+  }
+
   double radius = inputs.get("radius", "0.0").asDouble();
   double speed  = inputs.get("speed",  "0.0").asDouble();
 
@@ -52,13 +126,57 @@ std::string BetatronHandler::HandleRequest(Json::Value request) {
     double fieldIncrease = inputs.get("fieldIncrease",  "0.0").asDouble();
     solver->SetFieldIncreaseRatePerRotation(fieldIncrease);
   }
-  
+  solver->SetSampleDegrees(inputs.get("sampleDegrees", 0.0).asDouble());
+  solver->SetOdeMethod(GetOdeMethod(inputs));
+  solver->SetTolerance(inputs.get("tolerance", 0.0).asDouble());
+  solver->SetRecordRotations(inputs.get("recordRotations", false).asBool());
+  solver->SetStopAtRotation(inputs.get("stopAtRotation", 0).asInt());
+  if(inputs.isMember("radiusBand")) {
+    const Json::Value& band = inputs["radiusBand"];
+    solver->SetRadiusBand(band.get(0u, 0.0).asDouble(), band.get(1u, 0.0).asDouble());
+  }
+
   solver->SetInitialConditionsFromRadiusAndSpeed(radius, speed*Bach::SPEED_OF_LIGHT);
 
   solver->Initialize();
 
   solver->Run();
-  std::string json = solver->GetOdeData()->GetCollector()->AsJson();
+  results.push_back(solver->GetOdeData()->GetCollector());
 
-  return json;
+  // Telemetry is only returned when asked for, as its timings differ from run to run.
+  if(inputs.get("telemetry", false).asBool()) {
+    results.back()->SetTelemetry(solver->GetTelemetry());
+  }
+  return false;
+}
+
+void BetatronHandler::SolveBatch(const Json::Value& inputs, std::vector< shared_ptr<OdeDataCollector> >& results) {
+  std::vector<BetatronBatchSolver::Parameters> parameters(inputs.size());
+  for(Json::ArrayIndex i=0; i<inputs.size(); i++) {
+    const Json::Value& input = inputs[i];
+    parameters[i].radius = input.get("radius", "0.0").asDouble();
+    parameters[i].speed  = input.get("speed",  "0.0").asDouble()*Bach::SPEED_OF_LIGHT;
+    if(input.isMember("fieldIncrease")) {
+      parameters[i].fieldIncreaseRatePerRotation = input.get("fieldIncrease",  "0.0").asDouble();
+    }
+    parameters[i].sampleDegrees = input.get("sampleDegrees", 0.0).asDouble();
+    parameters[i].odeMethod = GetOdeMethod(input);
+    parameters[i].tolerance = input.get("tolerance", 0.0).asDouble();
+    parameters[i].recordRotations = input.get("recordRotations", false).asBool();
+    parameters[i].stopAtRotation = input.get("stopAtRotation", 0).asInt();
+    if(input.isMember("radiusBand")) {
+      parameters[i].minRadius = input["radiusBand"].get(0u, 0.0).asDouble();
+      parameters[i].maxRadius = input["radiusBand"].get(1u, 0.0).asDouble();
+    }
+  }
+
+  shared_ptr<BetatronBatchSolver> batchSolver = BetatronBatchSolver::CreateInstance(m_pool);
+  batchSolver->Solve(parameters);
+
+  for(int i=0; i<batchSolver->GetNumberOfSolvers(); i++) {
+    results.push_back(batchSolver->GetSolver(i)->GetOdeData()->GetCollector());
+    if(inputs[i].get("telemetry", false).asBool()) {
+      results.back()->SetTelemetry(batchSolver->GetSolver(i)->GetTelemetry());
+    }
+  }
 }
@@ -24,6 +24,8 @@ namespace Bach {
   class BetatronFieldController;
   class BaderDeuflhardOde;
   class OdeData;
+  class OdeDataCollector;
+  class WorkStealingPool;
 
   //*******************
   //* BetatronHandler *
@@ -38,9 +40,24 @@ namespace Bach {
     
     std::string HandleRequest(Json::Value request);
 
+    // Write the result into writer as it is serialized rather than returning it whole.
+    void HandleRequest(Json::Value request, JsonStreamWriter& writer);
+
+    // The result in the binary column format.
+    void HandleRequest(Json::Value request, BinaryColumnWriter& writer);
+
+    // The pool a parameter sweep is solved on. Without one the process wide pool is used.
+    void SetPool(boost::shared_ptr<WorkStealingPool> pool) { m_pool = pool; }
+
   protected:
     BetatronHandler();
+
+    // Run the simulations the request asks for and collect their data in the order
+    // of the inputs. Returns true for a parameter sweep, which is written as an array.
+    bool Solve(const Json::Value& request, std::vector< boost::shared_ptr<OdeDataCollector> >& results);
+    void SolveBatch(const Json::Value& inputs, std::vector< boost::shared_ptr<OdeDataCollector> >& results);
     
+    boost::shared_ptr<WorkStealingPool> m_pool;
     boost::weak_ptr<BetatronHandler> m_weakThis;
   };
 };
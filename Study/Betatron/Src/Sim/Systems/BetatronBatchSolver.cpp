@@ -0,0 +1,64 @@
+/**********************************************************************
+
+File     : BetatronBatchSolver.cpp
+Project  : Bach Simulation
+Purpose  : Source file for solving many betatron trajectories at once.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BetatronBatchSolver.h"
+#include "BetatronEquationSolver.h"
+#include "WorkStealingPool.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+  //***********************
+  //* BetatronBatchSolver *
+  //***********************
+
+shared_ptr<BetatronBatchSolver> BetatronBatchSolver::CreateInstance(shared_ptr<WorkStealingPool> pool) {
+  shared_ptr<BetatronBatchSolver> instance(new BetatronBatchSolver(pool ? pool : WorkStealingPool::GetSharedInstance()));
+  return instance;
+}
+
+BetatronBatchSolver::BetatronBatchSolver(shared_ptr<WorkStealingPool> pool) :
+  m_pool(pool)
+{
+}
+
+BetatronBatchSolver::~BetatronBatchSolver() {
+}
+
+void BetatronBatchSolver::Solve(const std::vector<Parameters>& parameters) {
+  m_solvers.clear();
+  m_solvers.resize(parameters.size());
+
+  // Each task writes only its own slot so the results stay in input order.
+  m_pool->ParallelFor((int) parameters.size(), [this, &parameters](int i) {
+    SolveOne(parameters[i], i);
+  });
+}
+
+void BetatronBatchSolver::SolveOne(const Parameters& parameters, int index) {
+  shared_ptr<BetatronEquationSolver> solver = BetatronEquationSolver::CreateInstance();
+  solver->SetFieldIncreaseRatePerRotation(parameters.fieldIncreaseRatePerRotation);
+  solver->SetNumRotations(parameters.numRotations);
+  solver->SetSampleDegrees(parameters.sampleDegrees);
+  solver->SetRecordRotations(parameters.recordRotations);
+  solver->SetStopAtRotation(parameters.stopAtRotation);
+  solver->SetRadiusBand(parameters.minRadius, parameters.maxRadius);
+  solver->SetOdeMethod((BetatronEquationSolver::OdeMethod) parameters.odeMethod);
+  solver->SetTolerance(parameters.tolerance);
+  solver->SetInitialConditionsFromRadiusAndSpeed(parameters.radius, parameters.speed);
+  solver->Initialize();
+  solver->Run();
+
+  m_solvers[index] = solver;
+}
@@ -0,0 +1,73 @@
+/**********************************************************************
+
+File     : BetatronBatchSolver.h
+Project  : Bach Simulation
+Purpose  : Header file for solving many betatron trajectories at once.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Each trajectory gets its own BetatronEquationSolver, and with it
+           its own equations, field controller and BaderDeuflhardOde
+           workspace, so the trajectories share nothing while they run.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_BETATRON_BATCH_SOLVER_H__
+#define __BACH_BETATRON_BATCH_SOLVER_H__
+
+#include "BachDefs.h"
+#include <vector>
+
+namespace Bach {
+
+  class BetatronEquationSolver;
+  class WorkStealingPool;
+
+  //***********************
+  //* BetatronBatchSolver *
+  //***********************
+
+  class BetatronBatchSolver {
+  public:
+    struct Parameters {
+      Parameters() : radius(0.0), speed(0.0), fieldIncreaseRatePerRotation(0.0), numRotations(5.0), sampleDegrees(0.0),
+                     recordRotations(false), stopAtRotation(0), minRadius(0.0), maxRadius(0.0), odeMethod(0), tolerance(0.0) {}
+
+      double radius;                       // m
+      double speed;                        // m/s
+      double fieldIncreaseRatePerRotation;
+      double numRotations;
+      double sampleDegrees;                // zero to sample at the solver's steps
+      bool recordRotations;
+      int stopAtRotation;                  // zero to run for numRotations
+      double minRadius;                    // m, the band the charge stops on leaving
+      double maxRadius;                    // m, zero for no band
+      int odeMethod;                       // a BetatronEquationSolver::OdeMethod
+      double tolerance;                    // zero for the solver's default
+    };
+
+    // Without a pool the process wide WorkStealingPool is used.
+    static boost::shared_ptr<BetatronBatchSolver> CreateInstance(boost::shared_ptr<WorkStealingPool> pool = boost::shared_ptr<WorkStealingPool>());
+
+    virtual ~BetatronBatchSolver();
+
+    // Solve every trajectory, returning once they are all done.
+    void Solve(const std::vector<Parameters>& parameters);
+
+    // The solvers in the same order as the parameters passed to Solve.
+    int GetNumberOfSolvers() const { return (int) m_solvers.size(); }
+    boost::shared_ptr<BetatronEquationSolver> GetSolver(int index) { return m_solvers[index]; }
+
+  protected:
+    BetatronBatchSolver(boost::shared_ptr<WorkStealingPool> pool);
+
+    void SolveOne(const Parameters& parameters, int index);
+
+    boost::shared_ptr<WorkStealingPool> m_pool;
+    std::vector<boost::shared_ptr<BetatronEquationSolver> > m_solvers;
+  };
+};
+
+#endif // __BACH_BETATRON_BATCH_SOLVER_H__
@@ -0,0 +1,36 @@
+/**********************************************************************
+
+File     : BetatronDerivatives.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the analytic Jacobian of the betatron equations.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BetatronDerivatives.h"
+#include "BetatronEquations.h"
+#include "BetatronFieldController.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+  //***********************
+  //* BetatronDerivatives *
+  //***********************
+
+BetatronDerivatives::BetatronDerivatives(shared_ptr<BetatronEquations> equations) :
+  m_equations(equations)
+{
+}
+
+BetatronDerivatives::~BetatronDerivatives() {
+}
+
+void BetatronDerivatives::GetDerivatives(double x, const Eigen::VectorXd& y, Eigen::VectorXd& dfdx, Eigen::MatrixXd& dfdy, shared_ptr<OdeData> odeData) {
+  m_equations->GetDerivativesT(x, y, dfdx, dfdy);
+}
@@ -0,0 +1,44 @@
+/**********************************************************************
+
+File     : BetatronDerivatives.h
+Project  : Bach Simulation
+Purpose  : Header file for the analytic Jacobian of the betatron equations.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The Lorentz force on the charge is linear in the velocity, so
+           dfdy and dfdx have a closed form and the Ridders differencing of
+           OdeNumericalDerivatives, with its many calls to Evaluate per
+           column, is not needed.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_BETATRON_DERIVATIVES_H__
+#define __BACH_BETATRON_DERIVATIVES_H__
+
+#include "OdeDerivatives.h"
+
+namespace Bach {
+
+  class BetatronEquations;
+
+  //***********************
+  //* BetatronDerivatives *
+  //***********************
+
+  class BetatronDerivatives : public OdeDerivatives {
+  public:
+    BetatronDerivatives(boost::shared_ptr<BetatronEquations> equations);
+    virtual ~BetatronDerivatives();
+
+    // The closed form from BetatronEquations::GetDerivativesT.
+    virtual void GetDerivatives(double x, const Eigen::VectorXd& y, Eigen::VectorXd& dfdx, Eigen::MatrixXd& dfdy, boost::shared_ptr<OdeData> odeData);
+
+  protected:
+    boost::shared_ptr<BetatronEquations> m_equations;
+  };
+};
+
+#endif // __BACH_BETATRON_DERIVATIVES_H__
@@ -13,13 +13,25 @@ All Rights Reserved.
 
 #include "BetatronEquationSolver.h"
 #include "BetatronEquations.h"
+#include "BetatronDerivatives.h"
+#include "OdeAutoDiffDerivatives.h"
+#include "OdeNumericalDerivatives.h"
 #include "BetatronFieldController.h"
 #include "NDimAccuracySpec.h"
 #include "OdeDataCollector.h"
+#include "StreamingOdeDataCollector.h"
+#include "GridOdeDataCollector.h"
 #include "SampledData.h"
 #include "SampledDerivedData.h"
 #include "BaderDeuflhardOde.h"
+#include "DormandPrinceOde.h"
+#include "BulirschStoerOde.h"
+#include "BorisPusher.h"
+#include "OdeAccuracySpec.h"
 #include "OdeData.h"
+#include "OdeSolverTelemetry.h"
+#include "OdeSolverMetrics.h"
+#include <algorithm>
 
 using namespace Bach;
 using namespace boost;
@@ -45,7 +57,16 @@ BetatronEquationSolver::BetatronEquationSolver() :
   m_initialPosition(3),
   m_initialVelocity(3),
   m_stepSize(0.00001),
-  m_iterationCount(0)
+  m_secondsPerRotation(0.0),
+  m_sampleDegrees(0.0),
+  m_recordRotations(false),
+  m_stopAtRotation(0),
+  m_minRadius(0.0),
+  m_maxRadius(0.0),
+  m_iterationCount(0),
+  m_jacobianMethod(AnalyticJacobian),
+  m_odeMethod(BaderDeuflhardMethod),
+  m_tolerance(0.0)
 {
   m_fieldController = BetatronFieldController::CreateInstance();
 }
@@ -65,6 +86,7 @@ void BetatronEquationSolver::SetInitialConditionsFromRadiusAndSpeed(double radiu
   // Calculate an appropriate stepsize.
   double distanceTraveledPerRotation = 2.0*NXGR_PI*radius;
   double secondsPerRotation = distanceTraveledPerRotation/speed;
+  m_secondsPerRotation = secondsPerRotation;
   
   m_startTime = 0.0;
   m_stepSize = 0.1*secondsPerRotation/360.0; // time to travel 0.1 degrees.
@@ -86,9 +108,33 @@ void BetatronEquationSolver::SetInitialConditionsFromRadiusAndSpeed(double radiu
 void BetatronEquationSolver::Initialize() {
   m_equations = BetatronEquations::CreateInstance();
   m_equations->SetFieldController(m_fieldController);
+  m_equations->SetRecordRotations(m_recordRotations);
+  m_equations->SetStopAtRotation(m_stopAtRotation);
+  if(m_maxRadius > 0.0) {
+    m_equations->SetRadiusBand(m_minRadius, m_maxRadius);
+  }
+
+  // A rotation shortens as the field grows, so this leaves room for a field that falls.
+  if(m_stopAtRotation > 0) {
+    m_endTime = std::max(m_endTime, 2.0*m_stopAtRotation*m_secondsPerRotation);
+  }
+
+  bool boris = (m_odeMethod == BorisMethod || m_odeMethod == RelativisticBorisMethod);
 
   m_odeData = OdeData::CreateInstance(m_equations);
-  m_odeData->SetCollector(shared_ptr<OdeDataCollector>(new OdeDataCollector()));
+  if(m_sampleDegrees > 0.0 && !boris) {
+    if(!m_streamFilePath.empty()) {
+      BACH_LOG_ERROR(L"BetatronEquationSolver::Initialize: Sampling by angle and streaming to a file cannot be combined");
+      throw std::exception();
+    }
+    m_odeData->SetCollector(shared_ptr<OdeDataCollector>(new GridOdeDataCollector(m_secondsPerRotation*m_sampleDegrees/360.0)));
+  }
+  else if(m_streamFilePath.empty()) {
+    m_odeData->SetCollector(shared_ptr<OdeDataCollector>(new OdeDataCollector()));
+  }
+  else {
+    m_odeData->SetCollector(shared_ptr<OdeDataCollector>(new StreamingOdeDataCollector(m_streamFilePath)));
+  }
 
   m_odeData->SetStartTime(m_startTime);
   m_odeData->SetEndTime(m_endTime);
@@ -104,11 +150,85 @@ void BetatronEquationSolver::Initialize() {
 
   m_equations->Initialize(m_odeData);
   
-  m_solver = BaderDeuflhardOde::CreateInstance();
+  double maximumStepSize = (m_endTime-m_startTime)/40.0;
+  switch(m_odeMethod) {
+    case BaderDeuflhardMethod : {
+      shared_ptr<BaderDeuflhardOde> solver = BaderDeuflhardOde::CreateInstance();
+      solver->SetMaximumStepSize(maximumStepSize);
+      switch(m_jacobianMethod) {
+        case AnalyticJacobian : {
+          solver->SetDifferentiator(shared_ptr<OdeDerivatives>(new BetatronDerivatives(m_equations)));
+          break;
+        }
+        case AutomaticJacobian : {
+          solver->SetDifferentiator(shared_ptr<OdeDerivatives>(new OdeAutoDiffDerivatives(m_equations->GetStateLength())));
+          break;
+        }
+        case NumericalJacobian : {
+          solver->SetDifferentiator(shared_ptr<OdeDerivatives>(new OdeNumericalDerivatives(m_equations->GetStateLength())));
+          break;
+        }
+      }
+      m_solver = solver;
+      break;
+    }
+    case DormandPrinceMethod : {
+      shared_ptr<DormandPrinceOde> solver = DormandPrinceOde::CreateInstance();
+      solver->SetMaximumStepSize(maximumStepSize);
+      m_solver = solver;
+      break;
+    }
+    case BulirschStoerMethod : {
+      shared_ptr<BulirschStoerOde> solver = BulirschStoerOde::CreateInstance();
+      solver->SetMaximumStepSize(maximumStepSize);
+      m_solver = solver;
+      break;
+    }
+    case BorisMethod :
+    case RelativisticBorisMethod : {
+      shared_ptr<BorisPusher> solver = BorisPusher::CreateInstance();
+      if(m_sampleDegrees > 0.0) {
+        solver->SetStepsPerSample(std::max(1, (int) floor(m_secondsPerRotation*m_sampleDegrees/(360.0*m_stepSize)+0.5)));
+      }
+      if(m_odeMethod == RelativisticBorisMethod) {
+        double speed = m_initialVelocity.norm();
+        double gamma = 1.0/sqrt(1.0-speed*speed/Bach::SPEED_OF_LIGHT_SQUARED);
+        m_fieldController->SetAsConstantB(gamma*m_magneticFieldMagnitude, Eigen::Vector3d(0.0, 0.0, 1.0));
+        solver->SetRelativistic(true);
+      }
+      m_solver = solver;
+      break;
+    }
+  }
   m_solver->SetStepSize(m_stepSize);
-  m_solver->SetMaximumStepSize((m_endTime-m_startTime)/40.0);
+  m_telemetry = OdeSolverTelemetry::CreateInstance(GetOdeMethodName(m_odeMethod));
+  m_solver->SetTelemetry(m_telemetry);
+
+  if(m_tolerance > 0.0) {
+    m_solver->SetAccuracySpec(shared_ptr<OdeAccuracySpec>(new OdeAccuracySpec(m_equations->GetStateLength(), m_tolerance)));
+  }
 }
 
 void BetatronEquationSolver::Run() {
+  OdeSolverTelemetry::Clock::time_point start = OdeSolverTelemetry::Clock::now();
   m_solver->Solve(m_odeData);
+  m_telemetry->AddSolveSeconds(std::chrono::duration<double>(OdeSolverTelemetry::Clock::now()-start).count());
+  OdeSolverMetrics::GetSharedInstance()->Record(*m_telemetry);
+  m_iterationCount = m_equations->GetIterationCount();
+
+  shared_ptr<StreamingOdeDataCollector> streamingCollector = dynamic_pointer_cast<StreamingOdeDataCollector>(m_odeData->GetCollector());
+  if(streamingCollector) {
+    streamingCollector->Finish();
+  }
+}
+
+const char* BetatronEquationSolver::GetOdeMethodName(OdeMethod odeMethod) {
+  switch(odeMethod) {
+    case BaderDeuflhardMethod :    return "baderDeuflhard";
+    case DormandPrinceMethod :     return "dormandPrince";
+    case BulirschStoerMethod :     return "bulirschStoer";
+    case BorisMethod :             return "boris";
+    case RelativisticBorisMethod : return "relativisticBoris";
+    default :                      return "";
+  }
 }
@@ -21,8 +21,9 @@ namespace Bach {
 
   class BetatronEquations;
   class BetatronFieldController;
-  class BaderDeuflhardOde;
+  class OdeSolver;
   class OdeData;
+  class OdeSolverTelemetry;
 
   //**************************
   //* BetatronEquationSolver *
@@ -39,11 +40,62 @@ namespace Bach {
     void SetInitialConditionsFromRadiusAndSpeed(double radius, double speed);
     void SetFieldIncreaseRatePerRotation(double fieldIncreaseRatePerRotation) { m_fieldIncreaseRatePerRotation = fieldIncreaseRatePerRotation; }
     void SetNumRotations(double numRotations) { m_numRotations = numRotations; }
+
+    // The initial step size chosen by SetInitialConditionsFromRadiusAndSpeed.
+    double GetStepSize() const { return m_stepSize; }
+
+    enum JacobianMethod {
+      AnalyticJacobian = 0,  // The closed form of BetatronDerivatives, the default.
+      AutomaticJacobian = 1, // Dual numbers through BetatronEquations::EvaluateT.
+      NumericalJacobian = 2  // Ridders differencing of Evaluate.
+    };
+
+    void SetJacobianMethod(JacobianMethod jacobianMethod) { m_jacobianMethod = jacobianMethod; }
+
+    enum OdeMethod {
+      BaderDeuflhardMethod = 0, // Semi-implicit extrapolation with a Jacobian, the default.
+      DormandPrinceMethod = 1,  // Explicit Runge-Kutta 5(4).
+      BulirschStoerMethod = 2,  // Explicit extrapolation, without dense output.
+      BorisMethod = 3,          // The fixed step Boris pusher, without dense output.
+      RelativisticBorisMethod = 4
+    };
+
+    // The Lorentz force system isn't stiff, so the explicit solvers skip the Jacobian for nothing
+    // lost. The Jacobian method only applies to BaderDeuflhardMethod. The Boris pushers step at
+    // the initial step size and sample every sampleDegrees rounded to a whole number of steps.
+    // The relativistic one raises the field by gamma so the orbit keeps its radius.
+    void SetOdeMethod(OdeMethod odeMethod) { m_odeMethod = odeMethod; }
+
+    // Tolerance of the OdeAccuracySpec the solver is given, zero to keep the solver's default.
+    void SetTolerance(double tolerance) { m_tolerance = tolerance; }
+
+    // Stream every step to a file instead of keeping the whole run in memory. Read it back with StreamedOdeData.
+    void SetStreamFilePath(const std::string& filePath) { m_streamFilePath = filePath; }
+
+    // Sample the trajectory every sampleDegrees of rotation, interpolated from the solver's
+    // dense output, instead of at the end of each step. Zero, the default, samples the steps.
+    void SetSampleDegrees(double sampleDegrees) { m_sampleDegrees = sampleDegrees; }
+
+    // Events, passed on to BetatronEquations. Stopping at a rotation runs for as long as it
+    // takes to get there, whatever the number of rotations.
+    void SetRecordRotations(bool recordRotations) { m_recordRotations = recordRotations; }
+    void SetStopAtRotation(int rotation) { m_stopAtRotation = rotation; }
+    void SetRadiusBand(double minRadius, double maxRadius) { m_minRadius = minRadius; m_maxRadius = maxRadius; }
     
     void Initialize();
     void Run();
 
     boost::shared_ptr<OdeData> GetOdeData() { return m_odeData; }
+    boost::shared_ptr<BetatronEquations> GetEquations() { return m_equations; }
+    boost::shared_ptr<OdeSolver> GetOdeSolver() { return m_solver; }
+
+    // Calls to BetatronEquations::Evaluate made by the last Run.
+    int GetIterationCount() const { return m_iterationCount; }
+
+    // What the solver did in the last Run, which is also added to OdeSolverMetrics. Its
+    // solver name is the method's name in a request.
+    boost::shared_ptr<OdeSolverTelemetry> GetTelemetry() { return m_telemetry; }
+    static const char* GetOdeMethodName(OdeMethod odeMethod);
 
   protected:
     BetatronEquationSolver();
@@ -52,8 +104,9 @@ namespace Bach {
 
     boost::shared_ptr<BetatronEquations> m_equations;
     boost::shared_ptr<BetatronFieldController> m_fieldController;
-    boost::shared_ptr<BaderDeuflhardOde> m_solver;
+    boost::shared_ptr<OdeSolver> m_solver;
     boost::shared_ptr<OdeData> m_odeData;
+    boost::shared_ptr<OdeSolverTelemetry> m_telemetry;
     double m_startTime;
     double m_endTime;
     double m_magneticFieldMagnitude;
@@ -63,7 +116,17 @@ namespace Bach {
     Eigen::VectorXd m_initialPosition;
     Eigen::VectorXd m_initialVelocity;
     double m_stepSize;
+    double m_secondsPerRotation;
+    double m_sampleDegrees;
+    bool m_recordRotations;
+    int m_stopAtRotation;
+    double m_minRadius;
+    double m_maxRadius;
     int m_iterationCount;
+    JacobianMethod m_jacobianMethod;
+    OdeMethod m_odeMethod;
+    double m_tolerance;
+    std::string m_streamFilePath;
   };
 };
 
@@ -40,7 +40,12 @@ BetatronEquations::BetatronEquations() :
   m_forceDueTodBdt(0.0, 0.0, 0.0),
   m_iterationCount(0),
   m_magneticField(new PointMagneticField),
-  m_internalValues(5) {  // B, dBdt, velocity, distance from origin, angle
+  m_internalValues(5),  // B, dBdt, velocity, distance from origin, angle
+  m_recordRotations(false),
+  m_stopAtRotation(0),
+  m_rotationCount(0),
+  m_minRadius(0.0),
+  m_maxRadius(0.0) {
   // y[0] = x position
   // y[1] = y position
   // y[2] = z position
@@ -54,8 +59,16 @@ BetatronEquations::BetatronEquations() :
 BetatronEquations::~BetatronEquations() {
 }
 
+shared_ptr<Bach::OdeEquations> BetatronEquations::Clone() const {
+  shared_ptr<BetatronEquations> clone(new BetatronEquations(*this));
+  clone->m_weakThis = clone;
+  clone->m_magneticField = shared_ptr<PointMagneticField>(new PointMagneticField(*m_magneticField));
+  return clone;
+}
+
 void BetatronEquations::Initialize(shared_ptr<Bach::OdeData> odeData) {
   m_iterationCount = 0;
+  m_rotationCount = 0;
 
   odeData->GetCollector()->InitializeWithSizes(6, 5);
 
@@ -104,39 +117,21 @@ void BetatronEquations::Evaluate(double time, const Eigen::VectorXd& y, Eigen::V
 
   m_iterationCount++;
 
-  m_position[0] = y[0];
-  m_position[1] = y[1];
-  m_position[2] = y[2];
-
-  double rotationalPosition = 0.0;
-  double rotationalAngle = atan2(y[1], y[0]);
-  if(rotationalAngle < 0.0) {
-    rotationalAngle = 2.0*NXGR_PI+rotationalAngle;
-  }
-  rotationalPosition = rotationalAngle/(2.0*NXGR_PI);
-  m_fieldController->GetField(time, m_position, m_magneticField);
-
-  Log(L"RotaationalPos: %f y,x = %f, %f      B = %e", rotationalPosition, y[1], y[0], m_charge*m_magneticField->B());
-
-  m_velocity[0] = y[3];
-  m_velocity[1] = y[4];
-  m_velocity[2] = y[5];
+  EvaluateT(time, y, dydt);
 
-  m_forceDueToB = m_velocity.cross(m_magneticField->UnitVectorB())*m_charge*m_magneticField->B()*Bach::ELECTRIC_CHARGE;
-
-  m_forceDueTodBdt = m_magneticField->UnitVectorB().cross(m_magneticField->dDelBdt());
-  
-  double massInv = 1.0/m_mass;
+  // Compiled out, with its arguments, unless the log level is trace.
+  BACH_LOG_TRACE(L"Rotational position: %f y,x = %f, %f      B = %e", atan2(y[1], y[0])/(2.0*NXGR_PI), y[1], y[0], m_charge*m_magneticField->B());
 
-  dydt[0] = y[3];
-  dydt[1] = y[4];
-  dydt[2] = y[5];
+  if(odeData->StoringThisCall()) {
+    m_velocity[0] = y[3];
+    m_velocity[1] = y[4];
+    m_velocity[2] = y[5];
 
-  dydt[3] = m_forceDueToB[0]*massInv;
-  dydt[4] = m_forceDueToB[1]*massInv;
-  dydt[5] = m_forceDueToB[2]*massInv;
+    double rotationalAngle = atan2(y[1], y[0]);
+    if(rotationalAngle < 0.0) {
+      rotationalAngle = 2.0*NXGR_PI+rotationalAngle;
+    }
 
-  if(odeData->StoringThisCall()) {
     m_internalValues[0] = m_magneticField->B();
     m_internalValues[1] = m_magneticField->dBdt();
     m_internalValues[2] = m_velocity.norm();
@@ -146,3 +141,77 @@ void BetatronEquations::Evaluate(double time, const Eigen::VectorXd& y, Eigen::V
     odeData->SetInternalValues(m_internalValues);
   }
 }
+
+void BetatronEquations::SetRecordRotations(bool recordRotations) {
+  m_recordRotations = recordRotations;
+  UpdateEvents();
+}
+
+void BetatronEquations::SetStopAtRotation(int rotation) {
+  m_stopAtRotation = rotation;
+  UpdateEvents();
+}
+
+void BetatronEquations::SetRadiusBand(double minRadius, double maxRadius) {
+  if(minRadius < 0.0 || maxRadius <= minRadius) {
+    BACH_LOG_ERROR(L"BetatronEquations::SetRadiusBand: The band from %e to %e is empty", minRadius, maxRadius);
+    throw std::exception();
+  }
+  m_minRadius = minRadius;
+  m_maxRadius = maxRadius;
+  UpdateEvents();
+}
+
+void BetatronEquations::UpdateEvents() {
+  m_events.clear();
+  if(m_recordRotations || m_stopAtRotation > 0) {
+    m_events.push_back(RotationEvent);
+  }
+  if(m_maxRadius > 0.0) {
+    m_events.push_back(InnerRadiusEvent);
+    m_events.push_back(OuterRadiusEvent);
+  }
+}
+
+void BetatronEquations::EvaluateEvents(double time, const Eigen::VectorXd& y, Eigen::VectorXd& g) {
+  double radius = sqrt(Square(y[0])+Square(y[1])+Square(y[2]));
+  for(size_t i=0; i<m_events.size(); i++) {
+    switch(m_events[i]) {
+      case RotationEvent : {
+        // An electron in a field along +z orbits counter clockwise, so y only rises through
+        // zero on the positive x axis.
+        g[i] = y[1];
+        break;
+      }
+      case InnerRadiusEvent : {
+        g[i] = m_minRadius-radius;
+        break;
+      }
+      case OuterRadiusEvent : {
+        g[i] = radius-m_maxRadius;
+        break;
+      }
+    }
+  }
+}
+
+std::string BetatronEquations::GetEventName(int index) const {
+  switch(m_events[index]) {
+    case RotationEvent :    return "rotation";
+    case InnerRadiusEvent : return "inside radius band";
+    case OuterRadiusEvent : return "outside radius band";
+  }
+  return "";
+}
+
+OdeEquations::EventAction BetatronEquations::HandleEvent(int index, double time, const Eigen::VectorXd& y, shared_ptr<Bach::OdeData> odeData) {
+  if(m_events[index] != RotationEvent) {
+    return StopAtEvent;
+  }
+
+  m_rotationCount++;
+  if(m_stopAtRotation > 0 && m_rotationCount >= m_stopAtRotation) {
+    return StopAtEvent;
+  }
+  return ContinueAtEvent;
+}
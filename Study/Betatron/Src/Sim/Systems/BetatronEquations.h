@@ -16,6 +16,8 @@ All Rights Reserved.
 #define __BACH_BETATRON_EQUATIONS_H__
 
 #include "OdeEquations.h"
+#include "AutoDiffOdeEquations.h"
+#include "OdeEquationsN.h"
 #include "BetatronFieldController.h"
 #include <vector>
 
@@ -25,7 +27,7 @@ namespace Bach {
   //* BetatronEquations *
   //*********************
   
-  class BetatronEquations : public Bach::OdeEquations {
+  class BetatronEquations : public Bach::OdeEquations, public AutoDiffOdeEquationsT<BetatronEquations>, public OdeEquationsN<6, BetatronEquations> {
   public:
   
     static boost::shared_ptr<BetatronEquations> CreateInstance();
@@ -34,6 +36,10 @@ namespace Bach {
     
     double GetCharge() { return m_charge; }
     double GetMass()   { return m_mass; }
+    boost::shared_ptr<BetatronFieldController> GetFieldController() { return m_fieldController; }
+
+    // Number of calls to Evaluate since Initialize.
+    int GetIterationCount() const { return m_iterationCount; }
     
     virtual void SetFieldController(boost::shared_ptr<BetatronFieldController> fieldController) { m_fieldController = fieldController; }
     virtual void SetCharge(double q) { m_charge = q; }
@@ -42,8 +48,102 @@ namespace Bach {
     virtual void Initialize(boost::shared_ptr<Bach::OdeData> odeData);
     virtual void Evaluate(double time, const Eigen::VectorXd& y, Eigen::VectorXd& dydt, boost::shared_ptr<Bach::OdeData> odeData);
 
+    // Shares the field controller, which only reads, and has its own field to fill in. The
+    // copy's evaluations aren't in this one's iteration count.
+    virtual boost::shared_ptr<Bach::OdeEquations> Clone() const;
+
+    // Events, none by default. A rotation is counted each time the charge crosses the positive
+    // x axis, where it starts, and the integration can be stopped at a given one. Leaving the
+    // band of radii between minRadius and maxRadius stops the integration.
+    void SetRecordRotations(bool recordRotations);
+    void SetStopAtRotation(int rotation);
+    void SetRadiusBand(double minRadius, double maxRadius);
+
+    // Rotations completed since Initialize.
+    int GetRotationCount() const { return m_rotationCount; }
+
+    virtual int GetNumberOfEvents() const { return (int) m_events.size(); }
+    virtual void EvaluateEvents(double time, const Eigen::VectorXd& y, Eigen::VectorXd& g);
+    virtual EventDirection GetEventDirection(int index) const { return EventRising; }
+    virtual std::string GetEventName(int index) const;
+    virtual EventAction HandleEvent(int index, double time, const Eigen::VectorXd& y, boost::shared_ptr<Bach::OdeData> odeData);
+
+    // The equations of motion for both doubles and the dual numbers of automatic differentiation.
+    // The field is uniform in space, so B only carries a derivative with respect to time.
+    template<class Scalar, class Vector>
+    void EvaluateT(const Scalar& time, const Vector& y, Vector& dydt) {
+      m_position[0] = ValueOf(y[0]);
+      m_position[1] = ValueOf(y[1]);
+      m_position[2] = ValueOf(y[2]);
+      m_fieldController->GetField(ValueOf(time), m_position, m_magneticField);
+
+      Scalar B = Chain(time, m_magneticField->B(), m_magneticField->dBdt());
+      const Eigen::Vector3d& u = m_magneticField->UnitVectorB();
+      double massInv = 1.0/m_mass;
+
+      dydt[0] = y[3];
+      dydt[1] = y[4];
+      dydt[2] = y[5];
+
+      // F = q e v x B
+      dydt[3] = (y[4]*u[2]-y[5]*u[1])*m_charge*B*Bach::ELECTRIC_CHARGE*massInv;
+      dydt[4] = (y[5]*u[0]-y[3]*u[2])*m_charge*B*Bach::ELECTRIC_CHARGE*massInv;
+      dydt[5] = (y[3]*u[1]-y[4]*u[0])*m_charge*B*Bach::ELECTRIC_CHARGE*massInv;
+    }
+
+    // The closed form Jacobian, used by BetatronDerivatives and BaderDeuflhardOdeN. The field
+    // from BetatronFieldController is uniform in space, so the accelerations depend on the
+    // velocities and time only.
+    template<class Vector, class Matrix>
+    void GetDerivativesT(double time, const Vector& y, Vector& dfdx, Matrix& dfdy) {
+      m_position = y.template segment<3>(0);
+      m_velocity = y.template segment<3>(3);
+      m_fieldController->GetField(time, m_position, m_magneticField);
+
+      // EvaluateT gives
+      //   dr/dt = v
+      //   dv/dt = c(t) v x u,  c(t) = q e B(t)/m
+      // where u is the unit vector of the field.
+      const Eigen::Vector3d& u = m_magneticField->UnitVectorB();
+      double qeOverM = m_charge*Bach::ELECTRIC_CHARGE/m_mass;
+      double c = qeOverM*m_magneticField->B();
+      double dcdt = qeOverM*m_magneticField->dBdt();
+
+      // The only explicit time dependence is through B(t).
+      dfdx.template head<3>().setZero();
+      dfdx.template tail<3>() = dcdt*m_velocity.cross(u);
+
+      // d(v x u)/dv is the cross product matrix of u, negated.
+      dfdy.setZero();
+      dfdy.template block<3,3>(0, 3).setIdentity();
+      dfdy(3, 4) =  c*u(2);
+      dfdy(3, 5) = -c*u(1);
+      dfdy(4, 3) = -c*u(2);
+      dfdy(4, 5) =  c*u(0);
+      dfdy(5, 3) =  c*u(1);
+      dfdy(5, 4) = -c*u(0);
+    }
+
+    // The fixed size interface for BaderDeuflhardOdeN.
+    void EvaluateN(double time, const VectorN& y, VectorN& dydt) {
+      m_iterationCount++;
+      EvaluateT(time, y, dydt);
+    }
+
+    void GetDerivativesN(double time, const VectorN& y, VectorN& dfdx, MatrixN& dfdy) {
+      GetDerivativesT(time, y, dfdx, dfdy);
+    }
+
   protected:
     BetatronEquations();
+
+    enum BetatronEvent {
+      RotationEvent,
+      InnerRadiusEvent,
+      OuterRadiusEvent
+    };
+
+    void UpdateEvents();
     
     boost::weak_ptr<BetatronEquations> m_weakThis;
 
@@ -57,6 +157,13 @@ namespace Bach {
     Eigen::Vector3d m_forceDueTodBdt;
     Eigen::VectorXd m_internalValues;
     int m_iterationCount;
+
+    bool m_recordRotations;
+    int m_stopAtRotation;   // Zero to never stop.
+    int m_rotationCount;
+    double m_minRadius;
+    double m_maxRadius;     // Zero for no band.
+    std::vector<BetatronEvent> m_events;
   };
 };
 
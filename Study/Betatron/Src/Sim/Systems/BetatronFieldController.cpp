@@ -58,7 +58,7 @@ void BetatronFieldController::GetField(
       double totalB = m_constantB*(1.0+m_fractionalIncreaseBPerSecond*t);
       field->SetDirection(m_directionOfConstantB);
       field->SetB(totalB);
-      field->SetdBdt(0.0);
+      field->SetdBdt(m_constantB*m_fractionalIncreaseBPerSecond);
       field->SetdDelBdt(Eigen::Vector3d(0.0, 0.0, 0.0));
       break;
     }
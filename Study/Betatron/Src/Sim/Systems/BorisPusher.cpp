@@ -0,0 +1,143 @@
+/**********************************************************************
+
+File     : BorisPusher.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the Boris particle pusher for a charge in a betatron.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BorisPusher.h"
+#include "BetatronEquations.h"
+#include "OdeData.h"
+#include "OdeSolverTelemetry.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+  //***************
+  //* BorisPusher *
+  //***************
+
+shared_ptr<BorisPusher> BorisPusher::CreateInstance() {
+  shared_ptr<BorisPusher> instance(new BorisPusher());
+  instance->m_weakThis = instance;
+  return instance;
+}
+
+BorisPusher::BorisPusher() :
+  m_relativistic(false),
+  m_stepsPerSample(1),
+  m_numberOfSteps(0),
+  m_magneticField(new PointMagneticField),
+  m_y(6),
+  m_dydx(6)
+{
+  m_stepSize = 0.001;
+}
+
+BorisPusher::~BorisPusher() {
+}
+
+void BorisPusher::Solve(shared_ptr<OdeData> odeData, bool reset) {
+  shared_ptr<BetatronEquations> equations = dynamic_pointer_cast<BetatronEquations>(odeData->GetOdeSystem());
+  if(!equations) {
+    BACH_LOG_ERROR(L"BorisPusher::Solve: Only a BetatronEquations system can be pushed");
+    throw std::exception();
+  }
+  if(odeData->WantsDenseOutput() || equations->GetNumberOfEvents() > 0) {
+    BACH_LOG_ERROR(L"BorisPusher::Solve: There is no dense output for grid sampling or events");
+    throw std::exception();
+  }
+  if(m_stepSize == 0.0 || m_stepsPerSample < 1) {
+    BACH_LOG_ERROR(L"BorisPusher::Solve: The step size is %e and steps per sample %d", m_stepSize, m_stepsPerSample);
+    throw std::exception();
+  }
+
+  if(reset) {
+    odeData->ResetStorage();
+    if(m_telemetry) {
+      m_telemetry->Reset();
+    }
+  }
+
+  shared_ptr<BetatronFieldController> fieldController = equations->GetFieldController();
+  double qeOverM = equations->GetCharge()*Bach::ELECTRIC_CHARGE/equations->GetMass();
+
+  double start = odeData->GetStartTime();
+  double end = odeData->GetEndTime();
+  long numberOfSteps = (long) ceil(fabs(end-start)/fabs(m_stepSize)-1.0e-9);
+  if(numberOfSteps < 1) {
+    numberOfSteps = 1;
+  }
+  double h = (end-start)/numberOfSteps;
+  double halfStep = 0.5*h;
+
+  VectorXd initialConditions = odeData->GetInitialConditions();
+  m_position = initialConditions.segment<3>(0);
+  m_momentum = initialConditions.segment<3>(3);
+  double gamma = 1.0;
+  if(m_relativistic) {
+    double speedSquared = m_momentum.squaredNorm();
+    if(speedSquared >= Bach::SPEED_OF_LIGHT_SQUARED) {
+      BACH_LOG_ERROR(L"BorisPusher::Solve: The speed %e is not below the speed of light", sqrt(speedSquared));
+      throw std::exception();
+    }
+    gamma = 1.0/sqrt(1.0-speedSquared/Bach::SPEED_OF_LIGHT_SQUARED);
+    m_momentum *= gamma;
+  }
+
+  m_numberOfSteps = 0;
+  odeData->SetStopFlag(false);
+  StoreSample(start, gamma, odeData);
+
+  Vector3d halfTurn;
+  Vector3d turn;
+  Vector3d momentumHalfTurned;
+  for(long i=0; i<numberOfSteps; i++) {
+    double t = start+i*h;
+
+    // Drift to the middle of the step.
+    m_position += (halfStep/gamma)*m_momentum;
+    fieldController->GetField(t+halfStep, m_position, m_magneticField);
+
+    // Turn the momentum about the field, by tan(theta/2) = |halfTurn| with theta the angle the
+    // charge turns through in the step.
+    halfTurn = (qeOverM*m_magneticField->B()*halfStep/gamma)*m_magneticField->UnitVectorB();
+    turn = (2.0/(1.0+halfTurn.squaredNorm()))*halfTurn;
+    momentumHalfTurned = m_momentum+m_momentum.cross(halfTurn);
+    m_momentum += momentumHalfTurned.cross(turn);
+
+    // With no electric field gamma is unchanged, so the second drift is at the same speed.
+    m_position += (halfStep/gamma)*m_momentum;
+    m_numberOfSteps++;
+    if(m_telemetry) {
+      m_telemetry->CountAcceptedStep();
+    }
+
+    if((i+1) % m_stepsPerSample == 0 || i+1 == numberOfSteps) {
+      StoreSample(i+1 == numberOfSteps ? end : t+h, gamma, odeData);
+      if(odeData->GetStopFlag()) {
+        break;
+      }
+    }
+  }
+}
+
+void BorisPusher::StoreSample(double t, double gamma, shared_ptr<OdeData> odeData) {
+  m_y.segment<3>(0) = m_position;
+  m_y.segment<3>(3) = m_momentum/gamma;
+
+  odeData->SetStoringThisCall(true);
+  EvaluateSystem(odeData->GetOdeSystem(), t, m_y, m_dydx, odeData);
+  odeData->SetStoringThisCall(false);
+
+  // Evaluate gives the non-relativistic acceleration.
+  m_dydx.segment<3>(3) /= gamma;
+  StoreData(odeData, t, m_y, m_dydx);
+}
@@ -0,0 +1,89 @@
+/**********************************************************************
+
+File     : BorisPusher.h
+Project  : Bach Simulation
+Purpose  : Header file for the Boris particle pusher for a charge in a betatron.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           A fixed step integrator for BetatronEquations that takes the field
+           straight from BetatronFieldController::GetField rather than
+           through Evaluate. Each step drifts the position half a step, turns
+           the velocity about the field at the middle of the step and drifts
+           the other half. The turn is the Boris rotation, which keeps the
+           speed, and so the energy, to rounding error and is volume
+           preserving, so the radius of an orbit doesn't drift however many
+           rotations are run. It is second order; the error shows as a small
+           lag in the phase of the orbit.
+
+           The relativistic variant turns the momentum per unit rest mass,
+           u = gamma v, with the frequency divided by gamma. In a magnetic
+           field alone gamma doesn't change, so the orbit is the same as the
+           non-relativistic one at gamma times the mass. The derivatives
+           stored with each sample are divided by gamma to match.
+
+           See Birdsall and Langdon, Plasma Physics via Computer Simulation,
+           section 4-4, and Qin et al, Physics of Plasmas 20, 084503 (2013).
+
+           Samples are stored every stepsPerSample steps and at the end, with
+           the derivatives and internal values from BetatronEquations::Evaluate.
+           There is no dense output, so grid sampling and events aren't
+           supported.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_BORIS_PUSHER_H__
+#define __BACH_BORIS_PUSHER_H__
+
+#include "BachDefs.h"
+#include "OdeSolver.h"
+#include "BetatronFieldController.h"
+
+namespace Bach {
+
+  //***************
+  //* BorisPusher *
+  //***************
+
+  class BorisPusher : public OdeSolver {
+  public:
+    static boost::shared_ptr<BorisPusher> CreateInstance();
+    virtual ~BorisPusher();
+
+    // Integrates a BetatronEquations system. The step size is fixed, shortened a little if need
+    // be so a whole number of steps reaches the end time.
+    void Solve(boost::shared_ptr<OdeData> odeData, bool reset = true);
+
+    virtual bool AccuracySpecRequired() { return false; }
+
+    void SetRelativistic(bool relativistic)    {  m_relativistic = relativistic;  }
+    void SetStepsPerSample(int stepsPerSample) {  m_stepsPerSample = stepsPerSample;  }
+
+    // Every step is taken at its size.
+    int GetNumberGood()       {  return m_numberOfSteps;  }
+    int GetNumberRetried()    {  return 0;  }
+
+  protected:
+    BorisPusher();
+
+    // Store the state at the end of a step, with the velocity from the momentum.
+    void StoreSample(double t, double gamma, boost::shared_ptr<OdeData> odeData);
+
+    boost::weak_ptr<BorisPusher> m_weakThis;
+
+    bool m_relativistic;
+    int m_stepsPerSample;
+    int m_numberOfSteps;
+
+    boost::shared_ptr<PointMagneticField> m_magneticField;
+    Eigen::Vector3d m_position;
+    Eigen::Vector3d m_momentum; // Per unit rest mass, which is the velocity when not relativistic.
+
+    Eigen::VectorXd m_y;
+    Eigen::VectorXd m_dydx;
+  };
+};
+
+#endif // __BACH_BORIS_PUSHER_H__
@@ -47,7 +47,7 @@ void DipoleMomentFinder::Solve(Real yOffset) {
   Real momentSumAboutX = 0.0;
   Real momentSumAboutY = 0.0;
   
-  LogPlain(L"Y Offset = %f", yOffset*METERS_TO_PICOMETERS);
+  BACH_LOG_INFO(L"Y Offset = %f", yOffset*METERS_TO_PICOMETERS);
 
   shared_ptr<Atom> atom;
   shared_ptr<SpOrbital> orbital;
@@ -64,7 +64,7 @@ void DipoleMomentFinder::Solve(Real yOffset) {
     Real y = position(1)+yOffset;
     momentSumAboutX += y*charge;
     momentSumAboutY += x*charge;
-    LogPlain(L"Atom[%d] mX=%f (%f pm x %f charge)", i, (y*charge)*ELECTRIC_CHARGE*COULOMB_METERS_TO_DEBYES, y*METERS_TO_PICOMETERS, charge);
+    BACH_LOG_INFO(L"Atom[%d] mX=%f (%f pm x %f charge)", i, (y*charge)*ELECTRIC_CHARGE*COULOMB_METERS_TO_DEBYES, y*METERS_TO_PICOMETERS, charge);
     
     for(Integer j=0; j<atom->GetNumSpOrbitals(); j++) {
       orbital = atom->GetSpOrbitalByIndex(j);
@@ -77,7 +77,7 @@ void DipoleMomentFinder::Solve(Real yOffset) {
       y = position(1)+yOffset;
       momentSumAboutX += y*charge;
       momentSumAboutY += x*charge;
-      LogPlain(L"SP Orbital[%d,%d] mX=%f (%f pm x %f charge)", i, j, (y*charge)*ELECTRIC_CHARGE*COULOMB_METERS_TO_DEBYES, y*METERS_TO_PICOMETERS, charge);
+      BACH_LOG_INFO(L"SP Orbital[%d,%d] mX=%f (%f pm x %f charge)", i, j, (y*charge)*ELECTRIC_CHARGE*COULOMB_METERS_TO_DEBYES, y*METERS_TO_PICOMETERS, charge);
     }
   }
   
@@ -93,7 +93,7 @@ void DipoleMomentFinder::Solve(Real yOffset) {
     Real y = position(1)+yOffset;
     momentSumAboutX += y*charge;
     momentSumAboutY += x*charge;
-    LogPlain(L"Bond[%d] mX=%f (%f pm x %f charge)", i, (y*charge)*ELECTRIC_CHARGE*COULOMB_METERS_TO_DEBYES, y*METERS_TO_PICOMETERS, charge);
+    BACH_LOG_INFO(L"Bond[%d] mX=%f (%f pm x %f charge)", i, (y*charge)*ELECTRIC_CHARGE*COULOMB_METERS_TO_DEBYES, y*METERS_TO_PICOMETERS, charge);
   }
 
   m_forceZ = forceSum*ELECTRIC_CHARGE;
@@ -105,7 +105,7 @@ Eigen::VectorXd MoleculeAccelSolverEquations::FindFunctionValues(const Eigen::Ve
   for(Integer i=0; i<numBonds; i++) {
     shared_ptr<Bond> bond = m_molecule->GetBondByIndex(i);
     Real remainder = bond->GetAccelEquationRemainder(shared_ptr<ForceVectors>());
-    Log(L"*** FindFunctionValues: Remainder[%d] = %e", i, remainder);
+    BACH_LOG_TRACE(L"*** FindFunctionValues: Remainder[%d] = %e", i, remainder);
     roots(i) = remainder;
   }
   
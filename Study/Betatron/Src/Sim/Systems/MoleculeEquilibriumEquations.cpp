@@ -20,6 +20,7 @@ All Rights Reserved.
 #include "RiddersExtrapolation.h"
 #include "Jacobian.h"
 #include "ForceVectors.h"
+#include "WorkStealingPool.h"
 
 using namespace Bach;
 using namespace boost;
@@ -40,7 +41,7 @@ shared_ptr<MoleculeEquilibriumEquations> MoleculeEquilibriumEquations::CreateIns
   return instance;
 }
 
-MoleculeEquilibriumEquations::MoleculeEquilibriumEquations(shared_ptr<Molecule> molecule) : m_molecule(molecule), m_tolerance(BachConst::DefaultMoleculeSystemSolverTolerance) {
+MoleculeEquilibriumEquations::MoleculeEquilibriumEquations(shared_ptr<Molecule> molecule) : m_molecule(molecule), m_tolerance(BachConst::DefaultMoleculeSystemSolverTolerance), m_numClonesTaken(0) {
 }
 
 MoleculeEquilibriumEquations::~MoleculeEquilibriumEquations() {
@@ -65,26 +66,50 @@ void MoleculeEquilibriumEquations::Initialize() {
   m_stepSizes.fill(Bach::CHARACTERISTIC_BOND_DISTANCE_UNIT);
 }
 
+shared_ptr<MoleculeEquilibriumEquations> MoleculeEquilibriumEquations::Clone() {
+  // The tolerance and step sizes are the defaults Initialize sets.
+  return CreateInstance(m_molecule->Clone());
+}
+
+void MoleculeEquilibriumEquations::SetPool(shared_ptr<WorkStealingPool> pool) {
+  m_jacobian->SetPool(pool);
+}
+
+shared_ptr<MoleculeEquilibriumEquations> MoleculeEquilibriumEquations::TakeClone() {
+  std::lock_guard<std::mutex> lock(m_clonesMutex);
+  if(m_numClonesTaken == m_clones.size()) {
+    m_clones.push_back(Clone());
+  }
+  return m_clones[m_numClonesTaken++];
+}
+
+void MoleculeEquilibriumEquations::ReturnClones() {
+  std::lock_guard<std::mutex> lock(m_clonesMutex);
+  m_numClonesTaken = 0;
+}
+
 Eigen::VectorXd MoleculeEquilibriumEquations::GetEquationValues(const Eigen::VectorXd& position) {
-Log(L"GETTING FUNCTION VALUES*****");
+BACH_LOG_TRACE(L"GETTING FUNCTION VALUES*****");
   Eigen::VectorXd remainder = FindFunctionValues(position, shared_ptr<ForceVectorsList>());
   return remainder;
 }
 
 Eigen::MatrixXd MoleculeEquilibriumEquations::GetJacobian(const Eigen::VectorXd& position) {
-Log(L"GETTING JACOBIAN*****");
-  m_jacobian->Start(position, m_stepSizes);
+BACH_LOG_TRACE(L"GETTING JACOBIAN*****");
+  // Without a pool the columns are found in turn on this molecule, and with one each
+  // thread's function evaluates a copy of its own. Find drops the functions before it
+  // returns, so the copies can all be handed out again on the next call.
+  ReturnClones();
+  m_jacobian->Find(position, m_stepSizes,
+    [this](const VectorXd& y, VectorXd& f) { f = FindFunctionValues(y, shared_ptr<ForceVectorsList>()); },
+    [this]() {
+      shared_ptr<MoleculeEquilibriumEquations> clone = TakeClone();
+      return Jacobian::Function([clone](const VectorXd& y, VectorXd& f) { f = clone->FindFunctionValues(y, shared_ptr<ForceVectorsList>()); });
+    });
 
-  Eigen::VectorXd tempRemainders(m_molecule->GetNumBonds());
-  
-  while(!m_jacobian->GetIsFinished()) {
-    tempRemainders = FindFunctionValues(m_jacobian->GetNewValue(), shared_ptr<ForceVectorsList>());
-    m_jacobian->SetFunctionValues(tempRemainders);
-  }
-  
   Eigen::MatrixXd dRemainderdPosition = m_jacobian->GetDerivatives();
-  Log(L"DDD derivs: %s", ToString(dRemainderdPosition.array()*(METERS_TO_PICOMETERS/NEWTONS_TO_NANONEWTONS)).c_str());
-  Log(L"EXIT EQUATIONS*****");
+  BACH_LOG_TRACE(L"DDD derivs: %s", ToString(dRemainderdPosition.array()*(METERS_TO_PICOMETERS/NEWTONS_TO_NANONEWTONS)).c_str());
+  BACH_LOG_TRACE(L"EXIT EQUATIONS*****");
   return dRemainderdPosition;
 }
 
@@ -98,7 +123,7 @@ Log(L"GETTING JACOBIAN*****");
 //    bond is the centering force of the bond
 
 Eigen::VectorXd MoleculeEquilibriumEquations::FindFunctionValues(const Eigen::VectorXd& positions, shared_ptr<ForceVectorsList> forceVectorStorageList) {
-LogPlain(L"* Positions to Try (pm): %s", ToString(positions.array()*METERS_TO_PICOMETERS).c_str());
+BACH_LOG_TRACE(L"* Positions to Try (pm): %s", ToString(positions.array()*METERS_TO_PICOMETERS).c_str());
 
   m_moleculeValues->SetLinearPos(positions);
 
@@ -121,7 +146,7 @@ LogPlain(L"* Positions to Try (pm): %s", ToString(positions.array()*METERS_TO_PI
     }
 
     Real remainder = bond->GetEquilibriumEquationRemainder(forceVectorStorage);
-    Log(L"Remainder[%d] (nN): %e", i, remainder*NEWTONS_TO_NANONEWTONS);
+    BACH_LOG_TRACE(L"Remainder[%d] (nN): %e", i, remainder*NEWTONS_TO_NANONEWTONS);
     roots(i) = remainder;
   }
   
@@ -6,6 +6,9 @@ Purpose  : Header file for a system of equations for solver for equilibrium posi
 Revisions: Original definition by Lawrence Gunn.
            2013/11/09
 
+           With a pool, GetJacobian finds the columns at once, each on a
+           copy of the equations over a copy of the molecule.
+           2026/10/18
 
 Copyright (c) 2013 by Lawrence Gunn
 All Rights Reserved.
@@ -16,6 +19,8 @@ All Rights Reserved.
 #define __BACH_MOLECULE_EQUILIBRIUM_EQUATIONS_H__
 
 #include "RootSolverEquations.h"
+#include <mutex>
+#include <vector>
 
 namespace Bach {
 
@@ -23,6 +28,7 @@ namespace Bach {
   class MoleculeValues;
   class Jacobian;
   class ForceVectorsList;
+  class WorkStealingPool;
 
   //********************************
   //* MoleculeEquilibriumEquations *
@@ -38,6 +44,12 @@ namespace Bach {
     boost::shared_ptr<Molecule> GetMolecule() { return m_molecule; }
     
     Eigen::VectorXd FindFunctionValues(const Eigen::VectorXd& positions, boost::shared_ptr<ForceVectorsList> forceVectorsStorageList);
+
+    // Equations over a copy of the molecule, which can be evaluated while these are.
+    boost::shared_ptr<MoleculeEquilibriumEquations> Clone();
+
+    // Find the columns of the Jacobian at once on pool.
+    void SetPool(boost::shared_ptr<WorkStealingPool> pool);
     
     // *** RootSolverEquations functions ***
     virtual void Initialize();
@@ -50,6 +62,11 @@ namespace Bach {
     
   protected:
     MoleculeEquilibriumEquations(boost::shared_ptr<Molecule> molecule);
+
+    // A copy for one of the functions Jacobian::Find asks for, different from those taken
+    // since the last ReturnClones, which makes them all free to take again.
+    boost::shared_ptr<MoleculeEquilibriumEquations> TakeClone();
+    void ReturnClones();
     
     boost::weak_ptr<MoleculeEquilibriumEquations> m_weakThis;
     boost::shared_ptr<Molecule> m_molecule;
@@ -61,6 +78,12 @@ namespace Bach {
 
     Eigen::VectorXd m_stepSizes;
     Real m_tolerance;
+
+    // Kept between calls to GetJacobian, as a molecule is costly to copy and its parts refer to
+    // each other, so a copy is never freed.
+    std::mutex m_clonesMutex;
+    std::vector< boost::shared_ptr<MoleculeEquilibriumEquations> > m_clones;
+    size_t m_numClonesTaken;
   };
 };
 
@@ -63,6 +63,10 @@ void MoleculeEquilibriumSolver::Initialize() {
   m_equilibriumEquations = MoleculeEquilibriumEquations::CreateInstance(m_molecule);
 }
 
+void MoleculeEquilibriumSolver::SetPool(shared_ptr<WorkStealingPool> pool) {
+  m_equilibriumEquations->SetPool(pool);
+}
+
 Eigen::VectorXd MoleculeEquilibriumSolver::PositionAndSolve() {
   shared_ptr<MoleculeValues> values = MoleculeValues::CreateInstance(m_molecule);
 
@@ -6,6 +6,8 @@ Purpose  : Header file for a molecule equilibrium solver - solve for x where v,a
 Revisions: Original definition by Lawrence Gunn.
            2013/11/07
 
+           SetPool finds the Jacobian of the equations on a pool.
+           2026/10/18
 
 Copyright (c) 2013 by Lawrence Gunn
 All Rights Reserved.
@@ -22,6 +24,7 @@ namespace Bach {
   class Molecule;
   class MoleculeEquilibriumEquations;
   class NDimNewtonRaphson;
+  class WorkStealingPool;
 
   //*****************************
   //* MoleculeEquilibriumSolver *
@@ -36,6 +39,9 @@ namespace Bach {
 
     boost::shared_ptr<Molecule> GetMolecule() { return m_molecule; }
     boost::shared_ptr<MoleculeEquilibriumEquations> GetEquilibriumEquations() { return m_equilibriumEquations; }
+
+    // Find the columns of each Jacobian at once on pool.
+    void SetPool(boost::shared_ptr<WorkStealingPool> pool);
     
     // *** RootSolverEquations functions ***
     Eigen::VectorXd PositionAndSolve(); // Ensure that all electrons are situated at the middle of all of the bonds.
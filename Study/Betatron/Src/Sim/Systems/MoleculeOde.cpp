@@ -15,6 +15,8 @@ All Rights Reserved.
 #include "Molecule.h"
 #include "Bond.h"
 #include "BondElectrons.h"
+#include "BondForce.h"
+#include <sstream>
 #include "OdeData.h"
 
 using namespace Bach;
@@ -50,7 +52,7 @@ void MoleculeOde::Initialize(shared_ptr<Bach::OdeData> odeData) {
 void MoleculeOde::Evaluate(double time, const Eigen::VectorXd& y, Eigen::VectorXd& dydt, shared_ptr<Bach::OdeData> odeData) {
 /*
   count++;
-  LogPlain(L"Iteration %d", count);
+  BACH_LOG_TRACE(L"Iteration %d", count);
   shared_ptr<Bond> bond;
   shared_ptr<BondElectrons> bondElectrons;
   int i = 0;
@@ -58,8 +60,8 @@ void MoleculeOde::Evaluate(double time, const Eigen::VectorXd& y, Eigen::VectorX
   for(; i<y.size(); i += 2, j++) {
     bond = m_molecule->GetBondByIndex(j);
     bondElectrons = bond->GetBondElectrons();
-    LogPlain(L"Pos[%d]: %e", j, y[i]);
-    LogPlain(L"Vel%d]: %e", j, y[i+1]);
+    BACH_LOG_TRACE(L"Pos[%d]: %e", j, y[i]);
+    BACH_LOG_TRACE(L"Vel%d]: %e", j, y[i+1]);
     bondElectrons->SetLinearPosition(y[i]); // Set the position relative to the first atom.
     bondElectrons->SetLinearVelocity(y[i+1]);
 // LAG - all wrong...    bondElectrons->CalculatePositionAndVelocity();
@@ -76,8 +78,8 @@ void MoleculeOde::Evaluate(double time, const Eigen::VectorXd& y, Eigen::VectorX
     dydt[i] = y[i+1];
     dydt[i+1] = acceleration;
 
-    LogPlain(L"dxdt[%d]: %e", j, dydt[i]);
-    LogPlain(L"dvdt[%d]: %e", j, dydt[i+1]);
+    BACH_LOG_TRACE(L"dxdt[%d]: %e", j, dydt[i]);
+    BACH_LOG_TRACE(L"dvdt[%d]: %e", j, dydt[i+1]);
     
     internalValues[i] = bondElectrons->GetElectricalInducedForce();
     internalValues[i+1] = bondElectrons->GetMagneticInducedForce();
@@ -86,3 +88,18 @@ void MoleculeOde::Evaluate(double time, const Eigen::VectorXd& y, Eigen::VectorX
   odeData->SetInternalValues(internalValues);
 */
 }
+
+void MoleculeOde::EvaluateEvents(double time, const Eigen::VectorXd& y, Eigen::VectorXd& g) {
+  // y holds the position and velocity of each bond's electrons, in turn.
+  for(int j=0; 2*j<y.size(); j++) {
+    shared_ptr<BondForce> bondForce = m_molecule->GetBondByIndex(j)->GetBondForceObject();
+    g[2*j]   = bondForce->GetFirstLimitMargin(y[2*j]);
+    g[2*j+1] = bondForce->GetSecondLimitMargin(y[2*j]);
+  }
+}
+
+std::string MoleculeOde::GetEventName(int index) const {
+  std::ostringstream name;
+  name << "bond " << index/2 << " broken towards " << (index%2 == 0 ? "first" : "second");
+  return name.str();
+}
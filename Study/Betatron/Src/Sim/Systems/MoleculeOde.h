@@ -38,6 +38,14 @@ namespace Bach {
 
     boost::shared_ptr<Molecule> GetMolecule() { return m_molecule; }
 
+    // Two events for each bond, at the limits of its electrons' position where BondForce
+    // has the bond broken towards its first and then its second atom. Either stops the
+    // integration.
+    virtual int GetNumberOfEvents() const { return GetStateLength(); }
+    virtual void EvaluateEvents(double time, const Eigen::VectorXd& y, Eigen::VectorXd& g);
+    virtual EventDirection GetEventDirection(int index) const { return EventFalling; }
+    virtual std::string GetEventName(int index) const;
+
   protected:
     MoleculeOde(boost::shared_ptr<Molecule> molecule);
     void InitializeFromMolecule();
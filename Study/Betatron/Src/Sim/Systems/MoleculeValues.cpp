@@ -96,7 +96,7 @@ Eigen::VectorXd MoleculeValues::GetAccelEquationRemainder() {  // Gets a vector
 void MoleculeValues::SetLinearPosVel(const Eigen::VectorXd& values) { // Sets molecule bonds with alternating position and velocity values.
   Integer numBonds = m_molecule->GetNumBonds();
   if(values.size() != 2*numBonds) {
-    Log(L"ERROR: MoleculeValues::SetLinearPosVel: values length of %d incorrect, should be %d", values.size(), 2*numBonds);
+    BACH_LOG_ERROR(L"MoleculeValues::SetLinearPosVel: values length of %d incorrect, should be %d", values.size(), 2*numBonds);
     throw std::exception();
   }
 
@@ -115,7 +115,7 @@ void MoleculeValues::SetLinearPosVel(const Eigen::VectorXd& values) { // Sets mo
 void MoleculeValues::SetLinearPos(const Eigen::VectorXd& values) {
   Integer numBonds = m_molecule->GetNumBonds();
   if(values.size() != numBonds) {
-    Log(L"ERROR: MoleculeValues::SetLinearPos: values length of %d incorrect, should be %d", values.size(), 2*numBonds);
+    BACH_LOG_ERROR(L"MoleculeValues::SetLinearPos: values length of %d incorrect, should be %d", values.size(), 2*numBonds);
     throw std::exception();
   }
 
@@ -130,7 +130,7 @@ void MoleculeValues::SetLinearPos(const Eigen::VectorXd& values) {
 void MoleculeValues::SetLinearVel(const Eigen::VectorXd& values) {
   Integer numBonds = m_molecule->GetNumBonds();
   if(values.size() != numBonds) {
-    Log(L"ERROR: MoleculeValues::SetLinearVel: values length of %d incorrect, should be %d", values.size(), 2*numBonds);
+    BACH_LOG_ERROR(L"MoleculeValues::SetLinearVel: values length of %d incorrect, should be %d", values.size(), 2*numBonds);
     throw std::exception();
   }
 
@@ -145,7 +145,7 @@ void MoleculeValues::SetLinearVel(const Eigen::VectorXd& values) {
 void MoleculeValues::SetLinearAccel(const Eigen::VectorXd& values) {
   Integer numBonds = m_molecule->GetNumBonds();
   if(values.size() != numBonds) {
-    Log(L"ERROR: MoleculeValues::SetLinearVel: values length of %d incorrect, should be %d", values.size(), 2*numBonds);
+    BACH_LOG_ERROR(L"MoleculeValues::SetLinearVel: values length of %d incorrect, should be %d", values.size(), 2*numBonds);
     throw std::exception();
   }
 
@@ -44,12 +44,12 @@ void WaterSwingArm::Initialize(shared_ptr<Bach::OdeData> odeData) {
 }
 
 void WaterSwingArm::Evaluate(double time, const Eigen::VectorXd& y, Eigen::VectorXd& dydt, shared_ptr<Bach::OdeData> odeData) {
-  LogPlain(L"Iteration %e", time);
+  BACH_LOG_TRACE(L"Iteration %e", time);
   
 
 /*
   count++;
-  LogPlain(L"Iteration %d", count);
+  BACH_LOG_TRACE(L"Iteration %d", count);
   shared_ptr<Bond> bond;
   shared_ptr<BondElectrons> bondElectrons;
   int i = 0;
@@ -57,8 +57,8 @@ void WaterSwingArm::Evaluate(double time, const Eigen::VectorXd& y, Eigen::Vecto
   for(; i<y.size(); i += 2, j++) {
     bond = m_molecule->GetBondByIndex(j);
     bondElectrons = bond->GetBondElectrons();
-    LogPlain(L"Pos[%d]: %e", j, y[i]);
-    LogPlain(L"Vel%d]: %e", j, y[i+1]);
+    BACH_LOG_TRACE(L"Pos[%d]: %e", j, y[i]);
+    BACH_LOG_TRACE(L"Vel%d]: %e", j, y[i+1]);
     bondElectrons->SetLinearPosition(y[i]); // Set the position relative to the first atom.
     bondElectrons->SetLinearVelocity(y[i+1]);
 // LAG - all wrong...    bondElectrons->CalculatePositionAndVelocity();
@@ -75,8 +75,8 @@ void WaterSwingArm::Evaluate(double time, const Eigen::VectorXd& y, Eigen::Vecto
     dydt[i] = y[i+1];
     dydt[i+1] = acceleration;
 
-    LogPlain(L"dxdt[%d]: %e", j, dydt[i]);
-    LogPlain(L"dvdt[%d]: %e", j, dydt[i+1]);
+    BACH_LOG_TRACE(L"dxdt[%d]: %e", j, dydt[i]);
+    BACH_LOG_TRACE(L"dvdt[%d]: %e", j, dydt[i+1]);
     
     internalValues[i] = bondElectrons->GetElectricalInducedForce();
     internalValues[i+1] = bondElectrons->GetMagneticInducedForce();
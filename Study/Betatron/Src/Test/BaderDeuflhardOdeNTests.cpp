@@ -0,0 +1,131 @@
+/**********************************************************************
+
+File     : BaderDeuflhardOdeNTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the fixed size Bader-Deuflhard solver.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BaderDeuflhardOdeNTests.h"
+#include "BaderDeuflhardOdeN.h"
+#include "BaderDeuflhardOde.h"
+#include "BetatronEquationSolver.h"
+#include "BetatronEquations.h"
+#include "OdeData.h"
+#include "OdeDataCollector.h"
+#include "SampledDerivedData.h"
+#include <vector>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const double RADIUS = 0.1;
+  const double SPEED = 0.5;          // Fraction of the speed of light.
+  const double NUM_ROTATIONS = 0.5;
+
+  typedef BaderDeuflhardOdeN<6, BetatronEquations> BetatronOdeN;
+
+  // Keeps every step start, as the OdeData of the dynamic solver does.
+  struct StepRecorder {
+    void operator()(double x, const BetatronOdeN::VectorN& y, const BetatronOdeN::VectorN& dydx) {
+      times.push_back(x);
+      states.push_back(y);
+    }
+    std::vector<double> times;
+    std::vector<BetatronOdeN::VectorN, Eigen::aligned_allocator<BetatronOdeN::VectorN> > states;
+  };
+
+  shared_ptr<BetatronEquationSolver> CreateSolver(double fieldIncrease) {
+    shared_ptr<BetatronEquationSolver> solver = BetatronEquationSolver::CreateInstance();
+    solver->SetFieldIncreaseRatePerRotation(fieldIncrease);
+    solver->SetNumRotations(NUM_ROTATIONS);
+    solver->SetInitialConditionsFromRadiusAndSpeed(RADIUS, SPEED*Bach::SPEED_OF_LIGHT);
+    solver->Initialize();
+    return solver;
+  }
+}
+
+  //***************************
+  //* BaderDeuflhardOdeNTests *
+  //***************************
+
+shared_ptr<BaderDeuflhardOdeNTests> BaderDeuflhardOdeNTests::CreateInstance() {
+  shared_ptr<BaderDeuflhardOdeNTests> instance(new BaderDeuflhardOdeNTests);
+  return instance;
+}
+
+BaderDeuflhardOdeNTests::BaderDeuflhardOdeNTests() :
+  m_success(false)
+{
+}
+
+BaderDeuflhardOdeNTests::~BaderDeuflhardOdeNTests() {
+}
+
+bool BaderDeuflhardOdeNTests::RunTests() {
+  m_success = true;
+  TestSameAsDynamic(0.0);
+  TestSameAsDynamic(0.01);
+
+  if(m_success) {
+    Log(L"BaderDeuflhardOdeN tests succeeded");
+  }
+  return m_success;
+}
+
+void BaderDeuflhardOdeNTests::TestSameAsDynamic(double fieldIncrease) {
+  std::string name = "Field increase " + std::to_string(fieldIncrease);
+
+  shared_ptr<BetatronEquationSolver> dynamicSolver = CreateSolver(fieldIncrease);
+  dynamicSolver->Run();
+  shared_ptr<BaderDeuflhardOde> dynamicOde = dynamic_pointer_cast<BaderDeuflhardOde>(dynamicSolver->GetOdeSolver());
+
+  // The same settings BetatronEquationSolver gives the dynamic solver.
+  shared_ptr<BetatronEquationSolver> solver = CreateSolver(fieldIncrease);
+  shared_ptr<OdeData> odeData = solver->GetOdeData();
+  BetatronOdeN ode;
+  ode.SetStepSize(solver->GetStepSize());
+  ode.SetMaximumStepSize((odeData->GetEndTime()-odeData->GetStartTime())/40.0);
+
+  BetatronOdeN::VectorN y = odeData->GetInitialConditions();
+  StepRecorder recorder;
+  ode.Solve(*solver->GetEquations(), odeData->GetStartTime(), odeData->GetEndTime(), y, recorder);
+
+  if(ode.GetNumberGood() != dynamicOde->GetNumberGood() || ode.GetNumberRetried() != dynamicOde->GetNumberRetried()) {
+    Fail(name + ": BaderDeuflhardOdeN took " + std::to_string(ode.GetNumberGood()) + " good and " + std::to_string(ode.GetNumberRetried()) +
+         " retried steps, BaderDeuflhardOde " + std::to_string(dynamicOde->GetNumberGood()) + " and " + std::to_string(dynamicOde->GetNumberRetried()));
+    return;
+  }
+  if(ode.GetNumberOfFactorizations() != dynamicOde->GetNumberOfFactorizations()) {
+    Fail(name + ": The solvers made different numbers of factorizations");
+  }
+
+  // The dynamic solver stores each step start, so its samples are the recorder's.
+  shared_ptr<SampledDerivedData> stateData = dynamicSolver->GetOdeData()->GetCollector()->GetStateData();
+  if(stateData->GetNumberOfSamples() != (int) recorder.times.size()) {
+    Fail(name + ": BaderDeuflhardOde stored " + std::to_string(stateData->GetNumberOfSamples()) + " step starts, BaderDeuflhardOdeN " +
+         std::to_string(recorder.times.size()));
+    return;
+  }
+  double x;
+  VectorXd yDynamic(6), dy(6);
+  for(int i=0; i<stateData->GetNumberOfSamples(); i++) {
+    stateData->Retrieve(i, x, yDynamic, dy);
+    if(x != recorder.times[i] || yDynamic != VectorXd(recorder.states[i])) {
+      Fail(name + ": The state at step " + std::to_string(i) + " isn't the same to the bit");
+      return;
+    }
+  }
+}
+
+void BaderDeuflhardOdeNTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
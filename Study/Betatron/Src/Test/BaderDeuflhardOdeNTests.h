@@ -0,0 +1,49 @@
+/**********************************************************************
+
+File     : BaderDeuflhardOdeNTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the fixed size Bader-Deuflhard solver.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           BaderDeuflhardOdeN<6, BetatronEquations> is checked to take the
+           same steps as the dynamic BaderDeuflhardOde on a betatron
+           trajectory, reaching the same state to the bit at every one.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_BADER_DEUFLHARD_ODE_N_TESTS_H__
+#define __BACH_BADER_DEUFLHARD_ODE_N_TESTS_H__
+
+#include "BachDefs.h"
+#include <string>
+
+namespace Bach {
+
+  //***************************
+  //* BaderDeuflhardOdeNTests *
+  //***************************
+
+  class BaderDeuflhardOdeNTests {
+  public:
+
+    static boost::shared_ptr<BaderDeuflhardOdeNTests> CreateInstance();
+
+    ~BaderDeuflhardOdeNTests();
+
+    bool RunTests();
+
+  protected:
+    BaderDeuflhardOdeNTests();
+
+    void TestSameAsDynamic(double fieldIncrease);
+
+    void Fail(const std::string& message);
+
+    bool m_success;
+  };
+};
+
+#endif // __BACH_BADER_DEUFLHARD_ODE_N_TESTS_H__
@@ -0,0 +1,179 @@
+/**********************************************************************
+
+File     : BetatronDerivativesTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the betatron equations' derivatives.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BetatronDerivativesTests.h"
+#include "BetatronEquationSolver.h"
+#include "BetatronEquations.h"
+#include "BetatronDerivatives.h"
+#include "OdeNumericalDerivatives.h"
+#include "OdeAutoDiffDerivatives.h"
+#include "BaderDeuflhardOde.h"
+#include "DenseOutputTests.h"
+#include "OdeData.h"
+#include "OdeDataCollector.h"
+#include "SampledDerivedData.h"
+#include <cstdio>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const double RADIUS = 0.1;
+  const double SPEED = 0.5;                 // Fraction of the speed of light.
+  const double FIELD_INCREASE = 0.01;       // Fractional increase per rotation, so dfdx isn't zero.
+  const int NUM_STATES = 5;                 // Spread evenly over the trajectory's samples.
+  const double NUMERICAL_TOLERANCE = 1.0e-8; // Relative to the largest entry.
+  const double AUTOMATIC_TOLERANCE = 1.0e-14; // Both are exact but for roundoff.
+}
+
+  //****************************
+  //* BetatronDerivativesTests *
+  //****************************
+
+shared_ptr<BetatronDerivativesTests> BetatronDerivativesTests::CreateInstance() {
+  shared_ptr<BetatronDerivativesTests> instance(new BetatronDerivativesTests);
+  return instance;
+}
+
+BetatronDerivativesTests::BetatronDerivativesTests() :
+  m_success(false)
+{
+}
+
+BetatronDerivativesTests::~BetatronDerivativesTests() {
+}
+
+bool BetatronDerivativesTests::RunTests() {
+  m_success = true;
+  CreateStates();
+  TestAnalyticAgainstNumerical();
+  TestAutomaticAgainstAnalytic();
+  TestDifferentiatorChoice();
+
+  if(m_success) {
+    Log(L"Betatron derivatives tests succeeded");
+  }
+  return m_success;
+}
+
+void BetatronDerivativesTests::CreateStates() {
+  m_solver = BetatronEquationSolver::CreateInstance();
+  m_solver->SetFieldIncreaseRatePerRotation(FIELD_INCREASE);
+  m_solver->SetNumRotations(1.0);
+  m_solver->SetInitialConditionsFromRadiusAndSpeed(RADIUS, SPEED*Bach::SPEED_OF_LIGHT);
+  m_solver->Initialize();
+  m_solver->Run();
+
+  // States the solver passed through, with the field at each one's time.
+  shared_ptr<SampledDerivedData> stateData = m_solver->GetOdeData()->GetCollector()->GetStateData();
+  int numSamples = stateData->GetNumberOfSamples();
+  m_times.resize(NUM_STATES);
+  m_states.resize(NUM_STATES, VectorXd(6));
+  for(int i=0; i<NUM_STATES; i++) {
+    VectorXd dy(6);
+    stateData->Retrieve(i*(numSamples-1)/(NUM_STATES-1), m_times[i], m_states[i], dy);
+  }
+  m_solver->GetOdeData()->SetStoringThisCall(false);
+}
+
+void BetatronDerivativesTests::TestAnalyticAgainstNumerical() {
+  shared_ptr<OdeData> odeData = m_solver->GetOdeData();
+  shared_ptr<BetatronEquations> equations = m_solver->GetEquations();
+  BetatronDerivatives analytic(equations);
+  OdeNumericalDerivatives numerical(6, NUMERICAL_TOLERANCE);
+
+  // Steps on the scale of the state, since the velocities are near 1e8 m/s and a step small
+  // beside them loses the difference to roundoff.
+  VectorXd step(6);
+  step << 1.0e-3, 1.0e-3, 1.0e-3, 1.0e6, 1.0e6, 1.0e6;
+  numerical.SetStepSize(step);
+
+  for(int i=0; i<NUM_STATES; i++) {
+    std::string at = " at state " + std::to_string(i);
+    VectorXd dfdxNumerical(6), dfdxAnalytic(6);
+    MatrixXd dfdyNumerical(6, 6), dfdyAnalytic(6, 6);
+    numerical.GetDerivatives(m_times[i], m_states[i], dfdxNumerical, dfdyNumerical, odeData);
+    analytic.GetDerivatives(m_times[i], m_states[i], dfdxAnalytic, dfdyAnalytic, odeData);
+    CheckClose("BetatronDerivatives dfdy" + at, dfdyNumerical, dfdyAnalytic, NUMERICAL_TOLERANCE);
+    CheckClose("BetatronDerivatives dfdx" + at, dfdxNumerical, dfdxAnalytic, NUMERICAL_TOLERANCE);
+
+    // The fixed size form BaderDeuflhardOdeN uses.
+    BetatronEquations::VectorN y = m_states[i];
+    BetatronEquations::VectorN dfdxN;
+    BetatronEquations::MatrixN dfdyN;
+    equations->GetDerivativesT(m_times[i], y, dfdxN, dfdyN);
+    CheckClose("GetDerivativesT dfdy" + at, dfdyNumerical, dfdyN, NUMERICAL_TOLERANCE);
+    CheckClose("GetDerivativesT dfdx" + at, dfdxNumerical, dfdxN, NUMERICAL_TOLERANCE);
+  }
+}
+
+void BetatronDerivativesTests::TestAutomaticAgainstAnalytic() {
+  shared_ptr<OdeData> odeData = m_solver->GetOdeData();
+  BetatronDerivatives analytic(m_solver->GetEquations());
+  OdeAutoDiffDerivatives automatic(6);
+
+  for(int i=0; i<NUM_STATES; i++) {
+    std::string at = " at state " + std::to_string(i);
+    VectorXd dfdxAutomatic(6), dfdxAnalytic(6);
+    MatrixXd dfdyAutomatic(6, 6), dfdyAnalytic(6, 6);
+    automatic.GetDerivatives(m_times[i], m_states[i], dfdxAutomatic, dfdyAutomatic, odeData);
+    analytic.GetDerivatives(m_times[i], m_states[i], dfdxAnalytic, dfdyAnalytic, odeData);
+    CheckClose("OdeAutoDiffDerivatives dfdy" + at, dfdyAnalytic, dfdyAutomatic, AUTOMATIC_TOLERANCE);
+    CheckClose("OdeAutoDiffDerivatives dfdx" + at, dfdxAnalytic, dfdxAutomatic, AUTOMATIC_TOLERANCE);
+  }
+}
+
+void BetatronDerivativesTests::TestDifferentiatorChoice() {
+  // Without one set, the betatron equations are differentiated automatically.
+  shared_ptr<BaderDeuflhardOde> solver = BaderDeuflhardOde::CreateInstance();
+  solver->InitializeDifferentiator(m_solver->GetOdeData());
+  if(!dynamic_pointer_cast<OdeAutoDiffDerivatives>(solver->GetDifferentiator())) {
+    Fail("InitializeDifferentiator didn't choose automatic differentiation for the betatron equations");
+  }
+
+  // Equations without dual numbers are differenced.
+  shared_ptr<OdeData> oscillatorData = OdeData::CreateInstance(shared_ptr<OdeEquations>(new HarmonicOscillatorOde()));
+  solver = BaderDeuflhardOde::CreateInstance();
+  solver->InitializeDifferentiator(oscillatorData);
+  if(!dynamic_pointer_cast<OdeNumericalDerivatives>(solver->GetDifferentiator())) {
+    Fail("InitializeDifferentiator didn't choose numerical derivatives for equations without dual numbers");
+  }
+
+  // One set beforehand is kept.
+  shared_ptr<OdeDerivatives> analytic(new BetatronDerivatives(m_solver->GetEquations()));
+  solver = BaderDeuflhardOde::CreateInstance();
+  solver->SetDifferentiator(analytic);
+  solver->InitializeDifferentiator(m_solver->GetOdeData());
+  if(solver->GetDifferentiator() != analytic) {
+    Fail("InitializeDifferentiator replaced the differentiator already set");
+  }
+}
+
+void BetatronDerivativesTests::CheckClose(const std::string& name, const MatrixXd& expected, const MatrixXd& found, double tolerance) {
+  if(expected.rows() != found.rows() || expected.cols() != found.cols()) {
+    Fail(name + ": The sizes differ");
+    return;
+  }
+  double difference = (expected-found).cwiseAbs().maxCoeff()/expected.cwiseAbs().maxCoeff();
+  if(!(difference <= tolerance)) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3e", difference);
+    Fail(name + ": Relative difference of " + text);
+  }
+}
+
+void BetatronDerivativesTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
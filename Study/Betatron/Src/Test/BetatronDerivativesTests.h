@@ -0,0 +1,63 @@
+/**********************************************************************
+
+File     : BetatronDerivativesTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the betatron equations' derivatives.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The closed form Jacobian, both from BetatronEquations::GetDerivativesT
+           at a fixed size and through BetatronDerivatives, is checked against
+           OdeNumericalDerivatives at states along a trajectory whose field
+           increases with time. The dual number derivatives of
+           OdeAutoDiffDerivatives are checked against the closed form, and
+           InitializeDifferentiator to choose them for the betatron equations
+           and only for equations that can be differentiated automatically.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_BETATRON_DERIVATIVES_TESTS_H__
+#define __BACH_BETATRON_DERIVATIVES_TESTS_H__
+
+#include "BachDefs.h"
+#include <string>
+#include <vector>
+
+namespace Bach {
+
+  class BetatronEquationSolver;
+
+  //****************************
+  //* BetatronDerivativesTests *
+  //****************************
+
+  class BetatronDerivativesTests {
+  public:
+
+    static boost::shared_ptr<BetatronDerivativesTests> CreateInstance();
+
+    ~BetatronDerivativesTests();
+
+    bool RunTests();
+
+  protected:
+    BetatronDerivativesTests();
+
+    void CreateStates();
+    void TestAnalyticAgainstNumerical();
+    void TestAutomaticAgainstAnalytic();
+    void TestDifferentiatorChoice();
+
+    void CheckClose(const std::string& name, const Eigen::MatrixXd& expected, const Eigen::MatrixXd& found, double tolerance);
+    void Fail(const std::string& message);
+
+    boost::shared_ptr<BetatronEquationSolver> m_solver;
+    std::vector<double> m_times;
+    std::vector<Eigen::VectorXd> m_states;
+    bool m_success;
+  };
+};
+
+#endif // __BACH_BETATRON_DERIVATIVES_TESTS_H__
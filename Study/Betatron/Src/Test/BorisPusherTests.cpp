@@ -0,0 +1,137 @@
+/**********************************************************************
+
+File     : BorisPusherTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the Boris pusher.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BorisPusherTests.h"
+#include "OdeSolver.h"
+#include "OdeData.h"
+#include "OdeDataCollector.h"
+#include "SampledDerivedData.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const double RADIUS = 0.1;
+  const double SPEED = 0.5*Bach::SPEED_OF_LIGHT;
+  const double NUM_ROTATIONS = 20.0;
+  const double SAMPLE_DEGREES = 5.0;
+
+  // The speed is kept to rounding error, and so is the radius, as the field is uniform.
+  const double DRIFT_TOLERANCE = 1.0e-12;
+
+  // The phase lags by about (h w)^2/12 of the angle turned, h w being a tenth of a degree.
+  const double POSITION_TOLERANCE = 1.0e-4;
+}
+
+  //********************
+  //* BorisPusherTests *
+  //********************
+
+shared_ptr<BorisPusherTests> BorisPusherTests::CreateInstance() {
+  shared_ptr<BorisPusherTests> instance(new BorisPusherTests);
+  return instance;
+}
+
+BorisPusherTests::BorisPusherTests() :
+  m_success(false)
+{
+}
+
+BorisPusherTests::~BorisPusherTests() {
+}
+
+bool BorisPusherTests::RunTests() {
+  m_success = true;
+  TestOrbit(BetatronEquationSolver::BorisMethod, L"Boris");
+  TestOrbit(BetatronEquationSolver::RelativisticBorisMethod, L"relativistic Boris");
+  TestEventsAreRefused();
+
+  if(m_success) {
+    Log(L"Boris pusher tests succeeded");
+  }
+  return m_success;
+}
+
+void BorisPusherTests::TestOrbit(BetatronEquationSolver::OdeMethod odeMethod, const std::wstring& name) {
+  shared_ptr<BetatronEquationSolver> solver = BetatronEquationSolver::CreateInstance();
+  solver->SetNumRotations(NUM_ROTATIONS);
+  solver->SetInitialConditionsFromRadiusAndSpeed(RADIUS, SPEED);
+  solver->SetSampleDegrees(SAMPLE_DEGREES);
+  solver->SetOdeMethod(odeMethod);
+  solver->Initialize();
+  solver->Run();
+
+  shared_ptr<OdeData> odeData = solver->GetOdeData();
+  shared_ptr<SampledDerivedData> states = odeData->GetCollector()->GetStateData();
+  int expectedSamples = (int) (NUM_ROTATIONS*360.0/SAMPLE_DEGREES+0.5)+1;
+  if(states->GetNumberOfSamples() != expectedSamples) {
+    Log(L"ERROR: BorisPusherTests: %d %s samples rather than %d", states->GetNumberOfSamples(), name.c_str(), expectedSamples);
+    m_success = false;
+    return;
+  }
+
+  double x;
+  VectorXd y(6), dy(6);
+  double maximumDrift = 0.0;
+  double maximumAccelerationError = 0.0;
+  for(int i=0; i<states->GetNumberOfSamples(); i++) {
+    states->Retrieve(i, x, y, dy);
+    maximumDrift = std::max(maximumDrift, fabs(y.head<3>().norm()/RADIUS-1.0));
+    maximumDrift = std::max(maximumDrift, fabs(y.tail<3>().norm()/SPEED-1.0));
+
+    // The stored acceleration is centripetal, v^2/r towards the centre.
+    Vector3d centripetal = -(SPEED*SPEED/(RADIUS*RADIUS))*y.head<3>();
+    maximumAccelerationError = std::max(maximumAccelerationError, (dy.tail<3>()-centripetal).norm()/(SPEED*SPEED/RADIUS));
+  }
+  if(maximumDrift > DRIFT_TOLERANCE) {
+    Log(L"ERROR: BorisPusherTests: The %s radius or speed drifts by %e", name.c_str(), maximumDrift);
+    m_success = false;
+  }
+  if(maximumAccelerationError > POSITION_TOLERANCE) {
+    Log(L"ERROR: BorisPusherTests: The %s acceleration is out by %e", name.c_str(), maximumAccelerationError);
+    m_success = false;
+  }
+
+  // Back at the start after a whole number of rotations.
+  states->Retrieve(states->GetNumberOfSamples()-1, x, y, dy);
+  if(x != odeData->GetEndTime()) {
+    Fail(L"The last sample is not at the end time");
+  }
+  double positionError = (y.head<3>()-Vector3d(RADIUS, 0.0, 0.0)).norm()/RADIUS;
+  if(positionError > POSITION_TOLERANCE) {
+    Log(L"ERROR: BorisPusherTests: The %s orbit ends %e from the start", name.c_str(), positionError);
+    m_success = false;
+  }
+}
+
+void BorisPusherTests::TestEventsAreRefused() {
+  shared_ptr<BetatronEquationSolver> solver = BetatronEquationSolver::CreateInstance();
+  solver->SetNumRotations(1.0);
+  solver->SetInitialConditionsFromRadiusAndSpeed(RADIUS, SPEED);
+  solver->SetRecordRotations(true);
+  solver->SetOdeMethod(BetatronEquationSolver::BorisMethod);
+  solver->Initialize();
+  try {
+    solver->Run();
+  }
+  catch(std::exception&) {
+    return;
+  }
+  Fail(L"The Boris pusher integrated a system with events");
+}
+
+void BorisPusherTests::Fail(const std::wstring& message) {
+  Log(L"ERROR: BorisPusherTests: %s", message.c_str());
+  m_success = false;
+}
@@ -0,0 +1,47 @@
+/**********************************************************************
+
+File     : BorisPusherTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the Boris pusher.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_BORIS_PUSHER_TESTS_H__
+#define __BACH_BORIS_PUSHER_TESTS_H__
+
+#include "BachDefs.h"
+#include "BetatronEquationSolver.h"
+
+namespace Bach {
+
+  //********************
+  //* BorisPusherTests *
+  //********************
+
+  class BorisPusherTests {
+  public:
+
+    static boost::shared_ptr<BorisPusherTests> CreateInstance();
+
+    ~BorisPusherTests();
+
+    bool RunTests();
+
+  protected:
+    BorisPusherTests();
+
+    void TestOrbit(BetatronEquationSolver::OdeMethod odeMethod, const std::wstring& name);
+    void TestEventsAreRefused();
+
+    void Fail(const std::wstring& message);
+
+    bool m_success;
+  };
+};
+
+#endif // __BACH_BORIS_PUSHER_TESTS_H__
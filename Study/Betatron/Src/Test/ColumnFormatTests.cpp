@@ -0,0 +1,261 @@
+/**********************************************************************
+
+File     : ColumnFormatTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for round trip tests of the binary column result format.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "ColumnFormatTests.h"
+#include "JsonStreamWriter.h"
+#include "SampledData.h"
+#include "SampledDerivedData.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdint.h>
+
+using namespace Bach;
+using namespace boost;
+
+namespace {
+  const int NUM_DEPENDENT = 3;
+
+  uint32_t ReadUInt(const std::string& bytes, size_t offset, size_t length) {
+    uint32_t value = 0;
+    for(size_t i=0; i<length; i++) {
+      value |= ((uint32_t) (unsigned char) bytes[offset+i]) << (8*i);
+    }
+    return value;
+  }
+
+  // A little-endian value of the given width, at either precision.
+  double ReadValue(const std::string& bytes, size_t offset, BinaryColumnWriter::Precision precision) {
+    unsigned char raw[8];
+    for(size_t i=0; i<(size_t) precision; i++) {
+      raw[i] = (unsigned char) bytes[offset+i];
+    }
+    const uint16_t one = 1;
+    if(*((const uint8_t*) &one) != 1) {
+      std::reverse(raw, raw+precision);
+    }
+    if(precision == BinaryColumnWriter::FLOAT64) {
+      double value;
+      std::memcpy(&value, raw, sizeof(double));
+      return value;
+    }
+    float value;
+    std::memcpy(&value, raw, sizeof(float));
+    return value;
+  }
+
+  bool SameDouble(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0 || a == b;
+  }
+}
+
+  //*********************
+  //* ColumnFormatTests *
+  //*********************
+
+shared_ptr<ColumnFormatTests> ColumnFormatTests::CreateInstance() {
+  shared_ptr<ColumnFormatTests> instance(new ColumnFormatTests);
+  instance->Initialize();
+  return instance;
+}
+
+ColumnFormatTests::ColumnFormatTests() :
+  m_success(false)
+{
+}
+
+ColumnFormatTests::~ColumnFormatTests() {
+}
+
+void ColumnFormatTests::Initialize() {
+  // Small buffers, so the header, the layout and the values are split across several.
+  m_pool = OutputBufferPool::CreateInstance(256);
+
+  // Values that only survive a round trip if no digits or bits are lost.
+  m_sampleValues.push_back(0.0);
+  m_sampleValues.push_back(-0.0);
+  m_sampleValues.push_back(1.0/3.0);
+  m_sampleValues.push_back(-3.141592653589793);
+  m_sampleValues.push_back(2.5e-8);
+  m_sampleValues.push_back(6.02214076e23);
+  m_sampleValues.push_back(std::numeric_limits<double>::denorm_min());
+  m_sampleValues.push_back(std::numeric_limits<double>::min());
+  m_sampleValues.push_back(std::numeric_limits<double>::max());
+  m_sampleValues.push_back(-0.1);
+  m_sampleValues.push_back(16777217.0);
+}
+
+bool ColumnFormatTests::RunTests() {
+  m_success = true;
+
+  const int numSamples = (int) m_sampleValues.size();
+  SampledData sampled(NUM_DEPENDENT, numSamples);
+  SampledDerivedData derived(NUM_DEPENDENT, numSamples);
+
+  std::vector<std::string> names, units;
+  for(int j=0; j<NUM_DEPENDENT; j++) {
+    names.push_back(std::string("y") + (char) ('0'+j));
+    units.push_back(j == 0 ? "m" : (j == 1 ? "m/s" : "\"quoted\" \\ unit"));
+  }
+  sampled.SetIndependentName("Time");
+  sampled.SetIndependentUnit("s");
+  sampled.SetArrayColumnNames(names);
+  sampled.SetArrayColumnUnits(units);
+  derived.SetIndependentName("Time");
+  derived.SetIndependentUnit("s");
+  derived.SetArrayColumnNames(names);
+  derived.SetArrayColumnUnits(units);
+
+  Eigen::VectorXd y(NUM_DEPENDENT);
+  Eigen::VectorXd dy(NUM_DEPENDENT);
+  for(int i=0; i<numSamples; i++) {
+    for(int j=0; j<NUM_DEPENDENT; j++) {
+      y(j) = m_sampleValues[(i+j) % numSamples];
+      dy(j) = -y(j);
+    }
+    sampled.Store(0.001*i, y);
+    derived.Store(0.001*i, y, dy);
+  }
+
+  TestRoundTrip("SampledData float64", sampled, BinaryColumnWriter::FLOAT64);
+  TestRoundTrip("SampledData float32", sampled, BinaryColumnWriter::FLOAT32);
+  TestRoundTrip("SampledDerivedData float64", derived, BinaryColumnWriter::FLOAT64);
+  TestRoundTrip("SampledDerivedData float32", derived, BinaryColumnWriter::FLOAT32);
+
+  if(m_success) {
+    Log(L"Column format tests succeeded");
+  }
+  return m_success;
+}
+
+template <class DataType>
+void ColumnFormatTests::TestRoundTrip(const std::string& name, DataType& data, BinaryColumnWriter::Precision precision) {
+  std::string text;
+  shared_ptr<JsonStreamWriter> jsonWriter = JsonStreamWriter::CreateInstance(m_pool,
+      [&text](const OutputBufferPtr& buffer) { text.append(buffer->GetData(), buffer->GetSize()); });
+  data.WriteJson(*jsonWriter);
+  jsonWriter->Flush();
+
+  std::string layoutText = JsonStreamWriter::WriteToString([&data](JsonStreamWriter& writer) {
+    data.WriteColumnLayout(writer);
+  });
+
+  std::string binary;
+  shared_ptr<BinaryColumnWriter> binaryWriter = BinaryColumnWriter::CreateInstance(m_pool,
+      [&binary](const OutputBufferPtr& buffer) { binary.append(buffer->GetData(), buffer->GetSize()); }, precision);
+  binaryWriter->WriteHeader(layoutText);
+  data.WriteColumns(*binaryWriter);
+  binaryWriter->Flush();
+
+  if(binary.size() != binaryWriter->GetNumberOfBytesWritten()) {
+    Fail(name+": the bytes handed on differ from the bytes written");
+    return;
+  }
+  if((unsigned char) binary[6] != (unsigned char) precision) {
+    Fail(name+": the header has the wrong bytes per value");
+    return;
+  }
+
+  Json::Value expected;
+  Json::Reader reader;
+  if(!reader.parse(text, expected)) {
+    Fail(name+": the JSON output does not parse");
+    return;
+  }
+
+  Json::Value layout;
+  std::vector< std::vector<double> > columns;
+  if(!Decode(binary, layout, columns)) {
+    Fail(name+": the binary output does not decode");
+    return;
+  }
+
+  if(columns.size() != 1+expected["dependent"].size()) {
+    Fail(name+": the number of columns differs");
+    return;
+  }
+  CheckColumn(name, expected["independent"], layout["independent"], columns[0], precision);
+  for(Json::ArrayIndex j=0; j<expected["dependent"].size(); j++) {
+    CheckColumn(name, expected["dependent"][j], layout["dependent"][j], columns[1+j], precision);
+  }
+}
+
+bool ColumnFormatTests::Decode(const std::string& binary, Json::Value& layout, std::vector< std::vector<double> >& columns) {
+  if(binary.size() < BinaryColumnWriter::HEADER_SIZE || binary.compare(0, 4, "BCOL") != 0) {
+    return false;
+  }
+  if(ReadUInt(binary, 4, 2) != BinaryColumnWriter::FORMAT_VERSION || binary[7] != 0) {
+    return false;
+  }
+  BinaryColumnWriter::Precision precision = (BinaryColumnWriter::Precision) binary[6];
+  size_t layoutLength = ReadUInt(binary, 8, 4);
+  if(BinaryColumnWriter::HEADER_SIZE+layoutLength > binary.size()) {
+    return false;
+  }
+
+  Json::Reader reader;
+  if(!reader.parse(binary.substr(BinaryColumnWriter::HEADER_SIZE, layoutLength), layout)) {
+    return false;
+  }
+
+  // The columns follow in the order the layout writes them: the independent
+  // values, then each dependent column.
+  std::vector<long> counts;
+  counts.push_back(layout["independent"]["values"].asInt());
+  for(Json::ArrayIndex j=0; j<layout["dependent"].size(); j++) {
+    counts.push_back(layout["dependent"][j]["values"].asInt());
+  }
+
+  size_t offset = BinaryColumnWriter::HEADER_SIZE+layoutLength;
+  offset = (offset+7)/8*8;
+  for(size_t c=0; c<counts.size(); c++) {
+    std::vector<double> values;
+    for(long i=0; i<counts[c]; i++) {
+      if(offset+precision > binary.size()) {
+        return false;
+      }
+      values.push_back(ReadValue(binary, offset, precision));
+      offset += precision;
+    }
+    columns.push_back(values);
+  }
+  return offset == binary.size();
+}
+
+void ColumnFormatTests::CheckColumn(const std::string& name, const Json::Value& expected, const Json::Value& layoutColumn,
+                                    const std::vector<double>& values, BinaryColumnWriter::Precision precision) {
+  std::string column = expected["name"].asString();
+  if(layoutColumn["name"] != expected["name"] || layoutColumn["units"] != expected["units"]) {
+    Fail(name+": the name or units of column "+column+" differ");
+    return;
+  }
+  if(values.size() != expected["values"].size()) {
+    Fail(name+": the length of column "+column+" differs");
+    return;
+  }
+  for(size_t i=0; i<values.size(); i++) {
+    double value = expected["values"][(Json::ArrayIndex) i].asDouble();
+    if(precision == BinaryColumnWriter::FLOAT32) {
+      value = (float) value;
+    }
+    if(!SameDouble(value, values[i])) {
+      Fail(name+": column "+column+" differs from the JSON at sample "+std::to_string((long long) i));
+      return;
+    }
+  }
+}
+
+void ColumnFormatTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
@@ -0,0 +1,66 @@
+/**********************************************************************
+
+File     : ColumnFormatTests.h
+Project  : Bach Simulation
+Purpose  : Header file for round trip tests of the binary column result format.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The sampled data is written both as JSON and as binary columns,
+           the binary is decoded here, and the names, units and values are
+           checked against the parsed JSON.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_COLUMN_FORMAT_TESTS_H__
+#define __BACH_COLUMN_FORMAT_TESTS_H__
+
+#include "BachDefs.h"
+#include "BinaryColumnWriter.h"
+#include "json.h"
+#include <string>
+#include <vector>
+
+namespace Bach {
+
+  class SampledData;
+  class SampledDerivedData;
+
+  //*********************
+  //* ColumnFormatTests *
+  //*********************
+
+  class ColumnFormatTests {
+  public:
+
+    static boost::shared_ptr<ColumnFormatTests> CreateInstance();
+
+    ~ColumnFormatTests();
+
+    bool RunTests();
+
+  protected:
+    ColumnFormatTests();
+
+    void Initialize();
+
+    template <class DataType>
+    void TestRoundTrip(const std::string& name, DataType& data, BinaryColumnWriter::Precision precision);
+
+    // Split the binary form into its layout and the values of each column.
+    bool Decode(const std::string& binary, Json::Value& layout, std::vector< std::vector<double> >& columns);
+
+    void CheckColumn(const std::string& name, const Json::Value& expected, const Json::Value& layoutColumn,
+                     const std::vector<double>& values, BinaryColumnWriter::Precision precision);
+
+    void Fail(const std::string& message);
+
+    boost::shared_ptr<OutputBufferPool> m_pool;
+    std::vector<double> m_sampleValues;
+    bool m_success;
+  };
+};
+
+#endif // __BACH_COLUMN_FORMAT_TESTS_H__
@@ -0,0 +1,195 @@
+/**********************************************************************
+
+File     : DenseOutputTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the dense output of the ODE solver.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "DenseOutputTests.h"
+#include "OdeDenseOutput.h"
+#include "GridOdeDataCollector.h"
+#include "BaderDeuflhardOde.h"
+#include "DormandPrinceOde.h"
+#include "OdeAccuracySpec.h"
+#include "OdeData.h"
+#include "SampledDerivedData.h"
+#include "SampledData.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const double SAMPLE_INTERVAL = 0.01;
+  const double END_TIME = 10.0;
+  const double TOLERANCE = 1.0e-8;
+
+  // A quintic and its first two derivatives.
+  double Quintic(double x)   { return 2.0-x+0.5*x*x+3.0*x*x*x-x*x*x*x+0.25*x*x*x*x*x; }
+  double Quintic1(double x)  { return -1.0+x+9.0*x*x-4.0*x*x*x+1.25*x*x*x*x; }
+  double Quintic2(double x)  { return 1.0+18.0*x-12.0*x*x+5.0*x*x*x; }
+}
+
+  //*************************
+  //* HarmonicOscillatorOde *
+  //*************************
+
+void HarmonicOscillatorOde::Evaluate(double x, const VectorXd& yIn, VectorXd& yOut, shared_ptr<OdeData> odeData) {
+  m_numberOfEvaluations++;
+  yOut(0) = yIn(1);
+  yOut(1) = -yIn(0);
+
+  // The energy, which should stay at 0.5.
+  if(odeData->StoringThisCall()) {
+    VectorXd internals(1);
+    internals(0) = 0.5*(yIn(0)*yIn(0)+yIn(1)*yIn(1));
+    odeData->SetInternalValues(internals);
+  }
+}
+
+  //********************
+  //* DenseOutputTests *
+  //********************
+
+shared_ptr<DenseOutputTests> DenseOutputTests::CreateInstance() {
+  shared_ptr<DenseOutputTests> instance(new DenseOutputTests);
+  return instance;
+}
+
+DenseOutputTests::DenseOutputTests() :
+  m_success(false)
+{
+}
+
+DenseOutputTests::~DenseOutputTests() {
+}
+
+bool DenseOutputTests::RunTests() {
+  m_success = true;
+  TestQuinticIsExact();
+  TestOscillatorOnGrid();
+  TestGridEndNotExact();
+
+  if(m_success) {
+    Log(L"Dense output tests succeeded");
+  }
+  return m_success;
+}
+
+void DenseOutputTests::TestQuinticIsExact() {
+  double x0 = -0.5;
+  double x1 = 1.5;
+  VectorXd y(1), dy(1), d2y(1);
+
+  OdeDenseOutput step;
+  y(0) = Quintic(x0); dy(0) = Quintic1(x0); d2y(0) = Quintic2(x0);
+  step.SetStart(x0, y, dy, d2y);
+  y(0) = Quintic(x1); dy(0) = Quintic1(x1); d2y(0) = Quintic2(x1);
+  step.SetEnd(x1, y, dy, d2y);
+
+  for(int i=0; i<=20; i++) {
+    double x = x0+(x1-x0)*i/20.0;
+    step.Evaluate(x, y, dy);
+    if(fabs(y(0)-Quintic(x)) > 1.0e-12 || fabs(dy(0)-Quintic1(x)) > 1.0e-11) {
+      Fail(L"The dense output does not reproduce a quintic");
+      return;
+    }
+  }
+}
+
+void DenseOutputTests::TestOscillatorOnGrid() {
+  shared_ptr<HarmonicOscillatorOde> equations(new HarmonicOscillatorOde());
+  shared_ptr<OdeData> odeData = OdeData::CreateInstance(equations);
+  shared_ptr<GridOdeDataCollector> collector(new GridOdeDataCollector(SAMPLE_INTERVAL));
+  odeData->SetCollector(collector);
+  odeData->SetStartTime(0.0);
+  odeData->SetEndTime(END_TIME);
+
+  VectorXd initialConditions(2);
+  initialConditions << 1.0, 0.0;
+  odeData->SetInitialConditions(initialConditions);
+
+  shared_ptr<BaderDeuflhardOde> solver = BaderDeuflhardOde::CreateInstance();
+  solver->SetAccuracySpec(shared_ptr<OdeAccuracySpec>(new OdeAccuracySpec(2, 1.0e-10)));
+  solver->SetStepSize(0.1);
+  solver->Solve(odeData);
+
+  shared_ptr<SampledDerivedData> states = collector->GetStateData();
+  shared_ptr<SampledData> internals = collector->GetInternalData();
+  long expectedSamples = collector->GetNumberOfGridTimes(odeData);
+  if(states->GetNumberOfSamples() != expectedSamples || internals->GetNumberOfSamples() != expectedSamples) {
+    Log(L"ERROR: DenseOutputTests: %d and %d samples for %ld grid times", states->GetNumberOfSamples(), internals->GetNumberOfSamples(), expectedSamples);
+    m_success = false;
+    return;
+  }
+
+  int numberOfSteps = solver->GetNumberGood()+solver->GetNumberRetried();
+  if(numberOfSteps*4 > expectedSamples) {
+    Log(L"ERROR: DenseOutputTests: %d steps for %ld samples", numberOfSteps, expectedSamples);
+    m_success = false;
+  }
+
+  double x;
+  VectorXd y(2), dy(2);
+  double maximumError = 0.0;
+  for(int i=0; i<states->GetNumberOfSamples(); i++) {
+    states->Retrieve(i, x, y, dy);
+    if(x != i*SAMPLE_INTERVAL) {
+      Fail(L"A sample is not at its grid time");
+      return;
+    }
+    maximumError = std::max(maximumError, fabs(y(0)-cos(x)));
+    maximumError = std::max(maximumError, fabs(y(1)+sin(x)));
+    maximumError = std::max(maximumError, fabs(dy(1)+cos(x)));
+    maximumError = std::max(maximumError, fabs((*internals)(i, 0)-0.5));
+  }
+
+  if(maximumError > TOLERANCE) {
+    Log(L"ERROR: DenseOutputTests: The grid samples are out by %e", maximumError);
+    m_success = false;
+  }
+}
+
+void DenseOutputTests::TestGridEndNotExact() {
+  // 3*0.1 is just past 0.3, so the last grid time is only the end once it is held to it.
+  shared_ptr<HarmonicOscillatorOde> equations(new HarmonicOscillatorOde());
+  shared_ptr<OdeData> odeData = OdeData::CreateInstance(equations);
+  shared_ptr<GridOdeDataCollector> collector(new GridOdeDataCollector(0.1));
+  odeData->SetCollector(collector);
+  odeData->SetStartTime(0.0);
+  odeData->SetEndTime(0.3);
+
+  VectorXd initialConditions(2);
+  initialConditions << 1.0, 0.0;
+  odeData->SetInitialConditions(initialConditions);
+
+  shared_ptr<DormandPrinceOde> solver = DormandPrinceOde::CreateInstance();
+  solver->SetAccuracySpec(shared_ptr<OdeAccuracySpec>(new OdeAccuracySpec(2, 1.0e-10)));
+  solver->SetStepSize(0.01);
+  solver->Solve(odeData);
+
+  shared_ptr<SampledDerivedData> states = collector->GetStateData();
+  if(collector->GetNumberOfGridTimes(odeData) != 4 || states->GetNumberOfSamples() != 4) {
+    Log(L"ERROR: DenseOutputTests: %d samples for %ld grid times on [0, 0.3]", states->GetNumberOfSamples(), collector->GetNumberOfGridTimes(odeData));
+    m_success = false;
+    return;
+  }
+
+  double x;
+  VectorXd y(2), dy(2);
+  states->Retrieve(3, x, y, dy);
+  if(x != 0.3 || fabs(y(0)-cos(0.3)) > TOLERANCE) {
+    Fail(L"The last grid sample is not at the end");
+  }
+}
+
+void DenseOutputTests::Fail(const std::wstring& message) {
+  Log(L"ERROR: DenseOutputTests: %s", message.c_str());
+  m_success = false;
+}
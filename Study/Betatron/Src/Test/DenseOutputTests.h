@@ -0,0 +1,68 @@
+/**********************************************************************
+
+File     : DenseOutputTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the dense output of the ODE solver.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The interpolant alone must reproduce a quintic exactly, and a
+           harmonic oscillator sampled on a grid through the dense output
+           must match its closed form while the solver takes far fewer
+           steps than there are samples.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_DENSE_OUTPUT_TESTS_H__
+#define __BACH_DENSE_OUTPUT_TESTS_H__
+
+#include "OdeEquations.h"
+
+namespace Bach {
+
+  //*************************
+  //* HarmonicOscillatorOde *
+  //*************************
+
+  // y'' = -y as the state (y, y'), so y = cos(x) from (1, 0).
+  class HarmonicOscillatorOde : public OdeEquations {
+  public:
+    HarmonicOscillatorOde() { SetStateLength(2); SetInternalLength(1); m_numberOfEvaluations = 0; }
+
+    void Evaluate(double x, const Eigen::VectorXd& yIn, Eigen::VectorXd& yOut, boost::shared_ptr<OdeData> odeData);
+
+    int GetNumberOfEvaluations() const { return m_numberOfEvaluations; }
+
+  protected:
+    int m_numberOfEvaluations;
+  };
+
+  //********************
+  //* DenseOutputTests *
+  //********************
+
+  class DenseOutputTests {
+  public:
+
+    static boost::shared_ptr<DenseOutputTests> CreateInstance();
+
+    ~DenseOutputTests();
+
+    bool RunTests();
+
+  protected:
+    DenseOutputTests();
+
+    void TestQuinticIsExact();
+    void TestOscillatorOnGrid();
+    void TestGridEndNotExact();
+
+    void Fail(const std::wstring& message);
+
+    bool m_success;
+  };
+};
+
+#endif // __BACH_DENSE_OUTPUT_TESTS_H__
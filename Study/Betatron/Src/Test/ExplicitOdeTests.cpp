@@ -0,0 +1,191 @@
+/**********************************************************************
+
+File     : ExplicitOdeTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the explicit Runge-Kutta and Bulirsch-Stoer solvers.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "ExplicitOdeTests.h"
+#include "OdeEventTests.h"
+#include "DormandPrinceOde.h"
+#include "BulirschStoerOde.h"
+#include "OdeAccuracySpec.h"
+#include "OdeData.h"
+#include "OdeDataCollector.h"
+#include "GridOdeDataCollector.h"
+#include "SampledDerivedData.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const double END_TIME = 10.0;
+  const double SAMPLE_INTERVAL = 0.01;
+  const double ODE_TOLERANCE = 1.0e-10;
+  const double STATE_TOLERANCE = 1.0e-8;
+  const double GRID_TOLERANCE = 1.0e-7;
+  const double TIME_TOLERANCE = 1.0e-8;
+
+  // NXGR_PI is only float precision.
+  const double PI = 4.0*atan(1.0);
+}
+
+  //********************
+  //* ExplicitOdeTests *
+  //********************
+
+shared_ptr<ExplicitOdeTests> ExplicitOdeTests::CreateInstance() {
+  shared_ptr<ExplicitOdeTests> instance(new ExplicitOdeTests);
+  return instance;
+}
+
+ExplicitOdeTests::ExplicitOdeTests() :
+  m_success(false)
+{
+}
+
+ExplicitOdeTests::~ExplicitOdeTests() {
+}
+
+bool ExplicitOdeTests::RunTests() {
+  m_success = true;
+  TestEndState(DormandPrinceOde::CreateInstance(), L"DormandPrinceOde");
+  TestEndState(BulirschStoerOde::CreateInstance(), L"BulirschStoerOde");
+  TestDormandPrinceOnGrid();
+  TestDormandPrinceEvents();
+  TestBulirschStoerRefusesEvents();
+
+  if(m_success) {
+    Log(L"Explicit ODE solver tests succeeded");
+  }
+  return m_success;
+}
+
+shared_ptr<OdeData> ExplicitOdeTests::CreateOdeData(shared_ptr<OdeEquations> equations) {
+  shared_ptr<OdeData> odeData = OdeData::CreateInstance(equations);
+  odeData->SetCollector(shared_ptr<OdeDataCollector>(new OdeDataCollector()));
+  odeData->SetStartTime(0.0);
+  odeData->SetEndTime(END_TIME);
+
+  VectorXd initialConditions(2);
+  initialConditions << 1.0, 0.0;
+  odeData->SetInitialConditions(initialConditions);
+  return odeData;
+}
+
+void ExplicitOdeTests::TestEndState(shared_ptr<OdeSolver> solver, const std::wstring& name) {
+  shared_ptr<HarmonicOscillatorOde> equations(new HarmonicOscillatorOde());
+  shared_ptr<OdeData> odeData = CreateOdeData(equations);
+  solver->SetAccuracySpec(shared_ptr<OdeAccuracySpec>(new OdeAccuracySpec(2, ODE_TOLERANCE)));
+  solver->SetStepSize(0.1);
+  solver->Solve(odeData);
+
+  // The last step is cut short to finish exactly at the end time.
+  shared_ptr<SampledDerivedData> states = odeData->GetCollector()->GetStateData();
+  double x;
+  VectorXd y(2), dy(2);
+  states->Retrieve(states->GetNumberOfSamples()-1, x, y, dy);
+  if(x != END_TIME) {
+    Log(L"ERROR: ExplicitOdeTests: %s finished at %.15f rather than the end time", name.c_str(), x);
+    m_success = false;
+    return;
+  }
+
+  double error = std::max(fabs(y(0)-cos(x)), fabs(y(1)+sin(x)));
+  if(error > STATE_TOLERANCE) {
+    Log(L"ERROR: ExplicitOdeTests: %s is out by %e at the end", name.c_str(), error);
+    m_success = false;
+  }
+  if(solver->GetNumberGood() == 0) {
+    Log(L"ERROR: ExplicitOdeTests: %s counted no steps", name.c_str());
+    m_success = false;
+  }
+}
+
+void ExplicitOdeTests::TestDormandPrinceOnGrid() {
+  shared_ptr<HarmonicOscillatorOde> equations(new HarmonicOscillatorOde());
+  shared_ptr<OdeData> odeData = CreateOdeData(equations);
+  shared_ptr<GridOdeDataCollector> collector(new GridOdeDataCollector(SAMPLE_INTERVAL));
+  odeData->SetCollector(collector);
+
+  shared_ptr<DormandPrinceOde> solver = DormandPrinceOde::CreateInstance();
+  solver->SetAccuracySpec(shared_ptr<OdeAccuracySpec>(new OdeAccuracySpec(2, ODE_TOLERANCE)));
+  solver->SetStepSize(0.1);
+  solver->Solve(odeData);
+
+  shared_ptr<SampledDerivedData> states = collector->GetStateData();
+  long expectedSamples = collector->GetNumberOfGridTimes(odeData);
+  if(states->GetNumberOfSamples() != expectedSamples) {
+    Log(L"ERROR: ExplicitOdeTests: %d samples for %ld grid times", states->GetNumberOfSamples(), expectedSamples);
+    m_success = false;
+    return;
+  }
+
+  double x;
+  VectorXd y(2), dy(2);
+  double maximumError = 0.0;
+  for(int i=0; i<states->GetNumberOfSamples(); i++) {
+    states->Retrieve(i, x, y, dy);
+    maximumError = std::max(maximumError, fabs(y(0)-cos(x)));
+    maximumError = std::max(maximumError, fabs(y(1)+sin(x)));
+  }
+  if(maximumError > GRID_TOLERANCE) {
+    Log(L"ERROR: ExplicitOdeTests: The DormandPrinceOde grid samples are out by %e", maximumError);
+    m_success = false;
+  }
+}
+
+void ExplicitOdeTests::TestDormandPrinceEvents() {
+  shared_ptr<OscillatorWithEventsOde> equations(new OscillatorWithEventsOde(PI));
+  shared_ptr<OdeData> odeData = CreateOdeData(equations);
+
+  shared_ptr<DormandPrinceOde> solver = DormandPrinceOde::CreateInstance();
+  solver->SetAccuracySpec(shared_ptr<OdeAccuracySpec>(new OdeAccuracySpec(2, ODE_TOLERANCE)));
+  solver->SetStepSize(0.1);
+  solver->Solve(odeData);
+
+  // A zero at pi/2 and then the stop at pi.
+  shared_ptr<OdeDataCollector> collector = odeData->GetCollector();
+  if(collector->GetNumberOfEvents() != 2 || collector->GetEventName(1) != "stop" || !odeData->GetStopFlag()) {
+    Log(L"ERROR: ExplicitOdeTests: %d events before stopping, not a zero and then the stop", collector->GetNumberOfEvents());
+    m_success = false;
+    return;
+  }
+  if(fabs(collector->GetEventTime(0)-0.5*PI) > TIME_TOLERANCE || fabs(collector->GetEventTime(1)-PI) > TIME_TOLERANCE) {
+    Log(L"ERROR: ExplicitOdeTests: The events are at %.15f and %.15f", collector->GetEventTime(0), collector->GetEventTime(1));
+    m_success = false;
+  }
+
+  shared_ptr<SampledDerivedData> states = collector->GetStateData();
+  double x;
+  VectorXd y(2), dy(2);
+  states->Retrieve(states->GetNumberOfSamples()-1, x, y, dy);
+  if(x != collector->GetEventTime(1) || fabs(y(0)+1.0) > STATE_TOLERANCE) {
+    Fail(L"The last DormandPrinceOde sample is not the stop");
+  }
+}
+
+void ExplicitOdeTests::TestBulirschStoerRefusesEvents() {
+  shared_ptr<OscillatorWithEventsOde> equations(new OscillatorWithEventsOde(0.0));
+  shared_ptr<OdeData> odeData = CreateOdeData(equations);
+  shared_ptr<BulirschStoerOde> solver = BulirschStoerOde::CreateInstance();
+  try {
+    solver->Solve(odeData);
+  }
+  catch(std::exception&) {
+    return;
+  }
+  Fail(L"BulirschStoerOde integrated a system with events");
+}
+
+void ExplicitOdeTests::Fail(const std::wstring& message) {
+  Log(L"ERROR: ExplicitOdeTests: %s", message.c_str());
+  m_success = false;
+}
@@ -0,0 +1,54 @@
+/**********************************************************************
+
+File     : ExplicitOdeTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the explicit Runge-Kutta and Bulirsch-Stoer solvers.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_EXPLICIT_ODE_TESTS_H__
+#define __BACH_EXPLICIT_ODE_TESTS_H__
+
+#include "BachDefs.h"
+
+namespace Bach {
+
+  class OdeSolver;
+  class OdeData;
+  class OdeEquations;
+
+  //********************
+  //* ExplicitOdeTests *
+  //********************
+
+  class ExplicitOdeTests {
+  public:
+
+    static boost::shared_ptr<ExplicitOdeTests> CreateInstance();
+
+    ~ExplicitOdeTests();
+
+    bool RunTests();
+
+  protected:
+    ExplicitOdeTests();
+
+    void TestEndState(boost::shared_ptr<OdeSolver> solver, const std::wstring& name);
+    void TestDormandPrinceOnGrid();
+    void TestDormandPrinceEvents();
+    void TestBulirschStoerRefusesEvents();
+
+    boost::shared_ptr<OdeData> CreateOdeData(boost::shared_ptr<OdeEquations> equations);
+
+    void Fail(const std::wstring& message);
+
+    bool m_success;
+  };
+};
+
+#endif // __BACH_EXPLICIT_ODE_TESTS_H__
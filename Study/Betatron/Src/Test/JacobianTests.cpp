@@ -0,0 +1,339 @@
+/**********************************************************************
+
+File     : JacobianTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the Jacobian found on a pool.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "JacobianTests.h"
+#include "DenseOutputTests.h"
+#include "Jacobian.h"
+#include "RiddersExtrapolation.h"
+#include "NDimAccuracySpec.h"
+#include "OdeNumericalDerivatives.h"
+#include "OdeData.h"
+#include "BetatronEquations.h"
+#include "MoleculeFactory.h"
+#include "Molecule.h"
+#include "MoleculeValues.h"
+#include "MoleculeEquilibriumEquations.h"
+#include "MoleculeEquilibriumSolver.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <thread>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const int NUM_THREADS = 4;
+  const int NUM_VARIABLES = 12;
+  const int NUM_NESTED = 6;
+  const int NUM_CALLERS = 2;
+  const int NUM_ROUNDS = 20;
+  const double TOLERANCE = 1.0e-8;
+
+  // Smooth, coupled functions of every variable, so each Jacobian entry is nonzero.
+  void EvaluateCoupled(const VectorXd& y, VectorXd& f) {
+    int n = (int) y.rows();
+    double total = y.sum();
+    for(int i=0; i<n; i++) {
+      f(i) = sin(y(i))*exp(0.1*total)+y(i)*y((i+1) % n);
+    }
+  }
+
+  shared_ptr<Jacobian> CreateJacobian(int size, double tolerance) {
+    shared_ptr<NDimAccuracySpec> accuracySpec(new NDimAccuracySpec(size));
+    accuracySpec->SetTolerance(tolerance);
+
+    shared_ptr<Jacobian> jacobian(new Jacobian());
+    jacobian->SetDerivativeFinder(shared_ptr<MultivariateDerivatives>(new RiddersExtrapolation(size)));
+    jacobian->SetAccuracySpec(accuracySpec);
+    return jacobian;
+  }
+
+  // The Jacobian found by the state machine, a value at a time.
+  void FindInTurn(Jacobian& jacobian, const VectorXd& target, const VectorXd& step) {
+    VectorXd values(target.rows());
+    jacobian.Start(target, step);
+    while(!jacobian.GetIsFinished()) {
+      EvaluateCoupled(jacobian.GetNewValue(), values);
+      jacobian.SetFunctionValues(values);
+    }
+  }
+
+  Jacobian::Function MakeCoupled() {
+    return Jacobian::Function(EvaluateCoupled);
+  }
+}
+
+  //*****************
+  //* JacobianTests *
+  //*****************
+
+shared_ptr<JacobianTests> JacobianTests::CreateInstance() {
+  shared_ptr<JacobianTests> instance(new JacobianTests);
+  return instance;
+}
+
+JacobianTests::JacobianTests() :
+  m_pool(WorkStealingPool::CreateInstance(NUM_THREADS)),
+  m_success(false)
+{
+}
+
+JacobianTests::~JacobianTests() {
+}
+
+bool JacobianTests::RunTests() {
+  m_success = true;
+  TestFunction();
+  TestNested();
+  TestCallersOffPool();
+  TestBetatronEquations();
+  TestMoleculeEquations();
+  TestWithoutClone();
+
+  if(m_success) {
+    Log(L"Jacobian tests succeeded");
+  }
+  return m_success;
+}
+
+void JacobianTests::TestFunction() {
+  VectorXd target = VectorXd::LinSpaced(NUM_VARIABLES, 0.1, 0.9);
+  VectorXd step = VectorXd::Constant(NUM_VARIABLES, 0.5);
+
+  shared_ptr<Jacobian> inTurn = CreateJacobian(NUM_VARIABLES, TOLERANCE);
+  FindInTurn(*inTurn, target, step);
+
+  shared_ptr<Jacobian> jacobian = CreateJacobian(NUM_VARIABLES, TOLERANCE);
+  jacobian->Find(target, step, EvaluateCoupled, MakeCoupled);
+  CheckSame("Without a pool", inTurn->GetDerivatives(), jacobian->GetDerivatives());
+
+  jacobian->SetPool(m_pool);
+  jacobian->Find(target, step, EvaluateCoupled, MakeCoupled);
+  CheckSame("On a pool", inTurn->GetDerivatives(), jacobian->GetDerivatives());
+  CheckSame("On a pool, the errors", inTurn->GetError(), jacobian->GetError());
+  if(!jacobian->GetIsFinished()) {
+    Fail("The Jacobian found on a pool isn't finished");
+  }
+
+  // The threads copy the accuracy spec again for each Jacobian, so they see it change.
+  target = VectorXd::LinSpaced(NUM_VARIABLES, -0.4, 0.3);
+  inTurn = CreateJacobian(NUM_VARIABLES, 1.0e-4);
+  FindInTurn(*inTurn, target, step);
+
+  shared_ptr<NDimAccuracySpec> accuracySpec(new NDimAccuracySpec(NUM_VARIABLES));
+  accuracySpec->SetTolerance(TOLERANCE);
+  jacobian->SetAccuracySpec(accuracySpec);
+  jacobian->Find(target, step, EvaluateCoupled, MakeCoupled);
+  accuracySpec->SetTolerance(1.0e-4);
+  jacobian->Find(target, step, EvaluateCoupled, MakeCoupled);
+  CheckSame("With a new tolerance", inTurn->GetDerivatives(), jacobian->GetDerivatives());
+
+  // Each column sees only its own variable change.
+  std::atomic<int> numWrong(0);
+  jacobian->Find(target, step, EvaluateCoupled, [&target, &numWrong]() {
+    return Jacobian::Function([&target, &numWrong](const VectorXd& y, VectorXd& f) {
+      if(((y.array() != target.array()).cast<int>()).sum() > 1) {
+        numWrong++;
+      }
+      EvaluateCoupled(y, f);
+    });
+  });
+  if(numWrong > 0) {
+    Fail("A column was evaluated with more than one variable moved from the target");
+  }
+}
+
+void JacobianTests::TestNested() {
+  // Jacobians found from tasks on the same pool, as a batch of solves would.
+  std::vector<VectorXd> targets(NUM_NESTED);
+  std::vector<MatrixXd> expected(NUM_NESTED);
+  VectorXd step = VectorXd::Constant(NUM_VARIABLES, 0.5);
+  for(int i=0; i<NUM_NESTED; i++) {
+    targets[i] = VectorXd::LinSpaced(NUM_VARIABLES, 0.1*i, 0.1*i+0.5);
+    shared_ptr<Jacobian> inTurn = CreateJacobian(NUM_VARIABLES, TOLERANCE);
+    FindInTurn(*inTurn, targets[i], step);
+    expected[i] = inTurn->GetDerivatives();
+  }
+
+  std::vector<MatrixXd> found(NUM_NESTED);
+  m_pool->ParallelFor(NUM_NESTED, [&](int i) {
+    shared_ptr<Jacobian> jacobian = CreateJacobian(NUM_VARIABLES, TOLERANCE);
+    jacobian->SetPool(m_pool);
+    jacobian->Find(targets[i], step, EvaluateCoupled, MakeCoupled);
+    found[i] = jacobian->GetDerivatives();
+  });
+
+  for(int i=0; i<NUM_NESTED; i++) {
+    CheckSame("Nested " + std::to_string(i), expected[i], found[i]);
+  }
+}
+
+void JacobianTests::TestCallersOffPool() {
+  // Threads of their own finding Jacobians on one pool, each helping with the others' columns
+  // while it waits. No copy of a function may be called by two threads at once.
+  std::vector<VectorXd> targets(NUM_CALLERS);
+  std::vector<MatrixXd> expected(NUM_CALLERS);
+  VectorXd step = VectorXd::Constant(NUM_VARIABLES, 0.5);
+  for(int i=0; i<NUM_CALLERS; i++) {
+    targets[i] = VectorXd::LinSpaced(NUM_VARIABLES, -0.2*i, 0.4-0.2*i);
+    shared_ptr<Jacobian> inTurn = CreateJacobian(NUM_VARIABLES, TOLERANCE);
+    FindInTurn(*inTurn, targets[i], step);
+    expected[i] = inTurn->GetDerivatives();
+  }
+
+  std::atomic<int> numShared(0);
+  auto makeFunction = [&numShared]() {
+    shared_ptr<std::atomic<int> > numCalling(new std::atomic<int>(0));
+    return Jacobian::Function([numCalling, &numShared](const VectorXd& y, VectorXd& f) {
+      if(++(*numCalling) > 1) {
+        numShared++;
+      }
+      // Give way while calling, so any other thread sharing the copy has the chance to.
+      std::this_thread::yield();
+      EvaluateCoupled(y, f);
+      (*numCalling)--;
+    });
+  };
+
+  std::vector<MatrixXd> found(NUM_CALLERS);
+  std::vector<std::thread> callers;
+  for(int i=0; i<NUM_CALLERS; i++) {
+    callers.push_back(std::thread([&, i] {
+      shared_ptr<Jacobian> jacobian = CreateJacobian(NUM_VARIABLES, TOLERANCE);
+      jacobian->SetPool(m_pool);
+      for(int round=0; round<NUM_ROUNDS; round++) {
+        jacobian->Find(targets[i], step, EvaluateCoupled, makeFunction);
+      }
+      found[i] = jacobian->GetDerivatives();
+    }));
+  }
+  for(size_t i=0; i<callers.size(); i++) {
+    callers[i].join();
+  }
+
+  if(numShared > 0) {
+    Fail("A copy of the function was called by two threads at once");
+  }
+  for(int i=0; i<NUM_CALLERS; i++) {
+    CheckSame("Off the pool " + std::to_string(i), expected[i], found[i]);
+  }
+}
+
+void JacobianTests::TestBetatronEquations() {
+  shared_ptr<BetatronFieldController> fieldController = BetatronFieldController::CreateInstance();
+  fieldController->SetAsConstantB(0.2, Vector3d(0.0, 0.0, 1.0));
+  shared_ptr<BetatronEquations> equations = BetatronEquations::CreateInstance();
+  equations->SetFieldController(fieldController);
+
+  shared_ptr<OdeData> odeData = OdeData::CreateInstance(equations);
+  odeData->SetStoringThisCall(false);
+
+  VectorXd y(6);
+  y << 0.1, -0.05, 0.01, 2.0e6, 3.0e6, 1.0e5;
+  VectorXd step = VectorXd::Constant(6, 1.0e3);
+
+  VectorXd dfdxInTurn, dfdx;
+  MatrixXd dfdyInTurn, dfdy;
+  OdeNumericalDerivatives inTurn(6, TOLERANCE);
+  inTurn.SetStepSize(step);
+  inTurn.GetDerivatives(1.0e-3, y, dfdxInTurn, dfdyInTurn, odeData);
+  int numEvaluations = equations->GetIterationCount();
+
+  OdeNumericalDerivatives derivatives(6, TOLERANCE);
+  derivatives.SetStepSize(step);
+  derivatives.SetPool(m_pool);
+  derivatives.GetDerivatives(1.0e-3, y, dfdx, dfdy, odeData);
+  CheckSame("Betatron time derivatives", dfdxInTurn, dfdx);
+  CheckSame("Betatron Jacobian", dfdyInTurn, dfdy);
+
+  // The copies evaluated the Jacobian, leaving only the time derivative to the equations.
+  if(equations->GetIterationCount()-numEvaluations >= numEvaluations) {
+    Fail("The betatron equations evaluated the Jacobian themselves on a pool");
+  }
+}
+
+void JacobianTests::TestMoleculeEquations() {
+  shared_ptr<Molecule> water = MoleculeFactory::CreateInstance(MoleculeFactory::Water, 1);
+  VectorXd positions = MoleculeValues::CreateInstance(water)->GetBondLengths();
+  positions(0) *= 0.45;
+  positions(1) *= 0.55;
+
+  // A copy of the molecule gives the same remainders as the original.
+  shared_ptr<MoleculeEquilibriumEquations> equations = MoleculeEquilibriumEquations::CreateInstance(water);
+  shared_ptr<MoleculeEquilibriumEquations> clone = equations->Clone();
+  VectorXd remainders = equations->FindFunctionValues(positions, shared_ptr<ForceVectorsList>());
+  CheckSame("Water remainders of a copy", remainders, clone->FindFunctionValues(positions, shared_ptr<ForceVectorsList>()));
+
+  // The Jacobian found on copies, twice so the copies are reused, leaving the molecule as it was.
+  MatrixXd inTurn = equations->GetJacobian(positions);
+  equations->FindFunctionValues(positions, shared_ptr<ForceVectorsList>());
+  VectorXd electronPositions = MoleculeValues::CreateInstance(water)->GetLinearPos();
+  equations->SetPool(m_pool);
+  for(int i=0; i<2; i++) {
+    CheckSame("Water Jacobian", inTurn, equations->GetJacobian(positions));
+  }
+  if(MoleculeValues::CreateInstance(water)->GetLinearPos() != electronPositions) {
+    Fail("The water molecule itself was evaluated for its Jacobian on a pool");
+  }
+
+  // And a whole solve for the equilibrium.
+  shared_ptr<MoleculeEquilibriumSolver> solverInTurn = MoleculeEquilibriumSolver::CreateInstance(MoleculeFactory::CreateInstance(MoleculeFactory::Water, 1));
+  shared_ptr<MoleculeEquilibriumSolver> solver = MoleculeEquilibriumSolver::CreateInstance(MoleculeFactory::CreateInstance(MoleculeFactory::Water, 1));
+  solver->SetPool(m_pool);
+  CheckSame("Water equilibrium", solverInTurn->PositionAndSolve(), solver->PositionAndSolve());
+}
+
+void JacobianTests::TestWithoutClone() {
+  shared_ptr<HarmonicOscillatorOde> equations(new HarmonicOscillatorOde());
+  shared_ptr<OdeData> odeData = OdeData::CreateInstance(equations);
+  odeData->SetStoringThisCall(false);
+
+  VectorXd y(2);
+  y << 0.3, -0.7;
+
+  VectorXd dfdxInTurn, dfdx;
+  MatrixXd dfdyInTurn, dfdy;
+  OdeNumericalDerivatives inTurn(2, TOLERANCE);
+  inTurn.GetDerivatives(0.0, y, dfdxInTurn, dfdyInTurn, odeData);
+  int numEvaluations = equations->GetNumberOfEvaluations();
+
+  // Equations without a Clone are evaluated in turn, and by themselves, on a pool.
+  OdeNumericalDerivatives derivatives(2, TOLERANCE);
+  derivatives.SetPool(m_pool);
+  derivatives.GetDerivatives(0.0, y, dfdx, dfdy, odeData);
+  CheckSame("Without a clone", dfdyInTurn, dfdy);
+  if(equations->GetNumberOfEvaluations() != 2*numEvaluations) {
+    Fail("Equations without a clone weren't evaluated by themselves on a pool");
+  }
+}
+
+void JacobianTests::CheckSame(const std::string& name, const MatrixXd& expected, const MatrixXd& found) {
+  if(expected.rows() != found.rows() || expected.cols() != found.cols()) {
+    Fail(name + ": The sizes differ");
+    return;
+  }
+  for(int j=0; j<expected.cols(); j++) {
+    for(int i=0; i<expected.rows(); i++) {
+      if(expected(i, j) != found(i, j)) {
+        Fail(name + ": Entry (" + std::to_string(i) + ", " + std::to_string(j) + ") differs from the one found in turn");
+        return;
+      }
+    }
+  }
+}
+
+void JacobianTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
@@ -0,0 +1,60 @@
+/**********************************************************************
+
+File     : JacobianTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the Jacobian found on a pool.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The columns found at once are checked to be the same to the bit
+           as those found in turn, for a plain function, for the betatron
+           equations through OdeNumericalDerivatives, for the equilibrium of a
+           water molecule on copies of the molecule and for equations that
+           can't be copied, and with several callers from off the pool at once.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_JACOBIAN_TESTS_H__
+#define __BACH_JACOBIAN_TESTS_H__
+
+#include "BachDefs.h"
+#include <string>
+
+namespace Bach {
+
+  class WorkStealingPool;
+
+  //*****************
+  //* JacobianTests *
+  //*****************
+
+  class JacobianTests {
+  public:
+
+    static boost::shared_ptr<JacobianTests> CreateInstance();
+
+    ~JacobianTests();
+
+    bool RunTests();
+
+  protected:
+    JacobianTests();
+
+    void TestFunction();
+    void TestNested();
+    void TestCallersOffPool();
+    void TestBetatronEquations();
+    void TestMoleculeEquations();
+    void TestWithoutClone();
+
+    void CheckSame(const std::string& name, const Eigen::MatrixXd& expected, const Eigen::MatrixXd& found);
+    void Fail(const std::string& message);
+
+    boost::shared_ptr<WorkStealingPool> m_pool;
+    bool m_success;
+  };
+};
+
+#endif // __BACH_JACOBIAN_TESTS_H__
@@ -0,0 +1,255 @@
+/**********************************************************************
+
+File     : JsonStreamWriterTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the JSON writer into pooled output buffers.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "JsonStreamWriterTests.h"
+#include "JsonStreamWriter.h"
+#include "json.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace Bach;
+using namespace boost;
+
+namespace {
+  const size_t SMALL_BUFFER_CAPACITY = 16;
+  const int NUM_LONG_STRING_CHARACTERS = 500;
+  const int NUM_RANDOM_DOUBLES = 20000;
+
+  struct EscapeCase {
+    std::string value;
+    std::string json;
+  };
+
+  // Each character as WriteString should escape it.
+  std::string Escape(char c) {
+    static const char* hexDigits = "0123456789abcdef";
+    unsigned char u = (unsigned char) c;
+    switch(c) {
+      case '"':  return "\\\"";
+      case '\\': return "\\\\";
+      case '\n': return "\\n";
+      case '\r': return "\\r";
+      case '\t': return "\\t";
+      default:
+        if(u < 0x20) {
+          return std::string("\\u00") + hexDigits[u >> 4] + hexDigits[u & 0xf];
+        }
+        return std::string(1, c);
+    }
+  }
+
+  std::string WriteString(const std::string& value) {
+    return JsonStreamWriter::WriteToString([&value](JsonStreamWriter& writer) { writer.WriteString(value); });
+  }
+
+  // Doubles with a short decimal form, and the text the fallback should find for them.
+  struct FormatCase {
+    double value;
+    const char* text;
+  };
+}
+
+  //*************************
+  //* JsonStreamWriterTests *
+  //*************************
+
+shared_ptr<JsonStreamWriterTests> JsonStreamWriterTests::CreateInstance() {
+  shared_ptr<JsonStreamWriterTests> instance(new JsonStreamWriterTests);
+  return instance;
+}
+
+JsonStreamWriterTests::JsonStreamWriterTests() :
+  m_success(false)
+{
+}
+
+JsonStreamWriterTests::~JsonStreamWriterTests() {
+}
+
+bool JsonStreamWriterTests::RunTests() {
+  m_success = true;
+  TestEscaping();
+  TestEscapingAcrossBuffers();
+  TestFormatDouble();
+  TestFormatDoubleFallback();
+  TestNonFiniteDoubles();
+
+  if(m_success) {
+    Log(L"JSON stream writer tests succeeded");
+  }
+  return m_success;
+}
+
+void JsonStreamWriterTests::TestEscaping() {
+  const EscapeCase cases[] = {
+    { "",                             "\"\"" },
+    { "plain text",                   "\"plain text\"" },
+    { "say \"hi\"",                   "\"say \\\"hi\\\"\"" },
+    { "C:\\dir\\",                    "\"C:\\\\dir\\\\\"" },
+    { "a\nb\rc\td",                   "\"a\\nb\\rc\\td\"" },
+    { std::string("\x01\x1f\b\f", 4), "\"\\u0001\\u001f\\u0008\\u000c\"" },
+    { std::string("nul\0end", 7),     "\"nul\\u0000end\"" },
+    { "\x7f/<>",                      "\"\x7f/<>\"" },           // Needn't be escaped.
+    { "caf\xc3\xa9 \xe2\x86\x92",     "\"caf\xc3\xa9 \xe2\x86\x92\"" } // UTF-8 passes through.
+  };
+
+  for(size_t i=0; i<sizeof(cases)/sizeof(cases[0]); i++) {
+    std::string json = WriteString(cases[i].value);
+    if(json != cases[i].json) {
+      Fail("String " + std::to_string(i) + " was written as " + json + " rather than " + cases[i].json);
+      continue;
+    }
+
+    // And a JSON parser reads back the original, except for a NUL, where this
+    // jsoncpp ends its strings.
+    if(cases[i].value.find('\0') != std::string::npos) {
+      continue;
+    }
+    Json::Value root;
+    Json::Reader reader;
+    if(!reader.parse("[" + json + "]", root) || root[0].asString() != cases[i].value) {
+      Fail("String " + std::to_string(i) + " didn't read back from " + json);
+    }
+  }
+}
+
+void JsonStreamWriterTests::TestEscapingAcrossBuffers() {
+  // Every kind of character, with escapes falling on and across buffer boundaries.
+  const std::string alphabet("ab\"\\\n\x01z\t", 8);
+  std::string value;
+  std::string expected = "\"";
+  for(int i=0; i<NUM_LONG_STRING_CHARACTERS; i++) {
+    char c = alphabet[(i*7+i/3) % alphabet.size()];
+    value += c;
+    expected += Escape(c);
+  }
+  expected += "\"";
+
+  std::vector<size_t> bufferSizes;
+  std::string json;
+  shared_ptr<OutputBufferPool> pool = OutputBufferPool::CreateInstance(SMALL_BUFFER_CAPACITY);
+  shared_ptr<JsonStreamWriter> writer = JsonStreamWriter::CreateInstance(pool,
+    [&bufferSizes, &json](const OutputBufferPtr& buffer) {
+      bufferSizes.push_back(buffer->GetSize());
+      json.append(buffer->GetData(), buffer->GetSize());
+    });
+  writer->WriteString(value);
+  writer->Flush();
+
+  if(json != expected) {
+    Fail("A string written across buffers was escaped differently");
+  }
+  if(bufferSizes.size() < expected.size()/SMALL_BUFFER_CAPACITY) {
+    Fail("A long string wasn't written across buffers");
+  }
+  for(size_t i=0; i<bufferSizes.size(); i++) {
+    if(bufferSizes[i] > SMALL_BUFFER_CAPACITY) {
+      Fail("A buffer was filled past its capacity");
+      break;
+    }
+  }
+}
+
+void JsonStreamWriterTests::TestFormatDouble() {
+  std::vector<double> values = {
+    0.0, -0.0, 1.0, -2.5, 0.1, 1.0/3.0, M_PI, 299792458.0, 1e21, 1e-7,
+    123456789012345678.0, std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(),
+    std::numeric_limits<double>::min(), std::numeric_limits<double>::denorm_min(),
+    std::numeric_limits<double>::epsilon()
+  };
+
+  // And doubles of every magnitude, from random bits.
+  std::mt19937_64 generator(20261018);
+  while((int) values.size() < NUM_RANDOM_DOUBLES) {
+    uint64_t bits = generator();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if(std::isfinite(value)) {
+      values.push_back(value);
+    }
+  }
+
+  char buffer[JsonStreamWriter::MAX_DOUBLE_LENGTH];
+  for(size_t i=0; i<values.size() && m_success; i++) {
+    CheckReadsBack("FormatDouble", values[i], buffer, JsonStreamWriter::FormatDouble(values[i], buffer));
+    CheckReadsBack("FormatDoubleByPrecision", values[i], buffer, JsonStreamWriter::FormatDoubleByPrecision(values[i], buffer));
+  }
+
+  // WriteDouble writes the same text as FormatDouble.
+  std::string written = JsonStreamWriter::WriteToString([](JsonStreamWriter& writer) { writer.WriteDouble(0.1); });
+  if(written != "0.1") {
+    Fail("WriteDouble wrote 0.1 as " + written);
+  }
+}
+
+void JsonStreamWriterTests::TestFormatDoubleFallback() {
+  // Those that 15 digits hold are written with no more digits than needed, and the
+  // rest with 16 or 17. A denormal holds fewer digits.
+  const FormatCase cases[] = {
+    { 0.1,         "0.1" },
+    { 0.3,         "0.3" },
+    { -2.5,        "-2.5" },
+    { 1234.5678,   "1234.5678" },
+    { 299792458.0, "299792458" },
+    { 1e100,       "1e+100" },
+    { 0.1+0.2,     "0.30000000000000004" },
+    { 1.0/3.0,     "0.3333333333333333" },
+    { std::numeric_limits<double>::denorm_min(), "4.94065645841247e-324" }
+  };
+
+  char buffer[JsonStreamWriter::MAX_DOUBLE_LENGTH];
+  for(size_t i=0; i<sizeof(cases)/sizeof(cases[0]); i++) {
+    int length = JsonStreamWriter::FormatDoubleByPrecision(cases[i].value, buffer);
+    if(std::string(buffer, length) != cases[i].text) {
+      Fail("The fallback wrote " + std::string(buffer, length) + " rather than " + cases[i].text);
+    }
+  }
+}
+
+void JsonStreamWriterTests::TestNonFiniteDoubles() {
+  std::string written = JsonStreamWriter::WriteToString([](JsonStreamWriter& writer) {
+    writer.WriteDouble(std::numeric_limits<double>::infinity());
+    writer.WriteRaw(",");
+    writer.WriteDouble(-std::numeric_limits<double>::infinity());
+    writer.WriteRaw(",");
+    writer.WriteDouble(std::numeric_limits<double>::quiet_NaN());
+  });
+  if(written != "null,null,null") {
+    Fail("Infinities and NaN were written as " + written + " rather than null");
+  }
+}
+
+void JsonStreamWriterTests::CheckReadsBack(const std::string& name, double value, const char* text, int length) {
+  char formatted[32];
+  std::snprintf(formatted, sizeof(formatted), "%.17g", value);
+  if(length <= 0 || length >= JsonStreamWriter::MAX_DOUBLE_LENGTH) {
+    Fail(name + " wrote " + formatted + " in " + std::to_string(length) + " characters");
+    return;
+  }
+
+  std::string written(text, length);
+  double readBack = std::strtod(written.c_str(), NULL);
+  if(readBack != value || std::signbit(readBack) != std::signbit(value)) {
+    Fail(name + " wrote " + formatted + " as " + written + ", which reads back differently");
+  }
+}
+
+void JsonStreamWriterTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
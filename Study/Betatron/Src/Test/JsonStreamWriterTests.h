@@ -0,0 +1,57 @@
+/**********************************************************************
+
+File     : JsonStreamWriterTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the JSON writer into pooled output buffers.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Strings are checked to be escaped as JSON requires, within one
+           buffer and across buffer boundaries, and doubles to be written so
+           that they read back exactly, both with std::to_chars and with the
+           fallback used where it is missing.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_JSON_STREAM_WRITER_TESTS_H__
+#define __BACH_JSON_STREAM_WRITER_TESTS_H__
+
+#include "BachDefs.h"
+#include <string>
+
+namespace Bach {
+
+  //*************************
+  //* JsonStreamWriterTests *
+  //*************************
+
+  class JsonStreamWriterTests {
+  public:
+
+    static boost::shared_ptr<JsonStreamWriterTests> CreateInstance();
+
+    ~JsonStreamWriterTests();
+
+    bool RunTests();
+
+  protected:
+    JsonStreamWriterTests();
+
+    void TestEscaping();
+    void TestEscapingAcrossBuffers();
+    void TestFormatDouble();
+    void TestFormatDoubleFallback();
+    void TestNonFiniteDoubles();
+
+    // Check that text has the length FormatDouble returned and reads back as exactly value.
+    void CheckReadsBack(const std::string& name, double value, const char* text, int length);
+
+    void Fail(const std::string& message);
+
+    bool m_success;
+  };
+};
+
+#endif // __BACH_JSON_STREAM_WRITER_TESTS_H__
@@ -0,0 +1,237 @@
+/**********************************************************************
+
+File     : LinearSolveWorkspaceTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the linear solves of the semi-implicit ODE steps.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "LinearSolveWorkspaceTests.h"
+#include "LinearSolveWorkspace.h"
+#include "BaderDeuflhardOde.h"
+#include "BetatronEquationSolver.h"
+#include "OdeData.h"
+#include "OdeDataCollector.h"
+#include "OdeSolverTelemetry.h"
+#include "SampledDerivedData.h"
+#include <cstdio>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const int NUM_STEP_SIZES = 4;
+  const double STEP_SIZES[NUM_STEP_SIZES] = { 1.0e-4, 1.0e-2, 0.5, 3.0 };
+  const double SOLVE_TOLERANCE = 1.0e-12;      // Relative to the solution.
+  const double TRAJECTORY_TOLERANCE = 1.0e-6;  // Relative to the state, inside the solver's own error.
+  const double STEP_COUNT_TOLERANCE = 0.01;    // Relative.
+  const int NUM_SAMPLES_BETWEEN = 97;          // Of the trajectories compared.
+
+  //**************************
+  //* QrLinearSolveWorkspace *
+  //**************************
+
+  // The factorization BaderDeuflhardOde made before the workspaces, a fresh column pivoting
+  // QR of (I - h*dfdy) for every extrapolation level.
+  class QrLinearSolveWorkspace : public LinearSolveWorkspace {
+  public:
+    QrLinearSolveWorkspace(int size) : m_a(size, size) {}
+
+    void Factor(double stepSize, const MatrixXd& dfdy) {
+      m_a = -stepSize*dfdy;
+      m_a.diagonal().array() += 1.0;
+      m_qr = m_a.colPivHouseholderQr();
+      m_numberOfFactorizations++;
+    }
+
+    void Solve(const VectorXd& b, VectorXd& x) {
+      VectorXd bCopy = b;
+      x = m_qr.solve(bCopy);
+    }
+
+    int GetSize() const      {  return (int) m_a.rows();  }
+    bool IsFixedSize() const {  return false;  }
+
+  protected:
+    MatrixXd m_a;
+    ColPivHouseholderQR<MatrixXd> m_qr;
+  };
+
+  // A fixed, well conditioned but not symmetric matrix, so pivoting matters.
+  MatrixXd CreateJacobian(int size) {
+    MatrixXd dfdy(size, size);
+    for(int j=0; j<size; j++) {
+      for(int i=0; i<size; i++) {
+        dfdy(i, j) = sin(1.0+3.0*i+7.0*j)*(i == j ? 2.0 : 1.0);
+      }
+    }
+    return dfdy;
+  }
+
+  double RelativeDifference(const VectorXd& expected, const VectorXd& found) {
+    return (expected-found).norm()/expected.norm();
+  }
+
+  std::string Format(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3e", value);
+    return text;
+  }
+
+  shared_ptr<BetatronEquationSolver> CreateBetatronSolver() {
+    shared_ptr<BetatronEquationSolver> solver = BetatronEquationSolver::CreateInstance();
+    solver->SetFieldIncreaseRatePerRotation(0.01);
+    solver->SetNumRotations(1.0);
+    solver->SetInitialConditionsFromRadiusAndSpeed(0.1, 0.5*Bach::SPEED_OF_LIGHT);
+    solver->Initialize();
+    return solver;
+  }
+}
+
+  //*****************************
+  //* LinearSolveWorkspaceTests *
+  //*****************************
+
+shared_ptr<LinearSolveWorkspaceTests> LinearSolveWorkspaceTests::CreateInstance() {
+  shared_ptr<LinearSolveWorkspaceTests> instance(new LinearSolveWorkspaceTests);
+  return instance;
+}
+
+LinearSolveWorkspaceTests::LinearSolveWorkspaceTests() :
+  m_success(false)
+{
+}
+
+LinearSolveWorkspaceTests::~LinearSolveWorkspaceTests() {
+}
+
+bool LinearSolveWorkspaceTests::RunTests() {
+  m_success = true;
+  TestCreateInstance();
+  TestAgainstQR(6);
+  TestAgainstQR(9);
+  TestSolveAgainstQR();
+
+  if(m_success) {
+    Log(L"Linear solve workspace tests succeeded");
+  }
+  return m_success;
+}
+
+void LinearSolveWorkspaceTests::TestCreateInstance() {
+  shared_ptr<LinearSolveWorkspace> workspace = LinearSolveWorkspace::CreateInstance(6);
+  if(!workspace->IsFixedSize() || workspace->GetSize() != 6) {
+    Fail("A 6 state workspace isn't the fixed size one");
+  }
+  workspace = LinearSolveWorkspace::CreateInstance(9);
+  if(workspace->IsFixedSize() || workspace->GetSize() != 9) {
+    Fail("A 9 state workspace isn't a dynamic one of that size");
+  }
+}
+
+void LinearSolveWorkspaceTests::TestAgainstQR(int size) {
+  std::string name = "Size " + std::to_string(size);
+  MatrixXd dfdy = CreateJacobian(size);
+  VectorXd b = VectorXd::LinSpaced(size, -1.0, 2.0);
+
+  shared_ptr<LinearSolveWorkspace> workspace = LinearSolveWorkspace::CreateInstance(size);
+  QrLinearSolveWorkspace qr(size);
+  for(int i=0; i<NUM_STEP_SIZES; i++) {
+    workspace->Factor(STEP_SIZES[i], dfdy);
+    qr.Factor(STEP_SIZES[i], dfdy);
+
+    VectorXd expected(size), x(size);
+    qr.Solve(b, expected);
+    workspace->Solve(b, x);
+    double difference = RelativeDifference(expected, x);
+    if(!(difference <= SOLVE_TOLERANCE)) {
+      Fail(name + ": The LU solve differs from the QR one by " + Format(difference));
+    }
+
+    // In place, as the sub-steps solve.
+    x = b;
+    workspace->Solve(x, x);
+    difference = RelativeDifference(expected, x);
+    if(!(difference <= SOLVE_TOLERANCE)) {
+      Fail(name + ": The LU solve in place differs from the QR one by " + Format(difference));
+    }
+  }
+
+  if(workspace->GetNumberOfFactorizations() != NUM_STEP_SIZES) {
+    Fail(name + ": Counted " + std::to_string(workspace->GetNumberOfFactorizations()) + " factorizations");
+  }
+  workspace->ResetNumberOfFactorizations();
+  if(workspace->GetNumberOfFactorizations() != 0) {
+    Fail(name + ": The count of factorizations wasn't reset");
+  }
+}
+
+void LinearSolveWorkspaceTests::TestSolveAgainstQR() {
+  shared_ptr<BetatronEquationSolver> luSolver = CreateBetatronSolver();
+  luSolver->Run();
+
+  shared_ptr<BetatronEquationSolver> qrSolver = CreateBetatronSolver();
+  shared_ptr<QrLinearSolveWorkspace> qr(new QrLinearSolveWorkspace(6));
+  dynamic_pointer_cast<BaderDeuflhardOde>(qrSolver->GetOdeSolver())->SetLinearSolveWorkspace(qr);
+  qrSolver->Run();
+
+  shared_ptr<BaderDeuflhardOde> lu = dynamic_pointer_cast<BaderDeuflhardOde>(luSolver->GetOdeSolver());
+  if(!lu->GetLinearSolveWorkspace()->IsFixedSize()) {
+    Fail("The betatron solve didn't use the fixed size workspace");
+  }
+  if(dynamic_pointer_cast<BaderDeuflhardOde>(qrSolver->GetOdeSolver())->GetLinearSolveWorkspace() != qr) {
+    Fail("The workspace set on the solver was replaced");
+  }
+
+  // The factorizations differ only by roundoff, which is enough to move the adaptive steps
+  // slightly, so the trajectories are compared at the same times on their samples.
+  int luSteps = lu->GetNumberGood()+lu->GetNumberRetried();
+  int qrSteps = qrSolver->GetOdeSolver()->GetNumberGood()+qrSolver->GetOdeSolver()->GetNumberRetried();
+  if(abs(luSteps-qrSteps) > STEP_COUNT_TOLERANCE*qrSteps) {
+    Fail("The LU solve took " + std::to_string(luSteps) + " steps, the QR one " + std::to_string(qrSteps));
+  }
+
+  shared_ptr<SampledDerivedData> luData = luSolver->GetOdeData()->GetCollector()->GetStateData();
+  shared_ptr<SampledDerivedData> qrData = qrSolver->GetOdeData()->GetCollector()->GetStateData();
+  double maxDifference = 0.0;
+  VectorXd yLu(6), yQr(6), dy(6);
+  for(int i=0; i<qrData->GetNumberOfSamples(); i+=NUM_SAMPLES_BETWEEN) {
+    double x;
+    qrData->Retrieve(i, x, yQr, dy);
+    luData->Retrieve(x, yLu);
+    maxDifference = std::max(maxDifference, (yLu.head<3>()-yQr.head<3>()).norm()/yQr.head<3>().norm());
+    maxDifference = std::max(maxDifference, (yLu.tail<3>()-yQr.tail<3>()).norm()/yQr.tail<3>().norm());
+  }
+  if(!(maxDifference <= TRAJECTORY_TOLERANCE)) {
+    Fail("The LU trajectory differs from the QR one by " + Format(maxDifference));
+  }
+
+  // Each step factors once per extrapolation level it tries, as the telemetry counted.
+  double factorizationsPerStep = lu->GetFactorizationsPerStep();
+  if(factorizationsPerStep != (double) lu->GetNumberOfFactorizations()/luSteps) {
+    Fail("GetFactorizationsPerStep isn't the factorizations over the steps");
+  }
+  if(lu->GetNumberOfFactorizations() != luSolver->GetTelemetry()->GetNumberOfFactorizations()) {
+    Fail("The workspace and the telemetry counted different numbers of factorizations");
+  }
+  if(!(factorizationsPerStep >= 2.0)) {
+    Fail("Only " + Format(factorizationsPerStep) + " factorizations per step, where extrapolation needs two levels");
+  }
+
+  // A second solve counts afresh.
+  luSolver->Run();
+  if(lu->GetFactorizationsPerStep() != factorizationsPerStep) {
+    Fail("The factorizations per step of a repeated solve differ");
+  }
+}
+
+void LinearSolveWorkspaceTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
@@ -0,0 +1,52 @@
+/**********************************************************************
+
+File     : LinearSolveWorkspaceTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the linear solves of the semi-implicit ODE steps.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The partial pivot LU of the fixed and dynamic workspaces is checked
+           against the column pivoting QR BaderDeuflhardOde used before them,
+           both for single solves and over a whole betatron solve, along with
+           the count of factorizations per step.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_LINEAR_SOLVE_WORKSPACE_TESTS_H__
+#define __BACH_LINEAR_SOLVE_WORKSPACE_TESTS_H__
+
+#include "BachDefs.h"
+#include <string>
+
+namespace Bach {
+
+  //*****************************
+  //* LinearSolveWorkspaceTests *
+  //*****************************
+
+  class LinearSolveWorkspaceTests {
+  public:
+
+    static boost::shared_ptr<LinearSolveWorkspaceTests> CreateInstance();
+
+    ~LinearSolveWorkspaceTests();
+
+    bool RunTests();
+
+  protected:
+    LinearSolveWorkspaceTests();
+
+    void TestCreateInstance();
+    void TestAgainstQR(int size);
+    void TestSolveAgainstQR();
+
+    void Fail(const std::string& message);
+
+    bool m_success;
+  };
+};
+
+#endif // __BACH_LINEAR_SOLVE_WORKSPACE_TESTS_H__
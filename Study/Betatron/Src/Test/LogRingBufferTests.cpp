@@ -0,0 +1,195 @@
+/**********************************************************************
+
+File     : LogRingBufferTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of leveled logging through LogRingBuffer.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "LogRingBufferTests.h"
+#include "LogRingBuffer.h"
+#include <thread>
+
+using namespace Bach;
+using namespace boost;
+
+namespace {
+  const int NUM_THREADS = 4;
+  const int MESSAGES_PER_THREAD = 100;
+}
+
+  //****************
+  //* CapturingLog *
+  //****************
+
+void CapturingLog::Write(const wchar_t* message) {
+  while(m_held) {
+    std::this_thread::yield();
+  }
+  m_messages.push_back(message);
+}
+
+  //**********************
+  //* LogRingBufferTests *
+  //**********************
+
+shared_ptr<LogRingBufferTests> LogRingBufferTests::CreateInstance() {
+  shared_ptr<LogRingBufferTests> instance(new LogRingBufferTests);
+  return instance;
+}
+
+LogRingBufferTests::LogRingBufferTests() :
+  m_success(false)
+{
+}
+
+LogRingBufferTests::~LogRingBufferTests() {
+}
+
+bool LogRingBufferTests::RunTests() {
+  m_success = true;
+
+  // The sink is only changed with nothing queued.
+  shared_ptr<LogRingBuffer> ring = LogRingBuffer::GetSharedInstance();
+  ring->Flush();
+  TestLevelsCompiledOut();
+  TestFormatting();
+  TestManyThreads();
+  TestFullRingDrops();
+  TestErrorsWritten();
+  ring->SetSink(shared_ptr<ILog>());
+
+  if(m_success) {
+    Log(L"Log ring buffer tests succeeded");
+  }
+  return m_success;
+}
+
+void LogRingBufferTests::TestLevelsCompiledOut() {
+  // Trace is above the default level, so the arguments aren't even evaluated.
+  int numberEvaluated = 0;
+  BACH_LOG_TRACE(L"Evaluated %d", ++numberEvaluated);
+  if(BACH_LOG_LEVEL < LogLevelTrace && numberEvaluated != 0) {
+    Fail(L"A trace message was compiled in");
+  }
+}
+
+void LogRingBufferTests::TestFormatting() {
+  shared_ptr<LogRingBuffer> ring = LogRingBuffer::GetSharedInstance();
+  m_sink.reset(new CapturingLog());
+  ring->SetSink(m_sink);
+
+  std::wstring name(L"wide");
+  BACH_LOG_ERROR(L"LogRingBufferTests: %s and %-6s| %d%%", name.c_str(), L"pad", 7);
+  BACH_LOG_WARNING(L"LogRingBufferTests: warning");
+  ring->Flush();
+
+  const std::vector<std::wstring>& messages = m_sink->GetMessages();
+  if(messages.size() != 2) {
+    Log(L"ERROR: LogRingBufferTests: %d messages written rather than 2", (int) messages.size());
+    m_success = false;
+    return;
+  }
+  if(messages[0] != L"ERROR: LogRingBufferTests: wide and pad   | 7%") {
+    Log(L"ERROR: LogRingBufferTests: Formatted as \"%s\"", messages[0].c_str());
+    m_success = false;
+  }
+  if(messages[1] != L"WARNING: LogRingBufferTests: warning") {
+    Fail(L"A warning isn't marked as one");
+  }
+}
+
+void LogRingBufferTests::TestManyThreads() {
+  shared_ptr<LogRingBuffer> ring = LogRingBuffer::GetSharedInstance();
+  m_sink.reset(new CapturingLog());
+  ring->SetSink(m_sink);
+
+  std::vector<std::thread> threads;
+  for(int t=0; t<NUM_THREADS; t++) {
+    threads.push_back(std::thread([t]() {
+      for(int i=0; i<MESSAGES_PER_THREAD; i++) {
+        BACH_LOG_INFO(L"%d %d", t, i);
+      }
+    }));
+  }
+  for(size_t t=0; t<threads.size(); t++) {
+    threads[t].join();
+  }
+  ring->Flush();
+
+  // Everything arrives, and in order for each thread.
+  const std::vector<std::wstring>& messages = m_sink->GetMessages();
+  if((int) messages.size() != NUM_THREADS*MESSAGES_PER_THREAD) {
+    Log(L"ERROR: LogRingBufferTests: %d messages from the threads rather than %d", (int) messages.size(), NUM_THREADS*MESSAGES_PER_THREAD);
+    m_success = false;
+    return;
+  }
+  std::vector<int> next(NUM_THREADS, 0);
+  for(size_t i=0; i<messages.size(); i++) {
+    int t = -1;
+    int index = -1;
+    if(swscanf(messages[i].c_str(), L"%d %d", &t, &index) != 2 || t < 0 || t >= NUM_THREADS || index != next[t]) {
+      Log(L"ERROR: LogRingBufferTests: \"%s\" is out of order", messages[i].c_str());
+      m_success = false;
+      return;
+    }
+    next[t]++;
+  }
+}
+
+void LogRingBufferTests::TestFullRingDrops() {
+  shared_ptr<LogRingBuffer> ring = LogRingBuffer::GetSharedInstance();
+  m_sink.reset(new CapturingLog());
+  ring->SetSink(m_sink);
+
+  // With the drain thread held up, messages past the capacity are dropped rather than waited for.
+  unsigned long droppedBefore = ring->GetNumberDropped();
+  m_sink->Hold();
+  int numberPushed = LogRingBuffer::CAPACITY+100;
+  for(int i=0; i<numberPushed; i++) {
+    BACH_LOG_INFO(L"Message %d", i);
+  }
+  unsigned long numberDropped = ring->GetNumberDropped()-droppedBefore;
+  m_sink->Release();
+  ring->Flush();
+
+  if(numberDropped < 100) {
+    Log(L"ERROR: LogRingBufferTests: %lu messages dropped from a full ring", numberDropped);
+    m_success = false;
+    return;
+  }
+
+  // The count of dropped messages is written after the message that was held up.
+  const std::vector<std::wstring>& messages = m_sink->GetMessages();
+  if((int) messages.size() != numberPushed-(int) numberDropped+1 || messages[1].find(L"WARNING: LogRingBuffer:") != 0) {
+    Log(L"ERROR: LogRingBufferTests: %d messages written after %lu were dropped", (int) messages.size(), numberDropped);
+    m_success = false;
+  }
+}
+
+void LogRingBufferTests::TestErrorsWritten() {
+  shared_ptr<LogRingBuffer> ring = LogRingBuffer::GetSharedInstance();
+  m_sink.reset(new CapturingLog());
+  ring->SetSink(m_sink);
+
+  // An error and what was queued before it are written by the time it returns, without a Flush.
+  BACH_LOG_INFO(L"LogRingBufferTests: before");
+  BACH_LOG_ERROR(L"LogRingBufferTests: error %d", 3);
+
+  const std::vector<std::wstring>& messages = m_sink->GetMessages();
+  if(messages.size() != 2 || messages[1] != L"ERROR: LogRingBufferTests: error 3") {
+    Log(L"ERROR: LogRingBufferTests: %d messages written by the time an error returned", (int) messages.size());
+    m_success = false;
+  }
+  ring->Flush();
+}
+
+void LogRingBufferTests::Fail(const std::wstring& message) {
+  Log(L"ERROR: LogRingBufferTests: %s", message.c_str());
+  m_success = false;
+}
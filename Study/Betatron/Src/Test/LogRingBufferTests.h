@@ -0,0 +1,75 @@
+/**********************************************************************
+
+File     : LogRingBufferTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of leveled logging through LogRingBuffer.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_LOG_RING_BUFFER_TESTS_H__
+#define __BACH_LOG_RING_BUFFER_TESTS_H__
+
+#include "BachDefs.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace Bach {
+
+  //****************
+  //* CapturingLog *
+  //****************
+
+  // Keeps what is written, optionally holding up the drain thread until released.
+  class CapturingLog : public ILog {
+  public:
+    CapturingLog() : m_held(false) {}
+
+    virtual void Write(const wchar_t* message);
+    virtual void WritePlain(const wchar_t* message) { Write(message); }
+
+    void Hold()    { m_held = true; }
+    void Release() { m_held = false; }
+
+    const std::vector<std::wstring>& GetMessages() const { return m_messages; }
+
+  protected:
+    std::atomic<bool> m_held;
+    std::vector<std::wstring> m_messages;
+  };
+
+  //**********************
+  //* LogRingBufferTests *
+  //**********************
+
+  class LogRingBufferTests {
+  public:
+
+    static boost::shared_ptr<LogRingBufferTests> CreateInstance();
+
+    ~LogRingBufferTests();
+
+    bool RunTests();
+
+  protected:
+    LogRingBufferTests();
+
+    void TestFormatting();
+    void TestLevelsCompiledOut();
+    void TestManyThreads();
+    void TestFullRingDrops();
+    void TestErrorsWritten();
+
+    void Fail(const std::wstring& message);
+
+    boost::shared_ptr<CapturingLog> m_sink;
+    bool m_success;
+  };
+};
+
+#endif // __BACH_LOG_RING_BUFFER_TESTS_H__
@@ -0,0 +1,164 @@
+/**********************************************************************
+
+File     : OdeEventTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of locating events during ODE integration.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "OdeEventTests.h"
+#include "BaderDeuflhardOde.h"
+#include "OdeAccuracySpec.h"
+#include "OdeData.h"
+#include "OdeDataCollector.h"
+#include "SampledDerivedData.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const double END_TIME = 10.0;
+  const double TIME_TOLERANCE = 1.0e-9;
+  const double STATE_TOLERANCE = 1.0e-8;
+
+  // NXGR_PI is only float precision.
+  const double PI = 4.0*atan(1.0);
+}
+
+  //***************************
+  //* OscillatorWithEventsOde *
+  //***************************
+
+void OscillatorWithEventsOde::EvaluateEvents(double x, const VectorXd& y, VectorXd& g) {
+  g(0) = y(0);
+  if(m_stopTime > 0.0) {
+    g(1) = x-m_stopTime;
+  }
+}
+
+OdeEquations::EventAction OscillatorWithEventsOde::HandleEvent(int index, double x, const VectorXd& y, shared_ptr<OdeData> odeData) {
+  if(index == 0) {
+    m_numberOfZeros++;
+    return ContinueAtEvent;
+  }
+  return StopAtEvent;
+}
+
+  //*****************
+  //* OdeEventTests *
+  //*****************
+
+shared_ptr<OdeEventTests> OdeEventTests::CreateInstance() {
+  shared_ptr<OdeEventTests> instance(new OdeEventTests);
+  return instance;
+}
+
+OdeEventTests::OdeEventTests() :
+  m_success(false)
+{
+}
+
+OdeEventTests::~OdeEventTests() {
+}
+
+bool OdeEventTests::RunTests() {
+  m_success = true;
+  TestZerosAreLocated();
+  TestStopAtEvent();
+
+  if(m_success) {
+    Log(L"ODE event tests succeeded");
+  }
+  return m_success;
+}
+
+shared_ptr<OdeData> OdeEventTests::Solve(shared_ptr<OscillatorWithEventsOde> equations) {
+  shared_ptr<OdeData> odeData = OdeData::CreateInstance(equations);
+  odeData->SetCollector(shared_ptr<OdeDataCollector>(new OdeDataCollector()));
+  odeData->SetStartTime(0.0);
+  odeData->SetEndTime(END_TIME);
+
+  VectorXd initialConditions(2);
+  initialConditions << 1.0, 0.0;
+  odeData->SetInitialConditions(initialConditions);
+
+  shared_ptr<BaderDeuflhardOde> solver = BaderDeuflhardOde::CreateInstance();
+  solver->SetAccuracySpec(shared_ptr<OdeAccuracySpec>(new OdeAccuracySpec(2, 1.0e-10)));
+  solver->SetStepSize(0.1);
+  solver->Solve(odeData);
+  return odeData;
+}
+
+void OdeEventTests::TestZerosAreLocated() {
+  shared_ptr<OscillatorWithEventsOde> equations(new OscillatorWithEventsOde(0.0));
+  shared_ptr<OdeData> odeData = Solve(equations);
+  shared_ptr<OdeDataCollector> collector = odeData->GetCollector();
+
+  // cos(x) is zero at pi/2, 3pi/2 and 5pi/2 before the end.
+  if(collector->GetNumberOfEvents() != 3 || equations->GetNumberOfZeros() != 3) {
+    Log(L"ERROR: OdeEventTests: %d events recorded and %d handled, not 3", collector->GetNumberOfEvents(), equations->GetNumberOfZeros());
+    m_success = false;
+    return;
+  }
+
+  for(int i=0; i<collector->GetNumberOfEvents(); i++) {
+    double expectedTime = (i+0.5)*PI;
+    if(collector->GetEventIndex(i) != 0 || collector->GetEventName(i) != "zero") {
+      Fail(L"An event is recorded as the wrong one");
+      return;
+    }
+    if(fabs(collector->GetEventTime(i)-expectedTime) > TIME_TOLERANCE) {
+      Log(L"ERROR: OdeEventTests: Zero %d is at %.15f rather than %.15f", i, collector->GetEventTime(i), expectedTime);
+      m_success = false;
+    }
+  }
+
+  // Events that are passed leave the integration running on to the end.
+  shared_ptr<SampledDerivedData> states = collector->GetStateData();
+  double x;
+  VectorXd y(2), dy(2);
+  states->Retrieve(states->GetNumberOfSamples()-1, x, y, dy);
+  if(x <= collector->GetEventTime(2) || odeData->GetStopFlag()) {
+    Fail(L"Passing an event stopped the integration");
+  }
+}
+
+void OdeEventTests::TestStopAtEvent() {
+  shared_ptr<OscillatorWithEventsOde> equations(new OscillatorWithEventsOde(PI));
+  shared_ptr<OdeData> odeData = Solve(equations);
+  shared_ptr<OdeDataCollector> collector = odeData->GetCollector();
+
+  if(collector->GetNumberOfEvents() != 2 || collector->GetEventName(1) != "stop") {
+    Log(L"ERROR: OdeEventTests: %d events before stopping, not a zero and then the stop", collector->GetNumberOfEvents());
+    m_success = false;
+    return;
+  }
+
+  // The last sample is the event, with y = cos(pi) = -1.
+  shared_ptr<SampledDerivedData> states = collector->GetStateData();
+  double x;
+  VectorXd y(2), dy(2);
+  states->Retrieve(states->GetNumberOfSamples()-1, x, y, dy);
+  if(!odeData->GetStopFlag()) {
+    Fail(L"The stop flag is not set after stopping at an event");
+  }
+  if(fabs(x-PI) > TIME_TOLERANCE || fabs(collector->GetEventTime(1)-x) > 0.0) {
+    Log(L"ERROR: OdeEventTests: Stopped at %.15f rather than at pi", x);
+    m_success = false;
+  }
+  if(fabs(y(0)+1.0) > STATE_TOLERANCE || fabs(y(1)) > STATE_TOLERANCE || fabs(dy(1)-1.0) > STATE_TOLERANCE) {
+    Log(L"ERROR: OdeEventTests: The state at the stop is (%e, %e)", y(0), y(1));
+    m_success = false;
+  }
+}
+
+void OdeEventTests::Fail(const std::wstring& message) {
+  Log(L"ERROR: OdeEventTests: %s", message.c_str());
+  m_success = false;
+}
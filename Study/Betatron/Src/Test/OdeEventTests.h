@@ -0,0 +1,72 @@
+/**********************************************************************
+
+File     : OdeEventTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of locating events during ODE integration.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           A harmonic oscillator's zeros must be found where cos(x) has
+           them, and a stopping event must end the integration exactly
+           there with the state interpolated to it.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_ODE_EVENT_TESTS_H__
+#define __BACH_ODE_EVENT_TESTS_H__
+
+#include "DenseOutputTests.h"
+
+namespace Bach {
+
+  //***************************
+  //* OscillatorWithEventsOde *
+  //***************************
+
+  // The zeros of y = cos(x), which are passed, and optionally a time to stop at.
+  class OscillatorWithEventsOde : public HarmonicOscillatorOde {
+  public:
+    OscillatorWithEventsOde(double stopTime) : m_stopTime(stopTime), m_numberOfZeros(0) {}
+
+    virtual int GetNumberOfEvents() const { return (m_stopTime > 0.0 ? 2 : 1); }
+    virtual void EvaluateEvents(double x, const Eigen::VectorXd& y, Eigen::VectorXd& g);
+    virtual std::string GetEventName(int index) const { return (index == 0 ? "zero" : "stop"); }
+    virtual EventAction HandleEvent(int index, double x, const Eigen::VectorXd& y, boost::shared_ptr<OdeData> odeData);
+
+    int GetNumberOfZeros() const { return m_numberOfZeros; }
+
+  protected:
+    double m_stopTime;
+    int m_numberOfZeros;
+  };
+
+  //*****************
+  //* OdeEventTests *
+  //*****************
+
+  class OdeEventTests {
+  public:
+
+    static boost::shared_ptr<OdeEventTests> CreateInstance();
+
+    ~OdeEventTests();
+
+    bool RunTests();
+
+  protected:
+    OdeEventTests();
+
+    void TestZerosAreLocated();
+    void TestStopAtEvent();
+
+    boost::shared_ptr<OdeData> Solve(boost::shared_ptr<OscillatorWithEventsOde> equations);
+
+    void Fail(const std::wstring& message);
+
+    bool m_success;
+  };
+};
+
+#endif // __BACH_ODE_EVENT_TESTS_H__
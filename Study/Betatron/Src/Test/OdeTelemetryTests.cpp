@@ -0,0 +1,209 @@
+/**********************************************************************
+
+File     : OdeTelemetryTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the ODE solver telemetry and metrics.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "OdeTelemetryTests.h"
+#include "DenseOutputTests.h"
+#include "OdeSolverTelemetry.h"
+#include "OdeSolverMetrics.h"
+#include "DormandPrinceOde.h"
+#include "BaderDeuflhardOde.h"
+#include "OdeAccuracySpec.h"
+#include "OdeData.h"
+#include "OdeDataCollector.h"
+#include "json.h"
+#include <numeric>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const double END_TIME = 10.0;
+  const double ODE_TOLERANCE = 1.0e-8;
+}
+
+  //*********************
+  //* OdeTelemetryTests *
+  //*********************
+
+shared_ptr<OdeTelemetryTests> OdeTelemetryTests::CreateInstance() {
+  shared_ptr<OdeTelemetryTests> instance(new OdeTelemetryTests);
+  return instance;
+}
+
+OdeTelemetryTests::OdeTelemetryTests() :
+  m_success(false)
+{
+}
+
+OdeTelemetryTests::~OdeTelemetryTests() {
+}
+
+bool OdeTelemetryTests::RunTests() {
+  m_success = true;
+  TestDormandPrinceCounts();
+  TestBaderDeuflhardCounts();
+  TestResultJson();
+  TestMetrics();
+
+  if(m_success) {
+    Log(L"ODE telemetry tests succeeded");
+  }
+  return m_success;
+}
+
+shared_ptr<OdeData> OdeTelemetryTests::CreateOdeData(shared_ptr<OdeEquations> equations) {
+  shared_ptr<OdeData> odeData = OdeData::CreateInstance(equations);
+  odeData->SetCollector(shared_ptr<OdeDataCollector>(new OdeDataCollector()));
+  odeData->SetStartTime(0.0);
+  odeData->SetEndTime(END_TIME);
+
+  VectorXd initialConditions(2);
+  initialConditions << 1.0, 0.0;
+  odeData->SetInitialConditions(initialConditions);
+  return odeData;
+}
+
+void OdeTelemetryTests::TestDormandPrinceCounts() {
+  shared_ptr<HarmonicOscillatorOde> equations(new HarmonicOscillatorOde());
+  shared_ptr<OdeData> odeData = CreateOdeData(equations);
+  shared_ptr<DormandPrinceOde> solver = DormandPrinceOde::CreateInstance();
+  solver->SetAccuracySpec(shared_ptr<OdeAccuracySpec>(new OdeAccuracySpec(2, ODE_TOLERANCE)));
+  solver->SetStepSize(1.0);
+  shared_ptr<OdeSolverTelemetry> telemetry = OdeSolverTelemetry::CreateInstance("dormandPrince");
+  solver->SetTelemetry(telemetry);
+  solver->Solve(odeData);
+
+  // Without a Jacobian every evaluation is the solver's own.
+  if(telemetry->GetNumberOfEvaluations() != equations->GetNumberOfEvaluations()) {
+    Fail(L"DormandPrinceOde counted a different number of evaluations from the equations");
+  }
+  if(telemetry->GetNumberAccepted() != solver->GetNumberGood()+solver->GetNumberRetried()) {
+    Fail(L"DormandPrinceOde counted a different number of accepted steps from the solver");
+  }
+  if(solver->GetNumberRetried() > 0 && telemetry->GetNumberRejected() == 0) {
+    Fail(L"DormandPrinceOde retried steps without counting a rejection");
+  }
+  if(telemetry->GetNumberOfCalls(OdeSolverTelemetry::StorePhase) != telemetry->GetNumberAccepted()+1) {
+    Fail(L"DormandPrinceOde didn't store each step and the start");
+  }
+  if(telemetry->GetNumberOfJacobians() != 0 || telemetry->GetNumberOfFactorizations() != 0) {
+    Fail(L"DormandPrinceOde counted Jacobians or factorizations");
+  }
+
+  // A reset clears the counts.
+  solver->Solve(odeData);
+  if(telemetry->GetNumberAccepted() != solver->GetNumberGood()+solver->GetNumberRetried()) {
+    Fail(L"DormandPrinceOde kept the counts of an earlier solve");
+  }
+}
+
+void OdeTelemetryTests::TestBaderDeuflhardCounts() {
+  shared_ptr<HarmonicOscillatorOde> equations(new HarmonicOscillatorOde());
+  shared_ptr<OdeData> odeData = CreateOdeData(equations);
+  shared_ptr<BaderDeuflhardOde> solver = BaderDeuflhardOde::CreateInstance();
+  solver->SetAccuracySpec(shared_ptr<OdeAccuracySpec>(new OdeAccuracySpec(2, ODE_TOLERANCE)));
+  solver->SetStepSize(0.1);
+  shared_ptr<OdeSolverTelemetry> telemetry = OdeSolverTelemetry::CreateInstance("baderDeuflhard");
+  solver->SetTelemetry(telemetry);
+  solver->Solve(odeData);
+
+  if(telemetry->GetNumberOfEvaluations() == 0 || telemetry->GetNumberOfEvaluations() > equations->GetNumberOfEvaluations()) {
+    Fail(L"BaderDeuflhardOde counted evaluations it didn't make");
+  }
+  if(telemetry->GetNumberOfJacobians() == 0) {
+    Fail(L"BaderDeuflhardOde counted no Jacobians");
+  }
+  if(telemetry->GetNumberOfFactorizations() != solver->GetNumberOfFactorizations()) {
+    Log(L"ERROR: OdeTelemetryTests: BaderDeuflhardOde counted %ld factorizations and its workspace %d",
+        telemetry->GetNumberOfFactorizations(), solver->GetNumberOfFactorizations());
+    m_success = false;
+  }
+  if(telemetry->GetNumberOfCalls(OdeSolverTelemetry::LinearSolvePhase) <= telemetry->GetNumberOfFactorizations()) {
+    Fail(L"BaderDeuflhardOde counted no linear solves");
+  }
+  if(telemetry->GetNumberAccepted() != solver->GetNumberGood()+solver->GetNumberRetried()) {
+    Fail(L"BaderDeuflhardOde counted a different number of accepted steps from the solver");
+  }
+
+  const std::vector<long>& orders = telemetry->GetOrderCounts();
+  if(std::accumulate(orders.begin(), orders.end(), 0L) != telemetry->GetNumberAccepted()) {
+    Fail(L"BaderDeuflhardOde's order counts don't add up to its accepted steps");
+  }
+}
+
+void OdeTelemetryTests::TestResultJson() {
+  shared_ptr<HarmonicOscillatorOde> equations(new HarmonicOscillatorOde());
+  shared_ptr<OdeData> odeData = CreateOdeData(equations);
+  shared_ptr<DormandPrinceOde> solver = DormandPrinceOde::CreateInstance();
+  shared_ptr<OdeSolverTelemetry> telemetry = OdeSolverTelemetry::CreateInstance("dormandPrince");
+  solver->SetTelemetry(telemetry);
+  solver->Solve(odeData);
+
+  shared_ptr<OdeDataCollector> collector = odeData->GetCollector();
+  if(collector->AsJson().find("\"telemetry\"") != std::string::npos) {
+    Fail(L"The results have telemetry that wasn't asked for");
+  }
+
+  collector->SetTelemetry(telemetry);
+  std::string json = collector->AsJson();
+  Json::Value root;
+  Json::Reader reader;
+  if(!reader.parse(json, root)) {
+    Fail(L"The results with telemetry aren't valid JSON");
+    return;
+  }
+  const Json::Value& written = root["telemetry"];
+  if(written["solver"].asString() != "dormandPrince" ||
+     written["evaluations"].asInt64() != telemetry->GetNumberOfEvaluations() ||
+     written["acceptedSteps"].asInt64() != telemetry->GetNumberAccepted() ||
+     !written["seconds"].isMember("evaluate") || !written["seconds"].isMember("store")) {
+    Fail(L"The telemetry in the results doesn't match the solve");
+  }
+}
+
+void OdeTelemetryTests::TestMetrics() {
+  shared_ptr<OdeSolverMetrics> metrics = OdeSolverMetrics::CreateInstance();
+  OdeSolverTelemetry telemetry("test");
+  telemetry.CountAcceptedStep(3);
+  telemetry.CountAcceptedStep(3);
+  telemetry.CountRejectedStep();
+  metrics->Record(telemetry);
+  metrics->Record(telemetry);
+
+  if(metrics->GetNumberOfSolves("test") != 2 || metrics->GetTotals("test").GetNumberAccepted() != 4) {
+    Fail(L"The metrics didn't add up two solves");
+  }
+
+  std::string text = metrics->GetPrometheusText();
+  const char* lines[] = {
+    "# TYPE bach_ode_solves_total counter\n",
+    "bach_ode_solves_total{solver=\"test\"} 2\n",
+    "bach_ode_accepted_steps_total{solver=\"test\"} 4\n",
+    "bach_ode_rejected_steps_total{solver=\"test\"} 2\n",
+    "bach_ode_order_steps_total{solver=\"test\",order=\"3\"} 4\n",
+    "bach_ode_phase_calls_total{solver=\"test\",phase=\"linearSolve\"} 0\n"
+  };
+  for(size_t i=0; i<sizeof(lines)/sizeof(lines[0]); i++) {
+    if(text.find(lines[i]) == std::string::npos) {
+      std::string line(lines[i]);
+      Log(L"ERROR: OdeTelemetryTests: The metrics are missing %s", std::wstring(line.begin(), line.end()-1).c_str());
+      m_success = false;
+    }
+  }
+}
+
+void OdeTelemetryTests::Fail(const std::wstring& message) {
+  Log(L"ERROR: OdeTelemetryTests: %s", message.c_str());
+  m_success = false;
+}
@@ -0,0 +1,53 @@
+/**********************************************************************
+
+File     : OdeTelemetryTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the ODE solver telemetry and metrics.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_ODE_TELEMETRY_TESTS_H__
+#define __BACH_ODE_TELEMETRY_TESTS_H__
+
+#include "BachDefs.h"
+
+namespace Bach {
+
+  class OdeData;
+  class OdeEquations;
+
+  //*********************
+  //* OdeTelemetryTests *
+  //*********************
+
+  class OdeTelemetryTests {
+  public:
+
+    static boost::shared_ptr<OdeTelemetryTests> CreateInstance();
+
+    ~OdeTelemetryTests();
+
+    bool RunTests();
+
+  protected:
+    OdeTelemetryTests();
+
+    void TestDormandPrinceCounts();
+    void TestBaderDeuflhardCounts();
+    void TestResultJson();
+    void TestMetrics();
+
+    boost::shared_ptr<OdeData> CreateOdeData(boost::shared_ptr<OdeEquations> equations);
+
+    void Fail(const std::wstring& message);
+
+    bool m_success;
+  };
+};
+
+#endif // __BACH_ODE_TELEMETRY_TESTS_H__
@@ -0,0 +1,132 @@
+/**********************************************************************
+
+File     : RequestHandlerTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the server's request handler.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "RequestHandlerTests.h"
+#include "request_handler.hpp"
+#include "request.hpp"
+#include "reply.hpp"
+#include "OdeSolverMetrics.h"
+
+using namespace Bach;
+using namespace boost;
+
+namespace {
+  // A short solve, with a method no other test here uses so its counts are this test's own.
+  const char SOLVER_NAME[] = "dormandPrince";
+  const std::string INPUT = "{\"radius\":0.1,\"speed\":0.5,\"method\":\"dormandPrince\",\"stopAtRotation\":1";
+
+  std::string MakeRequest(const std::string& inputs) {
+    return "{\"system\":\"betatron\",\"inputs\":"+inputs+"}";
+  }
+}
+
+  //***********************
+  //* RequestHandlerTests *
+  //***********************
+
+shared_ptr<RequestHandlerTests> RequestHandlerTests::CreateInstance() {
+  shared_ptr<RequestHandlerTests> instance(new RequestHandlerTests);
+  return instance;
+}
+
+RequestHandlerTests::RequestHandlerTests() :
+  m_handler(new http::server::request_handler("", 1)),
+  m_success(false)
+{
+}
+
+RequestHandlerTests::~RequestHandlerTests() {
+}
+
+bool RequestHandlerTests::RunTests() {
+  m_success = true;
+  TestCached();
+  TestTelemetryNotCached();
+  TestSweepTelemetryNotCached();
+
+  if(m_success) {
+    Log(L"Request handler tests succeeded");
+  }
+  return m_success;
+}
+
+void RequestHandlerTests::TestCached() {
+  shared_ptr<OdeSolverMetrics> metrics = OdeSolverMetrics::GetSharedInstance();
+  std::string input = MakeRequest(INPUT+",\"tolerance\":1e-6}");
+
+  long numSolves = metrics->GetNumberOfSolves(SOLVER_NAME);
+  std::string first = Send(input);
+  std::string second = Send(input);
+  if(metrics->GetNumberOfSolves(SOLVER_NAME) != numSolves+1) {
+    Fail("A repeated request without telemetry was solved again");
+  }
+  if(first.empty() || first != second) {
+    Fail("A repeated request without telemetry wasn't answered from the cache");
+  }
+}
+
+void RequestHandlerTests::TestTelemetryNotCached() {
+  shared_ptr<OdeSolverMetrics> metrics = OdeSolverMetrics::GetSharedInstance();
+  std::string input = MakeRequest(INPUT+",\"tolerance\":1e-7,\"telemetry\":true}");
+
+  // Each request is solved and counted, and returns the telemetry of its own solve.
+  long numSolves = metrics->GetNumberOfSolves(SOLVER_NAME);
+  long numEvaluations = metrics->GetTotals(SOLVER_NAME).GetNumberOfEvaluations();
+  for(int i=1; i<=2; i++) {
+    std::string output = Send(input);
+    if(output.find("\"telemetry\"") == std::string::npos) {
+      Fail("Request " + std::to_string(i) + " with telemetry didn't return it");
+    }
+    if(metrics->GetNumberOfSolves(SOLVER_NAME) != numSolves+i) {
+      Fail("Request " + std::to_string(i) + " with telemetry wasn't counted in the metrics");
+    }
+    long evaluations = metrics->GetTotals(SOLVER_NAME).GetNumberOfEvaluations();
+    if(evaluations <= numEvaluations) {
+      Fail("Request " + std::to_string(i) + " with telemetry added no evaluations to the metrics");
+    }
+    numEvaluations = evaluations;
+  }
+}
+
+void RequestHandlerTests::TestSweepTelemetryNotCached() {
+  shared_ptr<OdeSolverMetrics> metrics = OdeSolverMetrics::GetSharedInstance();
+
+  // One input of the sweep asking for telemetry is enough for the whole sweep to be solved again.
+  std::string input = MakeRequest("["+INPUT+",\"tolerance\":1e-6},"+INPUT+",\"tolerance\":1e-7,\"telemetry\":true}]");
+  long numSolves = metrics->GetNumberOfSolves(SOLVER_NAME);
+  Send(input);
+  Send(input);
+  if(metrics->GetNumberOfSolves(SOLVER_NAME) != numSolves+4) {
+    Fail("A repeated sweep with telemetry wasn't solved again");
+  }
+}
+
+std::string RequestHandlerTests::Send(const std::string& input) {
+  http::server::request request;
+  request.method = "GET";
+  request.uri = "/?do="+input;
+  request.http_version_major = 1;
+  request.http_version_minor = 1;
+
+  http::server::reply reply;
+  m_handler->handle_request(request, reply);
+  if(reply.status != http::server::reply::ok) {
+    Fail("The request " + input + " wasn't answered");
+  }
+  return reply.content;
+}
+
+void RequestHandlerTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
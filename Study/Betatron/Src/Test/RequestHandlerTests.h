@@ -0,0 +1,62 @@
+/**********************************************************************
+
+File     : RequestHandlerTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the server's request handler.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Repeated betatron requests are checked to be solved once and then
+           answered from the cache, unless they ask for telemetry, which is
+           solved afresh each time and counted into the metrics.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_REQUEST_HANDLER_TESTS_H__
+#define __BACH_REQUEST_HANDLER_TESTS_H__
+
+#include "BachDefs.h"
+#include <string>
+
+namespace http {
+namespace server {
+  class request_handler;
+}
+}
+
+namespace Bach {
+
+  //***********************
+  //* RequestHandlerTests *
+  //***********************
+
+  class RequestHandlerTests {
+  public:
+
+    static boost::shared_ptr<RequestHandlerTests> CreateInstance();
+
+    ~RequestHandlerTests();
+
+    bool RunTests();
+
+  protected:
+    RequestHandlerTests();
+
+    void TestCached();
+    void TestTelemetryNotCached();
+    void TestSweepTelemetryNotCached();
+
+    // The content of the reply to the request for do=input.
+    std::string Send(const std::string& input);
+
+    void Fail(const std::string& message);
+
+    // One handler for every request, so they share its cache as a server's would.
+    boost::shared_ptr<http::server::request_handler> m_handler;
+    bool m_success;
+  };
+};
+
+#endif // __BACH_REQUEST_HANDLER_TESTS_H__
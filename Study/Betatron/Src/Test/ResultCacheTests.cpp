@@ -0,0 +1,265 @@
+/**********************************************************************
+
+File     : ResultCacheTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the server's result cache.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "ResultCacheTests.h"
+#include "result_cache.hpp"
+#include "OutputBufferPool.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace Bach;
+using namespace boost;
+
+using http::server::result_cache;
+
+namespace {
+  const size_t BUFFER_CAPACITY = 256;
+  const int NUM_KEPT = 3;
+  const int NUM_WAITERS = 4;
+
+  // Long enough for any machine to start the waiting threads, short enough that a cache
+  // that doesn't coalesce fails rather than hangs.
+  const std::chrono::seconds WAIT_TIMEOUT(30);
+
+  // A producer of one buffer holding text.
+  result_cache::producer Produce(const shared_ptr<OutputBufferPool>& pool, const std::string& text) {
+    return [pool, text](const result_cache::chunk_handler& emit) {
+      OutputBufferPtr buffer = pool->Acquire();
+      buffer->Append(text.data(), text.size());
+      emit(buffer);
+    };
+  }
+
+  void IgnoreChunk(const OutputBufferPtr&) {
+  }
+
+  // Wait until the cache counts waiters requests coalesced, or the timeout passes.
+  bool WaitForCoalesced(result_cache& cache, size_t waiters) {
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now()+WAIT_TIMEOUT;
+    while(cache.get_stats().coalesced < waiters) {
+      if(std::chrono::steady_clock::now() > end) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    return true;
+  }
+}
+
+  //********************
+  //* ResultCacheTests *
+  //********************
+
+shared_ptr<ResultCacheTests> ResultCacheTests::CreateInstance() {
+  shared_ptr<ResultCacheTests> instance(new ResultCacheTests);
+  return instance;
+}
+
+ResultCacheTests::ResultCacheTests() :
+  m_bufferPool(OutputBufferPool::CreateInstance(BUFFER_CAPACITY)),
+  m_success(false)
+{
+}
+
+ResultCacheTests::~ResultCacheTests() {
+}
+
+bool ResultCacheTests::RunTests() {
+  m_success = true;
+  TestCanonicalKey();
+  TestEviction();
+  TestCoalescing();
+  TestCoalescedException();
+
+  if(m_success) {
+    Log(L"Result cache tests succeeded");
+  }
+  return m_success;
+}
+
+void ResultCacheTests::TestCanonicalKey() {
+  // Members sorted at every depth, no whitespace, and every number as a double to 17 digits.
+  std::string key = GetKey("{ \"inputs\": { \"speed\": 0.5, \"radius\": 1 }, \"system\": \"betatron\", \"list\": [2.50, true, null, \"a\"] }");
+  std::string expected = "{\"inputs\":{\"radius\":1,\"speed\":0.5},\"list\":[2.5,true,null,\"a\"],\"system\":\"betatron\"}";
+  if(key != expected) {
+    Fail("The key " + key + " isn't " + expected);
+  }
+
+  if(GetKey("{\"b\":{\"d\":1,\"c\":2},\"a\":3}") != GetKey("{\"a\":3,\"b\":{\"c\":2,\"d\":1}}")) {
+    Fail("Requests differing in member order have different keys");
+  }
+  if(GetKey("[1, 1.0, 1e0, 10e-1, 1.000000000000000000001]") != "[1,1,1,1,1]") {
+    Fail("The spellings of one have different keys");
+  }
+  if(GetKey("[0.1]") != "[0.10000000000000001]") {
+    Fail("0.1 isn't written with 17 significant digits");
+  }
+  if(GetKey("[0.1]") == GetKey("[0.10000000000000002]")) {
+    Fail("Neighbouring doubles have the same key");
+  }
+  if(GetKey("[\"1\"]") == GetKey("[1]")) {
+    Fail("A string and a number have the same key");
+  }
+}
+
+void ResultCacheTests::TestEviction() {
+  // Keys of one length and results of one buffer each take the same bytes, so the budget
+  // is set to hold exactly NUM_KEPT of them.
+  size_t entryBytes = 0;
+  {
+    result_cache measure(1 << 20);
+    measure.get_or_compute("key0", Produce(m_bufferPool, "result0"), IgnoreChunk);
+    entryBytes = measure.get_stats().bytes;
+  }
+  if(entryBytes < BUFFER_CAPACITY) {
+    Fail("A result was counted at less than its buffer's capacity");
+    return;
+  }
+
+  result_cache cache(NUM_KEPT*entryBytes);
+  for(int i=0; i<NUM_KEPT; i++) {
+    cache.get_or_compute("key" + std::to_string(i), Produce(m_bufferPool, "result" + std::to_string(i)), IgnoreChunk);
+  }
+  result_cache::stats stats = cache.get_stats();
+  if(stats.entries != (size_t) NUM_KEPT || stats.evictions != 0 || stats.bytes != NUM_KEPT*entryBytes) {
+    Fail("The cache didn't keep all it had the budget for");
+  }
+
+  // key0 is used again, leaving key1 the least recently used to make way for the next.
+  if(!cache.find("key0")) {
+    Fail("key0 wasn't found");
+  }
+  cache.get_or_compute("key" + std::to_string(NUM_KEPT), Produce(m_bufferPool, "last"), IgnoreChunk);
+  stats = cache.get_stats();
+  if(stats.evictions != 1 || stats.entries != (size_t) NUM_KEPT || stats.bytes > stats.budget_bytes) {
+    Fail("Adding one more result didn't evict exactly one");
+  }
+  if(cache.find("key1")) {
+    Fail("The least recently used result wasn't the one evicted");
+  }
+  for(int i=0; i<=NUM_KEPT; i++) {
+    if(i != 1 && !cache.find("key" + std::to_string(i))) {
+      Fail("key" + std::to_string(i) + " was evicted rather than key1");
+    }
+  }
+
+  // A result larger than the whole budget is returned but not kept, and evicts nothing.
+  std::atomic<int> numProduced(0);
+  result_cache::producer large = [this, &numProduced](const result_cache::chunk_handler& emit) {
+    numProduced++;
+    for(int i=0; i<NUM_KEPT+1; i++) {
+      emit(m_bufferPool->Acquire());
+    }
+  };
+  cache.get_or_compute("large", large, IgnoreChunk);
+  result_cache::result_ptr result = cache.get_or_compute("large", large, IgnoreChunk);
+  stats = cache.get_stats();
+  if(numProduced != 2 || !result || result->size() != (size_t) NUM_KEPT+1 || stats.evictions != 1 || stats.entries != (size_t) NUM_KEPT) {
+    Fail("A result larger than the budget was kept, or pushed others out");
+  }
+}
+
+void ResultCacheTests::TestCoalescing() {
+  result_cache cache(1 << 20);
+
+  // The first request's computation holds on until every other request is waiting for it.
+  std::atomic<int> numProduced(0);
+  std::atomic<bool> allWaited(true);
+  result_cache::producer produce = [&](const result_cache::chunk_handler& emit) {
+    numProduced++;
+    if(!WaitForCoalesced(cache, NUM_WAITERS)) {
+      allWaited = false;
+    }
+    Produce(m_bufferPool, "shared")(emit);
+  };
+
+  std::vector<std::string> received(NUM_WAITERS+1);
+  std::vector<result_cache::result_ptr> results(NUM_WAITERS+1);
+  std::vector<std::thread> requests;
+  for(int i=0; i<=NUM_WAITERS; i++) {
+    requests.push_back(std::thread([&, i] {
+      results[i] = cache.get_or_compute("key", produce, [&received, i](const OutputBufferPtr& buffer) {
+        received[i].append(buffer->GetData(), buffer->GetSize());
+      });
+    }));
+  }
+  for(size_t i=0; i<requests.size(); i++) {
+    requests[i].join();
+  }
+
+  result_cache::stats stats = cache.get_stats();
+  if(numProduced != 1 || !allWaited || stats.misses != 1 || stats.coalesced != (size_t) NUM_WAITERS) {
+    Fail("Concurrent requests for one key didn't wait for a single computation");
+  }
+  for(int i=0; i<=NUM_WAITERS; i++) {
+    if(received[i] != "shared" || results[i] != results[0]) {
+      Fail("Request " + std::to_string(i) + " didn't receive the one result");
+    }
+  }
+}
+
+void ResultCacheTests::TestCoalescedException() {
+  result_cache cache(1 << 20);
+
+  // A computation that throws fails every request waiting on it, and leaves nothing cached.
+  result_cache::producer produce = [&cache](const result_cache::chunk_handler&) {
+    WaitForCoalesced(cache, NUM_WAITERS);
+    throw std::runtime_error("failed");
+  };
+
+  std::atomic<int> numThrown(0);
+  std::vector<std::thread> requests;
+  for(int i=0; i<=NUM_WAITERS; i++) {
+    requests.push_back(std::thread([&] {
+      try {
+        cache.get_or_compute("key", produce, IgnoreChunk);
+      }
+      catch(const std::runtime_error&) {
+        numThrown++;
+      }
+    }));
+  }
+  for(size_t i=0; i<requests.size(); i++) {
+    requests[i].join();
+  }
+
+  if(numThrown != NUM_WAITERS+1) {
+    Fail(std::to_string(numThrown) + " of the requests waiting on a failed computation threw");
+  }
+  if(cache.get_stats().entries != 0 || cache.find("key")) {
+    Fail("A failed computation left a result cached");
+  }
+
+  // The next request computes afresh.
+  result_cache::result_ptr result = cache.get_or_compute("key", Produce(m_bufferPool, "again"), IgnoreChunk);
+  if(!result || ChainToString(*result) != "again") {
+    Fail("The key couldn't be computed again after a failure");
+  }
+}
+
+std::string ResultCacheTests::GetKey(const std::string& text) {
+  Json::Value request;
+  Json::Reader reader;
+  if(!reader.parse(text, request)) {
+    Fail("Couldn't parse " + text);
+  }
+  return result_cache::canonical_key(request);
+}
+
+void ResultCacheTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
@@ -0,0 +1,59 @@
+/**********************************************************************
+
+File     : ResultCacheTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the server's result cache.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Requests are checked to share a key whatever their member order or
+           number spelling, results to be evicted least recently used first
+           to stay within the budget, and concurrent requests for one key to
+           wait for a single computation.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_RESULT_CACHE_TESTS_H__
+#define __BACH_RESULT_CACHE_TESTS_H__
+
+#include "BachDefs.h"
+#include <string>
+
+namespace Bach {
+
+  class OutputBufferPool;
+
+  //********************
+  //* ResultCacheTests *
+  //********************
+
+  class ResultCacheTests {
+  public:
+
+    static boost::shared_ptr<ResultCacheTests> CreateInstance();
+
+    ~ResultCacheTests();
+
+    bool RunTests();
+
+  protected:
+    ResultCacheTests();
+
+    void TestCanonicalKey();
+    void TestEviction();
+    void TestCoalescing();
+    void TestCoalescedException();
+
+    // The key of the request JSON in text.
+    std::string GetKey(const std::string& text);
+
+    void Fail(const std::string& message);
+
+    boost::shared_ptr<OutputBufferPool> m_bufferPool;
+    bool m_success;
+  };
+};
+
+#endif // __BACH_RESULT_CACHE_TESTS_H__
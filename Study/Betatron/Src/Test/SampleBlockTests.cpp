@@ -0,0 +1,228 @@
+/**********************************************************************
+
+File     : SampleBlockTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the contiguous block of sampled values.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "SampleBlockTests.h"
+#include "SampledData.h"
+#include "SampledDerivedData.h"
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const int NUM_VARIABLES = 4;
+  const int CAPACITY = 10;
+  const int LARGER_CAPACITY = 25;
+  const int SMALLER_CAPACITY = 6;
+
+  // A value distinct for every sample and variable.
+  double GetValue(int sample, int variable) {
+    return 100.0*variable+sample+0.25;
+  }
+
+  void Fill(SampleBlock& block, int numSamples) {
+    VectorXd values(NUM_VARIABLES);
+    for(int i=0; i<numSamples; i++) {
+      for(int j=0; j<NUM_VARIABLES; j++) {
+        values(j) = GetValue(i, j);
+      }
+      block.SetSample(i, values);
+    }
+  }
+
+  std::string GetName(SampleBlock::Layout layout) {
+    return (layout == SampleBlock::SampleContiguous ? "Sample contiguous" : "Variable contiguous");
+  }
+}
+
+  //********************
+  //* SampleBlockTests *
+  //********************
+
+shared_ptr<SampleBlockTests> SampleBlockTests::CreateInstance() {
+  shared_ptr<SampleBlockTests> instance(new SampleBlockTests);
+  return instance;
+}
+
+SampleBlockTests::SampleBlockTests() :
+  m_success(false)
+{
+}
+
+SampleBlockTests::~SampleBlockTests() {
+}
+
+bool SampleBlockTests::RunTests() {
+  m_success = true;
+  SampleBlock::Layout layouts[2] = { SampleBlock::SampleContiguous, SampleBlock::VariableContiguous };
+  for(int i=0; i<2; i++) {
+    TestStoreAndView(layouts[i]);
+    TestResize(layouts[i]);
+    TestSampledDataResize(layouts[i]);
+  }
+  TestEmptyMinMax();
+
+  if(m_success) {
+    Log(L"Sample block tests succeeded");
+  }
+  return m_success;
+}
+
+void SampleBlockTests::TestStoreAndView(SampleBlock::Layout layout) {
+  std::string name = GetName(layout);
+  SampleBlock block(NUM_VARIABLES, CAPACITY, layout);
+  if(block.GetNumberOfVariables() != NUM_VARIABLES || block.GetCapacity() != CAPACITY || block.GetLayout() != layout) {
+    Fail(name + ": The block doesn't have the shape it was made with");
+  }
+  Fill(block, CAPACITY);
+  CheckValues(name, block, CAPACITY);
+
+  // Part of a sample, from a variable other than the first, in and out.
+  VectorXd part(2);
+  part << -1.0, -2.0;
+  block.SetSample(3, part, 1);
+  VectorXd out(2);
+  block.GetSample(3, out, 1);
+  if(out != part || block(3, 0) != GetValue(3, 0) || block(3, 3) != GetValue(3, 3)) {
+    Fail(name + ": Setting part of a sample changed the wrong values");
+  }
+
+  // The views see the same values through whichever stride the layout gives them.
+  SampleBlock::ConstStridedVector sample = block.Sample(5, 1, 3);
+  SampleBlock::ConstStridedVector variable = block.Variable(2, 4, 5);
+  for(int j=0; j<3; j++) {
+    if(sample(j) != GetValue(5, j+1)) {
+      Fail(name + ": The sample view doesn't match the values");
+      break;
+    }
+  }
+  for(int i=0; i<5; i++) {
+    if(variable(i) != GetValue(i+4, 2)) {
+      Fail(name + ": The variable view doesn't match the values");
+      break;
+    }
+  }
+
+  block(7, 2) = 0.5;
+  if(block.Variable(2, 0, CAPACITY)(7) != 0.5) {
+    Fail(name + ": A value set through operator() isn't seen by the views");
+  }
+}
+
+void SampleBlockTests::TestResize(SampleBlock::Layout layout) {
+  std::string name = GetName(layout);
+  SampleBlock block(NUM_VARIABLES, CAPACITY, layout);
+  Fill(block, CAPACITY);
+
+  block.Resize(CAPACITY);
+  CheckValues(name + ", resized to the same capacity", block, CAPACITY);
+
+  block.Resize(LARGER_CAPACITY);
+  if(block.GetCapacity() != LARGER_CAPACITY) {
+    Fail(name + ": The capacity wasn't increased");
+  }
+  CheckValues(name + ", grown", block, CAPACITY);
+
+  // The new space takes samples, without disturbing the ones kept.
+  VectorXd values = VectorXd::Constant(NUM_VARIABLES, -7.0);
+  block.SetSample(LARGER_CAPACITY-1, values);
+  CheckValues(name + ", grown then filled at the end", block, CAPACITY);
+
+  block.Resize(SMALLER_CAPACITY);
+  if(block.GetCapacity() != SMALLER_CAPACITY) {
+    Fail(name + ": The capacity wasn't decreased");
+  }
+  CheckValues(name + ", shrunk", block, SMALLER_CAPACITY);
+}
+
+void SampleBlockTests::TestSampledDataResize(SampleBlock::Layout layout) {
+  std::string name = GetName(layout);
+  SampledData data(NUM_VARIABLES, CAPACITY, layout);
+  SampledDerivedData derivedData(NUM_VARIABLES, CAPACITY, layout);
+  VectorXd y(NUM_VARIABLES), dy(NUM_VARIABLES);
+  for(int i=0; i<CAPACITY; i++) {
+    for(int j=0; j<NUM_VARIABLES; j++) {
+      y(j) = GetValue(i, j);
+      dy(j) = -GetValue(i, j);
+    }
+    data.Store(i, y);
+    derivedData.Store(i, y, dy);
+  }
+
+  // Shrinking below the samples stored drops the newest, and interpolation uses only those kept.
+  data.Resize(SMALLER_CAPACITY);
+  derivedData.Resize(SMALLER_CAPACITY);
+  if(data.GetNumberOfSamples() != SMALLER_CAPACITY || data.GetMaxNumberOfSamples() != SMALLER_CAPACITY ||
+     derivedData.GetNumberOfSamples() != SMALLER_CAPACITY || derivedData.GetMaxNumberOfSamples() != SMALLER_CAPACITY) {
+    Fail(name + ": Shrinking didn't clamp the number of samples");
+    return;
+  }
+  if(data.Max(1) != SMALLER_CAPACITY-1 || data.Min(1) != 0 || derivedData.Max(2) != SMALLER_CAPACITY-1 || derivedData.Min(2) != 0) {
+    Fail(name + ": Min and Max looked past the samples kept");
+  }
+
+  double x;
+  for(int i=0; i<SMALLER_CAPACITY; i++) {
+    data.Retrieve(i, x, y);
+    derivedData.Retrieve(i, x, y, dy);
+    if(x != i || y(3) != GetValue(i, 3) || dy(3) != -GetValue(i, 3)) {
+      Fail(name + ": Sample " + std::to_string(i) + " changed on shrinking");
+      return;
+    }
+  }
+  data.Retrieve(SMALLER_CAPACITY-1.5, y);
+  if(fabs(y(0)-GetValue(0, 0)-(SMALLER_CAPACITY-1.5)) > 1.0e-12) {
+    Fail(name + ": Interpolation after shrinking is out");
+  }
+
+  // Growing again leaves room to store after the samples kept.
+  data.Resize(LARGER_CAPACITY);
+  y.setConstant(1.0e6);
+  data.Store(SMALLER_CAPACITY, y);
+  if(data.GetNumberOfSamples() != SMALLER_CAPACITY+1 || data.Max(0) != SMALLER_CAPACITY) {
+    Fail(name + ": Storing after growing didn't follow the samples kept");
+  }
+}
+
+void SampleBlockTests::TestEmptyMinMax() {
+  // Nothing stored has no index of a minimum or maximum, rather than index 0.
+  SampledData data(NUM_VARIABLES, CAPACITY);
+  SampledDerivedData derivedData(NUM_VARIABLES, CAPACITY);
+  if(data.Max(0) != -1 || data.Min(0) != -1 || derivedData.Max(0) != -1 || derivedData.Min(0) != -1) {
+    Fail("Min or Max of an empty data set isn't -1");
+  }
+
+  VectorXd y = VectorXd::Constant(NUM_VARIABLES, 2.0);
+  data.Store(0.0, y);
+  if(data.Max(0) != 0 || data.Min(0) != 0) {
+    Fail("Min or Max of a single sample isn't 0");
+  }
+}
+
+void SampleBlockTests::CheckValues(const std::string& name, const SampleBlock& block, int numSamples) {
+  VectorXd values(NUM_VARIABLES);
+  for(int i=0; i<numSamples; i++) {
+    block.GetSample(i, values);
+    for(int j=0; j<NUM_VARIABLES; j++) {
+      if(block(i, j) != GetValue(i, j) || values(j) != GetValue(i, j)) {
+        Fail(name + ": Sample " + std::to_string(i) + ", variable " + std::to_string(j) + " isn't the value stored");
+        return;
+      }
+    }
+  }
+}
+
+void SampleBlockTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
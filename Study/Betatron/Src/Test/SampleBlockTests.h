@@ -0,0 +1,56 @@
+/**********************************************************************
+
+File     : SampleBlockTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the contiguous block of sampled values.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Both layouts are checked to store and view the same values, and to
+           keep them through Resize up and down, along with SampledData and
+           SampledDerivedData shrinking and answering Min and Max when empty.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_SAMPLE_BLOCK_TESTS_H__
+#define __BACH_SAMPLE_BLOCK_TESTS_H__
+
+#include "BachDefs.h"
+#include "SampleBlock.h"
+#include <string>
+
+namespace Bach {
+
+  //********************
+  //* SampleBlockTests *
+  //********************
+
+  class SampleBlockTests {
+  public:
+
+    static boost::shared_ptr<SampleBlockTests> CreateInstance();
+
+    ~SampleBlockTests();
+
+    bool RunTests();
+
+  protected:
+    SampleBlockTests();
+
+    void TestStoreAndView(SampleBlock::Layout layout);
+    void TestResize(SampleBlock::Layout layout);
+    void TestSampledDataResize(SampleBlock::Layout layout);
+    void TestEmptyMinMax();
+
+    // Check that samples [0, numSamples) of block hold the values Fill put there.
+    void CheckValues(const std::string& name, const SampleBlock& block, int numSamples);
+
+    void Fail(const std::string& message);
+
+    bool m_success;
+  };
+};
+
+#endif // __BACH_SAMPLE_BLOCK_TESTS_H__
@@ -0,0 +1,313 @@
+/**********************************************************************
+
+File     : SampledDataInterpTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the interpolated retrieval of sampled data.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "SampledDataInterpTests.h"
+#include "SampledData.h"
+#include "SampledDerivedData.h"
+#include "BarycentricInterp.h"
+#include "PolynomialInterp.h"
+#include "BisectionHunt.h"
+#include "InterpolationIndex.h"
+#include <boost/lexical_cast.hpp>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const int NUM_DEPENDENT = 5;
+  const int NUM_SAMPLES = 200;
+  const double TOLERANCE = 1.0e-12;
+
+  // Unevenly spaced, increasing abscissae.
+  double GetAbscissa(int i) {
+    return 0.01*i+0.003*sin(1.7*i);
+  }
+
+  double GetValue(int i, int j) {
+    double x = GetAbscissa(i);
+    return (j+1)*cos((j+1)*x)+j*x*x;
+  }
+
+  bool IsClose(double a, double b) {
+    return fabs(a-b) <= TOLERANCE*(1.0+fabs(b));
+  }
+
+  std::string AsString(double value) {
+    return lexical_cast<std::string>(value);
+  }
+}
+
+  //**************************
+  //* SampledDataInterpTests *
+  //**************************
+
+shared_ptr<SampledDataInterpTests> SampledDataInterpTests::CreateInstance() {
+  shared_ptr<SampledDataInterpTests> instance(new SampledDataInterpTests);
+  return instance;
+}
+
+SampledDataInterpTests::SampledDataInterpTests() :
+  m_success(false)
+{
+}
+
+SampledDataInterpTests::~SampledDataInterpTests() {
+}
+
+bool SampledDataInterpTests::RunTests() {
+  m_success = true;
+
+  TestBarycentricInterp(2);
+  TestBarycentricInterp(3);
+  TestBarycentricInterp(5);
+  TestBarycentricInterp(8);
+  TestRetrieve(SampleBlock::VariableContiguous, "VariableContiguous");
+  TestRetrieve(SampleBlock::SampleContiguous, "SampleContiguous");
+  TestEqualAbscissae();
+  TestBatchRetrieve(SampleBlock::VariableContiguous, "VariableContiguous", 1.0);
+  TestBatchRetrieve(SampleBlock::SampleContiguous, "SampleContiguous", 1.0);
+  TestBatchRetrieve(SampleBlock::VariableContiguous, "Descending", -1.0);
+
+  if(m_success) {
+    Log(L"Sampled data interpolation tests succeeded");
+  }
+  return m_success;
+}
+
+void SampledDataInterpTests::TestBarycentricInterp(int numberOfPoints) {
+  std::string name = "BarycentricInterp("+lexical_cast<std::string>(numberOfPoints)+")";
+
+  VectorXd x(numberOfPoints+2);
+  for(int i=0; i<x.rows(); i++) {
+    x(i) = GetAbscissa(i);
+  }
+  MatrixXd y(NUM_DEPENDENT, numberOfPoints);
+  for(int j=0; j<NUM_DEPENDENT; j++) {
+    for(int i=0; i<numberOfPoints; i++) {
+      y(j, i) = GetValue(i+1, j);
+    }
+  }
+
+  BarycentricInterp interp(numberOfPoints);
+  PolynomialInterp reference(numberOfPoints);
+  if(!interp.SetAbscissae(x, 1)) {
+    Fail(name+": distinct abscissae reported as equal");
+    return;
+  }
+
+  VectorXd result(NUM_DEPENDENT);
+  VectorXd column(numberOfPoints);
+  for(int k=0; k<=4*numberOfPoints; k++) {
+    // Through and a little beyond the points, on every point.
+    double xTarget = x(0)+k*(x(numberOfPoints+1)-x(0))/(4*numberOfPoints);
+    if(k % 4 == 0) {
+      xTarget = x(k/4+(k == 4*numberOfPoints ? 1 : 0));
+    }
+    interp.Interpolate(xTarget, y, result);
+    for(int j=0; j<NUM_DEPENDENT; j++) {
+      column = y.row(j).transpose();
+      double expected = reference.Interpolate(xTarget, x.segment(1, numberOfPoints), column);
+      if(!IsClose(result(j), expected) || !IsClose(interp.Interpolate(xTarget, y, j), expected)) {
+        Fail(name+": column "+lexical_cast<std::string>(j)+" at "+AsString(xTarget)+" is "+AsString(result(j))+" not "+AsString(expected));
+        return;
+      }
+    }
+  }
+
+  // Exactly the stored value on a point.
+  interp.Interpolate(x(2), y, result);
+  if(result != y.col(1)) {
+    Fail(name+": the value on a point is not the stored value");
+  }
+}
+
+void SampledDataInterpTests::TestRetrieve(SampleBlock::Layout layout, const std::string& name) {
+  // Small to start with, so it is resized while the window is cached.
+  SampledData data(NUM_DEPENDENT, NUM_SAMPLES/4, layout);
+  VectorXd y(NUM_DEPENDENT);
+  for(int i=0; i<NUM_SAMPLES; i++) {
+    for(int j=0; j<NUM_DEPENDENT; j++) {
+      y(j) = GetValue(i, j);
+    }
+    if(i == data.GetMaxNumberOfSamples()) {
+      data.Resize(2*data.GetMaxNumberOfSamples());
+    }
+    data.Store(GetAbscissa(i), y);
+
+    // Stored and retrieved in turn, then the same target twice, then on a point.
+    if(i >= 3) {
+      CheckRetrieve(name+" growing", data, 0.5*(GetAbscissa(i-1)+GetAbscissa(i)));
+      CheckRetrieve(name+" growing", data, 0.5*(GetAbscissa(i-1)+GetAbscissa(i)));
+      CheckRetrieve(name+" growing", data, GetAbscissa(i-2));
+    }
+  }
+
+  // Forwards, backwards and jumping about, so windows are both reused and changed.
+  for(int i=0; i<4*NUM_SAMPLES; i++) {
+    CheckRetrieve(name+" forwards", data, GetAbscissa(NUM_SAMPLES-1)*i/(4*NUM_SAMPLES));
+  }
+  for(int i=4*NUM_SAMPLES; i>=0; i--) {
+    CheckRetrieve(name+" backwards", data, GetAbscissa(NUM_SAMPLES-1)*i/(4*NUM_SAMPLES));
+  }
+  for(int i=0; i<NUM_SAMPLES; i++) {
+    CheckRetrieve(name+" jumping", data, GetAbscissa((37*i) % NUM_SAMPLES)+0.001);
+  }
+
+  // New values after a reset replace the cached window.
+  double xTarget = 0.5*(GetAbscissa(4)+GetAbscissa(5));
+  CheckRetrieve(name+" before reset", data, xTarget);
+  data.Reset();
+  for(int i=0; i<NUM_SAMPLES/2; i++) {
+    for(int j=0; j<NUM_DEPENDENT; j++) {
+      y(j) = -2.0*GetValue(i, j);
+    }
+    data.Store(GetAbscissa(i), y);
+  }
+  CheckRetrieve(name+" after reset", data, xTarget);
+
+  // As should fewer samples after a shrink.
+  data.Resize(NUM_SAMPLES/4);
+  CheckRetrieve(name+" after shrinking", data, GetAbscissa(NUM_SAMPLES/4-1));
+}
+
+void SampledDataInterpTests::TestEqualAbscissae() {
+  // A time stored twice, as when an integration is continued from where it stopped.
+  SampledData data(NUM_DEPENDENT, 8);
+  VectorXd y(NUM_DEPENDENT);
+  int times[] = { 0, 1, 2, 2, 3, 4, 5, 6 };
+  for(int k=0; k<8; k++) {
+    for(int j=0; j<NUM_DEPENDENT; j++) {
+      y(j) = GetValue(times[k], j);
+    }
+    data.Store(GetAbscissa(times[k]), y);
+  }
+
+  BarycentricInterp interp(3);
+  VectorXd x(3);
+  x << 1.0, 2.0, 2.0;
+  if(interp.SetAbscissae(x)) {
+    Fail("BarycentricInterp: equal abscissae not reported");
+  }
+
+  // There is no polynomial through the window about the repeated time, so that is an
+  // error, but the samples further on still interpolate.
+  bool threw = false;
+  try {
+    data.Retrieve(0.5*(GetAbscissa(1)+GetAbscissa(2)), y);
+  }
+  catch(std::exception&) {
+    threw = true;
+  }
+  if(!threw) {
+    Fail("SampledData: no error interpolating across equal abscissae");
+  }
+  CheckRetrieve("Equal abscissae", data, 0.5*(GetAbscissa(5)+GetAbscissa(6)));
+}
+
+void SampledDataInterpTests::TestBatchRetrieve(SampleBlock::Layout layout, const std::string& name, double direction) {
+  SampledData data(NUM_DEPENDENT, NUM_SAMPLES, layout);
+  SampledDerivedData derived(NUM_DEPENDENT, NUM_SAMPLES, layout);
+  VectorXd y(NUM_DEPENDENT);
+  VectorXd dy(NUM_DEPENDENT);
+  for(int i=0; i<NUM_SAMPLES; i++) {
+    for(int j=0; j<NUM_DEPENDENT; j++) {
+      y(j) = GetValue(i, j);
+      dy(j) = -(j+1)*(j+1)*sin((j+1)*GetAbscissa(i))+2.0*j*GetAbscissa(i);
+    }
+    data.Store(direction*GetAbscissa(i), y);
+    derived.Store(direction*GetAbscissa(i), y, direction*dy);
+  }
+  double xEnd = direction*GetAbscissa(NUM_SAMPLES-1);
+
+  // Many targets between each pair of samples, from a little before the first to a little after the last.
+  VectorXd dense = VectorXd::LinSpaced(10*NUM_SAMPLES, -0.05*xEnd, 1.05*xEnd);
+  CheckBatchRetrieve(name+" dense", data, dense);
+  CheckBatchRetrieve(name+" dense", derived, dense);
+
+  // Fewer targets than samples, some on them.
+  VectorXd sparse(NUM_SAMPLES/7);
+  for(int k=0; k<sparse.rows(); k++) {
+    sparse(k) = (k % 2 == 0 ? direction*GetAbscissa(7*k) : direction*0.5*(GetAbscissa(7*k)+GetAbscissa(7*k+1)));
+  }
+  CheckBatchRetrieve(name+" sparse", data, sparse);
+  CheckBatchRetrieve(name+" sparse", derived, sparse);
+
+  // Out of order targets are still right, only not found in one pass.
+  VectorXd jumping(NUM_SAMPLES);
+  for(int k=0; k<NUM_SAMPLES; k++) {
+    jumping(k) = direction*(GetAbscissa((37*k) % NUM_SAMPLES)+0.001);
+  }
+  CheckBatchRetrieve(name+" jumping", data, jumping);
+  CheckBatchRetrieve(name+" jumping", derived, jumping);
+
+  // And one target, or none.
+  CheckBatchRetrieve(name+" single", data, dense.segment(5, 1));
+  CheckBatchRetrieve(name+" single", derived, dense.segment(5, 1));
+  CheckBatchRetrieve(name+" empty", data, VectorXd());
+  CheckBatchRetrieve(name+" empty", derived, VectorXd());
+}
+
+template <class DataType>
+void SampledDataInterpTests::CheckBatchRetrieve(const std::string& name, DataType& data, const VectorXd& xTargets) {
+  MatrixXd batch;
+  data.Retrieve(xTargets, batch);
+  if(batch.rows() != NUM_DEPENDENT || batch.cols() != xTargets.rows()) {
+    Fail(name+": the batch result is "+lexical_cast<std::string>(batch.rows())+" by "+lexical_cast<std::string>(batch.cols()));
+    return;
+  }
+
+  VectorXd y(NUM_DEPENDENT);
+  for(int k=0; k<xTargets.rows(); k++) {
+    data.Retrieve(xTargets(k), y);
+    for(int j=0; j<NUM_DEPENDENT; j++) {
+      if(!IsClose(batch(j, k), y(j))) {
+        Fail(name+": column "+lexical_cast<std::string>(j)+" at "+AsString(xTargets(k))+" is "+AsString(batch(j, k))+" not "+AsString(y(j)));
+        return;
+      }
+    }
+  }
+}
+
+void SampledDataInterpTests::CheckRetrieve(const std::string& name, SampledData& data, double xTarget) {
+  int numberOfSamples = data.GetNumberOfSamples();
+  VectorXd x(numberOfSamples);
+  for(int i=0; i<numberOfSamples; i++) {
+    x(i) = data(i);
+  }
+
+  // As Retrieve did before BarycentricInterp, a Neville tableau for each column.
+  PolynomialInterp reference(3);
+  BisectionHunt hunter;
+  int indexLow = InterpolationIndex::ChooseInterpolationIndex(numberOfSamples, hunter.Find(xTarget, x), 3);
+  VectorXd window(3);
+
+  VectorXd y(NUM_DEPENDENT);
+  data.Retrieve(xTarget, y);
+  for(int j=0; j<NUM_DEPENDENT; j++) {
+    for(int i=0; i<3; i++) {
+      window(i) = data(indexLow+i, j);
+    }
+    double expected = reference.Interpolate(xTarget, x.segment(indexLow, 3), window);
+    double single = data.Retrieve(xTarget, j);
+    if(!IsClose(y(j), expected) || !IsClose(single, expected)) {
+      Fail(name+": column "+lexical_cast<std::string>(j)+" at "+AsString(xTarget)+" is "+AsString(y(j))+" and "+AsString(single)+" not "+AsString(expected));
+      return;
+    }
+  }
+}
+
+void SampledDataInterpTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
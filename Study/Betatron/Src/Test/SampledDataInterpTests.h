@@ -0,0 +1,64 @@
+/**********************************************************************
+
+File     : SampledDataInterpTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the interpolated retrieval of sampled data.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           BarycentricInterp and SampledData::Retrieve at a target are checked
+           against PolynomialInterp run one column at a time, for both sample
+           layouts and with the cached window reused, grown past and reset.
+           The batch retrievals of SampledData and SampledDerivedData are
+           checked against retrieving each target on its own.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_SAMPLED_DATA_INTERP_TESTS_H__
+#define __BACH_SAMPLED_DATA_INTERP_TESTS_H__
+
+#include "BachDefs.h"
+#include "SampleBlock.h"
+#include <string>
+
+namespace Bach {
+
+  class SampledData;
+
+  //**************************
+  //* SampledDataInterpTests *
+  //**************************
+
+  class SampledDataInterpTests {
+  public:
+
+    static boost::shared_ptr<SampledDataInterpTests> CreateInstance();
+
+    ~SampledDataInterpTests();
+
+    bool RunTests();
+
+  protected:
+    SampledDataInterpTests();
+
+    void TestBarycentricInterp(int numberOfPoints);
+    void TestRetrieve(SampleBlock::Layout layout, const std::string& name);
+    void TestEqualAbscissae();
+    void TestBatchRetrieve(SampleBlock::Layout layout, const std::string& name, double direction);
+
+    // The batch Retrieve of data at xTargets against Retrieve at each target in turn.
+    template <class DataType>
+    void CheckBatchRetrieve(const std::string& name, DataType& data, const Eigen::VectorXd& xTargets);
+
+    // Both forms of Retrieve at xTarget against PolynomialInterp over the stored samples.
+    void CheckRetrieve(const std::string& name, SampledData& data, double xTarget);
+
+    void Fail(const std::string& message);
+
+    bool m_success;
+  };
+};
+
+#endif // __BACH_SAMPLED_DATA_INTERP_TESTS_H__
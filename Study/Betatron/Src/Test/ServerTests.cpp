@@ -0,0 +1,387 @@
+/**********************************************************************
+
+File     : ServerTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the HTTP server over a loopback socket.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "ServerTests.h"
+#include "server.hpp"
+#include <asio.hpp>
+#include <poll.h>
+#include <cctype>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+using namespace Bach;
+
+namespace {
+  const std::chrono::seconds IDLE_TIMEOUT(30);
+  const std::chrono::milliseconds SHORT_IDLE_TIMEOUT(300);
+  const int CLOSE_WAIT_MS = 5000;     // For the server to close a connection it is done with.
+  const int EXTRA_REPLY_WAIT_MS = 200; // For a reply that shouldn't be sent at all.
+  const int REPLY_WAIT_MS = 60000;    // The longest any reply here may take.
+  const int SOLVE_START_MS = 200;     // For the server to read a request and start solving.
+
+  // Five rotations, about a second or more of solving.
+  const std::string LONG_SOLVE = "/?do={\"system\":\"betatron\",\"inputs\":{\"radius\":0.1,\"speed\":0.5,\"tolerance\":1e-3}}";
+
+  std::string MakeRequest(const std::string& target, const std::string& version = "HTTP/1.1", const std::string& headers = "") {
+    return "GET " + target + " " + version + "\r\nHost: localhost\r\n" + headers + "\r\n";
+  }
+
+  std::string ToLower(std::string text) {
+    for(size_t i=0; i<text.size(); i++) {
+      text[i] = (char) std::tolower((unsigned char) text[i]);
+    }
+    return text;
+  }
+
+  //*********
+  //* Reply *
+  //*********
+
+  struct Reply {
+    std::string version;
+    int status;
+    std::vector<std::pair<std::string, std::string> > headers; // Names in lower case.
+    std::string content;
+
+    std::string GetHeader(const std::string& name) const {
+      for(size_t i=0; i<headers.size(); i++) {
+        if(headers[i].first == name) {
+          return headers[i].second;
+        }
+      }
+      return "";
+    }
+  };
+
+  //**********
+  //* Client *
+  //**********
+
+  // A blocking client, keeping what it has read past one reply for the next.
+  class Client {
+  public:
+    Client(asio::io_service& ioService, unsigned short port) : m_socket(ioService) {
+      m_socket.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), port));
+      m_socket.set_option(asio::ip::tcp::no_delay(true));
+    }
+
+    void Send(const std::string& text) {
+      asio::write(m_socket, asio::buffer(text));
+    }
+
+    // True if the server has sent something, or closed, within the time.
+    bool WaitForInput(int milliseconds) {
+      if(m_input.size() > 0) {
+        return true;
+      }
+      pollfd descriptor = { m_socket.native_handle(), POLLIN, 0 };
+      return poll(&descriptor, 1, milliseconds) > 0;
+    }
+
+    // True if the server closes the connection within the time, without sending anything more.
+    bool IsClosedWithin(int milliseconds) {
+      if(m_input.size() > 0 || !WaitForInput(milliseconds)) {
+        return false;
+      }
+      asio::error_code ec;
+      char byte;
+      size_t bytes = m_socket.read_some(asio::buffer(&byte, 1), ec);
+      return (bytes == 0 && ec);
+    }
+
+    // Read one reply, framed by its Content-Length, chunked transfer encoding or the
+    // connection closing. False if the connection closed first or the framing is wrong.
+    bool ReadReply(Reply& reply) {
+      if(!WaitForInput(REPLY_WAIT_MS)) {
+        return false;
+      }
+      asio::error_code ec;
+      size_t headerBytes = asio::read_until(m_socket, m_input, "\r\n\r\n", ec);
+      if(ec) {
+        return false;
+      }
+      std::string head = Take(headerBytes);
+
+      size_t lineEnd = head.find("\r\n");
+      std::string statusLine = head.substr(0, lineEnd);
+      size_t space = statusLine.find(' ');
+      if(space == std::string::npos) {
+        return false;
+      }
+      reply.version = statusLine.substr(0, space);
+      reply.status = std::atoi(statusLine.c_str()+space+1);
+      reply.headers.clear();
+      reply.content.clear();
+      for(size_t start=lineEnd+2; start<head.size()-2; ) {
+        size_t end = head.find("\r\n", start);
+        std::string line = head.substr(start, end-start);
+        size_t colon = line.find(':');
+        if(colon == std::string::npos) {
+          return false;
+        }
+        size_t valueStart = line.find_first_not_of(' ', colon+1);
+        reply.headers.push_back(std::make_pair(ToLower(line.substr(0, colon)),
+                                               valueStart == std::string::npos ? "" : line.substr(valueStart)));
+        start = end+2;
+      }
+
+      if(ToLower(reply.GetHeader("transfer-encoding")) == "chunked") {
+        for(;;) {
+          std::string sizeLine;
+          if(!ReadLine(sizeLine)) {
+            return false;
+          }
+          char* end;
+          size_t size = std::strtoul(sizeLine.c_str(), &end, 16);
+          if(sizeLine.empty() || (*end != '\0' && *end != ';')) {
+            return false;
+          }
+          if(size == 0) {
+            // Trailers, if any, up to an empty line.
+            std::string line;
+            do {
+              if(!ReadLine(line)) {
+                return false;
+              }
+            } while(!line.empty());
+            return true;
+          }
+          if(!ReadBytes(size+2)) {
+            return false;
+          }
+          std::string chunk = Take(size+2);
+          if(chunk.compare(size, 2, "\r\n") != 0) {
+            return false;
+          }
+          reply.content.append(chunk, 0, size);
+        }
+      }
+
+      std::string contentLength = reply.GetHeader("content-length");
+      if(!contentLength.empty()) {
+        size_t length = std::strtoul(contentLength.c_str(), 0, 10);
+        if(!ReadBytes(length)) {
+          return false;
+        }
+        reply.content = Take(length);
+        return true;
+      }
+
+      // Without either, the content runs to the end of the connection.
+      asio::read(m_socket, m_input, asio::transfer_all(), ec);
+      if(ec != asio::error::eof) {
+        return false;
+      }
+      reply.content = Take(m_input.size());
+      return true;
+    }
+
+  private:
+    std::string Take(size_t bytes) {
+      std::string text(asio::buffers_begin(m_input.data()), asio::buffers_begin(m_input.data())+bytes);
+      m_input.consume(bytes);
+      return text;
+    }
+
+    bool ReadLine(std::string& line) {
+      asio::error_code ec;
+      size_t bytes = asio::read_until(m_socket, m_input, "\r\n", ec);
+      if(ec) {
+        return false;
+      }
+      line = Take(bytes);
+      line.resize(line.size()-2);
+      return true;
+    }
+
+    bool ReadBytes(size_t bytes) {
+      if(m_input.size() >= bytes) {
+        return true;
+      }
+      asio::error_code ec;
+      asio::read(m_socket, m_input, asio::transfer_exactly(bytes-m_input.size()), ec);
+      return !ec;
+    }
+
+    asio::ip::tcp::socket m_socket;
+    asio::streambuf m_input;
+  };
+}
+
+  //***************
+  //* ServerTests *
+  //***************
+
+boost::shared_ptr<ServerTests> ServerTests::CreateInstance() {
+  boost::shared_ptr<ServerTests> instance(new ServerTests);
+  return instance;
+}
+
+ServerTests::ServerTests() :
+  m_success(false)
+{
+}
+
+ServerTests::~ServerTests() {
+  StopServer();
+}
+
+bool ServerTests::RunTests() {
+  m_success = true;
+  TestStatsDuringSolve();
+  TestPipelined();
+  TestConnectionClose();
+  TestHttp10();
+  TestIdleTimeout();
+
+  if(m_success) {
+    Log(L"Server tests succeeded");
+  }
+  return m_success;
+}
+
+void ServerTests::TestStatsDuringSolve() {
+  // One I/O thread and one compute thread, so /stats could only be answered during the
+  // solve if the solve is off the I/O thread.
+  StartServer(IDLE_TIMEOUT);
+  asio::io_service ioService;
+  Client solveClient(ioService, m_server->port());
+  Client statsClient(ioService, m_server->port());
+
+  solveClient.Send(MakeRequest(LONG_SOLVE));
+  std::this_thread::sleep_for(std::chrono::milliseconds(SOLVE_START_MS));
+  if(solveClient.WaitForInput(0)) {
+    Fail("The long solve was answered too soon to test /stats during it");
+  }
+
+  Reply stats;
+  statsClient.Send(MakeRequest("/stats"));
+  if(!statsClient.ReadReply(stats) || stats.status != 200 || stats.content.empty() || stats.content[0] != '{') {
+    Fail("/stats wasn't answered during a solve");
+  }
+  if(solveClient.WaitForInput(0)) {
+    Fail("/stats wasn't answered until the solve had finished");
+  }
+
+  Reply solve;
+  if(!solveClient.ReadReply(solve) || solve.status != 200 || solve.content.empty()) {
+    Fail("The long solve wasn't answered");
+  }
+  StopServer();
+}
+
+void ServerTests::TestPipelined() {
+  // A solve, whose reply is chunked, and /stats, whose reply has a length, sent in one
+  // write. The replies must come back in order, each framed so the next can be found.
+  StartServer(IDLE_TIMEOUT);
+  asio::io_service ioService;
+  Client client(ioService, m_server->port());
+  client.Send(MakeRequest(LONG_SOLVE) + MakeRequest("/stats"));
+
+  Reply solve;
+  if(!client.ReadReply(solve)) {
+    Fail("The first of two pipelined replies was misframed");
+  }
+  else if(solve.version != "HTTP/1.1" || solve.status != 200 ||
+          ToLower(solve.GetHeader("connection")) != "keep-alive" || solve.content.empty() || solve.content[0] != '{') {
+    Fail("The first of two pipelined replies was wrong");
+  }
+
+  Reply stats;
+  if(!client.ReadReply(stats)) {
+    Fail("The second of two pipelined replies was misframed");
+  }
+  else if(stats.version != "HTTP/1.1" || stats.status != 200 ||
+          ToLower(stats.GetHeader("connection")) != "keep-alive" || stats.content.empty() || stats.content[0] != '{') {
+    Fail("The second of two pipelined replies was wrong");
+  }
+
+  if(client.WaitForInput(EXTRA_REPLY_WAIT_MS)) {
+    Fail("More than two replies were sent to two pipelined requests");
+  }
+  StopServer();
+}
+
+void ServerTests::TestConnectionClose() {
+  StartServer(IDLE_TIMEOUT);
+  asio::io_service ioService;
+  Client client(ioService, m_server->port());
+  client.Send(MakeRequest("/stats", "HTTP/1.1", "Connection: close\r\n"));
+
+  Reply stats;
+  if(!client.ReadReply(stats) || stats.status != 200) {
+    Fail("A request with Connection: close wasn't answered");
+  }
+  else if(ToLower(stats.GetHeader("connection")) != "close") {
+    Fail("A reply to Connection: close didn't say it would close");
+  }
+  if(!client.IsClosedWithin(CLOSE_WAIT_MS)) {
+    Fail("The connection wasn't closed after Connection: close");
+  }
+  StopServer();
+}
+
+void ServerTests::TestHttp10() {
+  StartServer(IDLE_TIMEOUT);
+  asio::io_service ioService;
+  Client client(ioService, m_server->port());
+  client.Send(MakeRequest("/stats", "HTTP/1.0"));
+
+  Reply stats;
+  if(!client.ReadReply(stats) || stats.status != 200) {
+    Fail("An HTTP/1.0 request wasn't answered");
+  }
+  else if(!stats.GetHeader("transfer-encoding").empty()) {
+    Fail("An HTTP/1.0 reply used a transfer encoding");
+  }
+  if(!client.IsClosedWithin(CLOSE_WAIT_MS)) {
+    Fail("The connection wasn't closed after an HTTP/1.0 request");
+  }
+  StopServer();
+}
+
+void ServerTests::TestIdleTimeout() {
+  StartServer(SHORT_IDLE_TIMEOUT);
+  asio::io_service ioService;
+  Client client(ioService, m_server->port());
+  client.Send(MakeRequest("/stats"));
+
+  Reply stats;
+  if(!client.ReadReply(stats) || stats.status != 200 || ToLower(stats.GetHeader("connection")) != "keep-alive") {
+    Fail("A request before the idle timeout wasn't answered with the connection kept alive");
+  }
+  if(!client.IsClosedWithin(CLOSE_WAIT_MS)) {
+    Fail("An idle connection wasn't closed after the timeout");
+  }
+  StopServer();
+}
+
+void ServerTests::StartServer(std::chrono::steady_clock::duration idleTimeout) {
+  m_server.reset(new http::server::server("127.0.0.1", "0", "", 1, 1, idleTimeout));
+  http::server::server* server = m_server.get();
+  m_serverThread = std::thread([server]() { server->run(); });
+}
+
+void ServerTests::StopServer() {
+  if(m_server) {
+    m_server->stop();
+    m_serverThread.join();
+    m_server.reset();
+  }
+}
+
+void ServerTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
@@ -0,0 +1,71 @@
+/**********************************************************************
+
+File     : ServerTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the HTTP server over a loopback socket.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The server is run on a port of the system's choosing and spoken
+           to as a client would. A request for the statistics is checked to
+           be answered while a long simulation is still being solved.
+           Also checked are the framing of pipelined replies, and that a
+           connection is closed when the client asks, when it speaks
+           HTTP/1.0 and when it has been idle for too long.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_SERVER_TESTS_H__
+#define __BACH_SERVER_TESTS_H__
+
+#include "BachDefs.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace http {
+  namespace server {
+    class server;
+  }
+}
+
+namespace Bach {
+
+  //***************
+  //* ServerTests *
+  //***************
+
+  class ServerTests {
+  public:
+
+    static boost::shared_ptr<ServerTests> CreateInstance();
+
+    ~ServerTests();
+
+    bool RunTests();
+
+  protected:
+    ServerTests();
+
+    void TestStatsDuringSolve();
+    void TestPipelined();
+    void TestConnectionClose();
+    void TestHttp10();
+    void TestIdleTimeout();
+
+    // Run a server on its own thread until StopServer.
+    void StartServer(std::chrono::steady_clock::duration idleTimeout);
+    void StopServer();
+
+    void Fail(const std::string& message);
+
+    std::unique_ptr<http::server::server> m_server;
+    std::thread m_serverThread;
+    bool m_success;
+  };
+};
+
+#endif // __BACH_SERVER_TESTS_H__
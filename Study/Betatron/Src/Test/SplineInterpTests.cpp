@@ -0,0 +1,382 @@
+/**********************************************************************
+
+File     : SplineInterpTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the cubic splines.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "SplineInterpTests.h"
+#include "SplineInterp.h"
+#include "HermiteInterp.h"
+#include "BisectionHunt.h"
+#include "SampledData.h"
+#include <boost/lexical_cast.hpp>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const int NUM_POINTS = 120;
+  const int NUM_TARGETS = 500;
+  const double TOLERANCE = 1.0e-12;
+
+  // Unevenly spaced abscissae, increasing or decreasing.
+  double GetAbscissa(int i, bool descending) {
+    double x = 0.1*i+0.03*sin(1.7*i);
+    return (descending ? -x : x);
+  }
+
+  double Cubic(double x) {
+    return 1.0+2.0*x-0.7*x*x+0.2*x*x*x;
+  }
+
+  double CubicSlope(double x) {
+    return 2.0-1.4*x+0.6*x*x;
+  }
+
+  // The same pseudo-random sequence in [0, 1) every run.
+  double NextRandom(unsigned int& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state/4294967296.0;
+  }
+
+  bool IsClose(double a, double b) {
+    return fabs(a-b) <= TOLERANCE*(1.0+fabs(b));
+  }
+
+  std::string AsString(double value) {
+    return lexical_cast<std::string>(value);
+  }
+}
+
+  //*********************
+  //* SplineInterpTests *
+  //*********************
+
+shared_ptr<SplineInterpTests> SplineInterpTests::CreateInstance() {
+  shared_ptr<SplineInterpTests> instance(new SplineInterpTests);
+  return instance;
+}
+
+SplineInterpTests::SplineInterpTests() :
+  m_success(false)
+{
+}
+
+SplineInterpTests::~SplineInterpTests() {
+}
+
+bool SplineInterpTests::RunTests() {
+  m_success = true;
+
+  TestNatural(false);
+  TestNatural(true);
+  TestClamped(false);
+  TestClamped(true);
+  TestMonotone();
+  TestTypeChange();
+  TestRepeatedPoint();
+  TestSampledData(SampleBlock::VariableContiguous, "Variable contiguous");
+  TestSampledData(SampleBlock::SampleContiguous, "Sample contiguous");
+
+  if(m_success) {
+    Log(L"Spline interpolation tests succeeded");
+  }
+  return m_success;
+}
+
+void SplineInterpTests::TestNatural(bool descending) {
+  std::string name = (descending ? "Natural descending" : "Natural");
+  VectorXd x(NUM_POINTS);
+  MatrixXd y(NUM_POINTS, 2);
+  for(int i=0; i<NUM_POINTS; i++) {
+    x(i) = GetAbscissa(i, descending);
+    y(i, 0) = sin(3.0*x(i))+0.1*x(i);
+    y(i, 1) = exp(-x(i)*x(i));
+  }
+
+  // After each point is appended the spline is that of the points so far.
+  SplineInterp spline(SplineInterp::Natural, 2);
+  VectorXd point(2);
+  VectorXd yResult(2);
+  for(int n=1; n<=NUM_POINTS; n++) {
+    point = y.row(n-1).transpose();
+    spline.Append(x(n-1), point);
+    if(n < 2 || (n > 12 && n%20 != 0)) {
+      continue;
+    }
+
+    for(int j=0; j<2; j++) {
+      VectorXd slopes = SolveNaturalSlopes(x.head(n), y.col(j).head(n));
+      for(int i=0; i<n; i++) {
+        if(!IsClose(spline.GetSlope(i, j), slopes(i))) {
+          Fail(name+": slope "+lexical_cast<std::string>(i)+" of "+lexical_cast<std::string>(n)+" points is "+AsString(spline.GetSlope(i, j))+" not "+AsString(slopes(i)));
+          return;
+        }
+      }
+
+      for(int i=0; i<n-1; i++) {
+        double xTarget = x(i)+0.3*(x(i+1)-x(i));
+        double expected = HermiteInterp::Interpolate(xTarget, x(i), x(i+1), y(i, j), y(i+1, j), slopes(i), slopes(i+1));
+        spline.Interpolate(xTarget, i, yResult);
+        if(!IsClose(yResult(j), expected) || yResult(j) != spline.Interpolate(xTarget, i, j)) {
+          Fail(name+": at "+AsString(xTarget)+" gives "+AsString(yResult(j))+" not "+AsString(expected));
+          return;
+        }
+      }
+    }
+  }
+}
+
+void SplineInterpTests::TestClamped(bool descending) {
+  // A cubic clamped to its own slopes at the ends is the cubic.
+  std::string name = (descending ? "Clamped descending" : "Clamped");
+  VectorXd x(NUM_POINTS);
+  for(int i=0; i<NUM_POINTS; i++) {
+    x(i) = GetAbscissa(i, descending)-2.0;
+  }
+
+  SplineInterp spline(SplineInterp::Clamped, 1);
+  VectorXd start(1);
+  VectorXd end(1);
+  start << CubicSlope(x(0));
+  end << CubicSlope(x(NUM_POINTS-1));
+  spline.SetEndSlopes(start, end);
+
+  VectorXd point(1);
+  for(int i=0; i<NUM_POINTS; i++) {
+    point << Cubic(x(i));
+    spline.Append(x(i), point);
+  }
+
+  BisectionHunt bisection;
+  unsigned int state = 2463534242u;
+  for(int k=0; k<NUM_TARGETS; k++) {
+    double xTarget = x(0)+(x(NUM_POINTS-1)-x(0))*NextRandom(state);
+    double value = spline.Interpolate(xTarget, bisection.Find(xTarget, x), 0);
+    if(!IsClose(value, Cubic(xTarget))) {
+      Fail(name+": at "+AsString(xTarget)+" gives "+AsString(value)+" not "+AsString(Cubic(xTarget)));
+      return;
+    }
+  }
+}
+
+void SplineInterpTests::TestMonotone() {
+  // A step, in one column going up and in the other down, which a natural spline overshoots.
+  VectorXd x(9);
+  VectorXd y(9);
+  x << 0.0, 1.0, 1.5, 2.0, 4.0, 4.2, 5.0, 7.0, 7.1;
+  y << 0.0, 0.0, 0.1, 1.0, 1.0, 1.05, 3.0, 3.0, 3.5;
+
+  SplineInterp monotone(SplineInterp::Monotone, 2);
+  SplineInterp natural(SplineInterp::Natural, 2);
+  VectorXd point(2);
+  for(int i=0; i<x.rows(); i++) {
+    point << y(i), -y(i);
+    monotone.Append(x(i), point);
+    natural.Append(x(i), point);
+  }
+
+  bool naturalOvershoots = false;
+  VectorXd yResult(2);
+  VectorXd yNatural(2);
+  VectorXd yLast(2);
+  for(int i=0; i<x.rows()-1; i++) {
+    yLast << y(i), -y(i);
+    for(int k=1; k<=50; k++) {
+      double xTarget = x(i)+k*(x(i+1)-x(i))/50.0;
+      monotone.Interpolate(xTarget, i, yResult);
+      natural.Interpolate(xTarget, i, yNatural);
+      naturalOvershoots = naturalOvershoots || yNatural(0) < y(i) || yNatural(0) > y(i+1);
+
+      if(yResult(0) < yLast(0)-TOLERANCE || yResult(1) > yLast(1)+TOLERANCE || yResult(0) > y(i+1)+TOLERANCE) {
+        Fail("Monotone: at "+AsString(xTarget)+" gives "+AsString(yResult(0))+" and "+AsString(yResult(1))+" after "+AsString(yLast(0)));
+        return;
+      }
+      yLast = yResult;
+    }
+  }
+  if(!naturalOvershoots) {
+    Fail("Monotone: the natural spline doesn't overshoot the data either");
+  }
+
+  // A straight line is kept straight.
+  SplineInterp line(SplineInterp::Monotone, 1);
+  for(int i=0; i<x.rows(); i++) {
+    point.resize(1);
+    point << 2.0*x(i)-1.0;
+    line.Append(x(i), point);
+  }
+  for(int i=0; i<x.rows()-1; i++) {
+    double xTarget = 0.5*(x(i)+x(i+1));
+    if(!IsClose(line.Interpolate(xTarget, i, 0), 2.0*xTarget-1.0)) {
+      Fail("Monotone: a line gives "+AsString(line.Interpolate(xTarget, i, 0))+" at "+AsString(xTarget));
+      return;
+    }
+  }
+}
+
+void SplineInterpTests::TestTypeChange() {
+  // Changing the type or the end slopes refits the points already there.
+  SplineInterp changed(SplineInterp::Natural, 1);
+  SplineInterp clamped(SplineInterp::Clamped, 1);
+  VectorXd start(1);
+  VectorXd end(1);
+  start << 1.0;
+  end << -2.0;
+  clamped.SetEndSlopes(start, end);
+
+  VectorXd point(1);
+  for(int i=0; i<NUM_POINTS; i++) {
+    point << cos(GetAbscissa(i, false));
+    changed.Append(GetAbscissa(i, false), point);
+    clamped.Append(GetAbscissa(i, false), point);
+  }
+  changed.SetType(SplineInterp::Clamped);
+  changed.SetEndSlopes(start, end);
+
+  for(int i=0; i<NUM_POINTS; i++) {
+    if(changed.GetSlope(i, 0) != clamped.GetSlope(i, 0)) {
+      Fail("Type change: slope "+lexical_cast<std::string>(i)+" is "+AsString(changed.GetSlope(i, 0))+" not "+AsString(clamped.GetSlope(i, 0)));
+      return;
+    }
+  }
+}
+
+void SplineInterpTests::TestRepeatedPoint() {
+  SplineInterp spline(SplineInterp::Natural, 1);
+  VectorXd point(1);
+  point << 1.0;
+  spline.Append(0.0, point);
+  spline.Append(1.0, point);
+
+  bool thrown = false;
+  try {
+    spline.Append(1.0, point);
+  }
+  catch(std::exception&) {
+    thrown = true;
+  }
+  if(!thrown) {
+    Fail("Repeated point: two points at the same x were accepted");
+  }
+
+  thrown = false;
+  try {
+    spline.Append(0.5, point);
+  }
+  catch(std::exception&) {
+    thrown = true;
+  }
+  if(!thrown || spline.GetNumberOfPoints() != 2) {
+    Fail("Repeated point: a point turning back was accepted");
+  }
+}
+
+void SplineInterpTests::TestSampledData(SampleBlock::Layout layout, const std::string& name) {
+  const int numDependent = 3;
+  SampledData data(numDependent, 10, layout);
+  shared_ptr<SplineInterp> reference(new SplineInterp(SplineInterp::Natural, numDependent));
+
+  // Some samples before the spline is set, which it is fitted to, and the rest after.
+  VectorXd x(NUM_POINTS);
+  VectorXd y(numDependent);
+  for(int i=0; i<NUM_POINTS; i++) {
+    if(data.GetNumberOfSamples() == data.GetMaxNumberOfSamples()) {
+      data.Resize(2*data.GetMaxNumberOfSamples());
+    }
+    x(i) = GetAbscissa(i, false);
+    for(int j=0; j<numDependent; j++) {
+      y(j) = cos((j+1)*x(i))+j;
+    }
+    data.Store(x(i), y);
+    reference->Append(x(i), y);
+    if(i == NUM_POINTS/3) {
+      data.SetSpline(shared_ptr<SplineInterp>(new SplineInterp(SplineInterp::Natural, numDependent)));
+    }
+  }
+
+  BisectionHunt bisection;
+  VectorXd xTargets(NUM_TARGETS);
+  VectorXd yExpected(numDependent);
+  VectorXd yResult(numDependent);
+  MatrixXd yBatch;
+  for(int pass=0; pass<2; pass++) {
+    int numSamples = data.GetNumberOfSamples();
+    for(int k=0; k<NUM_TARGETS; k++) {
+      xTargets(k) = x(0)+(x(numSamples-1)-x(0))*(k+0.37)/NUM_TARGETS;
+    }
+    data.Retrieve(xTargets, yBatch);
+
+    for(int k=0; k<NUM_TARGETS; k++) {
+      reference->Interpolate(xTargets(k), bisection.Find(xTargets(k), x.head(numSamples)), yExpected);
+      data.Retrieve(xTargets(k), yResult);
+      if(yResult != yExpected || yBatch.col(k) != yExpected || data.Retrieve(xTargets(k), 2) != yExpected(2)) {
+        Fail(name+": at "+AsString(xTargets(k))+" SampledData gives "+AsString(yResult(0))+" not "+AsString(yExpected(0)));
+        return;
+      }
+    }
+
+    // Cut back, when the spline is fitted to the samples that are left.
+    data.Resize(NUM_POINTS/2);
+    reference->Reset(numDependent);
+    for(int i=0; i<NUM_POINTS/2; i++) {
+      for(int j=0; j<numDependent; j++) {
+        y(j) = cos((j+1)*x(i))+j;
+      }
+      reference->Append(x(i), y);
+    }
+  }
+
+  // Without the spline the samples are interpolated as before.
+  SampledData plain(numDependent, NUM_POINTS/2, layout);
+  for(int i=0; i<NUM_POINTS/2; i++) {
+    for(int j=0; j<numDependent; j++) {
+      y(j) = cos((j+1)*x(i))+j;
+    }
+    plain.Store(x(i), y);
+  }
+  data.SetSpline(shared_ptr<SplineInterp>());
+  plain.Retrieve(xTargets(7), yExpected);
+  data.Retrieve(xTargets(7), yResult);
+  if(yResult != yExpected) {
+    Fail(name+": without the spline gives "+AsString(yResult(0))+" not "+AsString(yExpected(0)));
+  }
+}
+
+VectorXd SplineInterpTests::SolveNaturalSlopes(const VectorXd& x, const VectorXd& y) {
+  int n = (int) x.rows();
+  MatrixXd a = MatrixXd::Zero(n, n);
+  VectorXd b(n);
+
+  a(0, 0) = 2.0;
+  a(0, 1) = 1.0;
+  b(0) = 3.0*(y(1)-y(0))/(x(1)-x(0));
+  for(int i=1; i<n-1; i++) {
+    double h0 = x(i)-x(i-1);
+    double h1 = x(i+1)-x(i);
+    a(i, i-1) = h1;
+    a(i, i) = 2.0*(h0+h1);
+    a(i, i+1) = h0;
+    b(i) = 3.0*(h1*(y(i)-y(i-1))/h0+h0*(y(i+1)-y(i))/h1);
+  }
+  a(n-1, n-2) = 1.0;
+  a(n-1, n-1) = 2.0;
+  b(n-1) = 3.0*(y(n-1)-y(n-2))/(x(n-1)-x(n-2));
+
+  return a.partialPivLu().solve(b);
+}
+
+void SplineInterpTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
@@ -0,0 +1,59 @@
+/**********************************************************************
+
+File     : SplineInterpTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the cubic splines.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           The natural spline is checked against a solve of its whole system
+           as the points are appended one at a time, the clamped spline
+           against a cubic it reproduces, the monotone spline for overshoot,
+           and the splines in SampledData against the spline on its own.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_SPLINE_INTERP_TESTS_H__
+#define __BACH_SPLINE_INTERP_TESTS_H__
+
+#include "BachDefs.h"
+#include "SampleBlock.h"
+#include <string>
+
+namespace Bach {
+
+  //*********************
+  //* SplineInterpTests *
+  //*********************
+
+  class SplineInterpTests {
+  public:
+
+    static boost::shared_ptr<SplineInterpTests> CreateInstance();
+
+    ~SplineInterpTests();
+
+    bool RunTests();
+
+  protected:
+    SplineInterpTests();
+
+    void TestNatural(bool descending);
+    void TestClamped(bool descending);
+    void TestMonotone();
+    void TestTypeChange();
+    void TestRepeatedPoint();
+    void TestSampledData(SampleBlock::Layout layout, const std::string& name);
+
+    // The slopes of the natural spline through x and y from its whole system at once.
+    Eigen::VectorXd SolveNaturalSlopes(const Eigen::VectorXd& x, const Eigen::VectorXd& y);
+
+    void Fail(const std::string& message);
+
+    bool m_success;
+  };
+};
+
+#endif // __BACH_SPLINE_INTERP_TESTS_H__
@@ -0,0 +1,211 @@
+/**********************************************************************
+
+File     : StreamingOdeDataTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of streaming ODE data to disk and back.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "StreamingOdeDataTests.h"
+#include "DenseOutputTests.h"
+#include "StreamingOdeDataCollector.h"
+#include "StreamedOdeData.h"
+#include "OdeData.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  // Six full chunks and a partial one, through a window that fills several times over.
+  const int NUM_SAMPLES = 100;
+  const int NUM_STOPPED = 5;
+  const int CHUNK_SIZE = 16;
+  const int WINDOW_SIZE = 10;
+  const double SPACING = 0.01;
+  const double HERMITE_TOLERANCE = 1.0e-9;
+
+  // The storage is stopped from a subclass, as OdeDataCollector's own overflow handling does.
+  class StoppableCollector : public StreamingOdeDataCollector {
+  public:
+    StoppableCollector(const std::string& filePath) : StreamingOdeDataCollector(filePath, WINDOW_SIZE, CHUNK_SIZE) {}
+
+    void StopStorage() {
+      SetStateStorageIsStopped(true);
+      SetInternalStorageIsStopped(true);
+    }
+  };
+
+  double GetSampleX(int i) {
+    return i*SPACING;
+  }
+
+  void GetSample(double x, VectorXd& y, VectorXd& dy, VectorXd& internals) {
+    y << cos(x), -sin(x);
+    dy << -sin(x), -cos(x);
+    internals << 2.0*x+1.0;
+  }
+}
+
+  //*************************
+  //* StreamingOdeDataTests *
+  //*************************
+
+shared_ptr<StreamingOdeDataTests> StreamingOdeDataTests::CreateInstance() {
+  shared_ptr<StreamingOdeDataTests> instance(new StreamingOdeDataTests);
+  return instance;
+}
+
+StreamingOdeDataTests::StreamingOdeDataTests() :
+  m_filePath((std::filesystem::temp_directory_path()/"bach_streaming_ode_data_tests.bin").string()),
+  m_success(false)
+{
+}
+
+StreamingOdeDataTests::~StreamingOdeDataTests() {
+  std::remove(m_filePath.c_str());
+}
+
+bool StreamingOdeDataTests::RunTests() {
+  m_success = true;
+  WriteSamples();
+  if(m_success) {
+    TestLayout();
+    TestRetrieveByIndex();
+    TestRetrieveByTarget();
+  }
+
+  if(m_success) {
+    Log(L"Streaming ODE data tests succeeded");
+  }
+  return m_success;
+}
+
+void StreamingOdeDataTests::WriteSamples() {
+  shared_ptr<HarmonicOscillatorOde> equations(new HarmonicOscillatorOde());
+  shared_ptr<OdeData> odeData = OdeData::CreateInstance(equations);
+  shared_ptr<StoppableCollector> collector(new StoppableCollector(m_filePath));
+
+  VectorXd y(2), dy(2), internals(1);
+  for(int i=0; i<NUM_SAMPLES; i++) {
+    GetSample(GetSampleX(i), y, dy, internals);
+    odeData->SetInternalValues(internals);
+    collector->StoreData(GetSampleX(i), y, dy, odeData);
+  }
+
+  // Stopped storage keeps samples out of the file as well as the window.
+  collector->StopStorage();
+  for(int i=NUM_SAMPLES; i<NUM_SAMPLES+NUM_STOPPED; i++) {
+    GetSample(GetSampleX(i), y, dy, internals);
+    odeData->SetInternalValues(internals);
+    collector->StoreData(GetSampleX(i), y, dy, odeData);
+  }
+
+  collector->Finish();
+  if(collector->GetNumberOfStatesWritten() != NUM_SAMPLES || collector->GetNumberOfInternalsWritten() != NUM_SAMPLES) {
+    Log(L"ERROR: StreamingOdeDataTests: %ld states and %ld internals written rather than %d",
+        collector->GetNumberOfStatesWritten(), collector->GetNumberOfInternalsWritten(), NUM_SAMPLES);
+    m_success = false;
+  }
+}
+
+void StreamingOdeDataTests::TestLayout() {
+  FILE* file = fopen(m_filePath.c_str(), "rb");
+  if(!file) {
+    Fail("Unable to open the streamed file");
+    return;
+  }
+
+  StreamedOdeDataHeader header;
+  if(fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, STREAMED_ODE_DATA_MAGIC, sizeof(header.magic)) != 0 ||
+     header.version != STREAMED_ODE_DATA_VERSION || header.numStates != 2 || header.numInternal != 1) {
+    Fail("The header is not the one written");
+    fclose(file);
+    return;
+  }
+
+  // Full chunks of each kind, then the partial ones written by Finish, with nothing after.
+  int numChunks[3] = { 0, 0, 0 };
+  int numSamples[3] = { 0, 0, 0 };
+  StreamedOdeDataChunk chunk;
+  while(fread(&chunk, sizeof(chunk), 1, file) == 1) {
+    bool isState = (chunk.kind == StreamedOdeDataChunk::StateChunk);
+    if((!isState && chunk.kind != StreamedOdeDataChunk::InternalChunk) || chunk.numColumns != (isState ? 4u : 1u) ||
+       chunk.numSamples == 0 || chunk.numSamples > (uint32_t) CHUNK_SIZE) {
+      Fail("A chunk header is not one written");
+      fclose(file);
+      return;
+    }
+    if(chunk.numSamples != (uint32_t) CHUNK_SIZE && numSamples[chunk.kind]+chunk.numSamples != (uint32_t) NUM_SAMPLES) {
+      Fail("A partial chunk comes before the end");
+    }
+    numChunks[chunk.kind]++;
+    numSamples[chunk.kind] += chunk.numSamples;
+    fseek(file, (long) (sizeof(double)*chunk.numSamples*(1+chunk.numColumns)), SEEK_CUR);
+  }
+  fclose(file);
+
+  int expectedChunks = (NUM_SAMPLES+CHUNK_SIZE-1)/CHUNK_SIZE;
+  for(int kind=StreamedOdeDataChunk::StateChunk; kind<=StreamedOdeDataChunk::InternalChunk; kind++) {
+    if(numChunks[kind] != expectedChunks || numSamples[kind] != NUM_SAMPLES) {
+      Log(L"ERROR: StreamingOdeDataTests: %d chunks of kind %d holding %d samples", numChunks[kind], kind, numSamples[kind]);
+      m_success = false;
+    }
+  }
+}
+
+void StreamingOdeDataTests::TestRetrieveByIndex() {
+  shared_ptr<StreamedOdeData> data = StreamedOdeData::CreateInstance(m_filePath);
+  if(data->GetNumberOfSamples() != NUM_SAMPLES || data->GetNumberOfInternalSamples() != NUM_SAMPLES || data->GetInternalLength() != 1) {
+    Log(L"ERROR: StreamingOdeDataTests: %d states and %d internals read back", data->GetNumberOfSamples(), data->GetNumberOfInternalSamples());
+    m_success = false;
+    return;
+  }
+
+  double x;
+  VectorXd y(2), dy(2), expectedY(2), expectedDy(2), internals(1);
+  for(int i=0; i<NUM_SAMPLES; i++) {
+    data->Retrieve(i, x, y, dy);
+    GetSample(GetSampleX(i), expectedY, expectedDy, internals);
+    if(x != GetSampleX(i) || y != expectedY || dy != expectedDy) {
+      Fail("Sample " + std::to_string(i) + " is not the one written");
+      return;
+    }
+  }
+}
+
+void StreamingOdeDataTests::TestRetrieveByTarget() {
+  shared_ptr<StreamedOdeData> data = StreamedOdeData::CreateInstance(m_filePath);
+
+  // Between every pair of samples, and on each sample, the chunk starts among them.
+  VectorXd y(2), dy(2), internals(1), expectedY(2), expectedInternals(1);
+  for(int i=0; i<2*NUM_SAMPLES-1; i++) {
+    double xTarget = 0.5*i*SPACING;
+    GetSample(xTarget, expectedY, dy, expectedInternals);
+
+    data->Retrieve(xTarget, y);
+    if((y-expectedY).cwiseAbs().maxCoeff() > HERMITE_TOLERANCE || fabs(data->Retrieve(xTarget, 1)-expectedY(1)) > HERMITE_TOLERANCE) {
+      Fail("The states at " + std::to_string(xTarget) + " are out");
+      return;
+    }
+
+    data->RetrieveInternal(xTarget, internals);
+    if(fabs(internals(0)-expectedInternals(0)) > 1.0e-12) {
+      Fail("The internal value at " + std::to_string(xTarget) + " is out");
+      return;
+    }
+  }
+}
+
+void StreamingOdeDataTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
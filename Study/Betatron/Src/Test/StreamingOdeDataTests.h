@@ -0,0 +1,53 @@
+/**********************************************************************
+
+File     : StreamingOdeDataTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of streaming ODE data to disk and back.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Samples are written over several full chunks and a partial one,
+           the file layout is checked, and StreamedOdeData reads them back
+           by index and by target across the chunk boundaries.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_STREAMING_ODE_DATA_TESTS_H__
+#define __BACH_STREAMING_ODE_DATA_TESTS_H__
+
+#include "BachDefs.h"
+#include <string>
+
+namespace Bach {
+
+  //*************************
+  //* StreamingOdeDataTests *
+  //*************************
+
+  class StreamingOdeDataTests {
+  public:
+
+    static boost::shared_ptr<StreamingOdeDataTests> CreateInstance();
+
+    ~StreamingOdeDataTests();
+
+    bool RunTests();
+
+  protected:
+    StreamingOdeDataTests();
+
+    void WriteSamples();
+    void TestLayout();
+    void TestRetrieveByIndex();
+    void TestRetrieveByTarget();
+
+    void Fail(const std::string& message);
+
+    std::string m_filePath;
+    bool m_success;
+  };
+};
+
+#endif // __BACH_STREAMING_ODE_DATA_TESTS_H__
@@ -0,0 +1,225 @@
+/**********************************************************************
+
+File     : TableSearchTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the table searches.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "TableSearchTests.h"
+#include "BisectionHunt.h"
+#include "EytzingerSearch.h"
+#include "SampledData.h"
+#include <boost/lexical_cast.hpp>
+
+using namespace Bach;
+using namespace boost;
+using namespace Eigen;
+
+namespace {
+  const int NUM_RANDOM_TARGETS = 500;
+
+  // The same pseudo-random sequence in [0, 1) every run.
+  double NextRandom(unsigned int& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state/4294967296.0;
+  }
+
+  std::string AsString(double value) {
+    return lexical_cast<std::string>(value);
+  }
+}
+
+  //********************
+  //* TableSearchTests *
+  //********************
+
+shared_ptr<TableSearchTests> TableSearchTests::CreateInstance() {
+  shared_ptr<TableSearchTests> instance(new TableSearchTests);
+  return instance;
+}
+
+TableSearchTests::TableSearchTests() :
+  m_success(false)
+{
+}
+
+TableSearchTests::~TableSearchTests() {
+}
+
+bool TableSearchTests::RunTests() {
+  m_success = true;
+
+  VectorXd uniform = VectorXd::LinSpaced(1001, -2.0, 3.0);
+  TestTable("Uniform", uniform, true);
+  TestTable("Uniform descending", -uniform, true);
+
+  // Times of fixed steps, which are only close to even.
+  VectorXd stepped(777);
+  stepped(0) = 0.0;
+  for(int i=1; i<stepped.rows(); i++) {
+    stepped(i) = stepped(i-1)+0.1;
+  }
+  TestTable("Stepped", stepped, true);
+
+  VectorXd uneven(1000);
+  for(int i=0; i<uneven.rows(); i++) {
+    uneven(i) = 0.01*i*i+i+0.5*sin((double) i);
+  }
+  TestTable("Uneven", uneven, false);
+  TestTable("Uneven descending", -uneven, false);
+
+  // Repeated values, where which of them is found matters.
+  VectorXd repeated(9);
+  repeated << 0.0, 1.0, 1.0, 1.0, 2.0, 3.0, 3.0, 4.0, 7.0;
+  TestTable("Repeated", repeated, false);
+  TestTable("Repeated descending", -repeated, false);
+
+  // Small tables, including sizes that fill the last level of the tree and those that don't.
+  for(int size=1; size<=17; size++) {
+    VectorXd small(size);
+    for(int i=0; i<size; i++) {
+      small(i) = i*i;
+    }
+    TestTable("Size "+lexical_cast<std::string>(size), small, size == 2);
+  }
+
+  TestGrowingTable();
+  TestChangedTable();
+  TestSampledData();
+
+  if(m_success) {
+    Log(L"Table search tests succeeded");
+  }
+  return m_success;
+}
+
+void TableSearchTests::TestTable(const std::string& name, const VectorXd& table, bool uniform) {
+  std::vector<double> targets = GetTargets(table);
+
+  EytzingerSearch search;
+  CheckSearches(name, search, table, targets);
+  if(search.IsUniform() != uniform) {
+    Fail(name+": EytzingerSearch took the table as "+(uniform ? "uneven" : "even"));
+  }
+}
+
+void TableSearchTests::TestGrowingTable() {
+  // Values added to the end of a table with room for more, searched as they come, as
+  // SampledData does while it is being filled.
+  VectorXd table(2000);
+  EytzingerSearch search;
+  unsigned int state = 2463534242u;
+  for(int size=1; size<=table.rows(); size++) {
+    table(size-1) = (size == 1 ? 0.0 : table(size-2)+0.5+NextRandom(state));
+    Ref<const VectorXd> stored = table.head(size);
+    std::vector<double> targets;
+    targets.push_back(table(size-1));
+    targets.push_back(table(size-1)+0.25);
+    targets.push_back(table(size-1)*NextRandom(state));
+    targets.push_back(table(size/2));
+    CheckSearches("Growing "+lexical_cast<std::string>(size), search, stored, targets);
+    if(!m_success) {
+      return;
+    }
+  }
+}
+
+void TableSearchTests::TestChangedTable() {
+  VectorXd table = VectorXd::LinSpaced(100, 0.0, 99.0);
+  EytzingerSearch search;
+  CheckSearches("Before change", search, table, GetTargets(table));
+
+  // The same table with new values, which the search is told about.
+  for(int i=0; i<table.rows(); i++) {
+    table(i) = i*sqrt((double) i);
+  }
+  search.TableChanged();
+  CheckSearches("After change", search, table, GetTargets(table));
+  if(search.IsUniform()) {
+    Fail("After change: EytzingerSearch kept the table as even");
+  }
+}
+
+void TableSearchTests::TestSampledData() {
+  SampledData standard(2, 10);
+  SampledData eytzinger(2, 10);
+  eytzinger.SetTableSearch(shared_ptr<TableSearch>(new EytzingerSearch()));
+
+  // Grown from a small start with retrievals along the way, then reset and filled again.
+  VectorXd y(2);
+  VectorXd yStandard(2);
+  VectorXd yEytzinger(2);
+  unsigned int state = 88172645u;
+  for(int pass=0; pass<2; pass++) {
+    double x = 0.0;
+    for(int i=0; i<500; i++) {
+      if(standard.GetNumberOfSamples() == standard.GetMaxNumberOfSamples()) {
+        standard.Resize(2*standard.GetMaxNumberOfSamples());
+        eytzinger.Resize(2*eytzinger.GetMaxNumberOfSamples());
+      }
+      x += (pass == 0 ? 0.01 : 0.01+0.02*NextRandom(state));
+      y << sin(x), cos(3.0*x+pass);
+      standard.Store(x, y);
+      eytzinger.Store(x, y);
+
+      if(i >= 3) {
+        double xTarget = x*NextRandom(state);
+        standard.Retrieve(xTarget, yStandard);
+        eytzinger.Retrieve(xTarget, yEytzinger);
+        if(yStandard != yEytzinger) {
+          Fail("SampledData: at "+AsString(xTarget)+" EytzingerSearch gives "+AsString(yEytzinger(0))+" not "+AsString(yStandard(0)));
+          return;
+        }
+      }
+    }
+    standard.Reset();
+    eytzinger.Reset();
+  }
+}
+
+std::vector<double> TableSearchTests::GetTargets(const VectorXd& table) {
+  std::vector<double> targets;
+  int size = (int) table.rows();
+  double span = fabs(table(size-1)-table(0))+1.0;
+  for(int i=0; i<size; i++) {
+    targets.push_back(table(i));
+    targets.push_back(nextafter(table(i), -HUGE_VAL));
+    targets.push_back(nextafter(table(i), HUGE_VAL));
+    if(i+1 < size) {
+      targets.push_back(0.5*(table(i)+table(i+1)));
+    }
+  }
+  targets.push_back(table.minCoeff()-span);
+  targets.push_back(table.maxCoeff()+span);
+
+  unsigned int state = 2463534242u;
+  for(int i=0; i<NUM_RANDOM_TARGETS; i++) {
+    targets.push_back(table.minCoeff()-0.1*span+1.2*span*NextRandom(state));
+  }
+  return targets;
+}
+
+void TableSearchTests::CheckSearches(const std::string& name, TableSearch& search, const Ref<const VectorXd>& table, const std::vector<double>& targets) {
+  BisectionHunt bisection;
+  for(size_t i=0; i<targets.size(); i++) {
+    int expected = bisection.Find(targets[i], table);
+    int found = search.Find(targets[i], table);
+    if(found != expected) {
+      Fail(name+": at "+AsString(targets[i])+" found "+lexical_cast<std::string>(found)+" not "+lexical_cast<std::string>(expected));
+      return;
+    }
+  }
+}
+
+void TableSearchTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
@@ -0,0 +1,61 @@
+/**********************************************************************
+
+File     : TableSearchTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the table searches.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           EytzingerSearch is checked against BisectionHunt on even, nearly
+           even and uneven tables, ascending
+           and descending, with targets on, between and beyond the values,
+           and on tables that grow, are changed in place and are searched
+           through SampledData.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_TABLE_SEARCH_TESTS_H__
+#define __BACH_TABLE_SEARCH_TESTS_H__
+
+#include "BachDefs.h"
+#include <string>
+#include <vector>
+
+namespace Bach {
+
+  //********************
+  //* TableSearchTests *
+  //********************
+
+  class TableSearchTests {
+  public:
+
+    static boost::shared_ptr<TableSearchTests> CreateInstance();
+
+    ~TableSearchTests();
+
+    bool RunTests();
+
+  protected:
+    TableSearchTests();
+
+    void TestTable(const std::string& name, const Eigen::VectorXd& table, bool uniform);
+    void TestGrowingTable();
+    void TestChangedTable();
+    void TestSampledData();
+
+    // Targets on, between, either side of and beyond the values of table, and at random.
+    std::vector<double> GetTargets(const Eigen::VectorXd& table);
+
+    // Every search of table at targets against BisectionHunt.
+    void CheckSearches(const std::string& name, TableSearch& search, const Eigen::Ref<const Eigen::VectorXd>& table, const std::vector<double>& targets);
+
+    void Fail(const std::string& message);
+
+    bool m_success;
+  };
+};
+
+#endif // __BACH_TABLE_SEARCH_TESTS_H__
@@ -0,0 +1,133 @@
+/**********************************************************************
+
+File     : TestMain.cpp
+Project  : Bach Simulation
+Purpose  : Source file for the main function of the test executable.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Runs the test classes named on the command line, or all of them,
+           and returns nonzero if any failed. CTest runs each class on its
+           own so a failure points at the class.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "BachDefs.h"
+#include "LogRingBuffer.h"
+#include "BaderDeuflhardOdeNTests.h"
+#include "BetatronDerivativesTests.h"
+#include "BorisPusherTests.h"
+#include "ColumnFormatTests.h"
+#include "DenseOutputTests.h"
+#include "ExplicitOdeTests.h"
+#include "JacobianTests.h"
+#include "JsonStreamWriterTests.h"
+#include "LinearSolveWorkspaceTests.h"
+#include "LogRingBufferTests.h"
+#include "MagneticFieldDerivTests.h"
+#include "OdeEventTests.h"
+#include "OdeTelemetryTests.h"
+#include "RequestHandlerTests.h"
+#include "ResultCacheTests.h"
+#include "SampleBlockTests.h"
+#include "SampledDataInterpTests.h"
+#include "ServerTests.h"
+#include "SplineInterpTests.h"
+#include "StreamingOdeDataTests.h"
+#include "TableSearchTests.h"
+#include "WorkStealingPoolTests.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace Bach;
+
+namespace {
+  template<class Tests>
+  bool Run() {
+    return Tests::CreateInstance()->RunTests();
+  }
+
+  struct TestClass {
+    const char* name;
+    bool (*run)();
+  };
+
+  const TestClass TEST_CLASSES[] = {
+    { "BaderDeuflhardOdeNTests",    Run<BaderDeuflhardOdeNTests> },
+    { "BetatronDerivativesTests",   Run<BetatronDerivativesTests> },
+    { "BorisPusherTests",           Run<BorisPusherTests> },
+    { "ColumnFormatTests",          Run<ColumnFormatTests> },
+    { "DenseOutputTests",           Run<DenseOutputTests> },
+    { "ExplicitOdeTests",           Run<ExplicitOdeTests> },
+    { "JacobianTests",              Run<JacobianTests> },
+    { "JsonStreamWriterTests",      Run<JsonStreamWriterTests> },
+    { "LinearSolveWorkspaceTests",  Run<LinearSolveWorkspaceTests> },
+    { "LogRingBufferTests",         Run<LogRingBufferTests> },
+    { "MagneticFieldDerivTests",    Run<MagneticFieldDerivTests> },
+    { "OdeEventTests",              Run<OdeEventTests> },
+    { "OdeTelemetryTests",          Run<OdeTelemetryTests> },
+    { "RequestHandlerTests",        Run<RequestHandlerTests> },
+    { "ResultCacheTests",           Run<ResultCacheTests> },
+    { "SampleBlockTests",           Run<SampleBlockTests> },
+    { "SampledDataInterpTests",     Run<SampledDataInterpTests> },
+    { "ServerTests",                Run<ServerTests> },
+    { "SplineInterpTests",          Run<SplineInterpTests> },
+    { "StreamingOdeDataTests",      Run<StreamingOdeDataTests> },
+    { "TableSearchTests",           Run<TableSearchTests> },
+    { "WorkStealingPoolTests",      Run<WorkStealingPoolTests> }
+  };
+
+  const int NUM_TEST_CLASSES = sizeof(TEST_CLASSES)/sizeof(TEST_CLASSES[0]);
+
+  bool IsTestClass(const char* name) {
+    for(int i=0; i<NUM_TEST_CLASSES; i++) {
+      if(std::strcmp(name, TEST_CLASSES[i].name) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if(argc == 2 && std::strcmp(argv[1], "--list") == 0) {
+    for(int i=0; i<NUM_TEST_CLASSES; i++) {
+      std::printf("%s\n", TEST_CLASSES[i].name);
+    }
+    return 0;
+  }
+
+  for(int j=1; j<argc; j++) {
+    if(!IsTestClass(argv[j])) {
+      Log(L"ERROR: TestMain: There is no test class %s", WideStringFromUTF8(argv[j]).c_str());
+      return 2;
+    }
+  }
+
+  bool succeeded = true;
+  for(int i=0; i<NUM_TEST_CLASSES; i++) {
+    bool selected = (argc == 1);
+    for(int j=1; j<argc; j++) {
+      selected = selected || std::strcmp(argv[j], TEST_CLASSES[i].name) == 0;
+    }
+    if(!selected) {
+      continue;
+    }
+
+    bool passed = false;
+    try {
+      passed = TEST_CLASSES[i].run();
+    }
+    catch(std::exception&) {
+      Log(L"ERROR: TestMain: %s threw an exception", WideStringFromUTF8(TEST_CLASSES[i].name).c_str());
+    }
+    Log(L"%s: %s", WideStringFromUTF8(TEST_CLASSES[i].name).c_str(), passed ? L"passed" : L"FAILED");
+    succeeded = succeeded && passed;
+  }
+
+  // Messages logged through the ring are written by its thread, so wait for them.
+  LogRingBuffer::GetSharedInstance()->Flush();
+  return (succeeded ? 0 : 1);
+}
@@ -0,0 +1,239 @@
+/**********************************************************************
+
+File     : WorkStealingPoolTests.cpp
+Project  : Bach Simulation
+Purpose  : Source file for tests of the work stealing thread pool.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#include "WorkStealingPoolTests.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace Bach;
+using namespace boost;
+
+namespace {
+  const int NUM_THREADS = 4;
+  const int NUM_INDICES = 1000;
+  const int NUM_STOLEN = 64;
+  const int NUM_OUTER = 8;
+  const int NUM_INNER = 16;
+  const int THROWING_INDEX = 37;
+
+  // Long enough for any machine to steal a few tasks, short enough that a broken pool fails rather than hangs.
+  const std::chrono::seconds STEAL_TIMEOUT(30);
+}
+
+  //*************************
+  //* WorkStealingPoolTests *
+  //*************************
+
+shared_ptr<WorkStealingPoolTests> WorkStealingPoolTests::CreateInstance() {
+  shared_ptr<WorkStealingPoolTests> instance(new WorkStealingPoolTests);
+  return instance;
+}
+
+WorkStealingPoolTests::WorkStealingPoolTests() :
+  m_pool(WorkStealingPool::CreateInstance(NUM_THREADS)),
+  m_success(false)
+{
+}
+
+WorkStealingPoolTests::~WorkStealingPoolTests() {
+}
+
+bool WorkStealingPoolTests::RunTests() {
+  m_success = true;
+  TestParallelFor();
+  TestStealing();
+  TestNested();
+  TestExceptions();
+
+  if(m_success) {
+    Log(L"Work stealing pool tests succeeded");
+  }
+  return m_success;
+}
+
+void WorkStealingPoolTests::TestParallelFor() {
+  if(m_pool->GetNumberOfThreads() != NUM_THREADS || m_pool->GetWorkerIndex() != -1) {
+    Fail("The pool doesn't have the threads asked for, or takes this thread for one of them");
+  }
+
+  std::vector<std::atomic<int> > numRuns(NUM_INDICES);
+  std::atomic<int> numOffWorker(0);
+  m_pool->ParallelFor(NUM_INDICES, [&](int i) {
+    numRuns[i]++;
+    int worker = m_pool->GetWorkerIndex();
+    if(worker < -1 || worker >= NUM_THREADS) {
+      numOffWorker++;
+    }
+  });
+
+  for(int i=0; i<NUM_INDICES; i++) {
+    if(numRuns[i] != 1) {
+      Fail("Index " + std::to_string(i) + " was run " + std::to_string(numRuns[i]) + " times");
+      return;
+    }
+  }
+  if(numOffWorker > 0) {
+    Fail("A task saw a worker index out of range");
+  }
+
+  // Tasks submitted on their own are all done by the time Wait returns.
+  std::atomic<int> numSubmitted(0);
+  for(int i=0; i<NUM_INDICES; i++) {
+    m_pool->Submit([&numSubmitted] { numSubmitted++; });
+  }
+  m_pool->Wait();
+  if(numSubmitted != NUM_INDICES) {
+    Fail("Wait returned with " + std::to_string(numSubmitted) + " of the submitted tasks run");
+  }
+}
+
+void WorkStealingPoolTests::TestStealing() {
+  // A worker submits tasks onto its own queue and then blocks without running any, so the
+  // other workers can only get through them by stealing.
+  std::mutex mutex;
+  std::condition_variable allRun;
+  int numRun = 0;
+  int submitter = -1;
+  std::vector<int> runBy(NUM_STOLEN, -1);
+
+  m_pool->Submit([&] {
+    submitter = m_pool->GetWorkerIndex();
+    for(int i=0; i<NUM_STOLEN; i++) {
+      m_pool->Submit([&, i] {
+        std::lock_guard<std::mutex> lock(mutex);
+        runBy[i] = m_pool->GetWorkerIndex();
+        if(++numRun == NUM_STOLEN) {
+          allRun.notify_all();
+        }
+      });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    allRun.wait_for(lock, STEAL_TIMEOUT, [&numRun] { return numRun == NUM_STOLEN; });
+  });
+  m_pool->Wait();
+
+  if(numRun != NUM_STOLEN) {
+    Fail("Only " + std::to_string(numRun) + " of the tasks on a blocked worker's queue were stolen");
+    return;
+  }
+  for(int i=0; i<NUM_STOLEN; i++) {
+    if(runBy[i] < 0 || runBy[i] == submitter) {
+      Fail("Task " + std::to_string(i) + " was run by worker " + std::to_string(runBy[i]) + " rather than stolen");
+      return;
+    }
+  }
+}
+
+void WorkStealingPoolTests::TestNested() {
+  // More outer tasks than threads, each waiting on inner ones, would deadlock if a waiting
+  // worker didn't run queued tasks itself. A pool of one thread leaves it no choice.
+  shared_ptr<WorkStealingPool> pools[2] = { m_pool, WorkStealingPool::CreateInstance(1) };
+  for(int p=0; p<2; p++) {
+    shared_ptr<WorkStealingPool> pool = pools[p];
+    std::vector<std::atomic<int> > sums(NUM_OUTER);
+    std::atomic<int> numDeepest(0);
+    pool->ParallelFor(NUM_OUTER, [&](int i) {
+      pool->ParallelFor(NUM_INNER, [&, i](int j) {
+        sums[i] += j;
+        pool->ParallelFor(2, [&numDeepest](int) { numDeepest++; });
+      });
+    });
+
+    for(int i=0; i<NUM_OUTER; i++) {
+      if(sums[i] != NUM_INNER*(NUM_INNER-1)/2) {
+        Fail("Nested on " + std::to_string(pool->GetNumberOfThreads()) + " threads, outer task " + std::to_string(i) + " summed to " + std::to_string(sums[i]));
+        return;
+      }
+    }
+    if(numDeepest != 2*NUM_OUTER*NUM_INNER) {
+      Fail("Nested on " + std::to_string(pool->GetNumberOfThreads()) + " threads, " + std::to_string(numDeepest) + " of the deepest tasks ran");
+    }
+  }
+}
+
+void WorkStealingPoolTests::TestExceptions() {
+  // ParallelFor runs every index before rethrowing the exception to its caller.
+  std::atomic<int> numRun(0);
+  bool caught = false;
+  try {
+    m_pool->ParallelFor(NUM_INDICES, [&numRun](int i) {
+      numRun++;
+      if(i == THROWING_INDEX) {
+        throw std::runtime_error("index");
+      }
+    });
+  }
+  catch(const std::runtime_error& e) {
+    caught = (std::string(e.what()) == "index");
+  }
+  if(!caught || numRun != NUM_INDICES) {
+    Fail("ParallelFor didn't run every index and then rethrow the exception");
+  }
+
+  // From a nested ParallelFor the exception passes through the task that called it.
+  caught = false;
+  try {
+    m_pool->ParallelFor(NUM_OUTER, [this](int i) {
+      m_pool->ParallelFor(NUM_INNER, [i](int j) {
+        if(i == 1 && j == 2) {
+          throw std::runtime_error("nested");
+        }
+      });
+    });
+  }
+  catch(const std::runtime_error& e) {
+    caught = (std::string(e.what()) == "nested");
+  }
+  if(!caught) {
+    Fail("A nested ParallelFor's exception didn't reach the outer caller");
+  }
+
+  // Wait rethrows the first exception of the submitted tasks, and only once.
+  for(int i=0; i<NUM_OUTER; i++) {
+    m_pool->Submit([] { throw std::runtime_error("submitted"); });
+  }
+  caught = false;
+  try {
+    m_pool->Wait();
+  }
+  catch(const std::runtime_error& e) {
+    caught = (std::string(e.what()) == "submitted");
+  }
+  if(!caught) {
+    Fail("Wait didn't rethrow a submitted task's exception");
+  }
+  try {
+    m_pool->Wait();
+  }
+  catch(...) {
+    Fail("Wait rethrew an exception a second time");
+  }
+
+  // The pool is still whole after its tasks threw.
+  std::atomic<int> numAfter(0);
+  m_pool->ParallelFor(NUM_INDICES, [&numAfter](int) { numAfter++; });
+  if(numAfter != NUM_INDICES) {
+    Fail("The pool didn't run every index after its tasks threw");
+  }
+}
+
+void WorkStealingPoolTests::Fail(const std::string& message) {
+  Log(L"ERROR: %s", WideStringFromUTF8(message).c_str());
+  m_success = false;
+}
@@ -0,0 +1,55 @@
+/**********************************************************************
+
+File     : WorkStealingPoolTests.h
+Project  : Bach Simulation
+Purpose  : Header file for tests of the work stealing thread pool.
+Revisions: Original definition by Lawrence Gunn.
+           2026/10/18
+           Tasks left on one worker's queue are checked to be stolen by the
+           others, ParallelFor to run every index once, nested within its own
+           tasks too, and exceptions from tasks to reach the caller.
+
+Copyright (c) 2026 by Lawrence Gunn
+All Rights Reserved.
+
+*/
+
+#ifndef __BACH_WORK_STEALING_POOL_TESTS_H__
+#define __BACH_WORK_STEALING_POOL_TESTS_H__
+
+#include "BachDefs.h"
+#include <string>
+
+namespace Bach {
+
+  class WorkStealingPool;
+
+  //*************************
+  //* WorkStealingPoolTests *
+  //*************************
+
+  class WorkStealingPoolTests {
+  public:
+
+    static boost::shared_ptr<WorkStealingPoolTests> CreateInstance();
+
+    ~WorkStealingPoolTests();
+
+    bool RunTests();
+
+  protected:
+    WorkStealingPoolTests();
+
+    void TestParallelFor();
+    void TestStealing();
+    void TestNested();
+    void TestExceptions();
+
+    void Fail(const std::string& message);
+
+    boost::shared_ptr<WorkStealingPool> m_pool;
+    bool m_success;
+  };
+};
+
+#endif // __BACH_WORK_STEALING_POOL_TESTS_H__